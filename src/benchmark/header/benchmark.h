@@ -0,0 +1,82 @@
+/**
+ * @file benchmark.h
+ * @brief Market benchmark entry points and timing helpers.
+ *
+ * Each benchmark lives in its own source file and is registered in the table in benchmarkMain.cpp;
+ * "market_benchmark <name>..." runs the named benchmarks, without arguments all of them run.
+ */
+
+#ifndef MARKET_BENCHMARK_H
+#define MARKET_BENCHMARK_H
+
+#include <chrono>
+
+namespace Coruh
+{
+    namespace Benchmark
+    {
+        /**
+            @class Stopwatch
+            @brief Measures elapsed wall-clock time with a monotonic clock.
+        */
+        class Stopwatch
+        {
+        public:
+            /** @brief Starts the stopwatch. */
+            Stopwatch() : start(std::chrono::steady_clock::now()) {}
+
+            /** @brief Returns the seconds elapsed since construction. */
+            double elapsedSeconds() const
+            {
+                return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+
+        private:
+            std::chrono::steady_clock::time_point start;    ///< Construction time.
+        };
+
+        /**
+         * @brief Scales a mixed lookup/insert workload on the concurrent B+ tree from 1 to N threads.
+         *
+         * Compares the optimistic lock coupling tree with a BPlusTree guarded by one mutex.
+         */
+        void runConcurrentBPlusTreeBenchmark();
+
+        /**
+         * @brief Measures the cost per element of the MathUtility mean, min/max and median from 1e3 to 1e8 prices.
+         *
+         * Compares the vectorized reductions with scalar loops and the selection median with qsort.
+         */
+        void runMathUtilityBenchmark();
+
+        /**
+         * @brief Measures the cost per product of sorting products by price from 1e3 to 4e6 products.
+         *
+         * Compares heap sorting whole Product records with heap sorting and radix sorting (price, index) keys.
+         */
+        void runProductSortBenchmark();
+
+        /**
+         * @brief Measures the parallel catalog sort by price and by name from 1 to N threads.
+         *
+         * Compares it with the single-threaded heap sort of the product records.
+         */
+        void runParallelSortBenchmark();
+
+        /**
+         * @brief Measures finding the products with a name through the search index from 1e3 to 1e6 products.
+         *
+         * Compares exact and substring index queries with scanning the products file.
+         */
+        void runSearchIndexBenchmark();
+
+        /**
+         * @brief Measures the latency of single inserts into the hash tables from 1e3 to 1e5 products.
+         *
+         * Compares the median, p99 and maximum insert time of the linear hash table and the extendible hash file.
+         */
+        void runHashInsertBenchmark();
+    }
+}
+
+#endif // MARKET_BENCHMARK_H
@@ -0,0 +1,67 @@
+/**
+ * @file benchmarkMain.cpp
+ * @brief Entry point of the market benchmark executable.
+ *
+ * Benchmarks are meant to be run on a Release build; their timings are printed as plain tables.
+ */
+
+#include "../header/benchmark.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @struct BenchmarkEntry
+ * @brief Name and entry point of one benchmark.
+ */
+struct BenchmarkEntry {
+    const char* name;       ///< Name used on the command line.
+    void (*run)();          ///< Benchmark entry point.
+};
+
+/** @brief Every available benchmark. */
+static const BenchmarkEntry benchmarks[] = {
+    { "concurrent-bplustree", Coruh::Benchmark::runConcurrentBPlusTreeBenchmark },
+    { "math-utility", Coruh::Benchmark::runMathUtilityBenchmark },
+    { "product-sort", Coruh::Benchmark::runProductSortBenchmark },
+    { "parallel-sort", Coruh::Benchmark::runParallelSortBenchmark },
+    { "search-index", Coruh::Benchmark::runSearchIndexBenchmark },
+    { "hash-insert", Coruh::Benchmark::runHashInsertBenchmark },
+};
+
+/**
+ * @brief Runs the benchmarks named on the command line, or all of them.
+ *
+ * @param argc Argument count.
+ * @param argv Benchmark names.
+ * @return 0 on success, 1 if an unknown benchmark was requested.
+ */
+int main(int argc, char** argv) {
+    const int benchmarkCount = (int)(sizeof(benchmarks) / sizeof(benchmarks[0]));
+    if (argc < 2) {
+        for (int i = 0; i < benchmarkCount; i++) {
+            printf("== %s ==\n", benchmarks[i].name);
+            benchmarks[i].run();
+        }
+        return 0;
+    }
+
+    for (int arg = 1; arg < argc; arg++) {
+        bool found = false;
+        for (int i = 0; i < benchmarkCount; i++) {
+            if (strcmp(argv[arg], benchmarks[i].name) == 0) {
+                printf("== %s ==\n", benchmarks[i].name);
+                benchmarks[i].run();
+                found = true;
+            }
+        }
+        if (!found) {
+            printf("Unknown benchmark: %s\nAvailable:", argv[arg]);
+            for (int i = 0; i < benchmarkCount; i++) {
+                printf(" %s", benchmarks[i].name);
+            }
+            printf("\n");
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file concurrentBPlusTreeBenchmark.cpp
+ * @brief Thread scaling of the optimistic lock coupling B+ tree against a mutex-guarded B+ tree.
+ *
+ * The tree is pre-loaded with PRELOAD_KEYS keys; every thread then performs OPERATIONS_PER_THREAD operations,
+ * 95% lookups of random keys and 5% inserts of fresh keys, which mirrors many read queries while vendors are
+ * being added. Throughput is reported for 1 to hardware_concurrency() threads.
+ */
+
+#include "../header/benchmark.h"
+#include "bPlusTree.h"
+#include "concurrentBPlusTree.h"
+#include <mutex>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+/** @brief Keys loaded before the timed phase. */
+#define PRELOAD_KEYS 1000000
+/** @brief Operations performed by each thread in the timed phase. */
+#define OPERATIONS_PER_THREAD 1000000
+/** @brief One operation in this many is an insert. */
+#define INSERT_EVERY 20
+
+namespace
+{
+    typedef Coruh::Market::ConcurrentBPlusTree<int, int, 256> ConcurrentTree;
+    typedef Coruh::Market::BPlusTree<int, int, 256> SequentialTree;
+
+    /**
+        @class MutexBPlusTree
+        @brief Baseline: the sequential BPlusTree behind a single mutex.
+    */
+    class MutexBPlusTree
+    {
+    public:
+        bool find(int fiKey, int* foValue)
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            return tree.find(fiKey, foValue);
+        }
+
+        bool insert(int fiKey, int fiValue)
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            return tree.insert(fiKey, fiValue);
+        }
+
+    private:
+        std::mutex mutex;       ///< Serializes every operation.
+        SequentialTree tree;    ///< The guarded tree.
+    };
+
+    /**
+     * @brief Runs the mixed workload on fiThreads threads and returns the throughput in million operations per second.
+     *
+     * @param fiThreads Number of threads.
+     * @param foHitRate Receives the share of lookups that found their key, in percent; about half of the random
+     *                  keys were preloaded, so a rate far from 50% means lookups went wrong.
+     */
+    template <typename Tree>
+    double measureThroughput(int fiThreads, double* foHitRate)
+    {
+        Tree tree;
+        for (int i = 0; i < PRELOAD_KEYS; i++) {
+            int key = (int)(((long long)i * 2654435761LL) % PRELOAD_KEYS) * 2;
+            tree.insert(key, key);
+        }
+
+        std::vector<std::thread> threads;
+        long long found = 0;
+        std::mutex foundMutex;
+        Coruh::Benchmark::Stopwatch stopwatch;
+        for (int t = 0; t < fiThreads; t++) {
+            threads.push_back(std::thread([&tree, &found, &foundMutex, t]() {
+                unsigned int seed = 2463534242u + (unsigned int)t * 7919u;
+                long long hits = 0;
+                int nextInsert = 0;
+                for (int i = 0; i < OPERATIONS_PER_THREAD; i++) {
+                    seed ^= seed << 13;
+                    seed ^= seed >> 17;
+                    seed ^= seed << 5;
+                    if (i % INSERT_EVERY == 0) {
+                        // Odd keys are fresh: each thread owns every fiThreads-th of them
+                        int key = 2 * PRELOAD_KEYS + (nextInsert++ * 64 + t) * 2 + 1;
+                        tree.insert(key, key);
+                    }
+                    else {
+                        int value;
+                        if (tree.find((int)(seed % (2 * PRELOAD_KEYS)), &value)) {hits++;}
+                    }
+                }
+                std::lock_guard<std::mutex> guard(foundMutex);
+                found += hits;
+            }));
+        }
+        for (size_t i = 0; i < threads.size(); i++) {
+            threads[i].join();
+        }
+        double seconds = stopwatch.elapsedSeconds();
+        long long lookups = (long long)fiThreads * (OPERATIONS_PER_THREAD - (OPERATIONS_PER_THREAD + INSERT_EVERY - 1) / INSERT_EVERY);
+        *foHitRate = 100.0 * (double)found / (double)lookups;
+        return (double)fiThreads * OPERATIONS_PER_THREAD / seconds / 1e6;
+    }
+}
+
+void Coruh::Benchmark::runConcurrentBPlusTreeBenchmark()
+{
+    int maxThreads = (int)std::thread::hardware_concurrency();
+    if (maxThreads < 1) {maxThreads = 1;}
+    if (maxThreads > 64) {maxThreads = 64;}
+
+    printf("%-8s %14s %10s %8s %14s %10s %8s\n", "threads", "olc Mops/s", "speedup", "hits", "mutex Mops/s", "speedup", "hits");
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    double olcBase = 0;
+    double mutexBase = 0;
+    for (size_t i = 0; i < threadCounts.size(); i++) {
+        double olcHits = 0;
+        double lockedHits = 0;
+        double olc = measureThroughput<ConcurrentTree>(threadCounts[i], &olcHits);
+        double locked = measureThroughput<MutexBPlusTree>(threadCounts[i], &lockedHits);
+        if (i == 0) {
+            olcBase = olc;
+            mutexBase = locked;
+        }
+        printf("%-8d %14.2f %9.2fx %7.1f%% %14.2f %9.2fx %7.1f%%\n", threadCounts[i], olc, olc / olcBase, olcHits, locked, locked / mutexBase, lockedHits);
+    }
+}
@@ -0,0 +1,109 @@
+/**
+ * @file hashInsertBenchmark.cpp
+ * @brief Latency of single inserts into the linear hash table and the extendible hash file, from 1e3 to 1e5
+ *        products.
+ *
+ * Every insert is timed on its own, so the tail shows what growing the table costs the unlucky insert: a linear
+ * hash table splits one bucket per insert that passes the load limit, an extendible hash file splits one bucket
+ * page and doubles its directory now and then. The hash file keeps its pages on disk, so its inserts also pay
+ * for a page read and write; the percentiles are meant to be compared with the median of the same structure.
+ * Every product has its own vendor ID, so no bucket grows an overflow chain of a single vendor.
+ */
+
+#include "../header/benchmark.h"
+#include "linearHash.h"
+#include "extendibleHash.h"
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+/** @brief Hash file written for the benchmark; its directory goes next to it. */
+#define HASH_BENCHMARK_FILE "hash_benchmark.bin"
+/** @brief Buckets of the linear hash table before the first split. */
+#define HASH_BENCHMARK_INITIAL_BUCKETS 4
+
+using Coruh::Benchmark::Stopwatch;
+
+namespace
+{
+    /** @brief Fills the products with distinct vendor IDs in a scrambled order. */
+    void fillProducts(std::vector<Product>& foProducts)
+    {
+        for (size_t i = 0; i < foProducts.size(); i++) {
+            memset(&foProducts[i], 0, sizeof(Product));
+            foProducts[i].vendorId = (int)((i * 2654435761u) & 0x7fffffffu);
+            foProducts[i].price = (float)(i % 500);
+            snprintf(foProducts[i].productName, sizeof(foProducts[i].productName), "Product%zu", i);
+            strcpy(foProducts[i].season, "Summer");
+        }
+    }
+
+    /** @brief Returns the fiPercent percentile of fiLatencies, which is sorted on return. */
+    double percentile(std::vector<double>& fiLatencies, double fiPercent)
+    {
+        std::sort(fiLatencies.begin(), fiLatencies.end());
+        return fiLatencies[(size_t)(fiPercent / 100.0 * (double)(fiLatencies.size() - 1))];
+    }
+
+    /** @brief Prints the median, p99 and maximum of one run, in microseconds. */
+    void printLatencies(const char* fiName, int fiCount, std::vector<double>& fiLatencies)
+    {
+        double median = percentile(fiLatencies, 50.0);
+        double tail = percentile(fiLatencies, 99.0);
+        printf("%10d %-10s %12.2f %12.2f %12.2f %12.1f\n", fiCount, fiName, median * 1e6, tail * 1e6, fiLatencies.back() * 1e6, tail / median);
+    }
+
+    /** @brief Times every insert of fiProducts into a new linear hash table. */
+    bool timeLinearHash(const std::vector<Product>& fiProducts, std::vector<double>& foLatencies)
+    {
+        LinearHashTable* table = createLinearHashTable(HASH_BENCHMARK_INITIAL_BUCKETS, LINEAR_HASH_MAX_LOAD);
+        if (table == NULL) {return false;}
+        bool inserted = true;
+        for (size_t i = 0; i < fiProducts.size() && inserted; i++) {
+            Stopwatch watch;
+            inserted = linearHashInsert(table, &fiProducts[i]);
+            foLatencies[i] = watch.elapsedSeconds();
+        }
+        freeLinearHashTable(table);
+        return inserted;
+    }
+
+    /** @brief Times every insert of fiProducts into a new extendible hash file. */
+    bool timeExtendibleHash(const std::vector<Product>& fiProducts, std::vector<double>& foLatencies)
+    {
+        remove(HASH_BENCHMARK_FILE);
+        remove(HASH_BENCHMARK_FILE ".dir");
+        ExtendibleHashFile* hashFile = openExtendibleHashFile(HASH_BENCHMARK_FILE);
+        if (hashFile == NULL) {return false;}
+        bool inserted = true;
+        for (size_t i = 0; i < fiProducts.size() && inserted; i++) {
+            Stopwatch watch;
+            inserted = extendibleHashInsert(hashFile, &fiProducts[i]);
+            foLatencies[i] = watch.elapsedSeconds();
+        }
+        bool closed = closeExtendibleHashFile(hashFile);
+        remove(HASH_BENCHMARK_FILE);
+        remove(HASH_BENCHMARK_FILE ".dir");
+        return inserted && closed;
+    }
+}
+
+void Coruh::Benchmark::runHashInsertBenchmark()
+{
+    printf("%10s %-10s %12s %12s %12s %12s\n", "products", "table", "p50 us", "p99 us", "max us", "p99/p50");
+
+    const int sizes[] = {1000, 10000, 100000};
+    for (int s = 0; s < 3; s++) {
+        int count = sizes[s];
+        std::vector<Product> products((size_t)count);
+        fillProducts(products);
+        std::vector<double> latencies((size_t)count);
+
+        if (timeLinearHash(products, latencies)) {printLatencies("linear", count, latencies);}
+        else {printf("%10d %-10s  skipped: an insert failed\n", count, "linear");}
+
+        if (timeExtendibleHash(products, latencies)) {printLatencies("extendible", count, latencies);}
+        else {printf("%10d %-10s  skipped: cannot write the hash file\n", count, "extendible");}
+    }
+}
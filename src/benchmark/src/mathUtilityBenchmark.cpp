@@ -0,0 +1,129 @@
+/**
+ * @file mathUtilityBenchmark.cpp
+ * @brief Per-element cost of the MathUtility statistics kernels from 1e3 to 1e8 float prices.
+ *
+ * Each size is repeated until about REPEAT_ELEMENTS elements have been processed, so small arrays that stay in
+ * cache and large arrays that stream from memory are both measured reliably. The vectorized mean and min/max
+ * are compared with plain scalar loops, the selection-based median with qsort and compareDouble, which is what
+ * a median cost before. qsort is skipped above QSORT_MAX_ELEMENTS, and sizes that cannot be allocated are skipped.
+ */
+
+#include "../header/benchmark.h"
+#include "mathUtility.h"
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+/** @brief Elements processed per measurement, spread over as many repetitions as the size needs. */
+#define REPEAT_ELEMENTS 100000000LL
+/** @brief Largest size measured with the qsort baseline. */
+#define QSORT_MAX_ELEMENTS 10000000
+
+using Coruh::Benchmark::Stopwatch;
+using Coruh::Utility::MathUtility;
+
+namespace
+{
+    /** @brief Keeps results alive so the compiler cannot drop the measured work. */
+    volatile double benchmarkSink;
+
+    double scalarMean(const float* fiPrices, int fiCount)
+    {
+        double sum = 0.0;
+        for (int i = 0; i < fiCount; i++) {sum += fiPrices[i];}
+        return sum / fiCount;
+    }
+
+    void scalarMinMax(const float* fiPrices, int fiCount, float* foMin, float* foMax)
+    {
+        float minimum = fiPrices[0];
+        float maximum = fiPrices[0];
+        for (int i = 1; i < fiCount; i++) {
+            if (fiPrices[i] < minimum) {minimum = fiPrices[i];}
+            if (fiPrices[i] > maximum) {maximum = fiPrices[i];}
+        }
+        *foMin = minimum;
+        *foMax = maximum;
+    }
+
+    double qsortMedian(const float* fiPrices, int fiCount)
+    {
+        std::vector<double> values(fiPrices, fiPrices + fiCount);
+        qsort(values.data(), values.size(), sizeof(double), MathUtility::compareDouble);
+        return fiCount % 2 == 1 ? values[fiCount / 2] : (values[fiCount / 2 - 1] + values[fiCount / 2]) / 2.0;
+    }
+
+    /** @brief Returns how often an operation on fiCount elements is repeated. */
+    int repetitionsFor(int fiCount)
+    {
+        long long repetitions = REPEAT_ELEMENTS / fiCount;
+        return repetitions > 0 ? (int)repetitions : 1;
+    }
+
+    /** @brief Runs fiOperation repeatedly and returns nanoseconds per element. */
+    template <typename Operation>
+    double nanosecondsPerElement(int fiCount, int fiRepetitions, Operation fiOperation)
+    {
+        Stopwatch stopwatch;
+        for (int r = 0; r < fiRepetitions; r++) {fiOperation();}
+        return stopwatch.elapsedSeconds() * 1e9 / ((double)fiCount * fiRepetitions);
+    }
+}
+
+void Coruh::Benchmark::runMathUtilityBenchmark()
+{
+    printf("reduction variant: %s\n", MathUtility::reductionImplementationName());
+    printf("%10s %12s %12s %12s %12s %12s %12s\n", "elements", "mean ns/el", "scalar", "minmax ns/el", "scalar",
+           "median ns/el", "qsort");
+
+    for (long long size = 1000; size <= 100000000LL; size *= 10) {
+        int count = (int)size;
+        std::vector<float> prices;
+        try {
+            prices.resize((size_t)count);
+        }
+        catch (const std::bad_alloc&) {
+            printf("%10d skipped: not enough memory\n", count);
+            continue;
+        }
+        // Prices with two decimals and many repeats, like a real catalog
+        unsigned int state = 12345u;
+        for (int i = 0; i < count; i++) {
+            state = state * 1103515245u + 12345u;
+            prices[i] = (float)((state >> 8) % 100000) / 100.0f;
+        }
+
+        int repetitions = repetitionsFor(count);
+        const float* data = prices.data();
+        float minimum = 0.0f;
+        float maximum = 0.0f;
+        double meanFast = nanosecondsPerElement(count, repetitions, [&]() { benchmarkSink = MathUtility::calculateMean(data, count); });
+        double meanScalar = nanosecondsPerElement(count, repetitions, [&]() { benchmarkSink = scalarMean(data, count); });
+        double minMaxFast = nanosecondsPerElement(count, repetitions, [&]() {
+            MathUtility::calculateMinMax(data, count, &minimum, &maximum);
+            benchmarkSink = minimum + maximum;
+        });
+        double minMaxScalar = nanosecondsPerElement(count, repetitions, [&]() {
+            scalarMinMax(data, count, &minimum, &maximum);
+            benchmarkSink = minimum + maximum;
+        });
+
+        // Selection and sorting cost far more per element; a tenth of the repetitions is enough
+        int medianRepetitions = repetitions / 10 > 0 ? repetitions / 10 : 1;
+        double medianSelect = -1.0;
+        double medianSort = -1.0;
+        try {
+            medianSelect = nanosecondsPerElement(count, medianRepetitions, [&]() { benchmarkSink = MathUtility::calculateMedian(data, count); });
+            if (count <= QSORT_MAX_ELEMENTS) {
+                medianSort = nanosecondsPerElement(count, medianRepetitions, [&]() { benchmarkSink = qsortMedian(data, count); });
+            }
+        }
+        catch (const std::bad_alloc&) {
+        }
+
+        printf("%10d %12.3f %12.3f %12.3f %12.3f", count, meanFast, meanScalar, minMaxFast, minMaxScalar);
+        if (medianSelect >= 0.0) {printf(" %12.3f", medianSelect);} else {printf(" %12s", "-");}
+        if (medianSort >= 0.0) {printf(" %12.3f\n", medianSort);} else {printf(" %12s\n", "-");}
+    }
+}
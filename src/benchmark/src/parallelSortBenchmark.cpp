@@ -0,0 +1,79 @@
+/**
+ * @file parallelSortBenchmark.cpp
+ * @brief Catalog sort throughput from 1 to N threads, on 1e6 and 4e6 products.
+ *
+ * Each row sorts the same catalog with sortProductCatalog() by price and by name, with the thread count
+ * doubled from 1 up to the number of hardware threads. The single-threaded heapSort() of the records is the
+ * baseline the parallel sort replaces for large catalogs.
+ */
+
+#include "../header/benchmark.h"
+#include "productSort.h"
+#include <new>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+using Coruh::Benchmark::Stopwatch;
+
+namespace
+{
+    /** @brief Fills products with pseudo-random vendors, names from a small vocabulary and repeating prices. */
+    void fillCatalog(std::vector<Product>& foProducts)
+    {
+        static const char* const names[] = {"Tomato", "Potato", "Apple", "Pear", "Cucumber", "Carrot", "Cabbage", "Cherry"};
+        unsigned int state = 777u;
+        for (size_t i = 0; i < foProducts.size(); i++) {
+            state = state * 1664525u + 1013904223u;
+            memset(&foProducts[i], 0, sizeof(Product));
+            foProducts[i].vendorId = (int)((state >> 10) % 5000);
+            foProducts[i].price = (float)((state >> 8) % 10000 + 1) * 0.25f;
+            snprintf(foProducts[i].productName, sizeof(foProducts[i].productName), "%s%u", names[state % 8], (state >> 20) % 64);
+        }
+    }
+}
+
+void Coruh::Benchmark::runParallelSortBenchmark()
+{
+    int hardwareThreads = (int)std::thread::hardware_concurrency();
+    if (hardwareThreads <= 0) {hardwareThreads = 1;}
+    printf("hardware threads: %d\n", hardwareThreads);
+    printf("%10s %8s %14s %14s %16s\n", "products", "threads", "by price ms", "by name ms", "heapSort ms");
+
+    const int sizes[] = {1000000, 4000000};
+    for (int s = 0; s < 2; s++) {
+        int count = sizes[s];
+        std::vector<Product> products;
+        std::vector<int> order;
+        try {
+            products.resize(count);
+            order.resize(count);
+        }
+        catch (const std::bad_alloc&) {
+            printf("%10d  skipped: not enough memory\n", count);
+            continue;
+        }
+        fillCatalog(products);
+
+        double heapSortMilliseconds = 0.0;
+        {
+            std::vector<Product> copy(products);
+            Stopwatch stopwatch;
+            heapSort(copy.data(), count);
+            heapSortMilliseconds = stopwatch.elapsedSeconds() * 1e3;
+        }
+
+        for (int threads = 1; threads <= hardwareThreads; threads *= 2) {
+            Stopwatch byPrice;
+            bool sorted = sortProductCatalog(products.data(), count, PRODUCT_SORT_BY_PRICE, threads, order.data());
+            double priceMilliseconds = byPrice.elapsedSeconds() * 1e3;
+            Stopwatch byName;
+            sorted = sortProductCatalog(products.data(), count, PRODUCT_SORT_BY_NAME, threads, order.data()) && sorted;
+            double nameMilliseconds = byName.elapsedSeconds() * 1e3;
+            printf("%10d %8d %14.1f %14.1f %16.1f%s\n", count, threads, priceMilliseconds, nameMilliseconds, heapSortMilliseconds,
+                   sorted ? "" : "  FAILED");
+            if (threads < hardwareThreads && threads * 2 > hardwareThreads) {threads = hardwareThreads / 2;}
+        }
+    }
+}
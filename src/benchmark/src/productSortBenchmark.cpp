@@ -0,0 +1,123 @@
+/**
+ * @file productSortBenchmark.cpp
+ * @brief Cost of sorting products by price, from 1e3 to 4e6 products.
+ *
+ * The baseline is the heap sort that sifts whole Product records with the recursive heapify(); it is compared
+ * with heapSort(), which sorts (price, index) keys and moves every product once, and with sorting the keys
+ * alone by heap sort and by LSD radix sort, which is what the price comparison does. Prices repeat, as they
+ * do in a catalog.
+ */
+
+#include "../header/benchmark.h"
+#include "productSort.h"
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+/** @brief Products sorted per measurement, spread over as many repetitions as the size needs. */
+#define SORT_REPEAT_PRODUCTS 8000000LL
+
+using Coruh::Benchmark::Stopwatch;
+
+namespace
+{
+    /** @brief Fills products with pseudo-random prices between 0.25 and 2500.00. */
+    void fillProducts(std::vector<Product>& foProducts)
+    {
+        unsigned int state = 12345u;
+        for (size_t i = 0; i < foProducts.size(); i++) {
+            memset(&foProducts[i], 0, sizeof(Product));
+            state = state * 1664525u + 1013904223u;
+            foProducts[i].vendorId = (int)(i % 1000);
+            foProducts[i].price = (float)((state >> 8) % 10000 + 1) * 0.25f;
+            foProducts[i].quantity = (int)(state % 500);
+            strcpy(foProducts[i].productName, "Tomato");
+        }
+    }
+
+    /** @brief The heap sort that swaps Product records, kept as the baseline. */
+    void recordHeapSort(Product* fiProducts, int fiCount)
+    {
+        for (int i = fiCount / 2 - 1; i >= 0; i--) {heapify(fiProducts, fiCount, i);}
+        for (int i = fiCount - 1; i > 0; i--) {
+            Product temp = fiProducts[0];
+            fiProducts[0] = fiProducts[i];
+            fiProducts[i] = temp;
+            heapify(fiProducts, i, 0);
+        }
+    }
+
+    /** @brief Returns true if the products are in ascending price order. */
+    bool sortedByPrice(const std::vector<Product>& fiProducts)
+    {
+        for (size_t i = 1; i < fiProducts.size(); i++) {
+            if (fiProducts[i - 1].price > fiProducts[i].price) {return false;}
+        }
+        return true;
+    }
+
+    /** @brief Sorts copies of fiInput with fiSort and returns nanoseconds per product, excluding the copies. */
+    template <typename Sort>
+    double nanosecondsPerProduct(const std::vector<Product>& fiInput, std::vector<Product>& foWork, int fiRepetitions, Sort fiSort)
+    {
+        double seconds = 0.0;
+        for (int r = 0; r < fiRepetitions; r++) {
+            foWork = fiInput;
+            Stopwatch stopwatch;
+            fiSort();
+            seconds += stopwatch.elapsedSeconds();
+        }
+        return seconds * 1e9 / ((double)fiInput.size() * fiRepetitions);
+    }
+}
+
+void Coruh::Benchmark::runProductSortBenchmark()
+{
+    printf("%10s %16s %16s %16s %16s\n", "products", "records ns/el", "keyed ns/el", "key heap ns/el", "key radix ns/el");
+
+    const long long sizes[] = {1000, 10000, 100000, 1000000, 4000000};
+    for (int s = 0; s < 5; s++) {
+        int count = (int)sizes[s];
+        std::vector<Product> input;
+        std::vector<Product> work;
+        std::vector<PriceSortKey> keys;
+        try {
+            input.resize(count);
+            work.resize(count);
+            keys.resize(count);
+        }
+        catch (const std::bad_alloc&) {
+            printf("%10d  skipped: not enough memory\n", count);
+            continue;
+        }
+        fillProducts(input);
+        long long repetitions = SORT_REPEAT_PRODUCTS / count;
+        int rounds = repetitions > 0 ? (int)repetitions : 1;
+
+        double records = nanosecondsPerProduct(input, work, rounds, [&]() {recordHeapSort(work.data(), count);});
+        bool recordsSorted = sortedByPrice(work);
+        double keyed = nanosecondsPerProduct(input, work, rounds, [&]() {heapSort(work.data(), count);});
+        bool keyedSorted = sortedByPrice(work);
+        double keysOnly = nanosecondsPerProduct(input, work, rounds, [&]() {
+            for (int i = 0; i < count; i++) {
+                keys[i].price = work[i].price;
+                keys[i].index = i;
+            }
+            heapSortPriceKeys(keys.data(), count);
+        });
+        double keysRadix = nanosecondsPerProduct(input, work, rounds, [&]() {
+            for (int i = 0; i < count; i++) {
+                keys[i].price = work[i].price;
+                keys[i].index = i;
+            }
+            radixSortPriceKeys(keys.data(), count);
+        });
+        bool radixSorted = true;
+        for (int i = 1; i < count; i++) {radixSorted = radixSorted && keys[i - 1].price <= keys[i].price;}
+
+        printf("%10d %16.1f %16.1f %16.1f %16.1f%s\n", count, records, keyed, keysOnly, keysRadix,
+               recordsSorted && keyedSorted && radixSorted ? "" : "  UNSORTED");
+    }
+}
@@ -0,0 +1,112 @@
+/**
+ * @file searchIndexBenchmark.cpp
+ * @brief Cost of finding the products with a name, by scanning the products file and through the search index.
+ *
+ * The scan is the KMP search that enterSearchProducts() falls back to without an index: every record is read
+ * and matched. The index is queried for the exact name and for a substring of it, which reads the whole term
+ * dictionary. The catalog has 1000 product names, so every query finds one product in 1000.
+ */
+
+#include "../header/benchmark.h"
+#include "searchIndex.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** @brief Products file written for the benchmark. */
+#define SEARCH_BENCHMARK_PRODUCTS "search_benchmark_products.bin"
+/** @brief Index file written for the benchmark. */
+#define SEARCH_BENCHMARK_INDEX "search_benchmark.inv"
+/** @brief Distinct product names of the catalog. */
+#define SEARCH_BENCHMARK_NAMES 1000
+
+using Coruh::Benchmark::Stopwatch;
+
+namespace
+{
+    /** @brief Writes a catalog of fiCount products over SEARCH_BENCHMARK_NAMES names. */
+    bool writeCatalog(int fiCount)
+    {
+        FILE* file = fopen(SEARCH_BENCHMARK_PRODUCTS, "wb");
+        if (file == NULL) {return false;}
+        Product product;
+        memset(&product, 0, sizeof(product));
+        strcpy(product.season, "Summer");
+        for (int i = 0; i < fiCount; i++) {
+            snprintf(product.productName, sizeof(product.productName), "Product%04d", i % SEARCH_BENCHMARK_NAMES);
+            product.vendorId = i % 97;
+            product.price = (float)(i % 500);
+            fwrite(&product, sizeof(Product), 1, file);
+        }
+        return fclose(file) == 0;
+    }
+
+    /** @brief Counts the products whose name contains fiText by scanning the file with a compiled KMP pattern. */
+    int scanCatalog(const char* fiText)
+    {
+        FILE* file = fopen(SEARCH_BENCHMARK_PRODUCTS, "rb");
+        if (file == NULL) {return -1;}
+        KMPPattern pattern;
+        if (!compileKMPPattern(fiText, &pattern)) {
+            fclose(file);
+            return -1;
+        }
+        int count = 0;
+        Product product;
+        while (fread(&product, sizeof(Product), 1, file) == 1) {
+            if (findKMPPattern(&pattern, product.productName, (int)strnlen(product.productName, sizeof(product.productName))) >= 0) {count++;}
+        }
+        freeKMPPattern(&pattern);
+        fclose(file);
+        return count;
+    }
+
+    /** @brief Counts the products found by one index query. */
+    int queryCatalog(const char* fiText, SearchTermMatch fiMatch)
+    {
+        const SearchField nameField[1] = {SEARCH_FIELD_PRODUCT_NAME};
+        const char* terms[1] = {fiText};
+        uint32_t* records = NULL;
+        int count = querySearchIndex(SEARCH_BENCHMARK_INDEX, nameField, 1, terms, 1, fiMatch, true, &records);
+        free(records);
+        return count;
+    }
+}
+
+void Coruh::Benchmark::runSearchIndexBenchmark()
+{
+    printf("%10s %10s %14s %14s %14s %12s\n", "products", "results", "scan us/q", "exact us/q", "substr us/q", "index bytes");
+
+    const int sizes[] = {1000, 10000, 100000, 1000000};
+    for (int s = 0; s < 4; s++) {
+        int count = sizes[s];
+        if (!writeCatalog(count) || !buildSearchIndex(SEARCH_BENCHMARK_INDEX, SEARCH_BENCHMARK_PRODUCTS, "search_benchmark_vendors.bin")) {
+            printf("%10d  skipped: cannot write the catalog\n", count);
+            continue;
+        }
+        FILE* index = fopen(SEARCH_BENCHMARK_INDEX, "rb");
+        long indexBytes = index != NULL && fseek(index, 0, SEEK_END) == 0 ? ftell(index) : -1;
+        if (index != NULL) {fclose(index);}
+
+        int queries = count >= 100000 ? 10 : 100;
+        int scanned = 0;
+        Stopwatch scanWatch;
+        for (int q = 0; q < queries; q++) {scanned = scanCatalog("Product0421");}
+        double scan = scanWatch.elapsedSeconds() * 1e6 / queries;
+
+        int exactFound = 0;
+        Stopwatch exactWatch;
+        for (int q = 0; q < queries * 10; q++) {exactFound = queryCatalog("Product0421", SEARCH_TERM_EXACT);}
+        double exact = exactWatch.elapsedSeconds() * 1e6 / (queries * 10);
+
+        int substringFound = 0;
+        Stopwatch substringWatch;
+        for (int q = 0; q < queries; q++) {substringFound = queryCatalog("ct0421", SEARCH_TERM_SUBSTRING);}
+        double substring = substringWatch.elapsedSeconds() * 1e6 / queries;
+
+        printf("%10d %10d %14.1f %14.1f %14.1f %12ld%s\n", count, exactFound, scan, exact, substring, indexBytes,
+               scanned == exactFound && exactFound == substringFound ? "" : "  MISMATCH");
+    }
+    remove(SEARCH_BENCHMARK_PRODUCTS);
+    remove(SEARCH_BENCHMARK_INDEX);
+}
@@ -0,0 +1,25 @@
+/**
+ * @file atomicFile.h
+ * @brief Replaces a data file with new contents so that readers see either the old or the new file.
+ *
+ * The contents are written to "<path>.tmp", flushed to disk and renamed over path. A crash or an I/O error
+ * leaves path as it was; the rename happens only after every byte of the new file reached the disk.
+ */
+
+#ifndef ATOMIC_FILE_H
+#define ATOMIC_FILE_H
+
+#include <stdio.h>
+
+/**
+ * @brief Writes the contents of a replacement file.
+ *
+ * @param file The temporary file, open for binary writing.
+ * @param context The context passed to replaceFileAtomically().
+ * @return true if every write succeeded.
+ */
+typedef bool (*AtomicFileWriter)(FILE* file, const void* context);
+
+bool replaceFileAtomically(const char* path, AtomicFileWriter writer, const void* context);
+
+#endif // ATOMIC_FILE_H
@@ -0,0 +1,921 @@
+/**
+ * @file bPlusTree.h
+ * @brief Templated in-memory B+ tree with node fan-out derived from a target node size.
+ *
+ * The legacy BPlusTreeNode in market.h is fixed at MAX_KEYS = 3 keys per node, which makes the tree
+ * far too tall for real catalogs. This tree sizes its nodes from a byte budget (for example one cache line,
+ * 256 bytes or a 4 KiB page), stores values next to the keys in the leaves, splits internal nodes properly
+ * and grows at the root, so its height stays logarithmic in the fan-out. Erasing keeps every node except the
+ * root at least half full by borrowing from or merging with a sibling.
+ */
+
+#ifndef BPLUS_TREE_H
+#define BPLUS_TREE_H
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace Coruh
+{
+    namespace Market
+    {
+        /**
+            @struct BPlusTreeKeySearch
+            @brief Locates keys inside one sorted node.
+
+            The generic version is a binary search using only operator<. Key types with a faster
+            search (for example plain integers) can specialize this struct.
+        */
+        template <typename Key>
+        struct BPlusTreeKeySearch
+        {
+            /**
+             * @brief Returns the index of the first key that is not less than fiKey.
+             *
+             * @param fiKeys Sorted keys of the node.
+             * @param fiCount Number of keys.
+             * @param fiKey The key to locate.
+             * @return Index in [0, fiCount].
+             */
+            static int lowerBound(const Key* fiKeys, int fiCount, const Key& fiKey)
+            {
+                int low = 0;
+                int high = fiCount;
+                while (low < high) {
+                    int mid = (low + high) / 2;
+                    if (fiKeys[mid] < fiKey) {low = mid + 1;}
+                    else {high = mid;}
+                }
+                return low;
+            }
+
+            /**
+             * @brief Returns the index of the first key that is greater than fiKey.
+             *
+             * @param fiKeys Sorted keys of the node.
+             * @param fiCount Number of keys.
+             * @param fiKey The key to locate.
+             * @return Index in [0, fiCount].
+             */
+            static int upperBound(const Key* fiKeys, int fiCount, const Key& fiKey)
+            {
+                int low = 0;
+                int high = fiCount;
+                while (low < high) {
+                    int mid = (low + high) / 2;
+                    if (fiKey < fiKeys[mid]) {high = mid;}
+                    else {low = mid + 1;}
+                }
+                return low;
+            }
+        };
+
+        /**
+            @struct BPlusTreeIntSearch
+            @brief Vectorized key search for nodes with int keys.
+
+            Wide nodes are first narrowed by binary search to a window of four vector blocks. The window is then
+            searched by comparing a broadcast copy of the key against 8 (AVX2) or 4 (SSE2) keys at once; the
+            population count of each comparison mask is the number of keys on the searched side, so the last
+            levels of the search have no data-dependent branches. Every variant is exposed so tests and benchmarks
+            can compare them; lowerBound()/upperBound() use the fastest one the running CPU supports.
+        */
+        struct BPlusTreeIntSearch
+        {
+            /** @brief Signature shared by all search variants. */
+            typedef int (*SearchFunction)(const int* fiKeys, int fiCount, int fiKey);
+
+            /** @brief Scalar binary search: index of the first key not less than fiKey. */
+            static int lowerBoundScalar(const int* fiKeys, int fiCount, int fiKey);
+            /** @brief Scalar binary search: index of the first key greater than fiKey. */
+            static int upperBoundScalar(const int* fiKeys, int fiCount, int fiKey);
+            /** @brief SSE2 lower bound; falls back to the scalar version on non-x86 targets. */
+            static int lowerBoundSse2(const int* fiKeys, int fiCount, int fiKey);
+            /** @brief SSE2 upper bound; falls back to the scalar version on non-x86 targets. */
+            static int upperBoundSse2(const int* fiKeys, int fiCount, int fiKey);
+            /** @brief AVX2 lower bound; must only be called if CpuFeatures::hasAvx2() is true. */
+            static int lowerBoundAvx2(const int* fiKeys, int fiCount, int fiKey);
+            /** @brief AVX2 upper bound; must only be called if CpuFeatures::hasAvx2() is true. */
+            static int upperBoundAvx2(const int* fiKeys, int fiCount, int fiKey);
+
+            /** @brief Name of the variant selected at run time ("avx2", "sse2" or "scalar"). */
+            static const char* implementationName();
+
+            /**
+             * @brief Returns the index of the first key that is not less than fiKey, using the selected variant.
+             */
+            static int lowerBound(const int* fiKeys, int fiCount, int fiKey) { return lowerBoundFunction()(fiKeys, fiCount, fiKey); }
+
+            /**
+             * @brief Returns the index of the first key that is greater than fiKey, using the selected variant.
+             */
+            static int upperBound(const int* fiKeys, int fiCount, int fiKey) { return upperBoundFunction()(fiKeys, fiCount, fiKey); }
+
+        private:
+            static SearchFunction lowerBoundFunction();
+            static SearchFunction upperBoundFunction();
+        };
+
+        /**
+            @brief Int keys use the vectorized search.
+        */
+        template <>
+        struct BPlusTreeKeySearch<int>
+        {
+            static int lowerBound(const int* fiKeys, int fiCount, const int& fiKey) { return BPlusTreeIntSearch::lowerBound(fiKeys, fiCount, fiKey); }
+            static int upperBound(const int* fiKeys, int fiCount, const int& fiKey) { return BPlusTreeIntSearch::upperBound(fiKeys, fiCount, fiKey); }
+        };
+
+        /**
+            @struct BPlusTreeLayout
+            @brief Derives node capacities of a BPlusTree from its target node size.
+
+            Both node kinds start with a small header (leaf flag, key count and one pointer: the next leaf
+            link or the extra child pointer); the rest of the byte budget is divided into key/value entries
+            in leaves and key/child entries in internal nodes. Capacities never drop below 3.
+        */
+        template <typename Key, typename Value, std::size_t NodeBytes>
+        struct BPlusTreeLayout
+        {
+            /** @brief Bytes taken by the node header. */
+            static constexpr std::size_t headerBytes = sizeof(bool) + sizeof(int) + sizeof(void*);
+            /** @brief Bytes left for entries once the header is accounted for. */
+            static constexpr std::size_t payloadBytes = NodeBytes > headerBytes ? NodeBytes - headerBytes : 0;
+            /** @brief Number of key/value pairs that fit into one leaf. */
+            static constexpr int leafCapacity = payloadBytes / (sizeof(Key) + sizeof(Value)) >= 3
+                                                ? (int)(payloadBytes / (sizeof(Key) + sizeof(Value))) : 3;
+            /** @brief Number of separator keys that fit into one internal node. */
+            static constexpr int internalCapacity = payloadBytes / (sizeof(Key) + sizeof(void*)) >= 3
+                                                    ? (int)(payloadBytes / (sizeof(Key) + sizeof(void*))) : 3;
+        };
+
+        template <typename Key, typename Value, std::size_t NodeBytes>
+        constexpr int BPlusTreeLayout<Key, Value, NodeBytes>::leafCapacity;
+
+        template <typename Key, typename Value, std::size_t NodeBytes>
+        constexpr int BPlusTreeLayout<Key, Value, NodeBytes>::internalCapacity;
+
+        /**
+            @class BPlusTree
+            @brief B+ tree mapping unique keys to values.
+
+            Keys and values should be trivially copyable; they are stored by value inside fixed-size nodes.
+            Internal nodes hold separator keys where keys[i] is the smallest key reachable through children[i + 1].
+            Leaves are linked through next in key order.
+
+            @tparam Key Key type, ordered by operator<.
+            @tparam Value Value type stored in the leaves.
+            @tparam NodeBytes Target size of one node in bytes (e.g. 64, 256 or 4096).
+        */
+        template <typename Key, typename Value, std::size_t NodeBytes = 256>
+        class BPlusTree
+        {
+        public:
+            /** @brief Common header of leaf and internal nodes. */
+            struct Node
+            {
+                bool isLeaf;        ///< Indicates if the node is a leaf.
+                int keyCount;       ///< Number of keys in the node.
+            };
+
+            /**
+             * @brief Returns the number of key/value pairs that fit into one leaf.
+             * @return Leaf capacity, never below 3.
+             */
+            static constexpr int leafCapacity() { return BPlusTreeLayout<Key, Value, NodeBytes>::leafCapacity; }
+
+            /**
+             * @brief Returns the number of separator keys that fit into one internal node.
+             * @return Internal node capacity, never below 3.
+             */
+            static constexpr int internalCapacity() { return BPlusTreeLayout<Key, Value, NodeBytes>::internalCapacity; }
+
+            /** @brief Leaf node: sorted keys with their values and a link to the next leaf. */
+            struct LeafNode : Node
+            {
+                LeafNode* next;                     ///< Next leaf in key order, or nullptr.
+                Key keys[BPlusTreeLayout<Key, Value, NodeBytes>::leafCapacity];           ///< Sorted keys.
+                Value values[BPlusTreeLayout<Key, Value, NodeBytes>::leafCapacity];       ///< Values, parallel to keys.
+            };
+
+            /**
+                @class Iterator
+                @brief Forward iterator over the key/value pairs in ascending key order.
+
+                The iterator walks the linked leaves, so advancing it is O(1) and a range scan of k keys
+                costs one root-to-leaf descent plus k steps. Modifying the tree invalidates all iterators.
+            */
+            class Iterator
+            {
+            public:
+                /** @brief Creates an iterator positioned at entry fiIndex of fiLeaf (nullptr means end). */
+                Iterator(const LeafNode* fiLeaf = nullptr, int fiIndex = 0) : leaf(fiLeaf), index(fiIndex) { skipExhaustedLeaf(); }
+
+                /** @brief Returns true while the iterator points at an entry. */
+                bool valid() const { return leaf != nullptr; }
+
+                /** @brief Returns the key of the current entry; the iterator must be valid. */
+                const Key& key() const { return leaf->keys[index]; }
+
+                /** @brief Returns the value of the current entry; the iterator must be valid. */
+                const Value& value() const { return leaf->values[index]; }
+
+                /** @brief Advances to the next entry in key order. */
+                Iterator& operator++()
+                {
+                    index++;
+                    skipExhaustedLeaf();
+                    return *this;
+                }
+
+                bool operator==(const Iterator& fiOther) const { return leaf == fiOther.leaf && index == fiOther.index; }
+                bool operator!=(const Iterator& fiOther) const { return !(*this == fiOther); }
+
+            private:
+                const LeafNode* leaf;   ///< Current leaf, nullptr at the end.
+                int index;              ///< Entry index inside the current leaf.
+
+                /** @brief Moves past the end of the current leaf to the first entry of the next non-empty leaf. */
+                void skipExhaustedLeaf()
+                {
+                    while (leaf != nullptr && index >= leaf->keyCount) {
+                        leaf = leaf->next;
+                        index = 0;
+                    }
+                    if (leaf == nullptr) {index = 0;}
+                }
+            };
+
+            /** @brief Internal node: separator keys and child pointers. */
+            struct InternalNode : Node
+            {
+                Key keys[BPlusTreeLayout<Key, Value, NodeBytes>::internalCapacity];              ///< Sorted separator keys.
+                Node* children[BPlusTreeLayout<Key, Value, NodeBytes>::internalCapacity + 1];    ///< Child pointers, one more than keys.
+            };
+
+            /** @brief Creates an empty tree. */
+            BPlusTree() : root(nullptr), keyCount(0), treeHeight(0) {}
+
+            /** @brief Frees every node of the tree. */
+            ~BPlusTree() { clear(); }
+
+            BPlusTree(const BPlusTree&) = delete;
+            BPlusTree& operator=(const BPlusTree&) = delete;
+
+            /** @brief Removes all keys and frees every node. */
+            void clear()
+            {
+                destroy(root);
+                root = nullptr;
+                keyCount = 0;
+                treeHeight = 0;
+            }
+
+            /** @brief Returns the number of stored keys. */
+            std::size_t size() const { return keyCount; }
+
+            /** @brief Returns true if the tree holds no keys. */
+            bool empty() const { return keyCount == 0; }
+
+            /** @brief Returns the number of levels (0 for an empty tree, 1 for a single leaf). */
+            int height() const { return treeHeight; }
+
+            /**
+             * @brief Inserts a key or replaces the value of an existing key.
+             *
+             * @param fiKey The key to insert.
+             * @param fiValue The value to associate with the key.
+             * @return true if the key was new, false if an existing value was replaced.
+             */
+            bool insert(const Key& fiKey, const Value& fiValue)
+            {
+                if (root == nullptr) {
+                    root = newLeaf();
+                    treeHeight = 1;
+                }
+
+                Key separator;
+                Node* sibling = nullptr;
+                bool inserted = insertInto(root, fiKey, fiValue, &separator, &sibling);
+
+                if (sibling != nullptr) {
+                    // The root split: grow the tree by one level
+                    InternalNode* newRoot = newInternal();
+                    newRoot->keys[0] = separator;
+                    newRoot->children[0] = root;
+                    newRoot->children[1] = sibling;
+                    newRoot->keyCount = 1;
+                    root = newRoot;
+                    treeHeight++;
+                }
+
+                if (inserted) {keyCount++;}
+                return inserted;
+            }
+
+            /**
+             * @brief Looks up a key.
+             *
+             * @param fiKey The key to look up.
+             * @param foValue Output for the associated value; may be nullptr.
+             * @return true if the key is present, false otherwise.
+             */
+            bool find(const Key& fiKey, Value* foValue) const
+            {
+                const LeafNode* leaf = findLeaf(fiKey);
+                if (leaf == nullptr) {return false;}
+                int index = BPlusTreeKeySearch<Key>::lowerBound(leaf->keys, leaf->keyCount, fiKey);
+                if (index == leaf->keyCount || fiKey < leaf->keys[index]) {return false;}
+                if (foValue != nullptr) {*foValue = leaf->values[index];}
+                return true;
+            }
+
+            /**
+             * @brief Returns true if the key is present.
+             * @param fiKey The key to look up.
+             */
+            bool contains(const Key& fiKey) const { return find(fiKey, nullptr); }
+
+            /**
+             * @brief Removes a key.
+             *
+             * A node that drops below minimum occupancy borrows one entry from an adjacent sibling, or is merged
+             * with it when the sibling is at the minimum itself; merges can cascade up to the root, which is
+             * removed when it is left with a single child. Separator keys are not rewritten on erase: they remain
+             * valid bounds even after the key they were copied from is gone.
+             *
+             * @param fiKey The key to remove.
+             * @return true if the key was present, false otherwise.
+             */
+            bool erase(const Key& fiKey)
+            {
+                if (root == nullptr || !eraseFrom(root, fiKey)) {return false;}
+                keyCount--;
+
+                if (root->keyCount == 0) {
+                    Node* oldRoot = root;
+                    if (root->isLeaf) {
+                        root = nullptr;
+                        treeHeight = 0;
+                        delete static_cast<LeafNode*>(oldRoot);
+                    }
+                    else {
+                        root = static_cast<InternalNode*>(oldRoot)->children[0];
+                        treeHeight--;
+                        delete static_cast<InternalNode*>(oldRoot);
+                    }
+                }
+                return true;
+            }
+
+            /**
+             * @brief Verifies the structure of the whole tree.
+             *
+             * Checks that keys are strictly ascending and within their separator bounds, that every leaf is at the
+             * same depth, that non-root nodes respect minimum occupancy, and that the leaf chain visits exactly
+             * size() keys in order. Runs in O(n); intended for tests and debugging.
+             *
+             * @return true if every invariant holds, false otherwise.
+             */
+            bool checkInvariants() const
+            {
+                if (root == nullptr) {return keyCount == 0 && treeHeight == 0;}
+
+                const LeafNode* firstLeaf = nullptr;
+                if (!checkNode(root, 1, nullptr, nullptr, &firstLeaf)) {return false;}
+
+                std::size_t chained = 0;
+                const Key* previous = nullptr;
+                for (const LeafNode* leaf = firstLeaf; leaf != nullptr; leaf = leaf->next) {
+                    for (int i = 0; i < leaf->keyCount; i++) {
+                        if (previous != nullptr && !(*previous < leaf->keys[i])) {return false;}
+                        previous = &leaf->keys[i];
+                        chained++;
+                    }
+                }
+                return chained == keyCount;
+            }
+
+            /** @brief Returns an iterator to the smallest key. */
+            Iterator begin() const
+            {
+                const Node* node = root;
+                if (node == nullptr) {return end();}
+                while (!node->isLeaf) {
+                    node = static_cast<const InternalNode*>(node)->children[0];
+                }
+                return Iterator(static_cast<const LeafNode*>(node), 0);
+            }
+
+            /** @brief Returns the past-the-end iterator. */
+            Iterator end() const { return Iterator(); }
+
+            /**
+             * @brief Returns an iterator to the first key that is not less than fiKey.
+             *
+             * @param fiKey The lower bound of the range (inclusive).
+             * @return Iterator to the first key >= fiKey, or end().
+             */
+            Iterator lowerBound(const Key& fiKey) const
+            {
+                const LeafNode* leaf = findLeaf(fiKey);
+                if (leaf == nullptr) {return end();}
+                return Iterator(leaf, BPlusTreeKeySearch<Key>::lowerBound(leaf->keys, leaf->keyCount, fiKey));
+            }
+
+            /**
+             * @brief Returns an iterator to the first key that is greater than fiKey.
+             *
+             * @param fiKey The upper bound of the range (inclusive).
+             * @return Iterator to the first key > fiKey, or end().
+             */
+            Iterator upperBound(const Key& fiKey) const
+            {
+                const LeafNode* leaf = findLeaf(fiKey);
+                if (leaf == nullptr) {return end();}
+                return Iterator(leaf, BPlusTreeKeySearch<Key>::upperBound(leaf->keys, leaf->keyCount, fiKey));
+            }
+
+            /**
+             * @brief Replaces the contents of the tree with sorted key/value pairs, building it bottom-up.
+             *
+             * Leaves are filled to capacity and linked in order, then each internal level is built over the
+             * level below it, so loading n keys costs O(n) instead of one root-to-leaf descent per key.
+             * When the last node of a level would be less than half full it shares entries with its left
+             * neighbour so that every node keeps the minimum occupancy.
+             *
+             * @param fiKeys Keys in strictly ascending order.
+             * @param fiValues Values, parallel to fiKeys.
+             * @param fiCount Number of pairs.
+             * @return true on success, false if the keys are not strictly ascending (the tree is left unchanged).
+             */
+            bool bulkLoad(const Key* fiKeys, const Value* fiValues, std::size_t fiCount)
+            {
+                for (std::size_t i = 1; i < fiCount; i++) {
+                    if (!(fiKeys[i - 1] < fiKeys[i])) {return false;}
+                }
+
+                clear();
+                if (fiCount == 0) {return true;}
+
+                std::vector<Node*> level;
+                std::vector<Key> lowestKeys;
+                std::vector<std::size_t> sizes = distribute(fiCount, leafCapacity());
+                LeafNode* previous = nullptr;
+                std::size_t position = 0;
+                for (std::size_t i = 0; i < sizes.size(); i++) {
+                    LeafNode* leaf = newLeaf();
+                    for (std::size_t j = 0; j < sizes[i]; j++, position++) {
+                        leaf->keys[j] = fiKeys[position];
+                        leaf->values[j] = fiValues[position];
+                    }
+                    leaf->keyCount = (int)sizes[i];
+                    if (previous != nullptr) {previous->next = leaf;}
+                    previous = leaf;
+                    level.push_back(leaf);
+                    lowestKeys.push_back(leaf->keys[0]);
+                }
+                treeHeight = 1;
+
+                while (level.size() > 1) {
+                    std::vector<Node*> parents;
+                    std::vector<Key> parentLowestKeys;
+                    sizes = distribute(level.size(), internalCapacity() + 1);
+                    position = 0;
+                    for (std::size_t i = 0; i < sizes.size(); i++) {
+                        InternalNode* parent = newInternal();
+                        parentLowestKeys.push_back(lowestKeys[position]);
+                        for (std::size_t j = 0; j < sizes[i]; j++, position++) {
+                            parent->children[j] = level[position];
+                            if (j > 0) {parent->keys[j - 1] = lowestKeys[position];}
+                        }
+                        parent->keyCount = (int)sizes[i] - 1;
+                        parents.push_back(parent);
+                    }
+                    level.swap(parents);
+                    lowestKeys.swap(parentLowestKeys);
+                    treeHeight++;
+                }
+
+                root = level[0];
+                keyCount = fiCount;
+                return true;
+            }
+
+        private:
+            Node* root;                 ///< Root node, nullptr for an empty tree.
+            std::size_t keyCount;       ///< Number of stored keys.
+            int treeHeight;             ///< Number of levels.
+
+            /**
+             * @brief Splits fiCount entries into nodes of at most fiCapacity entries for bulk loading.
+             *
+             * All nodes are full except that a short last node is balanced with its left neighbour.
+             */
+            static std::vector<std::size_t> distribute(std::size_t fiCount, int fiCapacity)
+            {
+                std::size_t capacity = (std::size_t)fiCapacity;
+                std::size_t nodeCount = (fiCount + capacity - 1) / capacity;
+                std::vector<std::size_t> sizes(nodeCount, capacity);
+                std::size_t last = fiCount - (nodeCount - 1) * capacity;
+                sizes[nodeCount - 1] = last;
+                if (nodeCount > 1 && last < (capacity + 1) / 2) {
+                    std::size_t shared = capacity + last;
+                    sizes[nodeCount - 2] = shared - shared / 2;
+                    sizes[nodeCount - 1] = shared / 2;
+                }
+                return sizes;
+            }
+
+            /** @brief Fewest keys a non-root leaf may hold; a split of a full leaf leaves at least this many. */
+            static constexpr int minLeafKeys() { return (leafCapacity() + 1) / 2; }
+
+            /** @brief Fewest keys a non-root internal node may hold; a split of a full node leaves at least this many. */
+            static constexpr int minInternalKeys() { return internalCapacity() / 2; }
+
+            static int minKeys(const Node* fiNode) { return fiNode->isLeaf ? minLeafKeys() : minInternalKeys(); }
+
+            static LeafNode* newLeaf()
+            {
+                LeafNode* leaf = new LeafNode;
+                leaf->isLeaf = true;
+                leaf->keyCount = 0;
+                leaf->next = nullptr;
+                return leaf;
+            }
+
+            static InternalNode* newInternal()
+            {
+                InternalNode* node = new InternalNode;
+                node->isLeaf = false;
+                node->keyCount = 0;
+                return node;
+            }
+
+            static void destroy(Node* fiNode)
+            {
+                if (fiNode == nullptr) {return;}
+                if (fiNode->isLeaf) {
+                    delete static_cast<LeafNode*>(fiNode);
+                    return;
+                }
+                InternalNode* internal = static_cast<InternalNode*>(fiNode);
+                for (int i = 0; i <= internal->keyCount; i++) {
+                    destroy(internal->children[i]);
+                }
+                delete internal;
+            }
+
+            /**
+             * @brief Descends from the root to the leaf that may contain fiKey.
+             */
+            const LeafNode* findLeaf(const Key& fiKey) const
+            {
+                const Node* node = root;
+                if (node == nullptr) {return nullptr;}
+                while (!node->isLeaf) {
+                    const InternalNode* internal = static_cast<const InternalNode*>(node);
+                    node = internal->children[BPlusTreeKeySearch<Key>::upperBound(internal->keys, internal->keyCount, fiKey)];
+                }
+                return static_cast<const LeafNode*>(node);
+            }
+
+            /**
+             * @brief Inserts into the subtree rooted at fiNode.
+             *
+             * If fiNode has to split, its new right sibling and the separator key for the parent are returned
+             * through foSibling and foSeparator.
+             *
+             * @return true if the key was new, false if an existing value was replaced.
+             */
+            bool insertInto(Node* fiNode, const Key& fiKey, const Value& fiValue, Key* foSeparator, Node** foSibling)
+            {
+                if (fiNode->isLeaf) {
+                    return insertIntoLeaf(static_cast<LeafNode*>(fiNode), fiKey, fiValue, foSeparator, foSibling);
+                }
+
+                InternalNode* internal = static_cast<InternalNode*>(fiNode);
+                int childIndex = BPlusTreeKeySearch<Key>::upperBound(internal->keys, internal->keyCount, fiKey);
+                Key childSeparator;
+                Node* childSibling = nullptr;
+                bool inserted = insertInto(internal->children[childIndex], fiKey, fiValue, &childSeparator, &childSibling);
+                if (childSibling != nullptr) {
+                    insertIntoInternal(internal, childIndex, childSeparator, childSibling, foSeparator, foSibling);
+                }
+                return inserted;
+            }
+
+            /**
+             * @brief Removes fiKey from the subtree rooted at fiNode and rebalances the child it descended into.
+             *
+             * @return true if the key was found and removed.
+             */
+            bool eraseFrom(Node* fiNode, const Key& fiKey)
+            {
+                if (fiNode->isLeaf) {
+                    LeafNode* leaf = static_cast<LeafNode*>(fiNode);
+                    int position = BPlusTreeKeySearch<Key>::lowerBound(leaf->keys, leaf->keyCount, fiKey);
+                    if (position == leaf->keyCount || fiKey < leaf->keys[position]) {return false;}
+                    for (int i = position + 1; i < leaf->keyCount; i++) {
+                        leaf->keys[i - 1] = leaf->keys[i];
+                        leaf->values[i - 1] = leaf->values[i];
+                    }
+                    leaf->keyCount--;
+                    return true;
+                }
+
+                InternalNode* internal = static_cast<InternalNode*>(fiNode);
+                int childIndex = BPlusTreeKeySearch<Key>::upperBound(internal->keys, internal->keyCount, fiKey);
+                Node* child = internal->children[childIndex];
+                if (!eraseFrom(child, fiKey)) {return false;}
+                if (child->keyCount < minKeys(child)) {rebalanceChild(internal, childIndex);}
+                return true;
+            }
+
+            /**
+             * @brief Restores minimum occupancy of fiParent->children[fiChildIndex] after an erase.
+             *
+             * Borrowing is tried first (left sibling, then right); otherwise the child is merged with a sibling,
+             * which removes one separator from fiParent.
+             */
+            void rebalanceChild(InternalNode* fiParent, int fiChildIndex)
+            {
+                Node* child = fiParent->children[fiChildIndex];
+                Node* left = fiChildIndex > 0 ? fiParent->children[fiChildIndex - 1] : nullptr;
+                Node* right = fiChildIndex < fiParent->keyCount ? fiParent->children[fiChildIndex + 1] : nullptr;
+
+                if (left != nullptr && left->keyCount > minKeys(left)) {
+                    borrowFromLeft(fiParent, fiChildIndex);
+                }
+                else if (right != nullptr && right->keyCount > minKeys(right)) {
+                    borrowFromRight(fiParent, fiChildIndex);
+                }
+                else if (left != nullptr) {
+                    mergeChildren(fiParent, fiChildIndex - 1);
+                    child = left;
+                }
+                else {
+                    mergeChildren(fiParent, fiChildIndex);
+                }
+                assert(child->keyCount >= minKeys(child) && "B+ tree node below minimum occupancy after rebalance");
+                (void)child;
+            }
+
+            /** @brief Moves the last entry of the left sibling into the child at fiChildIndex. */
+            static void borrowFromLeft(InternalNode* fiParent, int fiChildIndex)
+            {
+                Node* child = fiParent->children[fiChildIndex];
+                Node* left = fiParent->children[fiChildIndex - 1];
+
+                if (child->isLeaf) {
+                    LeafNode* leaf = static_cast<LeafNode*>(child);
+                    LeafNode* sibling = static_cast<LeafNode*>(left);
+                    for (int i = leaf->keyCount; i > 0; i--) {
+                        leaf->keys[i] = leaf->keys[i - 1];
+                        leaf->values[i] = leaf->values[i - 1];
+                    }
+                    leaf->keys[0] = sibling->keys[sibling->keyCount - 1];
+                    leaf->values[0] = sibling->values[sibling->keyCount - 1];
+                    leaf->keyCount++;
+                    sibling->keyCount--;
+                    fiParent->keys[fiChildIndex - 1] = leaf->keys[0];
+                    return;
+                }
+
+                // Rotate through the parent: the separator comes down, the sibling's last key goes up
+                InternalNode* node = static_cast<InternalNode*>(child);
+                InternalNode* sibling = static_cast<InternalNode*>(left);
+                node->children[node->keyCount + 1] = node->children[node->keyCount];
+                for (int i = node->keyCount; i > 0; i--) {
+                    node->keys[i] = node->keys[i - 1];
+                    node->children[i] = node->children[i - 1];
+                }
+                node->keys[0] = fiParent->keys[fiChildIndex - 1];
+                node->children[0] = sibling->children[sibling->keyCount];
+                node->keyCount++;
+                fiParent->keys[fiChildIndex - 1] = sibling->keys[sibling->keyCount - 1];
+                sibling->keyCount--;
+            }
+
+            /** @brief Moves the first entry of the right sibling into the child at fiChildIndex. */
+            static void borrowFromRight(InternalNode* fiParent, int fiChildIndex)
+            {
+                Node* child = fiParent->children[fiChildIndex];
+                Node* right = fiParent->children[fiChildIndex + 1];
+
+                if (child->isLeaf) {
+                    LeafNode* leaf = static_cast<LeafNode*>(child);
+                    LeafNode* sibling = static_cast<LeafNode*>(right);
+                    leaf->keys[leaf->keyCount] = sibling->keys[0];
+                    leaf->values[leaf->keyCount] = sibling->values[0];
+                    leaf->keyCount++;
+                    for (int i = 1; i < sibling->keyCount; i++) {
+                        sibling->keys[i - 1] = sibling->keys[i];
+                        sibling->values[i - 1] = sibling->values[i];
+                    }
+                    sibling->keyCount--;
+                    fiParent->keys[fiChildIndex] = sibling->keys[0];
+                    return;
+                }
+
+                InternalNode* node = static_cast<InternalNode*>(child);
+                InternalNode* sibling = static_cast<InternalNode*>(right);
+                node->keys[node->keyCount] = fiParent->keys[fiChildIndex];
+                node->children[node->keyCount + 1] = sibling->children[0];
+                node->keyCount++;
+                fiParent->keys[fiChildIndex] = sibling->keys[0];
+                for (int i = 1; i < sibling->keyCount; i++) {
+                    sibling->keys[i - 1] = sibling->keys[i];
+                }
+                for (int i = 1; i <= sibling->keyCount; i++) {
+                    sibling->children[i - 1] = sibling->children[i];
+                }
+                sibling->keyCount--;
+            }
+
+            /**
+             * @brief Merges children[fiLeftIndex + 1] into children[fiLeftIndex] and drops their separator from fiParent.
+             *
+             * Leaves are concatenated and the right leaf is unlinked from the leaf chain; internal nodes also pull
+             * the separator down between the two key runs.
+             */
+            static void mergeChildren(InternalNode* fiParent, int fiLeftIndex)
+            {
+                Node* left = fiParent->children[fiLeftIndex];
+                Node* right = fiParent->children[fiLeftIndex + 1];
+
+                if (left->isLeaf) {
+                    LeafNode* leftLeaf = static_cast<LeafNode*>(left);
+                    LeafNode* rightLeaf = static_cast<LeafNode*>(right);
+                    for (int i = 0; i < rightLeaf->keyCount; i++) {
+                        leftLeaf->keys[leftLeaf->keyCount + i] = rightLeaf->keys[i];
+                        leftLeaf->values[leftLeaf->keyCount + i] = rightLeaf->values[i];
+                    }
+                    leftLeaf->keyCount += rightLeaf->keyCount;
+                    leftLeaf->next = rightLeaf->next;
+                    delete rightLeaf;
+                }
+                else {
+                    InternalNode* leftNode = static_cast<InternalNode*>(left);
+                    InternalNode* rightNode = static_cast<InternalNode*>(right);
+                    leftNode->keys[leftNode->keyCount] = fiParent->keys[fiLeftIndex];
+                    for (int i = 0; i < rightNode->keyCount; i++) {
+                        leftNode->keys[leftNode->keyCount + 1 + i] = rightNode->keys[i];
+                    }
+                    for (int i = 0; i <= rightNode->keyCount; i++) {
+                        leftNode->children[leftNode->keyCount + 1 + i] = rightNode->children[i];
+                    }
+                    leftNode->keyCount += rightNode->keyCount + 1;
+                    delete rightNode;
+                }
+
+                for (int i = fiLeftIndex + 1; i < fiParent->keyCount; i++) {
+                    fiParent->keys[i - 1] = fiParent->keys[i];
+                    fiParent->children[i] = fiParent->children[i + 1];
+                }
+                fiParent->keyCount--;
+            }
+
+            /**
+             * @brief Recursively validates the subtree rooted at fiNode for checkInvariants().
+             *
+             * @param fiNode The subtree root.
+             * @param fiDepth Depth of fiNode, 1 for the root.
+             * @param fiLower Inclusive lower bound for keys in the subtree, or nullptr.
+             * @param fiUpper Exclusive upper bound for keys in the subtree, or nullptr.
+             * @param foFirstLeaf Receives the leftmost leaf the first time a leaf is visited.
+             */
+            bool checkNode(const Node* fiNode, int fiDepth, const Key* fiLower, const Key* fiUpper, const LeafNode** foFirstLeaf) const
+            {
+                bool isRoot = fiNode == root;
+                if (fiNode->keyCount > (fiNode->isLeaf ? leafCapacity() : internalCapacity())) {return false;}
+                if (fiNode->keyCount < (isRoot ? 1 : minKeys(fiNode))) {return false;}
+
+                const Key* keys = fiNode->isLeaf ? static_cast<const LeafNode*>(fiNode)->keys
+                                                 : static_cast<const InternalNode*>(fiNode)->keys;
+                for (int i = 0; i < fiNode->keyCount; i++) {
+                    if (i > 0 && !(keys[i - 1] < keys[i])) {return false;}
+                    if (fiLower != nullptr && keys[i] < *fiLower) {return false;}
+                    if (fiUpper != nullptr && !(keys[i] < *fiUpper)) {return false;}
+                }
+
+                if (fiNode->isLeaf) {
+                    if (fiDepth != treeHeight) {return false;}
+                    if (*foFirstLeaf == nullptr) {*foFirstLeaf = static_cast<const LeafNode*>(fiNode);}
+                    return true;
+                }
+
+                const InternalNode* internal = static_cast<const InternalNode*>(fiNode);
+                for (int i = 0; i <= internal->keyCount; i++) {
+                    const Key* lower = i == 0 ? fiLower : &internal->keys[i - 1];
+                    const Key* upper = i == internal->keyCount ? fiUpper : &internal->keys[i];
+                    if (!checkNode(internal->children[i], fiDepth + 1, lower, upper, foFirstLeaf)) {return false;}
+                }
+                return true;
+            }
+
+            bool insertIntoLeaf(LeafNode* fiLeaf, const Key& fiKey, const Value& fiValue, Key* foSeparator, Node** foSibling)
+            {
+                int position = BPlusTreeKeySearch<Key>::lowerBound(fiLeaf->keys, fiLeaf->keyCount, fiKey);
+                if (position < fiLeaf->keyCount && !(fiKey < fiLeaf->keys[position])) {
+                    fiLeaf->values[position] = fiValue;
+                    return false;
+                }
+
+                if (fiLeaf->keyCount < leafCapacity()) {
+                    for (int i = fiLeaf->keyCount; i > position; i--) {
+                        fiLeaf->keys[i] = fiLeaf->keys[i - 1];
+                        fiLeaf->values[i] = fiLeaf->values[i - 1];
+                    }
+                    fiLeaf->keys[position] = fiKey;
+                    fiLeaf->values[position] = fiValue;
+                    fiLeaf->keyCount++;
+                    return true;
+                }
+
+                // Full leaf: split into two halves, the new key goes to whichever half it belongs to
+                LeafNode* right = newLeaf();
+                int total = leafCapacity() + 1;
+                int leftCount = total / 2;
+                int source = leafCapacity() - 1;
+                for (int target = total - 1; target >= 0; target--) {
+                    Key key;
+                    Value value;
+                    if (target == position) {
+                        key = fiKey;
+                        value = fiValue;
+                    }
+                    else {
+                        key = fiLeaf->keys[source];
+                        value = fiLeaf->values[source];
+                        source--;
+                    }
+                    if (target >= leftCount) {
+                        right->keys[target - leftCount] = key;
+                        right->values[target - leftCount] = value;
+                    }
+                    else {
+                        fiLeaf->keys[target] = key;
+                        fiLeaf->values[target] = value;
+                    }
+                }
+                fiLeaf->keyCount = leftCount;
+                right->keyCount = total - leftCount;
+                right->next = fiLeaf->next;
+                fiLeaf->next = right;
+
+                *foSeparator = right->keys[0];
+                *foSibling = right;
+                return true;
+            }
+
+            void insertIntoInternal(InternalNode* fiNode, int fiChildIndex, const Key& fiSeparator, Node* fiChild,
+                                    Key* foSeparator, Node** foSibling)
+            {
+                if (fiNode->keyCount < internalCapacity()) {
+                    for (int i = fiNode->keyCount; i > fiChildIndex; i--) {
+                        fiNode->keys[i] = fiNode->keys[i - 1];
+                        fiNode->children[i + 1] = fiNode->children[i];
+                    }
+                    fiNode->keys[fiChildIndex] = fiSeparator;
+                    fiNode->children[fiChildIndex + 1] = fiChild;
+                    fiNode->keyCount++;
+                    return;
+                }
+
+                // Full internal node: lay out keyCount + 1 keys, push the middle key up to the parent
+                const int total = internalCapacity() + 1;
+                Key keys[internalCapacity() + 1];
+                Node* children[internalCapacity() + 2];
+                for (int i = 0, source = 0; i < total; i++) {
+                    keys[i] = i == fiChildIndex ? fiSeparator : fiNode->keys[source++];
+                }
+                for (int i = 0, source = 0; i < total + 1; i++) {
+                    children[i] = i == fiChildIndex + 1 ? fiChild : fiNode->children[source++];
+                }
+
+                int middle = total / 2;
+                InternalNode* right = newInternal();
+                fiNode->keyCount = middle;
+                for (int i = 0; i < middle; i++) {
+                    fiNode->keys[i] = keys[i];
+                    fiNode->children[i] = children[i];
+                }
+                fiNode->children[middle] = children[middle];
+
+                right->keyCount = total - middle - 1;
+                for (int i = 0; i < right->keyCount; i++) {
+                    right->keys[i] = keys[middle + 1 + i];
+                    right->children[i] = children[middle + 1 + i];
+                }
+                right->children[right->keyCount] = children[total];
+
+                *foSeparator = keys[middle];
+                *foSibling = right;
+            }
+        };
+    }
+}
+
+#endif // BPLUS_TREE_H
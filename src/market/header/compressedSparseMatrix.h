@@ -0,0 +1,138 @@
+/**
+ * @file compressedSparseMatrix.h
+ * @brief Compressed sparse row/column views of the vendor-product price matrix.
+ *
+ * The triplets in sparseMatrix are kept in insertion order, so answering "what does vendor V sell" or
+ * "who sells product P" scans every entry. A compressed matrix groups the entries by one coordinate
+ * (the major axis): the distinct major IDs are sorted, and entries of the same major ID are stored
+ * contiguously between two row pointers. Grouped by vendor it is the CSR layout, grouped by product the
+ * CSC layout; a row or column is found by binary search and read in O(log rows + row length).
+ *
+ * Relations are collected in a SparseMatrixBuilder, which grows as needed and resolves duplicate
+ * (vendor, product) pairs in one batch step before the compressed views are built.
+ *
+ * A compressed matrix can be saved as a binary file whose sections are laid out exactly like the arrays in
+ * memory, so the file is mapped and used in place without parsing.
+ */
+
+#ifndef COMPRESSED_SPARSE_MATRIX_H
+#define COMPRESSED_SPARSE_MATRIX_H
+
+#include "market.h"
+
+/**
+ * @enum SparseMatrixAxis
+ * @brief Coordinate that a compressed matrix groups its entries by.
+ */
+typedef enum {
+    SPARSE_BY_VENDOR,           ///< Rows are vendors, entries hold product IDs (CSR).
+    SPARSE_BY_PRODUCT           ///< Rows are products, entries hold vendor IDs (CSC).
+} SparseMatrixAxis;
+
+/**
+ * @struct CompressedSparseMatrix
+ * @brief Entries grouped by major ID; row i spans [rowPointers[i], rowPointers[i + 1]) of minorIds and prices.
+ */
+typedef struct {
+    SparseMatrixAxis axis;      ///< Coordinate used as major ID.
+    int rowCount;               ///< Number of distinct major IDs.
+    int entryCount;             ///< Number of stored entries.
+    int* rowIds;                ///< Sorted distinct major IDs, rowCount elements.
+    int* rowPointers;           ///< Start of each row in minorIds/prices, rowCount + 1 elements.
+    int* minorIds;              ///< Other coordinate of each entry, entryCount elements.
+    float* prices;              ///< Price of each entry, entryCount elements.
+} CompressedSparseMatrix;
+
+/** @brief Capacity of a builder that was initialised with a capacity of 0. */
+#define SPARSE_BUILDER_DEFAULT_CAPACITY 64
+
+/**
+ * @struct SparseMatrixBuilder
+ * @brief Growable triplet buffer; finalising sorts it by (vendor, product) and keeps the last price of each pair.
+ */
+typedef struct {
+    SparseMatrixEntry* entries;     ///< Triplets in insertion order, or sorted and unique once finalised.
+    int entryCount;                 ///< Number of triplets in use.
+    int capacity;                   ///< Number of allocated triplets.
+    bool finalized;                 ///< The triplets are sorted and free of duplicates.
+} SparseMatrixBuilder;
+
+/**
+ * @struct ProductPriceAggregate
+ * @brief Price statistics of one product over all vendors that sell it.
+ */
+typedef struct {
+    int productId;              ///< Product the statistics belong to.
+    int count;                  ///< Number of vendors selling the product.
+    float minPrice;             ///< Lowest price.
+    float maxPrice;             ///< Highest price.
+    float meanPrice;            ///< Average price.
+} ProductPriceAggregate;
+
+int aggregateProductPrices(const CompressedSparseMatrix* columns, ProductPriceAggregate foAggregates[], int maxCount);
+bool aggregateProductPrice(const CompressedSparseMatrix* columns, int productId, ProductPriceAggregate* foAggregate);
+
+/** @brief File that keeps the vendor-product relations of the market application between runs. */
+#define VENDOR_PRODUCT_RELATIONS_FILE "relations.csr"
+/** @brief Signature of a compressed sparse matrix file ("CSRM"). */
+#define SPARSE_MATRIX_FILE_MAGIC 0x4D525343
+/** @brief Format version of a compressed sparse matrix file. */
+#define SPARSE_MATRIX_FILE_VERSION 1
+/** @brief Alignment of every section in a compressed sparse matrix file, in bytes. */
+#define SPARSE_MATRIX_FILE_ALIGNMENT 64
+
+/**
+ * @struct SparseMatrixFileHeader
+ * @brief First 64 bytes of a compressed sparse matrix file.
+ *
+ * The sections follow at the given offsets, each aligned to SPARSE_MATRIX_FILE_ALIGNMENT, in native byte order:
+ * rowIds (int32 x rowCount), rowPointers (int32 x rowCount + 1), minorIds (int32 x entryCount) and prices
+ * (float x entryCount).
+ */
+typedef struct {
+    uint32_t magic;             ///< SPARSE_MATRIX_FILE_MAGIC.
+    uint32_t version;           ///< SPARSE_MATRIX_FILE_VERSION.
+    int32_t axis;               ///< SparseMatrixAxis of the stored matrix.
+    int32_t rowCount;           ///< Number of rows.
+    int32_t entryCount;         ///< Number of entries.
+    int32_t reserved;           ///< Reserved, zero.
+    int64_t rowIdsOffset;       ///< File offset of the rowIds section.
+    int64_t rowPointersOffset;  ///< File offset of the rowPointers section.
+    int64_t minorIdsOffset;     ///< File offset of the minorIds section.
+    int64_t pricesOffset;       ///< File offset of the prices section.
+    int64_t fileSize;           ///< Total size of the file.
+} SparseMatrixFileHeader;
+
+/**
+ * @struct MappedSparseMatrix
+ * @brief A compressed sparse matrix file mapped read-only into memory.
+ *
+ * matrix points into the mapping; it must not be modified or passed to freeCompressedSparseMatrix().
+ */
+typedef struct {
+    CompressedSparseMatrix matrix;  ///< View of the mapped sections.
+    void* address;                  ///< Start of the mapping, or NULL.
+    size_t size;                    ///< Length of the mapping in bytes.
+#ifdef _WIN32
+    void* fileHandle;               ///< Handle of the mapped file.
+    void* mappingHandle;            ///< Handle of the file mapping object.
+#endif
+} MappedSparseMatrix;
+
+bool writeCompressedSparseMatrixFile(const CompressedSparseMatrix* matrix, const char* path);
+bool mapCompressedSparseMatrixFile(const char* path, MappedSparseMatrix* foMapped);
+void unmapCompressedSparseMatrixFile(MappedSparseMatrix* mapped);
+bool appendCompressedSparseMatrixToBuilder(const CompressedSparseMatrix* matrix, SparseMatrixBuilder* builder);
+
+bool initSparseMatrixBuilder(SparseMatrixBuilder* builder, int initialCapacity);
+void freeSparseMatrixBuilder(SparseMatrixBuilder* builder);
+bool sparseMatrixBuilderReserve(SparseMatrixBuilder* builder, int capacity);
+bool sparseMatrixBuilderAdd(SparseMatrixBuilder* builder, int vendorId, int productId, float price);
+int finalizeSparseMatrixBuilder(SparseMatrixBuilder* builder);
+bool freezeSparseMatrixBuilder(SparseMatrixBuilder* builder, SparseMatrixAxis axis, CompressedSparseMatrix* foMatrix);
+
+bool buildCompressedSparseMatrix(const SparseMatrixEntry* entries, int entryCount, SparseMatrixAxis axis, CompressedSparseMatrix* foMatrix);
+void freeCompressedSparseMatrix(CompressedSparseMatrix* matrix);
+int compressedSparseMatrixRow(const CompressedSparseMatrix* matrix, int rowId, const int** foMinorIds, const float** foPrices);
+
+#endif // COMPRESSED_SPARSE_MATRIX_H
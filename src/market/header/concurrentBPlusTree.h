@@ -0,0 +1,398 @@
+/**
+ * @file concurrentBPlusTree.h
+ * @brief Thread-safe in-memory B+ tree using optimistic lock coupling.
+ *
+ * Every node carries a version word. Readers take no locks and write no shared memory on the fast path: they
+ * remember the version of each node they pass, read the node, and re-check the version before trusting what
+ * they read, restarting the operation if a writer got in between. Writers take a node's lock only to modify
+ * it, i.e. to insert into a leaf or to split a full node, so lookups scale with the number of cores while
+ * vendors are being added.
+ */
+
+#ifndef CONCURRENT_BPLUS_TREE_H
+#define CONCURRENT_BPLUS_TREE_H
+
+#include "bPlusTree.h"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace Coruh
+{
+    namespace Market
+    {
+        /**
+            @class ConcurrentBPlusTree
+            @brief B+ tree mapping unique keys to values that supports concurrent find() and insert().
+
+            The version word of a node holds a lock bit (2) and a counter in the remaining bits; releasing a write
+            lock adds 2, which clears the lock bit and bumps the version in one step.
+            Full nodes are split eagerly on the way down, so a split never has to propagate further than the
+            parent, which is locked together with the node being split. There is no erase: a split keeps the node
+            and adds a sibling, so no node ever leaves the tree and none has to be retired while readers may still
+            hold a pointer to it; the destructor frees them all. Supporting erase would need epoch-based
+            reclamation, so that merged nodes are freed only after every reader that could have seen them is
+            done.
+
+            Only the version word is atomic. The optimistic reads of keyCount, keys, values and children are
+            unsynchronized plain loads that may race with a writer; what they return is used only after validate()
+            has re-read the node's version behind an acquire fence and found it unchanged, and is discarded
+            otherwise. Keys and values must therefore be trivially copyable.
+
+            @tparam Key Key type, ordered by operator<.
+            @tparam Value Value type stored in the leaves.
+            @tparam NodeBytes Target size of one node in bytes, including the version word.
+        */
+        template <typename Key, typename Value, std::size_t NodeBytes = 256>
+        class ConcurrentBPlusTree
+        {
+            /** @brief Capacities derived from the byte budget left after the version word. */
+            typedef BPlusTreeLayout<Key, Value, (NodeBytes > sizeof(std::uint64_t) ? NodeBytes - sizeof(std::uint64_t) : 0)> Layout;
+
+        public:
+            /** @brief Common header of leaf and internal nodes. */
+            struct Node
+            {
+                std::atomic<std::uint64_t> version;     ///< Lock bit and version counter.
+                bool isLeaf;                            ///< Indicates if the node is a leaf.
+                int keyCount;                           ///< Number of keys in the node.
+            };
+
+            /** @brief Leaf node: sorted keys with their values. */
+            struct LeafNode : Node
+            {
+                Key keys[Layout::leafCapacity];         ///< Sorted keys.
+                Value values[Layout::leafCapacity];     ///< Values, parallel to keys.
+            };
+
+            /** @brief Internal node: separator keys and child pointers; keys[i] is the smallest key under children[i + 1]. */
+            struct InternalNode : Node
+            {
+                Key keys[Layout::internalCapacity];                     ///< Sorted separator keys.
+                Node* children[Layout::internalCapacity + 1];           ///< Child pointers, one more than keys.
+            };
+
+            /** @brief Returns the number of key/value pairs that fit into one leaf. */
+            static constexpr int leafCapacity() { return Layout::leafCapacity; }
+
+            /** @brief Returns the number of separator keys that fit into one internal node. */
+            static constexpr int internalCapacity() { return Layout::internalCapacity; }
+
+            /** @brief Creates an empty tree consisting of one empty leaf. */
+            ConcurrentBPlusTree() : root(newLeaf()), keyCount(0), treeHeight(1), restartCount(0) {}
+
+            /** @brief Frees every node; no other thread may use the tree any more. */
+            ~ConcurrentBPlusTree() { destroy(root.load()); }
+
+            ConcurrentBPlusTree(const ConcurrentBPlusTree&) = delete;
+            ConcurrentBPlusTree& operator=(const ConcurrentBPlusTree&) = delete;
+
+            /** @brief Returns the number of stored keys. */
+            std::size_t size() const { return keyCount.load(std::memory_order_relaxed); }
+
+            /** @brief Returns the number of levels. */
+            int height() const { return treeHeight.load(std::memory_order_relaxed); }
+
+            /** @brief Returns how often an operation had to restart because a concurrent writer changed a node. */
+            std::size_t restarts() const { return restartCount.load(std::memory_order_relaxed); }
+
+            /**
+             * @brief Looks up a key without taking any lock.
+             *
+             * @param fiKey The key to look up.
+             * @param foValue Output for the associated value; may be nullptr.
+             * @return true if the key is present, false otherwise.
+             */
+            bool find(const Key& fiKey, Value* foValue) const
+            {
+                for (;; restartCount.fetch_add(1, std::memory_order_relaxed)) {
+                    Node* node = root.load(std::memory_order_acquire);
+                    std::uint64_t version = readLock(node);
+                    if (node != root.load(std::memory_order_acquire)) {continue;}
+
+                    bool restart = false;
+                    while (!node->isLeaf) {
+                        InternalNode* internal = static_cast<InternalNode*>(node);
+                        Node* child = internal->children[BPlusTreeKeySearch<Key>::upperBound(internal->keys, clampedCount(internal), fiKey)];
+                        // The child pointer may only be followed if the parent did not change while it was read
+                        if (!validate(internal, version)) {restart = true; break;}
+                        node = child;
+                        version = readLock(node);
+                    }
+                    if (restart) {continue;}
+
+                    LeafNode* leaf = static_cast<LeafNode*>(node);
+                    int count = clampedCount(leaf);
+                    int index = BPlusTreeKeySearch<Key>::lowerBound(leaf->keys, count, fiKey);
+                    bool found = index < count && !(fiKey < leaf->keys[index]);
+                    Value value = found ? leaf->values[index] : Value();
+                    if (!validate(leaf, version)) {continue;}
+
+                    if (found && foValue != nullptr) {*foValue = value;}
+                    return found;
+                }
+            }
+
+            /**
+             * @brief Returns true if the key is present.
+             * @param fiKey The key to look up.
+             */
+            bool contains(const Key& fiKey) const { return find(fiKey, nullptr); }
+
+            /**
+             * @brief Inserts a key or replaces the value of an existing key.
+             *
+             * Only the leaf that receives the key is locked, plus a node and its parent while the node is split.
+             *
+             * @param fiKey The key to insert.
+             * @param fiValue The value to associate with the key.
+             * @return true if the key was new, false if an existing value was replaced.
+             */
+            bool insert(const Key& fiKey, const Value& fiValue)
+            {
+                for (;; restartCount.fetch_add(1, std::memory_order_relaxed)) {
+                    Node* node = root.load(std::memory_order_acquire);
+                    std::uint64_t version = readLock(node);
+                    if (node != root.load(std::memory_order_acquire)) {continue;}
+
+                    InternalNode* parent = nullptr;
+                    std::uint64_t parentVersion = 0;
+                    bool restart = false;
+
+                    while (!node->isLeaf) {
+                        InternalNode* internal = static_cast<InternalNode*>(node);
+                        if (internal->keyCount == internalCapacity()) {
+                            splitNode(parent, parentVersion, internal, version);
+                            restart = true;
+                            break;
+                        }
+                        if (parent != nullptr && !validate(parent, parentVersion)) {restart = true; break;}
+
+                        Node* child = internal->children[BPlusTreeKeySearch<Key>::upperBound(internal->keys, clampedCount(internal), fiKey)];
+                        if (!validate(internal, version)) {restart = true; break;}
+                        parent = internal;
+                        parentVersion = version;
+                        node = child;
+                        version = readLock(node);
+                    }
+                    if (restart) {continue;}
+
+                    LeafNode* leaf = static_cast<LeafNode*>(node);
+                    if (leaf->keyCount == leafCapacity()) {
+                        splitNode(parent, parentVersion, leaf, version);
+                        continue;
+                    }
+
+                    if (!upgradeToWriteLock(leaf, version)) {continue;}
+                    if (parent != nullptr && !validate(parent, parentVersion)) {
+                        writeUnlock(leaf);
+                        continue;
+                    }
+                    bool inserted = insertIntoLeaf(leaf, fiKey, fiValue);
+                    writeUnlock(leaf);
+                    if (inserted) {keyCount.fetch_add(1, std::memory_order_relaxed);}
+                    return inserted;
+                }
+            }
+
+        private:
+            static const std::uint64_t LockedBit = 2;       ///< Set while a writer holds the node.
+
+            std::atomic<Node*> root;                        ///< Root node, never nullptr.
+            std::atomic<std::size_t> keyCount;              ///< Number of stored keys.
+            std::atomic<int> treeHeight;                    ///< Number of levels.
+            mutable std::atomic<std::size_t> restartCount;  ///< Number of optimistic restarts, for diagnostics.
+
+            /** @brief Key count of a node read without a lock, clamped so a torn read cannot index past the arrays. */
+            static int clampedCount(const LeafNode* fiNode)
+            {
+                int count = fiNode->keyCount;
+                return count < 0 ? 0 : (count > leafCapacity() ? leafCapacity() : count);
+            }
+
+            static int clampedCount(const InternalNode* fiNode)
+            {
+                int count = fiNode->keyCount;
+                return count < 0 ? 0 : (count > internalCapacity() ? internalCapacity() : count);
+            }
+
+            /**
+             * @brief Waits until the node is not write-locked and returns its version.
+             */
+            static std::uint64_t readLock(const Node* fiNode)
+            {
+                std::uint64_t version = fiNode->version.load(std::memory_order_acquire);
+                for (int spins = 0; (version & LockedBit) != 0; spins++) {
+                    if (spins > 64) {std::this_thread::yield();}
+                    version = fiNode->version.load(std::memory_order_acquire);
+                }
+                return version;
+            }
+
+            /**
+             * @brief Returns true if the node has not been modified since fiVersion was read.
+             *
+             * The fence keeps the preceding plain reads of the node from being reordered after the version check.
+             */
+            static bool validate(const Node* fiNode, std::uint64_t fiVersion)
+            {
+                std::atomic_thread_fence(std::memory_order_acquire);
+                return fiNode->version.load(std::memory_order_relaxed) == fiVersion;
+            }
+
+            /**
+             * @brief Atomically turns a validated read of fiVersion into a write lock.
+             *
+             * The release fence orders the lock bit before the writer's changes to the node, so a reader that sees
+             * any of those changes also fails validation.
+             */
+            static bool upgradeToWriteLock(Node* fiNode, std::uint64_t fiVersion)
+            {
+                if (!fiNode->version.compare_exchange_strong(fiVersion, fiVersion + LockedBit, std::memory_order_acquire)) {return false;}
+                std::atomic_thread_fence(std::memory_order_release);
+                return true;
+            }
+
+            /** @brief Releases a write lock and publishes a new version. */
+            static void writeUnlock(Node* fiNode)
+            {
+                fiNode->version.fetch_add(LockedBit, std::memory_order_release);
+            }
+
+            /**
+             * @brief Splits a full node, which must be the root if fiParent is nullptr.
+             *
+             * Both the parent and the node are write-locked for the duration of the split; if either changed
+             * since it was read, nothing is modified. The caller restarts its descent in every case.
+             */
+            void splitNode(InternalNode* fiParent, std::uint64_t fiParentVersion, Node* fiNode, std::uint64_t fiVersion)
+            {
+                if (fiParent != nullptr && !upgradeToWriteLock(fiParent, fiParentVersion)) {return;}
+                if (!upgradeToWriteLock(fiNode, fiVersion)) {
+                    if (fiParent != nullptr) {writeUnlock(fiParent);}
+                    return;
+                }
+                if (fiParent == nullptr && fiNode != root.load(std::memory_order_relaxed)) {
+                    // Another thread grew the tree above this node after it was read as the root
+                    writeUnlock(fiNode);
+                    return;
+                }
+
+                Key separator;
+                Node* sibling = fiNode->isLeaf ? static_cast<Node*>(splitLeaf(static_cast<LeafNode*>(fiNode), &separator))
+                                               : static_cast<Node*>(splitInternal(static_cast<InternalNode*>(fiNode), &separator));
+                if (fiParent != nullptr) {
+                    insertIntoInternal(fiParent, separator, sibling);
+                }
+                else {
+                    InternalNode* newRoot = newInternal();
+                    newRoot->keys[0] = separator;
+                    newRoot->children[0] = fiNode;
+                    newRoot->children[1] = sibling;
+                    newRoot->keyCount = 1;
+                    root.store(newRoot, std::memory_order_release);
+                    treeHeight.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                writeUnlock(fiNode);
+                if (fiParent != nullptr) {writeUnlock(fiParent);}
+            }
+
+            /** @brief Moves the upper half of a full leaf into a new leaf and returns it. */
+            static LeafNode* splitLeaf(LeafNode* fiLeaf, Key* foSeparator)
+            {
+                LeafNode* right = newLeaf();
+                int leftCount = fiLeaf->keyCount / 2;
+                right->keyCount = fiLeaf->keyCount - leftCount;
+                for (int i = 0; i < right->keyCount; i++) {
+                    right->keys[i] = fiLeaf->keys[leftCount + i];
+                    right->values[i] = fiLeaf->values[leftCount + i];
+                }
+                fiLeaf->keyCount = leftCount;
+                *foSeparator = right->keys[0];
+                return right;
+            }
+
+            /** @brief Moves the keys above the middle of a full internal node into a new node; the middle key moves up. */
+            static InternalNode* splitInternal(InternalNode* fiNode, Key* foSeparator)
+            {
+                InternalNode* right = newInternal();
+                int middle = fiNode->keyCount / 2;
+                right->keyCount = fiNode->keyCount - middle - 1;
+                for (int i = 0; i < right->keyCount; i++) {
+                    right->keys[i] = fiNode->keys[middle + 1 + i];
+                }
+                for (int i = 0; i <= right->keyCount; i++) {
+                    right->children[i] = fiNode->children[middle + 1 + i];
+                }
+                *foSeparator = fiNode->keys[middle];
+                fiNode->keyCount = middle;
+                return right;
+            }
+
+            /** @brief Adds a separator and its right child to a locked internal node that is not full. */
+            static void insertIntoInternal(InternalNode* fiNode, const Key& fiSeparator, Node* fiChild)
+            {
+                int position = BPlusTreeKeySearch<Key>::upperBound(fiNode->keys, fiNode->keyCount, fiSeparator);
+                for (int i = fiNode->keyCount; i > position; i--) {
+                    fiNode->keys[i] = fiNode->keys[i - 1];
+                    fiNode->children[i + 1] = fiNode->children[i];
+                }
+                fiNode->keys[position] = fiSeparator;
+                fiNode->children[position + 1] = fiChild;
+                fiNode->keyCount++;
+            }
+
+            /** @brief Inserts into a locked leaf that is not full, or replaces the value of an existing key. */
+            static bool insertIntoLeaf(LeafNode* fiLeaf, const Key& fiKey, const Value& fiValue)
+            {
+                int position = BPlusTreeKeySearch<Key>::lowerBound(fiLeaf->keys, fiLeaf->keyCount, fiKey);
+                if (position < fiLeaf->keyCount && !(fiKey < fiLeaf->keys[position])) {
+                    fiLeaf->values[position] = fiValue;
+                    return false;
+                }
+                for (int i = fiLeaf->keyCount; i > position; i--) {
+                    fiLeaf->keys[i] = fiLeaf->keys[i - 1];
+                    fiLeaf->values[i] = fiLeaf->values[i - 1];
+                }
+                fiLeaf->keys[position] = fiKey;
+                fiLeaf->values[position] = fiValue;
+                fiLeaf->keyCount++;
+                return true;
+            }
+
+            static LeafNode* newLeaf()
+            {
+                LeafNode* leaf = new LeafNode;
+                leaf->version.store(0, std::memory_order_relaxed);
+                leaf->isLeaf = true;
+                leaf->keyCount = 0;
+                return leaf;
+            }
+
+            static InternalNode* newInternal()
+            {
+                InternalNode* node = new InternalNode;
+                node->version.store(0, std::memory_order_relaxed);
+                node->isLeaf = false;
+                node->keyCount = 0;
+                return node;
+            }
+
+            static void destroy(Node* fiNode)
+            {
+                if (fiNode->isLeaf) {
+                    delete static_cast<LeafNode*>(fiNode);
+                    return;
+                }
+                InternalNode* internal = static_cast<InternalNode*>(fiNode);
+                for (int i = 0; i <= internal->keyCount; i++) {
+                    destroy(internal->children[i]);
+                }
+                delete internal;
+            }
+        };
+    }
+}
+
+#endif // CONCURRENT_BPLUS_TREE_H
@@ -0,0 +1,75 @@
+/**
+ * @file extendibleHash.h
+ * @brief Disk-resident extendible hashing file keyed by vendor ID.
+ *
+ * Products are stored in fixed-size 4 KiB bucket pages. A directory of 2^globalDepth page ids
+ * maps the low bits of a vendor hash to the bucket page holding every product of that vendor,
+ * so a point lookup or a per-vendor scan reads one page chain, independent of the total file size.
+ * Full buckets are split and the directory doubles on demand. Splitting cannot separate the
+ * products of one vendor, so a vendor with more than HASH_BUCKET_CAPACITY products grows an
+ * overflow chain of one page per HASH_BUCKET_CAPACITY products, with no upper bound.
+ *
+ * This is a standalone structure: the market menus look products up through products.idx
+ * (pagedBPlusTree.h) and do not keep a hash file.
+ */
+
+#ifndef EXTENDIBLE_HASH_H
+#define EXTENDIBLE_HASH_H
+
+#include "market.h"
+
+/** @brief Size of one bucket page in the hash file, in bytes. */
+#define HASH_PAGE_SIZE 4096
+/** @brief Size of the bucket page header (local depth, count, overflow link, reserved). */
+#define HASH_PAGE_HEADER_SIZE 16
+/** @brief Number of products that fit in one bucket page. */
+#define HASH_BUCKET_CAPACITY ((HASH_PAGE_SIZE - HASH_PAGE_HEADER_SIZE) / sizeof(Product))
+/** @brief Upper bound for the directory depth; buckets at this depth chain overflow pages instead of splitting. */
+#define HASH_MAX_GLOBAL_DEPTH 20
+/** @brief Marker for "no page" in overflow links. */
+#define HASH_NO_PAGE (-1)
+
+/**
+ * @struct HashBucketPage
+ * @brief On-disk image of one bucket page.
+ *
+ * This is the Bucket idea at page granularity: a page-sized array of products plus the local depth
+ * used by extendible hashing and a link to an overflow page for vendors that outgrow a single page.
+ */
+typedef struct {
+    int32_t localDepth;                                  ///< Number of hash bits shared by all products in this bucket.
+    int32_t productCount;                                ///< Number of products currently stored in this page.
+    int32_t overflowPage;                                ///< Page id of the next page in the chain, or HASH_NO_PAGE.
+    int32_t reserved;                                    ///< Reserved, keeps the product array 16-byte aligned.
+    Product products[HASH_BUCKET_CAPACITY];              ///< Products stored in this page.
+    char padding[HASH_PAGE_SIZE - HASH_PAGE_HEADER_SIZE - HASH_BUCKET_CAPACITY * sizeof(Product)]; ///< Pads the struct to a full page.
+} HashBucketPage;
+
+/**
+ * @struct ExtendibleHashFile
+ * @brief Handle for an open extendible hash file.
+ *
+ * The directory and the free page list live in a small sidecar file ("<path>.dir") and are kept in
+ * memory while the file is open; bucket pages are read from and written to disk on every operation.
+ */
+typedef struct {
+    FILE* dataFile;                 ///< Bucket page file.
+    char directoryPath[260];        ///< Path of the sidecar directory file.
+    int32_t globalDepth;            ///< Number of hash bits used to index the directory.
+    int32_t* directory;             ///< 2^globalDepth bucket page ids.
+    int32_t pageCount;              ///< Number of pages in the data file.
+    int32_t* freePages;             ///< Page ids released by splits and removals, reused before growing the file.
+    int32_t freePageCount;          ///< Number of entries in freePages.
+    int32_t freePageCapacity;       ///< Allocated length of freePages.
+    long pageReads;                 ///< Number of page reads issued since the file was opened.
+} ExtendibleHashFile;
+
+ExtendibleHashFile* openExtendibleHashFile(const char* path);
+bool closeExtendibleHashFile(ExtendibleHashFile* hashFile);
+bool extendibleHashInsert(ExtendibleHashFile* hashFile, const Product* product);
+bool extendibleHashFind(ExtendibleHashFile* hashFile, int vendorId, Product* foProduct);
+int extendibleHashScanVendor(ExtendibleHashFile* hashFile, int vendorId, Product foProducts[], int maxCount);
+bool extendibleHashRemove(ExtendibleHashFile* hashFile, int vendorId, const char* productName);
+int buildExtendibleHashFromProducts(ExtendibleHashFile* hashFile, const char* productsPath);
+
+#endif // EXTENDIBLE_HASH_H
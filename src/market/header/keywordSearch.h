@@ -0,0 +1,61 @@
+/**
+ * @file keywordSearch.h
+ * @brief Multi-keyword search: all keywords of a query are found in one pass over a text.
+ *
+ * The keywords are compiled into an Aho-Corasick automaton. Every state carries a complete transition table,
+ * so each byte of a text costs one table lookup no matter how many keywords the query has, and every state
+ * knows the set of keywords that end at it (including shorter keywords that are suffixes of longer ones) as a
+ * bit mask. A query therefore supports up to KEYWORD_SEARCH_MAX_KEYWORDS keywords.
+ *
+ * A record matches a query when all of its keywords occur in it (KEYWORD_MATCH_ALL) or at least one does
+ * (KEYWORD_MATCH_ANY). Matching is case sensitive, like the strstr() search it replaces.
+ */
+
+#ifndef KEYWORD_SEARCH_H
+#define KEYWORD_SEARCH_H
+
+#include "market.h"
+
+/** @brief Largest number of keywords in one automaton; the keyword sets are 64-bit masks. */
+#define KEYWORD_SEARCH_MAX_KEYWORDS 64
+
+/** @brief Separates alternatives in a keyword query ("apple | pear"); without it all keywords must match. */
+#define KEYWORD_QUERY_ANY_SEPARATOR '|'
+
+/**
+ * @enum KeywordMatchMode
+ * @brief How the keywords of a query combine.
+ */
+typedef enum {
+    KEYWORD_MATCH_ALL,          ///< Every keyword must occur.
+    KEYWORD_MATCH_ANY           ///< At least one keyword must occur.
+} KeywordMatchMode;
+
+/**
+ * @struct KeywordAutomaton
+ * @brief Aho-Corasick automaton over a set of keywords.
+ */
+typedef struct {
+    int stateCount;             ///< Number of states; state 0 is the root.
+    int keywordCount;           ///< Number of keywords.
+    int32_t* transitions;       ///< stateCount rows of 256 next states, failure transitions already folded in.
+    uint64_t* outputs;          ///< Per state, the keywords that end when the state is entered.
+    int* keywordLengths;        ///< Length of every keyword, for match offsets.
+} KeywordAutomaton;
+
+/**
+ * @struct KeywordMatch
+ * @brief One occurrence of a keyword in a text.
+ */
+typedef struct {
+    int keyword;                ///< Index of the keyword.
+    int offset;                 ///< Offset of its first byte in the text.
+} KeywordMatch;
+
+bool buildKeywordAutomaton(const char* const keywords[], int keywordCount, KeywordAutomaton* foAutomaton);
+void freeKeywordAutomaton(KeywordAutomaton* automaton);
+int findKeywords(const KeywordAutomaton* automaton, const char* text, int textLength, KeywordMatch foMatches[], int maxMatches, uint64_t* foFound);
+bool keywordsSatisfied(const KeywordAutomaton* automaton, uint64_t found, KeywordMatchMode mode);
+int splitKeywordQuery(char* query, char* foKeywords[], int maxKeywords, KeywordMatchMode* foMode);
+
+#endif // KEYWORD_SEARCH_H
@@ -0,0 +1,57 @@
+/**
+ * @file linearHash.h
+ * @brief Linear hashing variant of the bucketized product hash table.
+ *
+ * Unlike hashTableBuckets, whose size is fixed by TABLE_SIZE, a linear hash table grows one bucket
+ * at a time: whenever the load factor passes its limit the bucket at the split pointer is split,
+ * so no insert ever pays for rehashing the whole table.
+ */
+
+#ifndef LINEAR_HASH_H
+#define LINEAR_HASH_H
+
+#include "market.h"
+
+/** @brief Number of buckets allocated together in one segment; segments never move once allocated. */
+#define LINEAR_HASH_SEGMENT_SIZE 64
+/** @brief Default maximum ratio of stored products to primary bucket slots before a split is triggered. */
+#define LINEAR_HASH_MAX_LOAD 0.8
+
+/**
+ * @struct LinearHashBucket
+ * @brief A Bucket with a link to an overflow bucket for collisions beyond BUCKET_SIZE.
+ */
+typedef struct LinearHashBucket {
+    Bucket bucket;                        ///< Products stored in this bucket.
+    struct LinearHashBucket* overflow;    ///< Next bucket in the overflow chain, or NULL.
+} LinearHashBucket;
+
+/**
+ * @struct LinearHashTable
+ * @brief Linear hash table of products keyed by vendor ID.
+ *
+ * Buckets live in fixed-size segments so that growing the table only appends a segment pointer;
+ * existing buckets are never copied.
+ */
+typedef struct {
+    LinearHashBucket** segments;    ///< Segment directory, each segment holds LINEAR_HASH_SEGMENT_SIZE buckets.
+    int segmentCount;               ///< Number of allocated segments.
+    int segmentCapacity;            ///< Length of the segment directory.
+    int initialBucketCount;         ///< Number of buckets at level 0.
+    int level;                      ///< Number of completed doubling rounds.
+    int splitPointer;               ///< Next bucket to be split in the current round.
+    int bucketCount;                ///< Number of buckets currently addressable.
+    int productCount;               ///< Number of stored products.
+    double maxLoadFactor;           ///< Load factor that triggers a split.
+    int failedSplitCount;           ///< Splits skipped because memory ran out; the next insert tries again.
+} LinearHashTable;
+
+LinearHashTable* createLinearHashTable(int initialBucketCount, double maxLoadFactor);
+void freeLinearHashTable(LinearHashTable* table);
+bool linearHashInsert(LinearHashTable* table, const Product* product);
+bool linearHashSearch(LinearHashTable* table, int vendorId, Product* foProduct);
+int linearHashScanVendor(LinearHashTable* table, int vendorId, Product foProducts[], int maxCount);
+bool linearHashRemove(LinearHashTable* table, int vendorId, const char* productName);
+double linearHashLoadFactor(const LinearHashTable* table);
+
+#endif // LINEAR_HASH_H
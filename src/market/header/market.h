@@ -55,6 +55,11 @@
   * encoding, decoding, and storage do not exceed this limit, thus preventing buffer overflows.
   */
 #define MAX_CHAR 256
+ /**
+  * @def CHEAPEST_OFFER_COUNT
+  * @brief Number of offers listed by the cheapest offers option of the price comparison menu.
+  */
+#define CHEAPEST_OFFER_COUNT 3
 
   /**
    * @struct User
@@ -96,6 +101,15 @@ struct Product {
     char season[20];          ///< Season during which the product is available.
 };
 
+/**
+ * @struct PriceSortKey
+ * @brief Sort key for ordering products by price without moving the product records.
+ */
+struct PriceSortKey {
+    float price;              ///< Price of the product.
+    int index;                ///< Index of the product in the array being sorted.
+};
+
 /**
  * @struct HashTableEntry
  * @brief Represents an entry within a hash table used for product management.
@@ -192,6 +206,18 @@ typedef struct BPlusTreeNode {
     struct BPlusTreeNode* next;                       /**< Pointer to next leaf node (used for linked leaf nodes) */
 } BPlusTreeNode;
 
+/**
+ * @struct KMPPattern
+ * @brief A search pattern with its KMP longest-prefix-suffix table, compiled once for many searches.
+ *
+ * The LPS table and the pattern copy live in one allocation owned by the struct.
+ */
+typedef struct {
+    char* pattern;      ///< Zero-terminated copy of the pattern.
+    int* lps;           ///< lps[i] is the length of the longest proper prefix of pattern[0..i] that is also its suffix.
+    int length;         ///< Length of the pattern.
+} KMPPattern;
+
 
 
 /**
@@ -378,13 +404,28 @@ int linearQuotient(int key, int i);
 bool progressiveOverflowSearch(int key);
 bool useOfBucketsSearch(int key);
 int brentsMethodSearch(int key);
-void addVendorProductRelation(int vendorId, int productId, float price);
+bool addVendorProductRelation(int vendorId, int productId, float price);
 bool listProductsByVendor(int vendorId);
+bool listVendorsByProduct(int productId);
+bool listProductPriceAggregates();
+void recordProductPrice(float price);
+void resetProductPriceStatistics();
+bool showProductPriceStatistics();
+bool loadVendorProductRelations(const char* path);
+bool saveVendorProductRelations(const char* path);
 
 bool enterSearchProducts();
+void computeLPSArray(const char* pattern, int M, int* lps);
+bool compileKMPPattern(const char* pattern, KMPPattern* foCompiled);
+void freeKMPPattern(KMPPattern* compiled);
+int findKMPPattern(const KMPPattern* compiled, const char* text, int textLength);
+bool KMPSearch(const char* pattern, const char* text);
 bool enterKeywords();
 int priceComparis();
 bool comparePricesByName(const char* productName); 
+int selectProductsByPrice(const char* productFilePath, const char* productName, int k, bool cheapest, Product foProducts[]);
+bool showBestOffers(const char* productName, int k);
+bool showPriceSummary(const char* productName);
 bool selectProduct(char* selectedProductName);
 bool validateDay(const char* day);
 bool validateWorkingHours(const char* hours);
@@ -394,8 +435,6 @@ bool validateWorkingHours(const char* hours);
 
 /** @brief Fixed array defining the days of the week */
 extern const char* daysOfWeek[7];
-extern SparseMatrixEntry sparseMatrix[MAX_VENDORS * MAX_PRODUCTS];
-extern int sparseMatrixSize;
 
 bool addMarketHoursAndLocation();
 bool updateMarketHoursAndLocation();
@@ -408,6 +447,8 @@ void findSCC(Node* nodes[], int nodeCount);
 void tarjanDFS(Node* nodes[], int at, int* id, int* ids, int* low, Node** stack, int* stackTop, bool* onStack, int nodeCount);
 int findNodeIndex(Node* nodes[], Node* node, int nodeCount);
 bool heapify(Product arr[], int n, int i);
+void heapSort(Product arr[], int n);
+void heapSortPriceKeys(PriceSortKey keys[], int n);
 
 
 
@@ -0,0 +1,142 @@
+/**
+ * @file marketIndex.h
+ * @brief B+ tree indexes built over the market's binary record files.
+ *
+ * Each index maps a record field to the position of the record in its file, so lookups no longer
+ * need a full scan of vendor.bin or products.bin.
+ */
+
+#ifndef MARKET_INDEX_H
+#define MARKET_INDEX_H
+
+#include "market.h"
+#include "bPlusTree.h"
+#include "prefixBPlusTree.h"
+#include <string.h>
+
+namespace Coruh
+{
+    namespace Market
+    {
+        /** @brief Vendor ID to record index in vendor.bin, one 4 KiB node per level. */
+        typedef BPlusTree<int, long, 4096> VendorIdIndex;
+
+        /**
+         * @brief Builds the vendor ID index from a binary vendor file.
+         *
+         * The vendor file is read once; IDs are normally already ascending because vendors are appended
+         * with increasing IDs, in which case the tree is bulk loaded in linear time. Otherwise the IDs are
+         * sorted first. If an ID occurs more than once, the first record wins.
+         *
+         * @param fiVendorPath Path of the vendor file (e.g. "vendor.bin").
+         * @param foIndex The index to fill; its previous contents are replaced.
+         * @return true on success, false if the file cannot be opened.
+         */
+        bool buildVendorIdIndex(const char* fiVendorPath, VendorIdIndex& foIndex);
+
+        /**
+         * @brief Returns the record indexes of all vendors whose ID lies in [fiFirstId, fiLastId).
+         *
+         * @param fiIndex The vendor ID index.
+         * @param fiFirstId Smallest ID of the range (inclusive).
+         * @param fiLastId End of the range (exclusive).
+         * @param foPositions Output array of record indexes in ID order; may be NULL when only the count is needed.
+         * @param fiMaxCount Capacity of foPositions.
+         * @return The number of vendors in the range (may exceed fiMaxCount).
+         */
+        int findVendorIdsInRange(const VendorIdIndex& fiIndex, int fiFirstId, int fiLastId, long foPositions[], int fiMaxCount);
+
+        /**
+            @struct ProductPriceKey
+            @brief Key of the product price index.
+
+            Keys order by product name, then by price, then by record index in products.bin. All offers of one
+            product are therefore adjacent and sorted by price, so a name and a price range select one contiguous
+            run of leaf entries; the record index makes keys unique because prices repeat.
+        */
+        struct ProductPriceKey
+        {
+            char productName[50]; ///< Name of the product, zero padded.
+            float price;          ///< Price of the product.
+            long recordIndex;     ///< Index of the product record in products.bin.
+        };
+
+        /** @brief Orders price keys by product name, then price, then record index. */
+        inline bool operator<(const ProductPriceKey& fiLeft, const ProductPriceKey& fiRight)
+        {
+            int names = strncmp(fiLeft.productName, fiRight.productName, sizeof(fiLeft.productName));
+            if (names != 0) {return names < 0;}
+            if (fiLeft.price < fiRight.price) {return true;}
+            if (fiRight.price < fiLeft.price) {return false;}
+            return fiLeft.recordIndex < fiRight.recordIndex;
+        }
+
+        /** @brief (Product name, price) to record index in products.bin, one 4 KiB node per level. */
+        typedef BPlusTree<ProductPriceKey, long, 4096> ProductPriceIndex;
+
+        /**
+         * @brief Builds the price index from a binary products file.
+         *
+         * @param fiProductsPath Path of the products file (e.g. "products.bin").
+         * @param foIndex The index to fill; its previous contents are replaced.
+         * @return true on success, false if the file cannot be opened.
+         */
+        bool buildProductPriceIndex(const char* fiProductsPath, ProductPriceIndex& foIndex);
+
+        /**
+         * @brief Returns the record indexes of the products whose price lies in [fiMinPrice, fiMaxPrice].
+         *
+         * For a given name the matches are one run of leaf entries found by a single descent, so the cost is
+         * O(log n + k) for k matches, in ascending price order. Without a name every distinct name costs one
+         * descent; the results are then grouped by name and ascending in price within each name.
+         *
+         * @param fiIndex The price index.
+         * @param fiProductName Product name to match, or NULL for every product.
+         * @param fiMinPrice Lowest price (inclusive).
+         * @param fiMaxPrice Highest price (inclusive).
+         * @param foPositions Output array of record indexes; may be NULL when only the count is needed.
+         * @param fiMaxCount Capacity of foPositions.
+         * @return The number of matching products (may exceed fiMaxCount).
+         */
+        int findProductsInPriceRange(const ProductPriceIndex& fiIndex, const char* fiProductName, float fiMinPrice, float fiMaxPrice,
+                                     long foPositions[], int fiMaxCount);
+
+        /**
+            @struct ProductNameEntry
+            @brief Value of the product name index: where a name first occurs and how many products carry it.
+        */
+        struct ProductNameEntry
+        {
+            long firstRecord;     ///< Index of the first product record with this name in products.bin.
+            int productCount;     ///< Number of products (one per vendor offer) with this name.
+        };
+
+        /** @brief Distinct product names in byte order with front-coded keys, one 4 KiB node per level. */
+        typedef PrefixBPlusTree<ProductNameEntry, 4096> ProductNameIndex;
+
+        /**
+         * @brief Builds the product name index from a binary products file.
+         *
+         * @param fiProductsPath Path of the products file (e.g. "products.bin").
+         * @param foIndex The index to fill; its previous contents are replaced.
+         * @return true on success, false if the file cannot be opened.
+         */
+        bool buildProductNameIndex(const char* fiProductsPath, ProductNameIndex& foIndex);
+
+        /**
+         * @brief Lists the distinct product names starting with fiPrefix in sorted order.
+         *
+         * An empty prefix lists every name, which gives a sorted product listing; a typed prefix gives
+         * autocomplete suggestions. Only the leaves holding matching names are visited.
+         *
+         * @param fiIndex The product name index.
+         * @param fiPrefix Prefix to match; "" matches every name.
+         * @param foNames Output array of names; may be NULL when only the count is needed.
+         * @param fiMaxCount Capacity of foNames.
+         * @return The number of matching names (may exceed fiMaxCount).
+         */
+        int findProductNamesWithPrefix(const ProductNameIndex& fiIndex, const char* fiPrefix, char foNames[][50], int fiMaxCount);
+    }
+}
+
+#endif // MARKET_INDEX_H
@@ -0,0 +1,159 @@
+/**
+ * @file pagedBPlusTree.h
+ * @brief Disk-resident B+ tree indexing products.bin by vendor ID and product name.
+ *
+ * Nodes are fixed-size 4 KiB pages addressed by page id instead of BPlusTreeNode pointers, so the index
+ * lives in its own file, survives restarts and can grow beyond main memory. Every product record in
+ * products.bin has its own entry, keyed by vendor ID, product name and the byte offset of the record, so a
+ * vendor that lists the same product twice keeps both records in the index. Pages are accessed through a small LRU buffer pool; only the
+ * pages on the current root-to-leaf path have to be resident.
+ *
+ * The meta page records the record count and modification time of products.bin as of the last sync, so an
+ * index left behind by a products.bin that was replaced or edited elsewhere is detected and rebuilt.
+ */
+
+#ifndef PAGED_BPLUS_TREE_H
+#define PAGED_BPLUS_TREE_H
+
+#include "market.h"
+
+/** @brief Size of one page in the index file, in bytes. */
+#define BTREE_PAGE_SIZE 4096
+/** @brief Size of the node page header (leaf flag, key count, next leaf link, reserved). */
+#define BTREE_PAGE_HEADER_SIZE 16
+/** @brief Marker for "no page" in page links. */
+#define BTREE_NO_PAGE (-1)
+/** @brief Default number of page frames in the buffer pool. */
+#define BTREE_DEFAULT_POOL_SIZE 64
+/** @brief Smallest accepted buffer pool; an erase pins at most a node, its parent and both siblings. */
+#define BTREE_MIN_POOL_SIZE 4
+/** @brief Index file kept next to products.bin by the product menu functions, if it exists. */
+#define PRODUCT_INDEX_FILE "products.idx"
+
+/**
+ * @struct PagedProductKey
+ * @brief Key of the paged product index: vendor ID first, then product name, then record offset.
+ *
+ * Ordering by vendor first keeps all products of a vendor in neighbouring leaves, so per-vendor scans
+ * read only a few consecutive pages. The offset makes the keys of repeated listings of one product by one
+ * vendor distinct and orders them as in products.bin.
+ */
+typedef struct {
+    int32_t vendorId;           ///< Vendor that owns the product.
+    char productName[52];       ///< Product name, zero padded (Product::productName holds at most 50 bytes).
+    int64_t offset;             ///< Byte offset of the product record in products.bin.
+} PagedProductKey;
+
+/** @brief Number of keys in one leaf page. */
+#define BTREE_LEAF_CAPACITY ((BTREE_PAGE_SIZE - BTREE_PAGE_HEADER_SIZE) / sizeof(PagedProductKey))
+/** @brief Number of separator keys in one internal page (it holds one more child id than keys). */
+#define BTREE_INTERNAL_CAPACITY ((BTREE_PAGE_SIZE - BTREE_PAGE_HEADER_SIZE - sizeof(int32_t)) / (sizeof(PagedProductKey) + sizeof(int32_t)))
+
+/**
+ * @struct BTreePageHeader
+ * @brief Header shared by leaf and internal pages.
+ */
+typedef struct {
+    int32_t isLeaf;             ///< Non-zero for leaf pages.
+    int32_t keyCount;           ///< Number of keys in the page.
+    int32_t nextLeaf;           ///< Next leaf in key order, or BTREE_NO_PAGE; unused in internal pages.
+    int32_t reserved;           ///< Reserved, keeps the key array 16-byte aligned.
+} BTreePageHeader;
+
+/**
+ * @struct BTreeLeafPage
+ * @brief On-disk image of a leaf page.
+ */
+typedef struct {
+    BTreePageHeader header;                                   ///< Page header.
+    PagedProductKey keys[BTREE_LEAF_CAPACITY];                ///< Sorted keys; each carries the offset of its record.
+    char padding[BTREE_PAGE_SIZE - BTREE_PAGE_HEADER_SIZE - BTREE_LEAF_CAPACITY * sizeof(PagedProductKey)]; ///< Pads the struct to a full page.
+} BTreeLeafPage;
+
+/**
+ * @struct BTreeInternalPage
+ * @brief On-disk image of an internal page; keys[i] is the smallest key reachable through children[i + 1].
+ */
+typedef struct {
+    BTreePageHeader header;                                   ///< Page header.
+    PagedProductKey keys[BTREE_INTERNAL_CAPACITY];            ///< Sorted separator keys.
+    int32_t children[BTREE_INTERNAL_CAPACITY + 1];            ///< Child page ids.
+    char padding[BTREE_PAGE_SIZE - BTREE_PAGE_HEADER_SIZE - sizeof(int32_t) - BTREE_INTERNAL_CAPACITY * (sizeof(PagedProductKey) + sizeof(int32_t))]; ///< Pads the struct to a full page.
+} BTreeInternalPage;
+
+/**
+ * @struct BTreeMetaPage
+ * @brief Page 0 of the index file: locates the root and records the size of the tree.
+ */
+typedef struct {
+    int32_t magic;              ///< File signature.
+    int32_t pageSize;           ///< Page size the file was written with.
+    int32_t rootPage;           ///< Page id of the root node.
+    int32_t height;             ///< Number of levels, 1 for a single leaf.
+    int32_t pageCount;          ///< Number of pages in the file, including this one.
+    int32_t reserved;           ///< Reserved.
+    int64_t keyCount;           ///< Number of indexed product records.
+    int64_t sourceRecords;      ///< Records in products.bin when the index was last synced with it.
+    int64_t sourceModified;     ///< Modification time of products.bin at that point, in nanoseconds.
+    char padding[BTREE_PAGE_SIZE - 6 * sizeof(int32_t) - 3 * sizeof(int64_t)]; ///< Pads the struct to a full page.
+} BTreeMetaPage;
+
+/**
+ * @union BTreePage
+ * @brief One page of the index file viewed as any of its page kinds.
+ */
+typedef union {
+    BTreePageHeader header;         ///< Header common to node pages.
+    BTreeLeafPage leaf;             ///< Leaf view.
+    BTreeInternalPage internal;     ///< Internal node view.
+    BTreeMetaPage meta;             ///< Meta page view.
+} BTreePage;
+
+/**
+ * @struct BTreeFrame
+ * @brief One slot of the buffer pool.
+ */
+typedef struct {
+    int32_t pageId;             ///< Page held by the frame, or BTREE_NO_PAGE when empty.
+    bool dirty;                 ///< The page was modified and must be written back before eviction.
+    int pinCount;               ///< Number of users currently holding the page; pinned frames are never evicted.
+    uint64_t lastUsed;          ///< Access stamp used to pick the least recently used frame.
+    BTreePage page;             ///< Page contents.
+} BTreeFrame;
+
+/**
+ * @struct PagedBPlusTree
+ * @brief Handle for an open paged B+ tree file.
+ */
+typedef struct {
+    FILE* file;                 ///< Index file.
+    BTreeFrame* frames;         ///< Buffer pool frames.
+    int frameCount;             ///< Number of frames in the pool.
+    uint64_t accessClock;       ///< Monotonic stamp for LRU replacement.
+    int32_t rootPage;           ///< Page id of the root node.
+    int32_t height;             ///< Number of levels.
+    int32_t pageCount;          ///< Number of pages in the file.
+    int64_t keyCount;           ///< Number of indexed product records.
+    int64_t sourceRecords;      ///< Records in products.bin when the index was last synced with it, -1 if never.
+    int64_t sourceModified;     ///< Modification time of products.bin at that point, in nanoseconds.
+    long pageReads;             ///< Pages read from disk since the file was opened (buffer pool misses).
+    long pageWrites;            ///< Pages written to disk since the file was opened.
+} PagedBPlusTree;
+
+PagedBPlusTree* openPagedBPlusTree(const char* path, int poolSize);
+bool closePagedBPlusTree(PagedBPlusTree* tree);
+bool flushPagedBPlusTree(PagedBPlusTree* tree);
+int pagedBPlusTreeInsert(PagedBPlusTree* tree, int vendorId, const char* productName, int64_t offset);
+int pagedBPlusTreeErase(PagedBPlusTree* tree, int vendorId, const char* productName, int64_t offset);
+bool pagedBPlusTreeFind(PagedBPlusTree* tree, int vendorId, const char* productName, int64_t* foOffset);
+int pagedBPlusTreeScanVendor(PagedBPlusTree* tree, int vendorId, int64_t foOffsets[], int maxCount);
+int pagedBPlusTreeFindName(PagedBPlusTree* tree, const char* productName, int64_t foOffsets[], int maxCount);
+int64_t buildPagedBPlusTreeFromProducts(PagedBPlusTree* tree, const char* productsPath);
+PagedBPlusTree* openProductIndex(const char* indexPath, const char* productsPath, int poolSize);
+bool readProductAtOffset(FILE* productsFile, int64_t offset, Product* foProduct);
+bool appendToProductIndex(const char* indexPath, const char* productsPath, const Product* product);
+bool patchProductIndex(const char* indexPath, const char* productsPath, int64_t recordDelta, const Product removed[],
+                       const int64_t removedOffsets[], int removedCount, const Product placed[], const int64_t placedOffsets[], int placedCount);
+bool refreshProductIndex(const char* indexPath, const char* productsPath);
+
+#endif // PAGED_BPLUS_TREE_H
@@ -0,0 +1,672 @@
+/**
+ * @file prefixBPlusTree.h
+ * @brief B+ tree with compressed string keys for ordered and prefix lookups of product names.
+ *
+ * Product names are stored as 50-byte char arrays, and names in one catalog share long prefixes
+ * ("Tomato Cherry", "Tomato Roma", ...). Leaves front-code their keys: each key stores only the
+ * bytes that differ from the previous key. Internal nodes store the shortest separators that still
+ * split their children, and the prefix shared by all separators of a node is stored only once.
+ * More keys fit into each node, so the tree is shallower and uses less memory than fixed-width keys.
+ */
+
+#ifndef PREFIX_BPLUS_TREE_H
+#define PREFIX_BPLUS_TREE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Coruh
+{
+    namespace Market
+    {
+        /**
+            @class PrefixBPlusTree
+            @brief B+ tree mapping unique strings to values with front-coded leaves and prefix-truncated internal nodes.
+
+            Internal nodes are searched in place: the probe is compared with the node prefix once and then with
+            the separator remainders, without decoding the node. Leaves are scanned with the Iterator, which
+            rebuilds each key from the front coding as it advances, so a lookup decodes at most the keys of one
+            leaf. Nodes are fully decoded only when they are modified. Keys are at most maxKeyLength bytes long
+            and must not contain '\0'.
+
+            Leaf entry layout: [shared length][suffix length][suffix bytes][value bytes], where the shared length
+            counts the leading bytes taken from the previous key of the leaf (0 for the first key).
+            Internal node layout: [prefix length][prefix bytes] followed by [length][bytes] for each separator
+            with the node prefix removed. Separator keys[i] is a lower bound for every key under children[i + 1].
+
+            @tparam Value Value type stored in the leaves; must be trivially copyable.
+            @tparam NodeBytes Byte budget for the encoded entries of one node (at least 2048).
+        */
+        template <typename Value, std::size_t NodeBytes = 4096>
+        class PrefixBPlusTree
+        {
+            static_assert(NodeBytes >= 2048, "A node must hold enough maximal entries for every split half to fit");
+
+        public:
+            /** @brief Longest key accepted by insert(). */
+            static const std::size_t maxKeyLength = 255;
+
+            /** @brief Most children of one internal node, independent of how well the separators compress. */
+            static constexpr int maxFanout() { return (int)(NodeBytes / 16); }
+
+            /** @brief Common header of leaf and internal nodes. */
+            struct Node
+            {
+                bool isLeaf;                    ///< Indicates if the node is a leaf.
+                int keyCount;                   ///< Number of keys (leaves) or separators (internal nodes).
+                std::size_t usedBytes;          ///< Bytes of data in use.
+            };
+
+            /** @brief Leaf node: front-coded keys with their values and a link to the next leaf. */
+            struct LeafNode : Node
+            {
+                LeafNode* next;                         ///< Next leaf in key order, or nullptr.
+                unsigned char data[NodeBytes];          ///< Encoded entries.
+            };
+
+            /** @brief Internal node: prefix-truncated separators and child pointers. */
+            struct InternalNode : Node
+            {
+                Node* children[NodeBytes / 16 + 1];     ///< Child pointers, one more than separators.
+                unsigned char data[NodeBytes];          ///< Node prefix followed by the separator remainders.
+            };
+
+            /**
+                @class Iterator
+                @brief Forward iterator over the keys in ascending byte order.
+
+                The current key is rebuilt from the front-coded leaf while advancing. Modifying the tree
+                invalidates all iterators.
+            */
+            class Iterator
+            {
+            public:
+                /** @brief Creates an iterator at the first entry of fiLeaf (nullptr means end). */
+                explicit Iterator(const LeafNode* fiLeaf = nullptr) : leaf(fiLeaf), offset(0), nextOffset(0), index(0), currentValue()
+                {
+                    skipExhaustedLeaf();
+                    decodeCurrent();
+                }
+
+                /** @brief Returns true while the iterator points at an entry. */
+                bool valid() const { return leaf != nullptr; }
+
+                /** @brief Returns the key of the current entry; the iterator must be valid. */
+                const std::string& key() const { return currentKey; }
+
+                /** @brief Returns the value of the current entry; the iterator must be valid. */
+                const Value& value() const { return currentValue; }
+
+                /** @brief Returns true if the current key starts with fiPrefix. */
+                bool keyStartsWith(const char* fiPrefix) const
+                {
+                    std::size_t length = std::strlen(fiPrefix);
+                    return currentKey.size() >= length && std::memcmp(currentKey.data(), fiPrefix, length) == 0;
+                }
+
+                /** @brief Advances to the next entry in key order. */
+                Iterator& operator++()
+                {
+                    offset = nextOffset;
+                    index++;
+                    if (index >= leaf->keyCount) {
+                        leaf = leaf->next;
+                        offset = 0;
+                        index = 0;
+                        currentKey.clear();
+                        skipExhaustedLeaf();
+                    }
+                    decodeCurrent();
+                    return *this;
+                }
+
+                bool operator==(const Iterator& fiOther) const { return leaf == fiOther.leaf && index == fiOther.index; }
+                bool operator!=(const Iterator& fiOther) const { return !(*this == fiOther); }
+
+            private:
+                const LeafNode* leaf;           ///< Current leaf, nullptr at the end.
+                std::size_t offset;             ///< Byte offset of the current entry in the leaf.
+                std::size_t nextOffset;         ///< Byte offset of the following entry.
+                int index;                      ///< Entry index inside the current leaf.
+                std::string currentKey;         ///< Rebuilt key of the current entry.
+                Value currentValue;             ///< Value of the current entry.
+
+                void skipExhaustedLeaf()
+                {
+                    while (leaf != nullptr && leaf->keyCount == 0) {leaf = leaf->next;}
+                    if (leaf == nullptr) {index = 0;}
+                }
+
+                void decodeCurrent()
+                {
+                    if (leaf == nullptr) {return;}
+                    const unsigned char* entry = leaf->data + offset;
+                    std::size_t shared = entry[0];
+                    std::size_t suffixLength = entry[1];
+                    currentKey.resize(shared);
+                    currentKey.append(reinterpret_cast<const char*>(entry + 2), suffixLength);
+                    std::memcpy(&currentValue, entry + 2 + suffixLength, sizeof(Value));
+                    nextOffset = offset + 2 + suffixLength + sizeof(Value);
+                }
+
+                friend class PrefixBPlusTree;
+            };
+
+            /** @brief Creates an empty tree. */
+            PrefixBPlusTree() : root(nullptr), keyCount(0), treeHeight(0) {}
+
+            /** @brief Frees every node of the tree. */
+            ~PrefixBPlusTree() { clear(); }
+
+            PrefixBPlusTree(const PrefixBPlusTree&) = delete;
+            PrefixBPlusTree& operator=(const PrefixBPlusTree&) = delete;
+
+            /** @brief Removes all keys and frees every node. */
+            void clear()
+            {
+                destroy(root);
+                root = nullptr;
+                keyCount = 0;
+                treeHeight = 0;
+            }
+
+            /** @brief Returns the number of stored keys. */
+            std::size_t size() const { return keyCount; }
+
+            /** @brief Returns true if the tree holds no keys. */
+            bool empty() const { return keyCount == 0; }
+
+            /** @brief Returns the number of levels (0 for an empty tree, 1 for a single leaf). */
+            int height() const { return treeHeight; }
+
+            /**
+             * @brief Returns the number of encoded bytes in use across all nodes.
+             *
+             * Comparing it with the total key length shows how much front coding and prefix truncation save.
+             */
+            std::size_t encodedBytes() const { return countBytes(root); }
+
+            /**
+             * @brief Inserts a key or replaces the value of an existing key.
+             *
+             * @param fiKey The key, at most maxKeyLength bytes.
+             * @param fiValue The value to associate with the key.
+             * @return true if the key was new, false if an existing value was replaced or the key is too long.
+             */
+            bool insert(const char* fiKey, const Value& fiValue)
+            {
+                std::size_t length = std::strlen(fiKey);
+                if (length > maxKeyLength) {return false;}
+                std::string key(fiKey, length);
+
+                if (root == nullptr) {
+                    root = newLeaf();
+                    treeHeight = 1;
+                }
+
+                std::string separator;
+                Node* sibling = nullptr;
+                bool inserted = insertInto(root, key, fiValue, &separator, &sibling);
+                if (sibling != nullptr) {
+                    // The root split: grow the tree by one level
+                    InternalNode* newRoot = newInternal();
+                    std::vector<std::string> separators(1, separator);
+                    encodeInternal(newRoot, separators, 0, 1);
+                    newRoot->children[0] = root;
+                    newRoot->children[1] = sibling;
+                    root = newRoot;
+                    treeHeight++;
+                }
+
+                if (inserted) {keyCount++;}
+                return inserted;
+            }
+
+            /**
+             * @brief Looks up a key.
+             *
+             * @param fiKey The key to look up.
+             * @param foValue Output for the associated value; may be nullptr.
+             * @return true if the key is present, false otherwise.
+             */
+            bool find(const char* fiKey, Value* foValue) const
+            {
+                Iterator it = lowerBound(fiKey);
+                if (!it.valid() || it.key() != fiKey) {return false;}
+                if (foValue != nullptr) {*foValue = it.value();}
+                return true;
+            }
+
+            /**
+             * @brief Returns true if the key is present.
+             * @param fiKey The key to look up.
+             */
+            bool contains(const char* fiKey) const { return find(fiKey, nullptr); }
+
+            /** @brief Returns an iterator to the smallest key. */
+            Iterator begin() const
+            {
+                const Node* node = root;
+                if (node == nullptr) {return end();}
+                while (!node->isLeaf) {
+                    node = static_cast<const InternalNode*>(node)->children[0];
+                }
+                return Iterator(static_cast<const LeafNode*>(node));
+            }
+
+            /** @brief Returns the past-the-end iterator. */
+            Iterator end() const { return Iterator(); }
+
+            /**
+             * @brief Returns an iterator to the first key that is not less than fiKey.
+             *
+             * With a prefix as fiKey this is the first key carrying that prefix, if any; iterate while
+             * Iterator::keyStartsWith() holds to enumerate all of them in order.
+             */
+            Iterator lowerBound(const char* fiKey) const
+            {
+                const Node* node = root;
+                if (node == nullptr) {return end();}
+                std::size_t length = std::strlen(fiKey);
+                while (!node->isLeaf) {
+                    const InternalNode* internal = static_cast<const InternalNode*>(node);
+                    node = internal->children[childIndexFor(internal, fiKey, length)];
+                }
+
+                Iterator it(static_cast<const LeafNode*>(node));
+                while (it.valid() && compareBytes(it.key().data(), it.key().size(), fiKey, length) < 0) {++it;}
+                return it;
+            }
+
+            /**
+             * @brief Replaces the contents of the tree with sorted key/value pairs, building it bottom-up.
+             *
+             * Leaves are filled with front-coded entries up to the node budget and linked in order, then each
+             * internal level is built over the level below from the shortest separators between neighbouring
+             * nodes, so loading n keys encodes every node once instead of decoding a leaf per inserted key.
+             *
+             * @param fiKeys Keys in strictly ascending byte order, each at most maxKeyLength bytes.
+             * @param fiValues Values, parallel to fiKeys.
+             * @return true on success, false if the keys are not strictly ascending or one is too long (the tree is left unchanged).
+             */
+            bool bulkLoad(const std::vector<std::string>& fiKeys, const std::vector<Value>& fiValues)
+            {
+                if (fiKeys.size() != fiValues.size()) {return false;}
+                for (std::size_t i = 0; i < fiKeys.size(); i++) {
+                    if (fiKeys[i].size() > maxKeyLength) {return false;}
+                    if (i > 0 && !(fiKeys[i - 1] < fiKeys[i])) {return false;}
+                }
+
+                clear();
+                if (fiKeys.empty()) {return true;}
+
+                // separators[i] splits level[i] from level[i + 1]
+                std::vector<Node*> level;
+                std::vector<std::string> separators;
+                LeafNode* previous = nullptr;
+                std::size_t begin = 0;
+                while (begin < fiKeys.size()) {
+                    std::size_t end = begin;
+                    std::size_t bytes = 0;
+                    while (end < fiKeys.size()) {
+                        std::size_t shared = end == begin ? 0 : commonPrefixLength(fiKeys[end - 1], fiKeys[end]);
+                        std::size_t entryBytes = 2 + fiKeys[end].size() - shared + sizeof(Value);
+                        if (bytes + entryBytes > NodeBytes) {break;}
+                        bytes += entryBytes;
+                        end++;
+                    }
+
+                    LeafNode* leaf = newLeaf();
+                    encodeLeaf(leaf, fiKeys, fiValues, begin, end);
+                    if (previous != nullptr) {
+                        previous->next = leaf;
+                        separators.push_back(shortestSeparator(fiKeys[begin - 1], fiKeys[begin]));
+                    }
+                    previous = leaf;
+                    level.push_back(leaf);
+                    begin = end;
+                }
+                treeHeight = 1;
+
+                while (level.size() > 1) {
+                    std::vector<Node*> parents;
+                    std::vector<std::string> parentSeparators;
+                    std::size_t first = 0;
+                    while (first < level.size()) {
+                        // Children [first, last] with separators [first, last); the encoded size is tracked as
+                        // 1 + prefix + sum(1 + length - prefix) while separators are added
+                        std::size_t last = first;
+                        std::size_t lengths = 0;
+                        while (last + 1 < level.size() && (int)(last - first) < maxFanout()) {
+                            std::size_t count = last - first + 1;
+                            std::size_t prefixLength = commonPrefixLength(separators[first], separators[last]);
+                            std::size_t bytes = 1 + prefixLength + count + lengths + separators[last].size() - count * prefixLength;
+                            if (bytes > NodeBytes) {break;}
+                            lengths += separators[last].size();
+                            last++;
+                        }
+
+                        InternalNode* parent = newInternal();
+                        encodeInternal(parent, separators, first, last);
+                        std::copy(level.begin() + first, level.begin() + last + 1, parent->children);
+                        if (!parents.empty()) {parentSeparators.push_back(separators[first - 1]);}
+                        parents.push_back(parent);
+                        first = last + 1;
+                    }
+                    level.swap(parents);
+                    separators.swap(parentSeparators);
+                    treeHeight++;
+                }
+
+                root = level[0];
+                keyCount = fiKeys.size();
+                return true;
+            }
+
+        private:
+            Node* root;                 ///< Root node, nullptr for an empty tree.
+            std::size_t keyCount;       ///< Number of stored keys.
+            int treeHeight;             ///< Number of levels.
+
+            /** @brief Lexicographic byte comparison of two strings of known length. */
+            static int compareBytes(const char* fiLeft, std::size_t fiLeftLength, const char* fiRight, std::size_t fiRightLength)
+            {
+                int result = std::memcmp(fiLeft, fiRight, fiLeftLength < fiRightLength ? fiLeftLength : fiRightLength);
+                if (result != 0) {return result;}
+                return fiLeftLength < fiRightLength ? -1 : (fiLeftLength > fiRightLength ? 1 : 0);
+            }
+
+            /** @brief Returns the length of the common prefix of two strings. */
+            static std::size_t commonPrefixLength(const std::string& fiLeft, const std::string& fiRight)
+            {
+                std::size_t length = 0;
+                while (length < fiLeft.size() && length < fiRight.size() && fiLeft[length] == fiRight[length]) {length++;}
+                return length;
+            }
+
+            /**
+             * @brief Returns the index of the child that may contain fiKey, i.e. the number of separators <= fiKey.
+             *
+             * The probe is compared with the node prefix once; only if it carries the prefix are the separator
+             * remainders scanned.
+             */
+            static int childIndexFor(const InternalNode* fiNode, const char* fiKey, std::size_t fiLength)
+            {
+                const unsigned char* position = fiNode->data;
+                std::size_t prefixLength = *position++;
+                const char* prefix = reinterpret_cast<const char*>(position);
+                position += prefixLength;
+
+                std::size_t shared = fiLength < prefixLength ? fiLength : prefixLength;
+                int prefixOrder = std::memcmp(fiKey, prefix, shared);
+                if (prefixOrder < 0 || (prefixOrder == 0 && fiLength < prefixLength)) {return 0;}
+                if (prefixOrder > 0) {return fiNode->keyCount;}
+
+                const char* rest = fiKey + prefixLength;
+                std::size_t restLength = fiLength - prefixLength;
+                int index = 0;
+                for (; index < fiNode->keyCount; index++) {
+                    std::size_t separatorLength = *position++;
+                    if (compareBytes(rest, restLength, reinterpret_cast<const char*>(position), separatorLength) < 0) {break;}
+                    position += separatorLength;
+                }
+                return index;
+            }
+
+            static void decodeLeaf(const LeafNode* fiLeaf, std::vector<std::string>* foKeys, std::vector<Value>* foValues)
+            {
+                for (Iterator it(fiLeaf); it.valid() && it.leaf == fiLeaf; ++it) {
+                    foKeys->push_back(it.key());
+                    foValues->push_back(it.value());
+                }
+            }
+
+            static std::size_t encodedLeafSize(const std::vector<std::string>& fiKeys, std::size_t fiBegin, std::size_t fiEnd)
+            {
+                std::size_t bytes = 0;
+                for (std::size_t i = fiBegin; i < fiEnd; i++) {
+                    std::size_t shared = i == fiBegin ? 0 : commonPrefixLength(fiKeys[i - 1], fiKeys[i]);
+                    bytes += 2 + fiKeys[i].size() - shared + sizeof(Value);
+                }
+                return bytes;
+            }
+
+            static void encodeLeaf(LeafNode* fiLeaf, const std::vector<std::string>& fiKeys, const std::vector<Value>& fiValues,
+                                   std::size_t fiBegin, std::size_t fiEnd)
+            {
+                unsigned char* position = fiLeaf->data;
+                for (std::size_t i = fiBegin; i < fiEnd; i++) {
+                    std::size_t shared = i == fiBegin ? 0 : commonPrefixLength(fiKeys[i - 1], fiKeys[i]);
+                    std::size_t suffixLength = fiKeys[i].size() - shared;
+                    *position++ = (unsigned char)shared;
+                    *position++ = (unsigned char)suffixLength;
+                    std::memcpy(position, fiKeys[i].data() + shared, suffixLength);
+                    position += suffixLength;
+                    std::memcpy(position, &fiValues[i], sizeof(Value));
+                    position += sizeof(Value);
+                }
+                fiLeaf->keyCount = (int)(fiEnd - fiBegin);
+                fiLeaf->usedBytes = (std::size_t)(position - fiLeaf->data);
+            }
+
+            static void decodeInternal(const InternalNode* fiNode, std::vector<std::string>* foSeparators)
+            {
+                const unsigned char* position = fiNode->data;
+                std::size_t prefixLength = *position++;
+                std::string prefix(reinterpret_cast<const char*>(position), prefixLength);
+                position += prefixLength;
+                for (int i = 0; i < fiNode->keyCount; i++) {
+                    std::size_t length = *position++;
+                    foSeparators->push_back(prefix + std::string(reinterpret_cast<const char*>(position), length));
+                    position += length;
+                }
+            }
+
+            static std::size_t encodedInternalSize(const std::vector<std::string>& fiSeparators, std::size_t fiBegin, std::size_t fiEnd)
+            {
+                std::size_t prefixLength = fiEnd > fiBegin ? commonPrefixLength(fiSeparators[fiBegin], fiSeparators[fiEnd - 1]) : 0;
+                std::size_t bytes = 1 + prefixLength;
+                for (std::size_t i = fiBegin; i < fiEnd; i++) {
+                    bytes += 1 + fiSeparators[i].size() - prefixLength;
+                }
+                return bytes;
+            }
+
+            /**
+             * @brief Encodes separators [fiBegin, fiEnd); children are managed by the caller.
+             *
+             * Separators are sorted, so the prefix shared by all of them is the common prefix of the first and the last.
+             */
+            static void encodeInternal(InternalNode* fiNode, const std::vector<std::string>& fiSeparators, std::size_t fiBegin, std::size_t fiEnd)
+            {
+                std::size_t prefixLength = fiEnd > fiBegin ? commonPrefixLength(fiSeparators[fiBegin], fiSeparators[fiEnd - 1]) : 0;
+                unsigned char* position = fiNode->data;
+                *position++ = (unsigned char)prefixLength;
+                if (prefixLength > 0) {
+                    std::memcpy(position, fiSeparators[fiBegin].data(), prefixLength);
+                    position += prefixLength;
+                }
+                for (std::size_t i = fiBegin; i < fiEnd; i++) {
+                    std::size_t length = fiSeparators[i].size() - prefixLength;
+                    *position++ = (unsigned char)length;
+                    std::memcpy(position, fiSeparators[i].data() + prefixLength, length);
+                    position += length;
+                }
+                fiNode->keyCount = (int)(fiEnd - fiBegin);
+                fiNode->usedBytes = (std::size_t)(position - fiNode->data);
+            }
+
+            /**
+             * @brief Returns the shortest string s with fiLeft < s <= fiRight, used as the separator after a leaf split.
+             *
+             * It is the prefix of fiRight one byte longer than the common prefix of both keys.
+             */
+            static std::string shortestSeparator(const std::string& fiLeft, const std::string& fiRight)
+            {
+                return fiRight.substr(0, commonPrefixLength(fiLeft, fiRight) + 1);
+            }
+
+            /**
+             * @brief Returns the index at which [0, fiCount) is split so that both halves carry about half of fiBytes.
+             *
+             * @param fiSizes Encoded size of each entry.
+             */
+            static std::size_t balancedSplitPoint(const std::vector<std::size_t>& fiSizes, std::size_t fiBytes)
+            {
+                std::size_t running = 0;
+                std::size_t split = 1;
+                while (split < fiSizes.size() - 1 && running + fiSizes[split - 1] <= fiBytes / 2) {
+                    running += fiSizes[split - 1];
+                    split++;
+                }
+                return split;
+            }
+
+            bool insertInto(Node* fiNode, const std::string& fiKey, const Value& fiValue, std::string* foSeparator, Node** foSibling)
+            {
+                if (fiNode->isLeaf) {
+                    return insertIntoLeaf(static_cast<LeafNode*>(fiNode), fiKey, fiValue, foSeparator, foSibling);
+                }
+
+                InternalNode* internal = static_cast<InternalNode*>(fiNode);
+                int childIndex = childIndexFor(internal, fiKey.data(), fiKey.size());
+                std::string childSeparator;
+                Node* childSibling = nullptr;
+                bool inserted = insertInto(internal->children[childIndex], fiKey, fiValue, &childSeparator, &childSibling);
+                if (childSibling != nullptr) {
+                    insertIntoInternal(internal, childIndex, childSeparator, childSibling, foSeparator, foSibling);
+                }
+                return inserted;
+            }
+
+            bool insertIntoLeaf(LeafNode* fiLeaf, const std::string& fiKey, const Value& fiValue, std::string* foSeparator, Node** foSibling)
+            {
+                std::vector<std::string> keys;
+                std::vector<Value> values;
+                decodeLeaf(fiLeaf, &keys, &values);
+
+                std::size_t position = 0;
+                while (position < keys.size() && keys[position] < fiKey) {position++;}
+                if (position < keys.size() && keys[position] == fiKey) {
+                    values[position] = fiValue;
+                    encodeLeaf(fiLeaf, keys, values, 0, keys.size());
+                    return false;
+                }
+                keys.insert(keys.begin() + position, fiKey);
+                values.insert(values.begin() + position, fiValue);
+
+                std::size_t bytes = encodedLeafSize(keys, 0, keys.size());
+                if (bytes <= NodeBytes) {
+                    encodeLeaf(fiLeaf, keys, values, 0, keys.size());
+                    return true;
+                }
+
+                // Overflow: split by encoded size so both halves fit, then link the new leaf after this one
+                std::vector<std::size_t> sizes(keys.size());
+                for (std::size_t i = 0; i < keys.size(); i++) {
+                    std::size_t shared = i == 0 ? 0 : commonPrefixLength(keys[i - 1], keys[i]);
+                    sizes[i] = 2 + keys[i].size() - shared + sizeof(Value);
+                }
+                std::size_t split = balancedSplitPoint(sizes, bytes);
+
+                LeafNode* right = newLeaf();
+                encodeLeaf(fiLeaf, keys, values, 0, split);
+                encodeLeaf(right, keys, values, split, keys.size());
+                right->next = fiLeaf->next;
+                fiLeaf->next = right;
+
+                *foSeparator = shortestSeparator(keys[split - 1], keys[split]);
+                *foSibling = right;
+                return true;
+            }
+
+            void insertIntoInternal(InternalNode* fiNode, int fiChildIndex, const std::string& fiSeparator, Node* fiChild,
+                                    std::string* foSeparator, Node** foSibling)
+            {
+                std::vector<std::string> separators;
+                decodeInternal(fiNode, &separators);
+                std::vector<Node*> children(fiNode->children, fiNode->children + fiNode->keyCount + 1);
+                separators.insert(separators.begin() + fiChildIndex, fiSeparator);
+                children.insert(children.begin() + fiChildIndex + 1, fiChild);
+
+                std::size_t bytes = encodedInternalSize(separators, 0, separators.size());
+                if (bytes <= NodeBytes && (int)separators.size() <= maxFanout()) {
+                    encodeInternal(fiNode, separators, 0, separators.size());
+                    std::copy(children.begin(), children.end(), fiNode->children);
+                    return;
+                }
+
+                // Overflow: the separator at the split point moves up, each half keeps its own (at least as long) prefix
+                std::size_t prefixLength = commonPrefixLength(separators.front(), separators.back());
+                std::vector<std::size_t> sizes(separators.size());
+                for (std::size_t i = 0; i < separators.size(); i++) {
+                    sizes[i] = 1 + separators[i].size() - prefixLength;
+                }
+                std::size_t middle = balancedSplitPoint(sizes, bytes - 1 - prefixLength);
+
+                InternalNode* right = newInternal();
+                encodeInternal(fiNode, separators, 0, middle);
+                std::copy(children.begin(), children.begin() + middle + 1, fiNode->children);
+                encodeInternal(right, separators, middle + 1, separators.size());
+                std::copy(children.begin() + middle + 1, children.end(), right->children);
+
+                *foSeparator = separators[middle];
+                *foSibling = right;
+            }
+
+            static std::size_t countBytes(const Node* fiNode)
+            {
+                if (fiNode == nullptr) {return 0;}
+                std::size_t bytes = fiNode->usedBytes;
+                if (!fiNode->isLeaf) {
+                    const InternalNode* internal = static_cast<const InternalNode*>(fiNode);
+                    for (int i = 0; i <= internal->keyCount; i++) {
+                        bytes += countBytes(internal->children[i]);
+                    }
+                }
+                return bytes;
+            }
+
+            static LeafNode* newLeaf()
+            {
+                LeafNode* leaf = new LeafNode;
+                leaf->isLeaf = true;
+                leaf->keyCount = 0;
+                leaf->usedBytes = 0;
+                leaf->next = nullptr;
+                return leaf;
+            }
+
+            static InternalNode* newInternal()
+            {
+                InternalNode* node = new InternalNode;
+                node->isLeaf = false;
+                node->keyCount = 0;
+                node->usedBytes = 0;
+                return node;
+            }
+
+            static void destroy(Node* fiNode)
+            {
+                if (fiNode == nullptr) {return;}
+                if (fiNode->isLeaf) {
+                    delete static_cast<LeafNode*>(fiNode);
+                    return;
+                }
+                InternalNode* internal = static_cast<InternalNode*>(fiNode);
+                for (int i = 0; i <= internal->keyCount; i++) {
+                    destroy(internal->children[i]);
+                }
+                delete internal;
+            }
+        };
+
+        template <typename Value, std::size_t NodeBytes>
+        const std::size_t PrefixBPlusTree<Value, NodeBytes>::maxKeyLength;
+    }
+}
+
+#endif // PREFIX_BPLUS_TREE_H
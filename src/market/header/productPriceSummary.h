@@ -0,0 +1,76 @@
+/**
+ * @file productPriceSummary.h
+ * @brief Per-product-name price summaries kept in a hash file next to products.bin.
+ *
+ * A summary holds the number of offers, the price sum and the cheapest and most expensive offer of one
+ * product name, so "lowest/highest price for X" is answered by reading one or two records instead of
+ * scanning and sorting products.bin. The file is an open-addressing hash table of fixed-size records: a name
+ * hashes to a slot, and linear probing reads the following slots until the name or an empty slot is found.
+ * Adding a product rewrites a single record; the table is rebuilt with twice the slots when it is three
+ * quarters full.
+ *
+ * Updates and deletes in the product menu always affect every record of a name, so a name's summary is
+ * dropped as a whole and rebuilt from the records it is given; minima and maxima never have to be
+ * recomputed from products.bin. Like the product index, the summary file is only maintained while it
+ * exists; it is created by openProductPriceSummaries().
+ */
+
+#ifndef PRODUCT_PRICE_SUMMARY_H
+#define PRODUCT_PRICE_SUMMARY_H
+
+#include "market.h"
+
+/** @brief Summary file kept next to products.bin by the product menu functions, if it exists. */
+#define PRODUCT_PRICE_SUMMARY_FILE "products.sum"
+/** @brief Identifies a summary file ("PSUM"). */
+#define PRICE_SUMMARY_FILE_MAGIC 0x4D555350u
+/** @brief Version of the summary file layout. */
+#define PRICE_SUMMARY_FILE_VERSION 1u
+/** @brief Number of slots of a new summary file. */
+#define PRICE_SUMMARY_INITIAL_SLOTS 64
+
+/**
+ * @enum PriceSummarySlotState
+ * @brief State of a slot in the summary file.
+ */
+typedef enum {
+    PRICE_SUMMARY_EMPTY = 0,        ///< Never used; ends a probe sequence.
+    PRICE_SUMMARY_USED = 1,         ///< Holds the summary of a product name.
+    PRICE_SUMMARY_DELETED = 2       ///< Held a removed summary; probing continues past it.
+} PriceSummarySlotState;
+
+/**
+ * @struct ProductPriceSummary
+ * @brief Price summary of all offers of one product name; one slot of the summary file.
+ */
+typedef struct {
+    int32_t state;              ///< A PriceSummarySlotState.
+    int32_t count;              ///< Number of offers.
+    char productName[52];       ///< Product name, zero padded (Product::productName holds at most 50 bytes).
+    float minPrice;             ///< Lowest price.
+    int32_t minVendorId;        ///< Vendor of the first offer with the lowest price.
+    float maxPrice;             ///< Highest price.
+    int32_t maxVendorId;        ///< Vendor of the first offer with the highest price.
+    double priceSum;            ///< Sum of all prices, for the average.
+} ProductPriceSummary;
+
+/**
+ * @struct PriceSummaryFileHeader
+ * @brief First 32 bytes of a summary file; the slots follow.
+ */
+typedef struct {
+    uint32_t magic;             ///< PRICE_SUMMARY_FILE_MAGIC.
+    uint32_t version;           ///< PRICE_SUMMARY_FILE_VERSION.
+    int32_t slotCount;          ///< Number of slots, a power of two.
+    int32_t usedCount;          ///< Slots holding a summary.
+    int32_t occupiedCount;      ///< Slots holding a summary or a deleted marker.
+    int32_t reserved[3];        ///< Always 0.
+} PriceSummaryFileHeader;
+
+bool buildProductPriceSummaries(const char* summaryPath, const char* productsPath);
+bool openProductPriceSummaries(const char* summaryPath, const char* productsPath);
+bool findProductPriceSummary(const char* summaryPath, const char* productName, ProductPriceSummary* foSummary);
+bool addToProductPriceSummaries(const char* summaryPath, const Product* product);
+bool removeFromProductPriceSummaries(const char* summaryPath, const char* productName);
+
+#endif // PRODUCT_PRICE_SUMMARY_H
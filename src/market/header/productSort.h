@@ -0,0 +1,62 @@
+/**
+ * @file productSort.h
+ * @brief Sorted catalog reports: products ordered by price, name or vendor, sorted on several threads.
+ *
+ * Products are not moved while sorting. Each product is represented by a 16-byte ProductSortEntry whose
+ * 64-bit key orders like the requested field, and only the entries are sorted; the result is an array of
+ * record indexes. Small catalogs are sorted on the calling thread. From PARALLEL_SORT_THRESHOLD products on,
+ * the entries are split into one run per thread, the runs are sorted concurrently and then merged pairwise,
+ * with the merges of each round also running concurrently.
+ *
+ * Every order is total: equal keys fall back to the full name where the key holds only a name prefix, and
+ * then to the record index, so the output does not depend on the number of threads.
+ *
+ * The price comparison report is the batch form of comparePricesByName(): the sorted offers and price
+ * statistics of every product name, from a single pass over the products file.
+ */
+
+#ifndef PRODUCT_SORT_H
+#define PRODUCT_SORT_H
+
+#include "market.h"
+
+/** @brief Catalogs with at least this many products are sorted on several threads. */
+#define PARALLEL_SORT_THRESHOLD 100000
+
+/** @brief Smallest run given to one thread; fewer threads are used for catalogs that would give smaller runs. */
+#define PARALLEL_SORT_MIN_RUN 32768
+
+/** @brief Report file written by the price comparison menu for all products. */
+#define PRICE_COMPARISON_REPORT_FILE "price_report.txt"
+
+/** @brief Report file written by the product menu with the whole catalog in the chosen order. */
+#define SORTED_PRODUCT_REPORT_FILE "product_report.txt"
+
+/**
+ * @enum ProductSortOrder
+ * @brief Field a catalog report is sorted by.
+ */
+typedef enum {
+    PRODUCT_SORT_BY_PRICE,      ///< Ascending price.
+    PRODUCT_SORT_BY_NAME,       ///< Product name in strcmp order, then ascending price.
+    PRODUCT_SORT_BY_VENDOR      ///< Ascending vendor ID, then ascending price.
+} ProductSortOrder;
+
+/**
+ * @struct ProductSortEntry
+ * @brief Sort key of one product and the index of its record.
+ */
+typedef struct {
+    uint64_t key;               ///< Order-preserving encoding of the sorted field(s).
+    int32_t index;              ///< Index of the product record.
+    int32_t reserved;           ///< Padding to 16 bytes, always 0.
+} ProductSortEntry;
+
+uint32_t orderedPriceBits(float price);
+void radixSortPriceKeys(PriceSortKey keys[], int n);
+int loadProductCatalog(const char* productFilePath, Product** foProducts);
+bool sortProductCatalog(const Product* products, int count, ProductSortOrder order, int threadCount, int* foOrder);
+bool writeSortedProductReport(const char* productFilePath, ProductSortOrder order, int threadCount, const char* reportPath);
+bool writePriceComparisonReport(const char* productFilePath, const char* reportPath);
+
+#endif // PRODUCT_SORT_H
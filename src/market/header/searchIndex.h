@@ -0,0 +1,106 @@
+/**
+ * @file searchIndex.h
+ * @brief Inverted index over product names, seasons and vendor names, kept in a file next to products.bin.
+ *
+ * Every product name, season, vendor name and vendor ID is a term of its field, and every term has a posting
+ * list: the ascending record numbers of the products (or vendors) that carry it. The file holds the terms in
+ * sorted order followed by the posting lists, each stored as the differences between neighbouring record
+ * numbers in variable-length bytes. An exact lookup is a binary search over the terms plus the decoding of one
+ * list, so its cost follows the number of results rather than the size of the catalog; a substring lookup
+ * reads the terms, of which there are far fewer than records. Queries of several terms intersect (or unite)
+ * the posting lists of the terms.
+ *
+ * Adding a product or vendor appends one (term, record number) entry per term to a tail after the posting area
+ * and rewrites only the header, so it costs the size of the record rather than of the catalog. Queries read the
+ * tail along with the posting lists; once it holds SEARCH_INDEX_TAIL_LIMIT entries, the next addition merges it
+ * into the posting lists by rewriting the file. Updates and deletes rewrite the data files and may move records,
+ * so the index is rebuilt. Like the product index, the search index is only maintained while it exists; it is
+ * created by openSearchIndex().
+ */
+
+#ifndef SEARCH_INDEX_H
+#define SEARCH_INDEX_H
+
+#include "market.h"
+
+/** @brief Search index kept next to products.bin and vendor.bin by the menu functions, if it exists. */
+#define SEARCH_INDEX_FILE "search.inv"
+/** @brief Identifies a search index file ("SINV"). */
+#define SEARCH_INDEX_FILE_MAGIC 0x564E4953u
+/** @brief Version of the search index file layout. */
+#define SEARCH_INDEX_FILE_VERSION 2u
+/** @brief Tail entries kept before an addition merges them into the posting lists. */
+#define SEARCH_INDEX_TAIL_LIMIT 512
+
+/**
+ * @enum SearchField
+ * @brief Field a term belongs to. Product fields post product record numbers, vendor fields vendor record numbers.
+ */
+typedef enum {
+    SEARCH_FIELD_PRODUCT_NAME = 0,  ///< Product::productName.
+    SEARCH_FIELD_SEASON = 1,        ///< Product::season.
+    SEARCH_FIELD_VENDOR_NAME = 2,   ///< Vendor::name.
+    SEARCH_FIELD_VENDOR_ID = 3      ///< Vendor::id in decimal.
+} SearchField;
+
+/**
+ * @enum SearchTermMatch
+ * @brief How a query term selects index terms.
+ */
+typedef enum {
+    SEARCH_TERM_EXACT,              ///< The index term equals the query term.
+    SEARCH_TERM_SUBSTRING           ///< The index term contains the query term.
+} SearchTermMatch;
+
+/**
+ * @struct SearchIndexTerm
+ * @brief Dictionary entry of one term; the entries are sorted by field and then by term in strcmp order.
+ */
+typedef struct {
+    int32_t field;              ///< A SearchField.
+    char term[52];              ///< The term, zero padded (the indexed fields hold at most 50 bytes).
+    uint32_t postingCount;      ///< Number of records carrying the term.
+    uint32_t postingOffset;     ///< Offset of the encoded posting list from the start of the posting area.
+    uint32_t postingBytes;      ///< Length of the encoded posting list.
+    uint32_t lastRecord;        ///< Highest record number in the list, the base for appending.
+} SearchIndexTerm;
+
+/**
+ * @struct SearchIndexTailEntry
+ * @brief Term of a record added since the posting lists were written; the entries follow the posting area.
+ */
+typedef struct {
+    int32_t field;              ///< A SearchField.
+    char term[52];              ///< The term, zero padded.
+    uint32_t record;            ///< Record number carrying the term.
+} SearchIndexTailEntry;
+
+/**
+ * @struct SearchIndexFileHeader
+ * @brief First 32 bytes of a search index file; termCount dictionary entries, the posting area and tailCount
+ *        tail entries follow.
+ */
+typedef struct {
+    uint32_t magic;             ///< SEARCH_INDEX_FILE_MAGIC.
+    uint32_t version;           ///< SEARCH_INDEX_FILE_VERSION.
+    int32_t termCount;          ///< Number of dictionary entries.
+    int32_t productCount;       ///< Product records indexed.
+    int32_t vendorCount;        ///< Vendor records indexed.
+    uint32_t postingBytes;      ///< Size of the posting area.
+    int32_t tailCount;          ///< Number of tail entries.
+    int32_t reserved;           ///< Always 0.
+} SearchIndexFileHeader;
+
+size_t encodePostingList(const uint32_t records[], int count, uint8_t* foBytes);
+int decodePostingList(const uint8_t* bytes, size_t byteCount, uint32_t* foRecords, int maxRecords);
+int intersectPostingLists(const uint32_t first[], int firstCount, const uint32_t second[], int secondCount, uint32_t* foRecords);
+
+bool buildSearchIndex(const char* indexPath, const char* productsPath, const char* vendorsPath);
+bool openSearchIndex(const char* indexPath, const char* productsPath, const char* vendorsPath);
+int querySearchIndex(const char* indexPath, const SearchField fields[], int fieldCount, const char* const terms[], int termCount,
+                     SearchTermMatch match, bool matchAll, uint32_t** foRecords);
+bool addProductToSearchIndex(const char* indexPath, const char* productsPath, const char* vendorsPath, const Product* product);
+bool addVendorToSearchIndex(const char* indexPath, const char* productsPath, const char* vendorsPath, const Vendor* vendor);
+bool refreshSearchIndex(const char* indexPath, const char* productsPath, const char* vendorsPath);
+
+#endif // SEARCH_INDEX_H
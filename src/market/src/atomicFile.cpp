@@ -0,0 +1,57 @@
+/**
+ * @file atomicFile.cpp
+ * @brief Write-to-temporary-and-rename replacement of data files.
+ */
+
+#include "../header/atomicFile.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Replaces a file with the output of a writer, atomically.
+ *
+ * The writer fills "<path>.tmp"; the file is flushed and synced to disk before it is renamed over path
+ * (MoveFileExA with MOVEFILE_WRITE_THROUGH on Windows), so path never holds a partly written file.
+ *
+ * @param path The file to replace; it does not have to exist.
+ * @param writer Writes the new contents.
+ * @param context Passed through to writer.
+ * @return true on success, false if the writer or an I/O operation failed (path is left unchanged).
+ */
+bool replaceFileAtomically(const char* path, AtomicFileWriter writer, const void* context) {
+    if (path == NULL || writer == NULL) {return false;}
+
+    size_t pathLength = strlen(path);
+    char* temporaryPath = (char*)malloc(pathLength + 5);
+    if (temporaryPath == NULL) {return false;}
+    memcpy(temporaryPath, path, pathLength);
+    memcpy(temporaryPath + pathLength, ".tmp", 5);
+
+    FILE* file = fopen(temporaryPath, "wb");
+    bool written = file != NULL;
+    if (written) {
+        written = writer(file, context) && fflush(file) == 0;
+#ifdef _WIN32
+        written = written && _commit(_fileno(file)) == 0;
+#else
+        written = written && fsync(fileno(file)) == 0;
+#endif
+        written = fclose(file) == 0 && written;
+    }
+#ifdef _WIN32
+    written = written && MoveFileExA(temporaryPath, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    written = written && rename(temporaryPath, path) == 0;
+#endif
+    if (!written) {remove(temporaryPath);}
+    free(temporaryPath);
+    return written;
+}
@@ -0,0 +1,178 @@
+/**
+ * @file bPlusTreeSearch.cpp
+ * @brief Scalar, SSE2 and AVX2 key search inside B+ tree nodes with int keys.
+ *
+ * @details For a sorted node, lowerBound(key) equals the number of keys less than key and upperBound(key) the
+ * number of keys not greater than key. A binary search first narrows wide nodes down to a window of a few
+ * vector blocks; the vector variants then count the window without branching: a signed compare yields an
+ * all-ones lane for every key on the searched side, movemask packs the lanes into bits and a popcount adds
+ * them up. The variant is chosen once from the CPU features reported by the utility module.
+ */
+
+#include "../header/bPlusTree.h"
+#include "cpuFeatures.h"
+
+#ifdef CORUH_X86
+#include <immintrin.h>
+#endif
+
+using Coruh::Market::BPlusTreeIntSearch;
+using Coruh::Utility::CpuFeatures;
+
+/**
+ * @brief Counts the set bits of a movemask result.
+ */
+static inline int countMaskBits(unsigned int mask) {
+#if defined(_MSC_VER)
+    return (int)__popcnt(mask);
+#else
+    return __builtin_popcount(mask);
+#endif
+}
+
+/** @brief Keys left for the SSE2 block count once the binary search has narrowed the range (4 blocks of 4). */
+#define BPLUS_TREE_SSE2_WINDOW 16
+/** @brief Keys left for the AVX2 block count once the binary search has narrowed the range (4 blocks of 8). */
+#define BPLUS_TREE_AVX2_WINDOW 32
+
+/**
+ * @brief Binary search that stops once at most fiWindow candidates remain.
+ *
+ * On return every key before *foLow is on the searched side and every key from *foHigh on is not, so the
+ * answer is *foLow plus the number of searched-side keys in [*foLow, *foHigh).
+ *
+ * @param fiUpper false to search for the first key not less than fiKey, true for the first key greater than fiKey.
+ */
+static inline void narrowSearchWindow(const int* fiKeys, int fiCount, int fiKey, bool fiUpper, int fiWindow, int* foLow, int* foHigh) {
+    int low = 0;
+    int high = fiCount;
+    while (high - low > fiWindow) {
+        int mid = (low + high) / 2;
+        bool searchedSide = fiUpper ? fiKeys[mid] <= fiKey : fiKeys[mid] < fiKey;
+        if (searchedSide) {low = mid + 1;}
+        else {high = mid;}
+    }
+    *foLow = low;
+    *foHigh = high;
+}
+
+int BPlusTreeIntSearch::lowerBoundScalar(const int* fiKeys, int fiCount, int fiKey) {
+    int low, high;
+    narrowSearchWindow(fiKeys, fiCount, fiKey, false, 0, &low, &high);
+    return low;
+}
+
+int BPlusTreeIntSearch::upperBoundScalar(const int* fiKeys, int fiCount, int fiKey) {
+    int low, high;
+    narrowSearchWindow(fiKeys, fiCount, fiKey, true, 0, &low, &high);
+    return low;
+}
+
+#ifdef CORUH_X86
+
+/**
+ * @brief Counts keys in [fiLow, fiHigh) that are less than (or, with fiUpper, not greater than) fiKey, 4 at a time.
+ */
+CORUH_TARGET("sse2")
+static int countSearchedSideSse2(const int* fiKeys, int fiLow, int fiHigh, int fiKey, bool fiUpper) {
+    const __m128i key = _mm_set1_epi32(fiKey);
+    int count = 0;
+    int index = fiLow;
+    for (; index + 4 <= fiHigh; index += 4) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(fiKeys + index));
+        if (fiUpper) {
+            count += 4 - countMaskBits((unsigned int)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(block, key))));
+        }
+        else {
+            count += countMaskBits((unsigned int)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(key, block))));
+        }
+    }
+    for (; index < fiHigh; index++) {
+        count += fiUpper ? fiKeys[index] <= fiKey : fiKeys[index] < fiKey;
+    }
+    return count;
+}
+
+/**
+ * @brief Counts keys in [fiLow, fiHigh) that are less than (or, with fiUpper, not greater than) fiKey, 8 at a time.
+ */
+CORUH_TARGET("avx2")
+static int countSearchedSideAvx2(const int* fiKeys, int fiLow, int fiHigh, int fiKey, bool fiUpper) {
+    const __m256i key = _mm256_set1_epi32(fiKey);
+    int count = 0;
+    int index = fiLow;
+    for (; index + 8 <= fiHigh; index += 8) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(fiKeys + index));
+        if (fiUpper) {
+            count += 8 - countMaskBits((unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(block, key))));
+        }
+        else {
+            count += countMaskBits((unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(key, block))));
+        }
+    }
+    for (; index < fiHigh; index++) {
+        count += fiUpper ? fiKeys[index] <= fiKey : fiKeys[index] < fiKey;
+    }
+    return count;
+}
+
+int BPlusTreeIntSearch::lowerBoundSse2(const int* fiKeys, int fiCount, int fiKey) {
+    int low, high;
+    narrowSearchWindow(fiKeys, fiCount, fiKey, false, BPLUS_TREE_SSE2_WINDOW, &low, &high);
+    return low + countSearchedSideSse2(fiKeys, low, high, fiKey, false);
+}
+
+int BPlusTreeIntSearch::upperBoundSse2(const int* fiKeys, int fiCount, int fiKey) {
+    int low, high;
+    narrowSearchWindow(fiKeys, fiCount, fiKey, true, BPLUS_TREE_SSE2_WINDOW, &low, &high);
+    return low + countSearchedSideSse2(fiKeys, low, high, fiKey, true);
+}
+
+int BPlusTreeIntSearch::lowerBoundAvx2(const int* fiKeys, int fiCount, int fiKey) {
+    int low, high;
+    narrowSearchWindow(fiKeys, fiCount, fiKey, false, BPLUS_TREE_AVX2_WINDOW, &low, &high);
+    return low + countSearchedSideAvx2(fiKeys, low, high, fiKey, false);
+}
+
+int BPlusTreeIntSearch::upperBoundAvx2(const int* fiKeys, int fiCount, int fiKey) {
+    int low, high;
+    narrowSearchWindow(fiKeys, fiCount, fiKey, true, BPLUS_TREE_AVX2_WINDOW, &low, &high);
+    return low + countSearchedSideAvx2(fiKeys, low, high, fiKey, true);
+}
+
+#else
+
+int BPlusTreeIntSearch::lowerBoundSse2(const int* fiKeys, int fiCount, int fiKey) { return lowerBoundScalar(fiKeys, fiCount, fiKey); }
+int BPlusTreeIntSearch::upperBoundSse2(const int* fiKeys, int fiCount, int fiKey) { return upperBoundScalar(fiKeys, fiCount, fiKey); }
+int BPlusTreeIntSearch::lowerBoundAvx2(const int* fiKeys, int fiCount, int fiKey) { return lowerBoundScalar(fiKeys, fiCount, fiKey); }
+int BPlusTreeIntSearch::upperBoundAvx2(const int* fiKeys, int fiCount, int fiKey) { return upperBoundScalar(fiKeys, fiCount, fiKey); }
+
+#endif
+
+const char* BPlusTreeIntSearch::implementationName() {
+#ifdef CORUH_X86
+    if (CpuFeatures::hasAvx2()) {return "avx2";}
+    if (CpuFeatures::hasSse2()) {return "sse2";}
+#endif
+    return "scalar";
+}
+
+BPlusTreeIntSearch::SearchFunction BPlusTreeIntSearch::lowerBoundFunction() {
+#ifdef CORUH_X86
+    static const SearchFunction function = CpuFeatures::hasAvx2() ? lowerBoundAvx2
+                                         : CpuFeatures::hasSse2() ? lowerBoundSse2 : lowerBoundScalar;
+#else
+    static const SearchFunction function = lowerBoundScalar;
+#endif
+    return function;
+}
+
+BPlusTreeIntSearch::SearchFunction BPlusTreeIntSearch::upperBoundFunction() {
+#ifdef CORUH_X86
+    static const SearchFunction function = CpuFeatures::hasAvx2() ? upperBoundAvx2
+                                         : CpuFeatures::hasSse2() ? upperBoundSse2 : upperBoundScalar;
+#else
+    static const SearchFunction function = upperBoundScalar;
+#endif
+    return function;
+}
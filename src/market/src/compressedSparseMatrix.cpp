@@ -0,0 +1,271 @@
+/**
+ * @file compressedSparseMatrix.cpp
+ * @brief Construction and row lookup of compressed sparse row/column matrices.
+ *
+ * @details Matrices are built from the triplet list with a counting sort: the distinct major IDs are sorted
+ * once, every entry is counted into its row, the counts are turned into row pointers by a prefix sum and the
+ * entries are scattered into place. The scatter walks the triplets in order, so each row keeps the insertion
+ * order of its entries.
+ *
+ * The builder appends triplets to a buffer that doubles when full. Finalising stable-sorts the buffer by
+ * (vendor, product), so the last entry of each run of equal pairs is the most recently added one, and
+ * compacts every run to that entry.
+ */
+
+#include "../header/compressedSparseMatrix.h"
+#include <algorithm>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Returns the major ID of a triplet for the given axis.
+ */
+static int majorIdOf(const SparseMatrixEntry* entry, SparseMatrixAxis axis) {
+    return axis == SPARSE_BY_VENDOR ? entry->vendorId : entry->productId;
+}
+
+/**
+ * @brief qsort comparator for int values.
+ */
+static int compareIds(const void* left, const void* right) {
+    int a = *(const int*)left;
+    int b = *(const int*)right;
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Returns the row index of a major ID, or -1 if the matrix has no such row.
+ */
+static int findRow(const CompressedSparseMatrix* matrix, int rowId) {
+    int low = 0;
+    int high = matrix->rowCount - 1;
+    while (low <= high) {
+        int middle = low + (high - low) / 2;
+        if (matrix->rowIds[middle] == rowId) {return middle;}
+        if (matrix->rowIds[middle] < rowId) {low = middle + 1;}
+        else {high = middle - 1;}
+    }
+    return -1;
+}
+
+/**
+ * @brief Builds a compressed matrix grouping the triplets by vendor (CSR) or by product (CSC).
+ *
+ * @param entries The triplets.
+ * @param entryCount Number of triplets.
+ * @param axis Coordinate to group by.
+ * @param foMatrix The matrix to fill; it must be empty or previously freed.
+ * @return true on success, false on invalid arguments or allocation failure (foMatrix is left empty).
+ */
+bool buildCompressedSparseMatrix(const SparseMatrixEntry* entries, int entryCount, SparseMatrixAxis axis, CompressedSparseMatrix* foMatrix) {
+    if (foMatrix == NULL || entryCount < 0 || (entries == NULL && entryCount > 0)) {return false;}
+    memset(foMatrix, 0, sizeof(CompressedSparseMatrix));
+    foMatrix->axis = axis;
+
+    size_t entryBytes = (size_t)(entryCount > 0 ? entryCount : 1);
+    int* sortedIds = (int*)malloc(entryBytes * sizeof(int));
+    foMatrix->minorIds = (int*)malloc(entryBytes * sizeof(int));
+    foMatrix->prices = (float*)malloc(entryBytes * sizeof(float));
+    if (sortedIds == NULL || foMatrix->minorIds == NULL || foMatrix->prices == NULL) {
+        free(sortedIds);
+        freeCompressedSparseMatrix(foMatrix);
+        return false;
+    }
+
+    // Distinct major IDs in ascending order
+    for (int i = 0; i < entryCount; i++) {sortedIds[i] = majorIdOf(&entries[i], axis);}
+    qsort(sortedIds, (size_t)entryCount, sizeof(int), compareIds);
+    int rowCount = 0;
+    for (int i = 0; i < entryCount; i++) {
+        if (rowCount == 0 || sortedIds[rowCount - 1] != sortedIds[i]) {sortedIds[rowCount++] = sortedIds[i];}
+    }
+    foMatrix->rowIds = sortedIds;
+    foMatrix->rowCount = rowCount;
+    foMatrix->entryCount = entryCount;
+
+    foMatrix->rowPointers = (int*)calloc((size_t)rowCount + 1, sizeof(int));
+    int* fill = (int*)malloc(((size_t)rowCount + 1) * sizeof(int));
+    int* rowOfEntry = (int*)malloc(entryBytes * sizeof(int));
+    if (foMatrix->rowPointers == NULL || fill == NULL || rowOfEntry == NULL) {
+        free(fill);
+        free(rowOfEntry);
+        freeCompressedSparseMatrix(foMatrix);
+        return false;
+    }
+
+    // Count the entries of each row, then turn the counts into start offsets
+    for (int i = 0; i < entryCount; i++) {
+        rowOfEntry[i] = findRow(foMatrix, majorIdOf(&entries[i], axis));
+        foMatrix->rowPointers[rowOfEntry[i] + 1]++;
+    }
+    for (int row = 0; row < rowCount; row++) {foMatrix->rowPointers[row + 1] += foMatrix->rowPointers[row];}
+
+    // Scatter in triplet order so every row keeps its insertion order
+    memcpy(fill, foMatrix->rowPointers, ((size_t)rowCount + 1) * sizeof(int));
+    for (int i = 0; i < entryCount; i++) {
+        int position = fill[rowOfEntry[i]]++;
+        foMatrix->minorIds[position] = axis == SPARSE_BY_VENDOR ? entries[i].productId : entries[i].vendorId;
+        foMatrix->prices[position] = entries[i].price;
+    }
+
+    free(fill);
+    free(rowOfEntry);
+    return true;
+}
+
+/**
+ * @brief Releases the arrays of a compressed matrix and leaves it empty.
+ *
+ * @param matrix The matrix; NULL is ignored.
+ */
+void freeCompressedSparseMatrix(CompressedSparseMatrix* matrix) {
+    if (matrix == NULL) {return;}
+    free(matrix->rowIds);
+    free(matrix->rowPointers);
+    free(matrix->minorIds);
+    free(matrix->prices);
+    SparseMatrixAxis axis = matrix->axis;
+    memset(matrix, 0, sizeof(CompressedSparseMatrix));
+    matrix->axis = axis;
+}
+
+/**
+ * @brief Returns the entries of one row: the products of a vendor (CSR) or the vendors of a product (CSC).
+ *
+ * @param matrix The matrix.
+ * @param rowId The vendor ID or product ID, depending on the matrix axis.
+ * @param foMinorIds Receives a pointer to the row's minor IDs; may be NULL.
+ * @param foPrices Receives a pointer to the row's prices; may be NULL.
+ * @return Number of entries in the row, 0 if the ID has none.
+ */
+int compressedSparseMatrixRow(const CompressedSparseMatrix* matrix, int rowId, const int** foMinorIds, const float** foPrices) {
+    int row = matrix == NULL ? -1 : findRow(matrix, rowId);
+    if (row < 0) {
+        if (foMinorIds != NULL) {*foMinorIds = NULL;}
+        if (foPrices != NULL) {*foPrices = NULL;}
+        return 0;
+    }
+    int start = matrix->rowPointers[row];
+    if (foMinorIds != NULL) {*foMinorIds = matrix->minorIds + start;}
+    if (foPrices != NULL) {*foPrices = matrix->prices + start;}
+    return matrix->rowPointers[row + 1] - start;
+}
+
+/**
+ * @brief Initialises an empty builder.
+ *
+ * @param builder The builder.
+ * @param initialCapacity Number of triplets to allocate up front; 0 selects SPARSE_BUILDER_DEFAULT_CAPACITY.
+ * @return true on success, false on invalid arguments or allocation failure.
+ */
+bool initSparseMatrixBuilder(SparseMatrixBuilder* builder, int initialCapacity) {
+    if (builder == NULL || initialCapacity < 0) {return false;}
+    memset(builder, 0, sizeof(SparseMatrixBuilder));
+    builder->finalized = true;
+    return sparseMatrixBuilderReserve(builder, initialCapacity > 0 ? initialCapacity : SPARSE_BUILDER_DEFAULT_CAPACITY);
+}
+
+/**
+ * @brief Releases the buffer of a builder and leaves it empty.
+ *
+ * @param builder The builder; NULL is ignored.
+ */
+void freeSparseMatrixBuilder(SparseMatrixBuilder* builder) {
+    if (builder == NULL) {return;}
+    free(builder->entries);
+    memset(builder, 0, sizeof(SparseMatrixBuilder));
+    builder->finalized = true;
+}
+
+/**
+ * @brief Makes room for at least capacity triplets, e.g. before loading a whole relation feed.
+ *
+ * @param builder The builder.
+ * @param capacity Required number of triplets.
+ * @return true on success, false on allocation failure (the buffer is unchanged).
+ */
+bool sparseMatrixBuilderReserve(SparseMatrixBuilder* builder, int capacity) {
+    if (builder == NULL || capacity < 0) {return false;}
+    if (capacity <= builder->capacity) {return true;}
+    SparseMatrixEntry* entries = (SparseMatrixEntry*)realloc(builder->entries, (size_t)capacity * sizeof(SparseMatrixEntry));
+    if (entries == NULL) {return false;}
+    builder->entries = entries;
+    builder->capacity = capacity;
+    return true;
+}
+
+/**
+ * @brief Appends a triplet, doubling the buffer when it is full.
+ *
+ * Duplicate (vendor, product) pairs are kept until the builder is finalised.
+ *
+ * @param builder The builder.
+ * @param vendorId The ID of the vendor.
+ * @param productId The ID of the product.
+ * @param price The price of the product from the vendor.
+ * @return true on success, false if the buffer cannot grow.
+ */
+bool sparseMatrixBuilderAdd(SparseMatrixBuilder* builder, int vendorId, int productId, float price) {
+    if (builder == NULL) {return false;}
+    if (builder->entryCount == builder->capacity) {
+        if (builder->capacity > INT_MAX / 2) {return false;}
+        int capacity = builder->capacity > 0 ? builder->capacity * 2 : SPARSE_BUILDER_DEFAULT_CAPACITY;
+        if (!sparseMatrixBuilderReserve(builder, capacity)) {return false;}
+    }
+    SparseMatrixEntry* entry = &builder->entries[builder->entryCount++];
+    entry->vendorId = vendorId;
+    entry->productId = productId;
+    entry->price = price;
+    builder->finalized = false;
+    return true;
+}
+
+/**
+ * @brief Sorts the triplets by (vendor, product) and keeps only the most recently added price of each pair.
+ *
+ * Does nothing if no triplet was added since the last call.
+ *
+ * @param builder The builder.
+ * @return Number of distinct triplets left, or -1 if builder is NULL.
+ */
+int finalizeSparseMatrixBuilder(SparseMatrixBuilder* builder) {
+    if (builder == NULL) {return -1;}
+    if (builder->finalized) {return builder->entryCount;}
+
+    // A stable sort keeps equal pairs in insertion order, so the last of each run is the latest write
+    std::stable_sort(builder->entries, builder->entries + builder->entryCount,
+        [](const SparseMatrixEntry& lhs, const SparseMatrixEntry& rhs) {
+            if (lhs.vendorId != rhs.vendorId) {return lhs.vendorId < rhs.vendorId;}
+            return lhs.productId < rhs.productId;
+        });
+
+    int unique = 0;
+    for (int i = 0; i < builder->entryCount; i++) {
+        if (unique > 0 && builder->entries[unique - 1].vendorId == builder->entries[i].vendorId &&
+            builder->entries[unique - 1].productId == builder->entries[i].productId) {
+            builder->entries[unique - 1].price = builder->entries[i].price;
+        }
+        else {
+            builder->entries[unique++] = builder->entries[i];
+        }
+    }
+    builder->entryCount = unique;
+    builder->finalized = true;
+    return unique;
+}
+
+/**
+ * @brief Finalises the builder and builds a compressed view of its triplets.
+ *
+ * The builder stays usable; relations added later appear after the next freeze.
+ *
+ * @param builder The builder.
+ * @param axis Coordinate to group by.
+ * @param foMatrix The matrix to fill; it must be empty or previously freed.
+ * @return true on success, false on invalid arguments or allocation failure.
+ */
+bool freezeSparseMatrixBuilder(SparseMatrixBuilder* builder, SparseMatrixAxis axis, CompressedSparseMatrix* foMatrix) {
+    if (finalizeSparseMatrixBuilder(builder) < 0) {return false;}
+    return buildCompressedSparseMatrix(builder->entries, builder->entryCount, axis, foMatrix);
+}
@@ -0,0 +1,546 @@
+/**
+ * @file extendibleHash.cpp
+ * @brief Disk-resident extendible hashing file for products keyed by vendor ID.
+ *
+ * @details Bucket pages are HASH_PAGE_SIZE bytes and are addressed by page id (offset = id * HASH_PAGE_SIZE).
+ * The directory maps the low globalDepth bits of a vendor hash to a bucket page. When a bucket page fills up
+ * it is split in two by one more hash bit, doubling the directory if the bucket was already at global depth.
+ * A bucket whose products all share one hash (typically one large vendor) cannot be separated by splitting,
+ * so it grows a chain of overflow pages instead. Every product of a vendor therefore lives in a single chain:
+ * a lookup or a scan reads one page for a vendor that fits a page, and one page per HASH_BUCKET_CAPACITY
+ * products for a vendor that does not.
+ */
+
+#include "../header/extendibleHash.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** @brief Magic number identifying a directory sidecar file. */
+#define HASH_DIRECTORY_MAGIC 0x48534844
+
+static_assert(sizeof(HashBucketPage) == HASH_PAGE_SIZE, "HashBucketPage must fill exactly one page");
+
+/**
+ * @brief Mixes a vendor ID into a well distributed 32-bit hash.
+ *
+ * Vendor IDs are often sequential, so the low bits used by the directory are scrambled first.
+ *
+ * @param vendorId The vendor ID to hash.
+ * @return The 32-bit hash value.
+ */
+static uint32_t hashVendorId(int vendorId) {
+    uint32_t x = (uint32_t)vendorId;
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+/**
+ * @brief Positions the data file at the start of a page.
+ *
+ * @param file The data file.
+ * @param pageId The page to seek to.
+ * @return true on success, false otherwise.
+ */
+static bool seekHashPage(FILE* file, int32_t pageId) {
+#ifdef _WIN32
+    return _fseeki64(file, (int64_t)pageId * HASH_PAGE_SIZE, SEEK_SET) == 0;
+#else
+    return fseeko(file, (off_t)pageId * HASH_PAGE_SIZE, SEEK_SET) == 0;
+#endif
+}
+
+/**
+ * @brief Reads one bucket page from disk.
+ *
+ * @param hashFile The hash file.
+ * @param pageId The page to read.
+ * @param page Output buffer for the page.
+ * @return true on success, false otherwise.
+ */
+static bool readBucketPage(ExtendibleHashFile* hashFile, int32_t pageId, HashBucketPage* page) {
+    if (!seekHashPage(hashFile->dataFile, pageId)) {return false;}
+    hashFile->pageReads++;
+    return fread(page, sizeof(HashBucketPage), 1, hashFile->dataFile) == 1;
+}
+
+/**
+ * @brief Writes one bucket page to disk.
+ *
+ * @param hashFile The hash file.
+ * @param pageId The page to write.
+ * @param page The page contents.
+ * @return true on success, false otherwise.
+ */
+static bool writeBucketPage(ExtendibleHashFile* hashFile, int32_t pageId, const HashBucketPage* page) {
+    if (!seekHashPage(hashFile->dataFile, pageId)) {return false;}
+    return fwrite(page, sizeof(HashBucketPage), 1, hashFile->dataFile) == 1;
+}
+
+/**
+ * @brief Resets a page buffer to an empty bucket.
+ *
+ * @param page The page buffer.
+ * @param localDepth The local depth of the bucket.
+ */
+static void initializeBucketPage(HashBucketPage* page, int32_t localDepth) {
+    memset(page, 0, sizeof(HashBucketPage));
+    page->localDepth = localDepth;
+    page->overflowPage = HASH_NO_PAGE;
+}
+
+/**
+ * @brief Returns a page id for a new page, reusing released pages first.
+ *
+ * @param hashFile The hash file.
+ * @return The allocated page id.
+ */
+static int32_t allocateBucketPage(ExtendibleHashFile* hashFile) {
+    if (hashFile->freePageCount > 0) {
+        return hashFile->freePages[--hashFile->freePageCount];
+    }
+    return hashFile->pageCount++;
+}
+
+/**
+ * @brief Adds a page id to the free page list.
+ *
+ * @param hashFile The hash file.
+ * @param pageId The page that is no longer referenced.
+ * @return true on success, false if the list could not grow.
+ */
+static bool releaseBucketPage(ExtendibleHashFile* hashFile, int32_t pageId) {
+    if (hashFile->freePageCount == hashFile->freePageCapacity) {
+        int32_t newCapacity = hashFile->freePageCapacity == 0 ? 16 : hashFile->freePageCapacity * 2;
+        int32_t* grown = (int32_t*)realloc(hashFile->freePages, newCapacity * sizeof(int32_t));
+        if (grown == NULL) {return false;}
+        hashFile->freePages = grown;
+        hashFile->freePageCapacity = newCapacity;
+    }
+    hashFile->freePages[hashFile->freePageCount++] = pageId;
+    return true;
+}
+
+/**
+ * @brief Writes the directory and free page list to the sidecar file.
+ *
+ * @param hashFile The hash file.
+ * @return true on success, false otherwise.
+ */
+static bool saveHashDirectory(ExtendibleHashFile* hashFile) {
+    FILE* directoryFile = fopen(hashFile->directoryPath, "wb");
+    if (directoryFile == NULL) {return false;}
+
+    int32_t header[4] = { HASH_DIRECTORY_MAGIC, hashFile->globalDepth, hashFile->pageCount, hashFile->freePageCount };
+    size_t directorySize = (size_t)1 << hashFile->globalDepth;
+    bool ok = fwrite(header, sizeof(header), 1, directoryFile) == 1 &&
+              fwrite(hashFile->directory, sizeof(int32_t), directorySize, directoryFile) == directorySize &&
+              fwrite(hashFile->freePages, sizeof(int32_t), hashFile->freePageCount, directoryFile) == (size_t)hashFile->freePageCount;
+    fflush(hashFile->dataFile);
+    return fclose(directoryFile) == 0 && ok;
+}
+
+/**
+ * @brief Loads the directory and free page list from the sidecar file.
+ *
+ * @param hashFile The hash file.
+ * @return true if a valid directory was loaded, false otherwise.
+ */
+static bool loadHashDirectory(ExtendibleHashFile* hashFile) {
+    FILE* directoryFile = fopen(hashFile->directoryPath, "rb");
+    if (directoryFile == NULL) {return false;}
+
+    int32_t header[4];
+    bool ok = fread(header, sizeof(header), 1, directoryFile) == 1 && header[0] == HASH_DIRECTORY_MAGIC &&
+              header[1] >= 0 && header[1] <= HASH_MAX_GLOBAL_DEPTH && header[2] > 0 && header[3] >= 0;
+    if (ok) {
+        size_t directorySize = (size_t)1 << header[1];
+        hashFile->globalDepth = header[1];
+        hashFile->pageCount = header[2];
+        hashFile->directory = (int32_t*)malloc(directorySize * sizeof(int32_t));
+        hashFile->freePageCapacity = header[3] > 0 ? header[3] : 16;
+        hashFile->freePages = (int32_t*)malloc(hashFile->freePageCapacity * sizeof(int32_t));
+        hashFile->freePageCount = header[3];
+        ok = hashFile->directory != NULL && hashFile->freePages != NULL &&
+             fread(hashFile->directory, sizeof(int32_t), directorySize, directoryFile) == directorySize &&
+             fread(hashFile->freePages, sizeof(int32_t), hashFile->freePageCount, directoryFile) == (size_t)hashFile->freePageCount;
+    }
+
+    fclose(directoryFile);
+    return ok;
+}
+
+/**
+ * @brief Opens an extendible hash file, creating an empty one if it does not exist.
+ *
+ * @param path Path of the bucket page file; the directory is stored in "<path>.dir".
+ * @return Pointer to the open hash file, or NULL on failure.
+ */
+ExtendibleHashFile* openExtendibleHashFile(const char* path) {
+    ExtendibleHashFile* hashFile = (ExtendibleHashFile*)calloc(1, sizeof(ExtendibleHashFile));
+    if (hashFile == NULL) {return NULL;}
+    snprintf(hashFile->directoryPath, sizeof(hashFile->directoryPath), "%s.dir", path);
+
+    hashFile->dataFile = fopen(path, "r+b");
+    if (hashFile->dataFile != NULL && loadHashDirectory(hashFile)) {
+        return hashFile;
+    }
+
+    // Missing or inconsistent files: start over with a single empty bucket at depth 0
+    if (hashFile->dataFile != NULL) {fclose(hashFile->dataFile);}
+    free(hashFile->directory);
+    free(hashFile->freePages);
+    hashFile->directory = NULL;
+    hashFile->freePages = NULL;
+    hashFile->freePageCount = 0;
+    hashFile->freePageCapacity = 0;
+
+    hashFile->dataFile = fopen(path, "w+b");
+    hashFile->directory = (int32_t*)malloc(sizeof(int32_t));
+    if (hashFile->dataFile == NULL || hashFile->directory == NULL) {
+        if (hashFile->dataFile != NULL) {fclose(hashFile->dataFile);}
+        free(hashFile->directory);
+        free(hashFile);
+        return NULL;
+    }
+
+    HashBucketPage page;
+    initializeBucketPage(&page, 0);
+    hashFile->globalDepth = 0;
+    hashFile->pageCount = 0;
+    hashFile->directory[0] = allocateBucketPage(hashFile);
+    if (!writeBucketPage(hashFile, hashFile->directory[0], &page) || !saveHashDirectory(hashFile)) {
+        closeExtendibleHashFile(hashFile);
+        return NULL;
+    }
+    return hashFile;
+}
+
+/**
+ * @brief Flushes the directory and closes the hash file.
+ *
+ * @param hashFile The hash file to close; the handle is freed.
+ * @return true if everything was written successfully, false otherwise.
+ */
+bool closeExtendibleHashFile(ExtendibleHashFile* hashFile) {
+    if (hashFile == NULL) {return false;}
+    bool ok = saveHashDirectory(hashFile);
+    if (fclose(hashFile->dataFile) != 0) {ok = false;}
+    free(hashFile->directory);
+    free(hashFile->freePages);
+    free(hashFile);
+    return ok;
+}
+
+/**
+ * @brief Doubles the directory so that it is indexed by one more hash bit.
+ *
+ * @param hashFile The hash file.
+ * @return true on success, false if the maximum depth is reached or memory runs out.
+ */
+static bool doubleHashDirectory(ExtendibleHashFile* hashFile) {
+    if (hashFile->globalDepth >= HASH_MAX_GLOBAL_DEPTH) {return false;}
+    size_t oldSize = (size_t)1 << hashFile->globalDepth;
+    int32_t* grown = (int32_t*)realloc(hashFile->directory, 2 * oldSize * sizeof(int32_t));
+    if (grown == NULL) {return false;}
+    // With low-bit indexing the new upper half mirrors the lower half
+    memcpy(grown + oldSize, grown, oldSize * sizeof(int32_t));
+    hashFile->directory = grown;
+    hashFile->globalDepth++;
+    return true;
+}
+
+/**
+ * @brief Writes products into a page chain, taking extra pages from a pool of reusable ids.
+ *
+ * @param hashFile The hash file.
+ * @param firstPageId The first page of the chain.
+ * @param products The products to store.
+ * @param count Number of products.
+ * @param localDepth The local depth of the bucket.
+ * @param spareIds Pool of page ids that may be reused.
+ * @param spareCount Number of ids left in the pool, updated on return.
+ * @return true on success, false otherwise.
+ */
+static bool writeBucketChain(ExtendibleHashFile* hashFile, int32_t firstPageId, const Product* products, int count,
+                             int32_t localDepth, int32_t* spareIds, int* spareCount) {
+    HashBucketPage page;
+    int32_t pageId = firstPageId;
+    int written = 0;
+
+    do {
+        initializeBucketPage(&page, localDepth);
+        int chunk = count - written;
+        if (chunk > (int)HASH_BUCKET_CAPACITY) {chunk = (int)HASH_BUCKET_CAPACITY;}
+        memcpy(page.products, products + written, chunk * sizeof(Product));
+        page.productCount = chunk;
+        written += chunk;
+
+        int32_t nextPageId = HASH_NO_PAGE;
+        if (written < count) {
+            nextPageId = *spareCount > 0 ? spareIds[--(*spareCount)] : allocateBucketPage(hashFile);
+        }
+        page.overflowPage = nextPageId;
+        if (!writeBucketPage(hashFile, pageId, &page)) {return false;}
+        pageId = nextPageId;
+    } while (written < count);
+
+    return true;
+}
+
+/**
+ * @brief Splits a full bucket by one more hash bit.
+ *
+ * All products of the bucket's page chain are redistributed between the original bucket and a new one,
+ * and the directory entries that now belong to the new bucket are redirected to it.
+ *
+ * @param hashFile The hash file.
+ * @param pageId The primary page of the bucket.
+ * @param primary The already-read primary page.
+ * @return true on success, false otherwise.
+ */
+static bool splitBucket(ExtendibleHashFile* hashFile, int32_t pageId, const HashBucketPage* primary) {
+    int32_t depth = primary->localDepth;
+    if (depth == hashFile->globalDepth && !doubleHashDirectory(hashFile)) {return false;}
+
+    // Gather the whole chain so that overflow pages are redistributed as well
+    int capacity = (int)HASH_BUCKET_CAPACITY;
+    int productCount = 0;
+    int chainLength = 0;
+    int chainCapacity = 4;
+    Product* products = (Product*)malloc(capacity * sizeof(Product));
+    int32_t* chainIds = (int32_t*)malloc(chainCapacity * sizeof(int32_t));
+    if (products == NULL || chainIds == NULL) {free(products); free(chainIds); return false;}
+
+    HashBucketPage page = *primary;
+    while (true) {
+        if (productCount + page.productCount > capacity) {
+            capacity = 2 * (productCount + page.productCount);
+            Product* grown = (Product*)realloc(products, capacity * sizeof(Product));
+            if (grown == NULL) {free(products); free(chainIds); return false;}
+            products = grown;
+        }
+        memcpy(products + productCount, page.products, page.productCount * sizeof(Product));
+        productCount += page.productCount;
+        if (page.overflowPage == HASH_NO_PAGE) {break;}
+        if (chainLength == chainCapacity) {
+            chainCapacity *= 2;
+            int32_t* grown = (int32_t*)realloc(chainIds, chainCapacity * sizeof(int32_t));
+            if (grown == NULL) {free(products); free(chainIds); return false;}
+            chainIds = grown;
+        }
+        chainIds[chainLength++] = page.overflowPage;
+        if (!readBucketPage(hashFile, page.overflowPage, &page)) {free(products); free(chainIds); return false;}
+    }
+
+    // Partition in place: products staying in the old bucket first, products moving to the new bucket after
+    int stayCount = 0;
+    for (int i = 0; i < productCount; i++) {
+        if (((hashVendorId(products[i].vendorId) >> depth) & 1U) == 0) {
+            Product temp = products[stayCount];
+            products[stayCount] = products[i];
+            products[i] = temp;
+            stayCount++;
+        }
+    }
+
+    int32_t newPageId = allocateBucketPage(hashFile);
+    size_t directorySize = (size_t)1 << hashFile->globalDepth;
+    for (size_t i = 0; i < directorySize; i++) {
+        if (hashFile->directory[i] == pageId && ((i >> depth) & 1U) != 0) {
+            hashFile->directory[i] = newPageId;
+        }
+    }
+
+    int spareCount = chainLength;
+    bool ok = writeBucketChain(hashFile, pageId, products, stayCount, depth + 1, chainIds, &spareCount) &&
+              writeBucketChain(hashFile, newPageId, products + stayCount, productCount - stayCount, depth + 1, chainIds, &spareCount);
+    while (ok && spareCount > 0) {
+        ok = releaseBucketPage(hashFile, chainIds[--spareCount]);
+    }
+
+    free(products);
+    free(chainIds);
+    return ok && saveHashDirectory(hashFile);
+}
+
+/**
+ * @brief Inserts a product into the hash file under its vendor ID.
+ *
+ * @param hashFile The hash file.
+ * @param product The product to insert.
+ * @return true on success, false otherwise.
+ */
+bool extendibleHashInsert(ExtendibleHashFile* hashFile, const Product* product) {
+    if (hashFile == NULL || product == NULL) {return false;}
+    uint32_t hash = hashVendorId(product->vendorId);
+    HashBucketPage page;
+
+    while (true) {
+        int32_t pageId = hashFile->directory[hash & (((uint32_t)1 << hashFile->globalDepth) - 1)];
+        if (!readBucketPage(hashFile, pageId, &page)) {return false;}
+
+        if (page.productCount < (int32_t)HASH_BUCKET_CAPACITY) {
+            page.products[page.productCount++] = *product;
+            return writeBucketPage(hashFile, pageId, &page);
+        }
+
+        // A split only helps if some product hashes differently from the new one
+        bool allSameHash = true;
+        for (int i = 0; i < page.productCount && allSameHash; i++) {
+            if (hashVendorId(page.products[i].vendorId) != hash) {allSameHash = false;}
+        }
+        if (!allSameHash && page.localDepth < HASH_MAX_GLOBAL_DEPTH) {
+            if (!splitBucket(hashFile, pageId, &page)) {return false;}
+            continue;
+        }
+
+        // Chain an overflow page: find a chained page with room, or append a new one
+        int32_t currentId = pageId;
+        while (page.overflowPage != HASH_NO_PAGE) {
+            currentId = page.overflowPage;
+            if (!readBucketPage(hashFile, currentId, &page)) {return false;}
+            if (page.productCount < (int32_t)HASH_BUCKET_CAPACITY) {
+                page.products[page.productCount++] = *product;
+                return writeBucketPage(hashFile, currentId, &page);
+            }
+        }
+
+        HashBucketPage overflow;
+        initializeBucketPage(&overflow, page.localDepth);
+        overflow.products[0] = *product;
+        overflow.productCount = 1;
+        int32_t overflowId = allocateBucketPage(hashFile);
+        page.overflowPage = overflowId;
+        return writeBucketPage(hashFile, overflowId, &overflow) && writeBucketPage(hashFile, currentId, &page) &&
+               saveHashDirectory(hashFile);
+    }
+}
+
+/**
+ * @brief Looks up one product of a vendor.
+ *
+ * @param hashFile The hash file.
+ * @param vendorId The vendor ID to look up.
+ * @param foProduct Output for the first product found; may be NULL to test for presence only.
+ * @return true if the vendor has at least one product, false otherwise.
+ */
+bool extendibleHashFind(ExtendibleHashFile* hashFile, int vendorId, Product* foProduct) {
+    if (hashFile == NULL) {return false;}
+    uint32_t hash = hashVendorId(vendorId);
+    int32_t pageId = hashFile->directory[hash & (((uint32_t)1 << hashFile->globalDepth) - 1)];
+    HashBucketPage page;
+
+    while (pageId != HASH_NO_PAGE) {
+        if (!readBucketPage(hashFile, pageId, &page)) {return false;}
+        for (int i = 0; i < page.productCount; i++) {
+            if (page.products[i].vendorId == vendorId) {
+                if (foProduct != NULL) {*foProduct = page.products[i];}
+                return true;
+            }
+        }
+        pageId = page.overflowPage;
+    }
+    return false;
+}
+
+/**
+ * @brief Collects all products of a vendor.
+ *
+ * @param hashFile The hash file.
+ * @param vendorId The vendor ID to scan.
+ * @param foProducts Output array; may be NULL when only the count is needed.
+ * @param maxCount Capacity of foProducts.
+ * @return The total number of products the vendor has (may exceed maxCount), or -1 on read errors.
+ */
+int extendibleHashScanVendor(ExtendibleHashFile* hashFile, int vendorId, Product foProducts[], int maxCount) {
+    if (hashFile == NULL) {return -1;}
+    uint32_t hash = hashVendorId(vendorId);
+    int32_t pageId = hashFile->directory[hash & (((uint32_t)1 << hashFile->globalDepth) - 1)];
+    HashBucketPage page;
+    int found = 0;
+
+    while (pageId != HASH_NO_PAGE) {
+        if (!readBucketPage(hashFile, pageId, &page)) {return -1;}
+        for (int i = 0; i < page.productCount; i++) {
+            if (page.products[i].vendorId == vendorId) {
+                if (foProducts != NULL && found < maxCount) {foProducts[found] = page.products[i];}
+                found++;
+            }
+        }
+        pageId = page.overflowPage;
+    }
+    return found;
+}
+
+/**
+ * @brief Removes one product of a vendor by name.
+ *
+ * Buckets are not merged back; emptied overflow pages are unlinked and reused by later inserts.
+ *
+ * @param hashFile The hash file.
+ * @param vendorId The vendor that owns the product.
+ * @param productName The product name to remove.
+ * @return true if a product was removed, false otherwise.
+ */
+bool extendibleHashRemove(ExtendibleHashFile* hashFile, int vendorId, const char* productName) {
+    if (hashFile == NULL || productName == NULL) {return false;}
+    uint32_t hash = hashVendorId(vendorId);
+    int32_t primaryId = hashFile->directory[hash & (((uint32_t)1 << hashFile->globalDepth) - 1)];
+    int32_t previousId = HASH_NO_PAGE;
+    int32_t pageId = primaryId;
+    HashBucketPage page;
+    HashBucketPage previous;
+
+    while (pageId != HASH_NO_PAGE) {
+        if (!readBucketPage(hashFile, pageId, &page)) {return false;}
+        for (int i = 0; i < page.productCount; i++) {
+            if (page.products[i].vendorId != vendorId || strcmp(page.products[i].productName, productName) != 0) {continue;}
+
+            page.products[i] = page.products[--page.productCount];
+            if (page.productCount > 0 || (page.overflowPage == HASH_NO_PAGE && previousId == HASH_NO_PAGE)) {
+                return writeBucketPage(hashFile, pageId, &page);
+            }
+            if (previousId != HASH_NO_PAGE) {
+                // Unlink an emptied overflow page
+                previous.overflowPage = page.overflowPage;
+                return writeBucketPage(hashFile, previousId, &previous) && releaseBucketPage(hashFile, pageId) &&
+                       saveHashDirectory(hashFile);
+            }
+            // Emptied primary page with a chain behind it: pull the next page forward
+            int32_t nextId = page.overflowPage;
+            if (!readBucketPage(hashFile, nextId, &page)) {return false;}
+            return writeBucketPage(hashFile, pageId, &page) && releaseBucketPage(hashFile, nextId) &&
+                   saveHashDirectory(hashFile);
+        }
+        previous = page;
+        previousId = pageId;
+        pageId = page.overflowPage;
+    }
+    return false;
+}
+
+/**
+ * @brief Loads every product record of a products file into the hash file.
+ *
+ * @param hashFile The hash file.
+ * @param productsPath Path of the binary products file (e.g. "products.bin").
+ * @return The number of products inserted, or -1 if the products file cannot be opened.
+ */
+int buildExtendibleHashFromProducts(ExtendibleHashFile* hashFile, const char* productsPath) {
+    FILE* productFile = fopen(productsPath, "rb");
+    if (productFile == NULL) {return -1;}
+
+    Product product;
+    int inserted = 0;
+    while (fread(&product, sizeof(Product), 1, productFile)) {
+        if (extendibleHashInsert(hashFile, &product)) {inserted++;}
+    }
+
+    fclose(productFile);
+    return inserted;
+}
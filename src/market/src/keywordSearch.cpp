@@ -0,0 +1,188 @@
+/**
+ * @file keywordSearch.cpp
+ * @brief Aho-Corasick automaton for keyword queries over product and vendor records.
+ *
+ * @details The keywords are first inserted into a trie. A breadth-first pass then gives every state its
+ * failure state, the longest proper suffix of its path that is also a trie path, and replaces each missing
+ * transition with the transition of the failure state, which is already complete because it is shallower.
+ * The output mask of a state is its own keywords plus the output mask of its failure state, so the keywords
+ * ending at a position are known without following failure links while scanning.
+ */
+
+#include "../header/keywordSearch.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Compiles a set of keywords into an automaton.
+ *
+ * @param keywords The keywords; none may be empty. Equal keywords are allowed and match together.
+ * @param keywordCount Number of keywords, 1 to KEYWORD_SEARCH_MAX_KEYWORDS.
+ * @param foAutomaton Receives the automaton; release it with freeKeywordAutomaton().
+ * @return true on success, false for invalid keywords or when out of memory.
+ */
+bool buildKeywordAutomaton(const char* const keywords[], int keywordCount, KeywordAutomaton* foAutomaton) {
+    memset(foAutomaton, 0, sizeof(KeywordAutomaton));
+    if (keywords == NULL || keywordCount < 1 || keywordCount > KEYWORD_SEARCH_MAX_KEYWORDS) {return false;}
+
+    int maxStates = 1;
+    for (int k = 0; k < keywordCount; k++) {
+        if (keywords[k] == NULL || keywords[k][0] == '\0') {return false;}
+        maxStates += (int)strlen(keywords[k]);
+    }
+
+    int32_t* transitions = (int32_t*)malloc((size_t)maxStates * 256 * sizeof(int32_t));
+    uint64_t* outputs = (uint64_t*)calloc((size_t)maxStates, sizeof(uint64_t));
+    int32_t* failures = (int32_t*)malloc((size_t)maxStates * sizeof(int32_t));
+    int32_t* queue = (int32_t*)malloc((size_t)maxStates * sizeof(int32_t));
+    int* keywordLengths = (int*)malloc((size_t)keywordCount * sizeof(int));
+    if (transitions == NULL || outputs == NULL || failures == NULL || queue == NULL || keywordLengths == NULL) {
+        free(transitions);
+        free(outputs);
+        free(failures);
+        free(queue);
+        free(keywordLengths);
+        return false;
+    }
+    memset(transitions, 0xFF, (size_t)maxStates * 256 * sizeof(int32_t));
+
+    // Trie of the keywords
+    int stateCount = 1;
+    for (int k = 0; k < keywordCount; k++) {
+        int state = 0;
+        const unsigned char* keyword = (const unsigned char*)keywords[k];
+        for (int i = 0; keyword[i] != '\0'; i++) {
+            int32_t* next = &transitions[(size_t)state * 256 + keyword[i]];
+            if (*next < 0) {*next = stateCount++;}
+            state = *next;
+        }
+        outputs[state] |= (uint64_t)1 << k;
+        keywordLengths[k] = (int)strlen(keywords[k]);
+    }
+
+    // Failure states in breadth-first order; missing transitions become failure transitions
+    int head = 0;
+    int tail = 0;
+    for (int c = 0; c < 256; c++) {
+        int32_t child = transitions[c];
+        if (child < 0) {transitions[c] = 0;}
+        else {
+            failures[child] = 0;
+            queue[tail++] = child;
+        }
+    }
+    while (head < tail) {
+        int32_t state = queue[head++];
+        int32_t* row = &transitions[(size_t)state * 256];
+        const int32_t* failureRow = &transitions[(size_t)failures[state] * 256];
+        outputs[state] |= outputs[failures[state]];
+        for (int c = 0; c < 256; c++) {
+            if (row[c] < 0) {row[c] = failureRow[c];}
+            else {
+                failures[row[c]] = failureRow[c];
+                queue[tail++] = row[c];
+            }
+        }
+    }
+    free(failures);
+    free(queue);
+
+    foAutomaton->stateCount = stateCount;
+    foAutomaton->keywordCount = keywordCount;
+    foAutomaton->transitions = transitions;
+    foAutomaton->outputs = outputs;
+    foAutomaton->keywordLengths = keywordLengths;
+    return true;
+}
+
+/**
+ * @brief Releases the tables of an automaton.
+ *
+ * @param automaton The automaton; it is left empty.
+ */
+void freeKeywordAutomaton(KeywordAutomaton* automaton) {
+    free(automaton->transitions);
+    free(automaton->outputs);
+    free(automaton->keywordLengths);
+    memset(automaton, 0, sizeof(KeywordAutomaton));
+}
+
+/**
+ * @brief Finds the keywords occurring in a text in one pass.
+ *
+ * Matches are reported in order of their end position, keywords ending at the same position by index. The
+ * scan stops early once every keyword has been found and no more matches can be stored.
+ *
+ * @param automaton The compiled keywords.
+ * @param text The text; it does not have to be zero terminated.
+ * @param textLength Number of bytes of text to search.
+ * @param foMatches Receives up to maxMatches matches; may be NULL when maxMatches is 0.
+ * @param maxMatches Capacity of foMatches.
+ * @param foFound Receives the set of keywords found, bit k for keyword k; may be NULL.
+ * @return The number of matches stored in foMatches.
+ */
+int findKeywords(const KeywordAutomaton* automaton, const char* text, int textLength, KeywordMatch foMatches[], int maxMatches, uint64_t* foFound) {
+    uint64_t allKeywords = automaton->keywordCount >= 64 ? ~(uint64_t)0 : (((uint64_t)1 << automaton->keywordCount) - 1);
+    uint64_t found = 0;
+    int matchCount = 0;
+    int32_t state = 0;
+
+    for (int i = 0; i < textLength; i++) {
+        state = automaton->transitions[(size_t)state * 256 + (unsigned char)text[i]];
+        uint64_t ending = automaton->outputs[state];
+        if (ending == 0) {continue;}
+
+        found |= ending;
+        while (ending != 0 && matchCount < maxMatches) {
+            int keyword = 0;
+            while ((ending & ((uint64_t)1 << keyword)) == 0) {keyword++;}
+            ending &= ending - 1;
+            foMatches[matchCount].keyword = keyword;
+            foMatches[matchCount].offset = i + 1 - automaton->keywordLengths[keyword];
+            matchCount++;
+        }
+        if (found == allKeywords && matchCount >= maxMatches) {break;}
+    }
+
+    if (foFound != NULL) {*foFound = found;}
+    return matchCount;
+}
+
+/**
+ * @brief Decides whether a set of found keywords satisfies a query.
+ *
+ * @param automaton The compiled keywords.
+ * @param found The keywords found by findKeywords().
+ * @param mode Whether all keywords or any keyword must occur.
+ * @return true if the record matches.
+ */
+bool keywordsSatisfied(const KeywordAutomaton* automaton, uint64_t found, KeywordMatchMode mode) {
+    uint64_t allKeywords = automaton->keywordCount >= 64 ? ~(uint64_t)0 : (((uint64_t)1 << automaton->keywordCount) - 1);
+    if (mode == KEYWORD_MATCH_ANY) {return (found & allKeywords) != 0;}
+    return (found & allKeywords) == allKeywords;
+}
+
+/**
+ * @brief Splits a query into keywords.
+ *
+ * Keywords are separated by white space. If the query contains KEYWORD_QUERY_ANY_SEPARATOR, that character
+ * also separates keywords and any of them matches; otherwise all of them must match.
+ *
+ * @param query The query; separators are overwritten with zero bytes.
+ * @param foKeywords Receives pointers into query.
+ * @param maxKeywords Capacity of foKeywords; further keywords are ignored.
+ * @param foMode Receives the match mode.
+ * @return The number of keywords.
+ */
+int splitKeywordQuery(char* query, char* foKeywords[], int maxKeywords, KeywordMatchMode* foMode) {
+    *foMode = strchr(query, KEYWORD_QUERY_ANY_SEPARATOR) != NULL ? KEYWORD_MATCH_ANY : KEYWORD_MATCH_ALL;
+
+    const char separators[] = {' ', '\t', '\r', '\n', KEYWORD_QUERY_ANY_SEPARATOR, '\0'};
+    int keywordCount = 0;
+    char* keyword = strtok(query, separators);
+    while (keyword != NULL && keywordCount < maxKeywords) {
+        foKeywords[keywordCount++] = keyword;
+        keyword = strtok(NULL, separators);
+    }
+    return keywordCount;
+}
@@ -0,0 +1,320 @@
+/**
+ * @file linearHash.cpp
+ * @brief Linear hashing implementation of the bucketized product hash table.
+ *
+ * @details A key is first addressed with h mod (N * 2^level); buckets below the split pointer have already
+ * been split in this round and are addressed with h mod (N * 2^(level + 1)) instead. Each split moves
+ * only the products of one bucket chain, which keeps the cost of any single insert bounded.
+ */
+
+#include "../header/linearHash.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Mixes a vendor ID so that sequential IDs spread over the buckets.
+ *
+ * @param vendorId The vendor ID to hash.
+ * @return The hash value.
+ */
+static uint32_t linearHashKey(int vendorId) {
+    uint32_t x = (uint32_t)vendorId * 2654435761U;
+    return x ^ (x >> 16);
+}
+
+/**
+ * @brief Returns the bucket with the given index.
+ *
+ * @param table The hash table.
+ * @param index Bucket index, must be below bucketCount.
+ * @return Pointer to the bucket.
+ */
+static LinearHashBucket* linearHashBucketAt(LinearHashTable* table, int index) {
+    return &table->segments[index / LINEAR_HASH_SEGMENT_SIZE][index % LINEAR_HASH_SEGMENT_SIZE];
+}
+
+/**
+ * @brief Computes the bucket index of a key for the current level and split pointer.
+ *
+ * @param table The hash table.
+ * @param vendorId The vendor ID.
+ * @return The bucket index.
+ */
+static int linearHashAddress(const LinearHashTable* table, int vendorId) {
+    uint32_t hash = linearHashKey(vendorId);
+    uint32_t roundSize = (uint32_t)table->initialBucketCount << table->level;
+    uint32_t index = hash % roundSize;
+    if (index < (uint32_t)table->splitPointer) {
+        index = hash % (roundSize << 1);
+    }
+    return (int)index;
+}
+
+/**
+ * @brief Makes sure the segment for the given bucket index is allocated.
+ *
+ * @param table The hash table.
+ * @param index The bucket index about to be used.
+ * @return true on success, false if memory runs out.
+ */
+static bool ensureLinearHashSegment(LinearHashTable* table, int index) {
+    int segment = index / LINEAR_HASH_SEGMENT_SIZE;
+    if (segment < table->segmentCount) {return true;}
+
+    if (table->segmentCount == table->segmentCapacity) {
+        int newCapacity = table->segmentCapacity * 2;
+        LinearHashBucket** grown = (LinearHashBucket**)realloc(table->segments, newCapacity * sizeof(LinearHashBucket*));
+        if (grown == NULL) {return false;}
+        table->segments = grown;
+        table->segmentCapacity = newCapacity;
+    }
+
+    LinearHashBucket* buckets = (LinearHashBucket*)calloc(LINEAR_HASH_SEGMENT_SIZE, sizeof(LinearHashBucket));
+    if (buckets == NULL) {return false;}
+    table->segments[table->segmentCount++] = buckets;
+    return true;
+}
+
+/**
+ * @brief Appends a product to a bucket chain, adding an overflow bucket if every bucket in the chain is full.
+ *
+ * @param bucket The primary bucket.
+ * @param product The product to store.
+ * @param spares Overflow buckets to reuse before allocating new ones, linked through overflow; may be NULL.
+ * @return true on success, false if memory runs out.
+ */
+static bool appendToLinearHashChain(LinearHashBucket* bucket, const Product* product, LinearHashBucket** spares) {
+    while (bucket->bucket.productCount == BUCKET_SIZE) {
+        if (bucket->overflow == NULL) {
+            if (spares != NULL && *spares != NULL) {
+                bucket->overflow = *spares;
+                *spares = (*spares)->overflow;
+                memset(bucket->overflow, 0, sizeof(LinearHashBucket));
+            }
+            else {
+                bucket->overflow = (LinearHashBucket*)calloc(1, sizeof(LinearHashBucket));
+                if (bucket->overflow == NULL) {return false;}
+            }
+        }
+        bucket = bucket->overflow;
+    }
+    bucket->bucket.products[bucket->bucket.productCount++] = *product;
+    return true;
+}
+
+/**
+ * @brief Creates an empty linear hash table.
+ *
+ * @param initialBucketCount Number of buckets at level 0 (values below 1 are treated as 1).
+ * @param maxLoadFactor Load factor that triggers a split (values not above 0 select LINEAR_HASH_MAX_LOAD).
+ * @return Pointer to the new table, or NULL on allocation failure.
+ */
+LinearHashTable* createLinearHashTable(int initialBucketCount, double maxLoadFactor) {
+    LinearHashTable* table = (LinearHashTable*)calloc(1, sizeof(LinearHashTable));
+    if (table == NULL) {return NULL;}
+
+    table->initialBucketCount = initialBucketCount < 1 ? 1 : initialBucketCount;
+    table->maxLoadFactor = maxLoadFactor > 0 ? maxLoadFactor : LINEAR_HASH_MAX_LOAD;
+    table->segmentCapacity = 4;
+    table->segments = (LinearHashBucket**)malloc(table->segmentCapacity * sizeof(LinearHashBucket*));
+    if (table->segments == NULL) {free(table); return NULL;}
+
+    for (int i = 0; i < table->initialBucketCount; i++) {
+        if (!ensureLinearHashSegment(table, i)) {freeLinearHashTable(table); return NULL;}
+    }
+    table->bucketCount = table->initialBucketCount;
+    return table;
+}
+
+/**
+ * @brief Frees a linear hash table with all of its buckets.
+ *
+ * @param table The table to free.
+ */
+void freeLinearHashTable(LinearHashTable* table) {
+    if (table == NULL) {return;}
+    for (int i = 0; i < table->bucketCount; i++) {
+        LinearHashBucket* overflow = linearHashBucketAt(table, i)->overflow;
+        while (overflow != NULL) {
+            LinearHashBucket* next = overflow->overflow;
+            free(overflow);
+            overflow = next;
+        }
+    }
+    for (int i = 0; i < table->segmentCount; i++) {
+        free(table->segments[i]);
+    }
+    free(table->segments);
+    free(table);
+}
+
+/**
+ * @brief Returns the current load factor (products per primary bucket slot).
+ *
+ * @param table The hash table.
+ * @return The load factor.
+ */
+double linearHashLoadFactor(const LinearHashTable* table) {
+    return (double)table->productCount / ((double)table->bucketCount * BUCKET_SIZE);
+}
+
+/**
+ * @brief Splits the bucket at the split pointer and advances the pointer.
+ *
+ * The products of the split bucket chain are redistributed between the bucket and its new image
+ * at index splitPointer + N * 2^level using one more bit of the hash. The overflow buckets of the old
+ * chain are reused for the two new chains: once k buckets of the chain have been read, their products fit
+ * into the two primary buckets and k - 1 overflow buckets, so redistribution never allocates.
+ *
+ * @param table The hash table.
+ * @return true on success, false if the segment for the new bucket cannot be allocated; the table is
+ *         unchanged in that case.
+ */
+static bool splitLinearHashBucket(LinearHashTable* table) {
+    int newIndex = table->bucketCount;
+    if (!ensureLinearHashSegment(table, newIndex)) {return false;}
+
+    LinearHashBucket* oldBucket = linearHashBucketAt(table, table->splitPointer);
+    LinearHashBucket* newBucket = linearHashBucketAt(table, newIndex);
+    memset(newBucket, 0, sizeof(LinearHashBucket));
+
+    // Detach the chain, then re-append each product with the next round's modulus
+    LinearHashBucket chain = *oldBucket;
+    memset(oldBucket, 0, sizeof(LinearHashBucket));
+    uint32_t nextRoundSize = ((uint32_t)table->initialBucketCount << table->level) << 1;
+
+    LinearHashBucket* spares = NULL;
+    LinearHashBucket* current = &chain;
+    while (current != NULL) {
+        // Copy the bucket out first, so that it is already a spare while its own products are placed
+        Bucket products = current->bucket;
+        LinearHashBucket* next = current->overflow;
+        if (current != &chain) {
+            current->overflow = spares;
+            spares = current;
+        }
+        for (int i = 0; i < products.productCount; i++) {
+            const Product* product = &products.products[i];
+            uint32_t index = linearHashKey(product->vendorId) % nextRoundSize;
+            appendToLinearHashChain((int)index == newIndex ? newBucket : oldBucket, product, &spares);
+        }
+        current = next;
+    }
+    while (spares != NULL) {
+        LinearHashBucket* next = spares->overflow;
+        free(spares);
+        spares = next;
+    }
+
+    table->bucketCount++;
+    table->splitPointer++;
+    if (table->splitPointer == (table->initialBucketCount << table->level)) {
+        table->level++;
+        table->splitPointer = 0;
+    }
+    return true;
+}
+
+/**
+ * @brief Inserts a product under its vendor ID, splitting one bucket if the load factor is exceeded.
+ *
+ * A split that cannot get memory for its segment leaves the table as it was; it is counted in
+ * failedSplitCount and tried again by the next insert, and the product stays inserted.
+ *
+ * @param table The hash table.
+ * @param product The product to insert.
+ * @return true if the product was inserted, false otherwise.
+ */
+bool linearHashInsert(LinearHashTable* table, const Product* product) {
+    if (table == NULL || product == NULL) {return false;}
+    LinearHashBucket* bucket = linearHashBucketAt(table, linearHashAddress(table, product->vendorId));
+    if (!appendToLinearHashChain(bucket, product, NULL)) {return false;}
+    table->productCount++;
+
+    if (linearHashLoadFactor(table) > table->maxLoadFactor && !splitLinearHashBucket(table)) {
+        table->failedSplitCount++;
+    }
+    return true;
+}
+
+/**
+ * @brief Searches for a product of a vendor.
+ *
+ * @param table The hash table.
+ * @param vendorId The vendor ID to look up.
+ * @param foProduct Output for the first product found; may be NULL.
+ * @return true if the vendor has at least one product, false otherwise.
+ */
+bool linearHashSearch(LinearHashTable* table, int vendorId, Product* foProduct) {
+    if (table == NULL) {return false;}
+    for (LinearHashBucket* bucket = linearHashBucketAt(table, linearHashAddress(table, vendorId)); bucket != NULL; bucket = bucket->overflow) {
+        for (int i = 0; i < bucket->bucket.productCount; i++) {
+            if (bucket->bucket.products[i].vendorId == vendorId) {
+                if (foProduct != NULL) {*foProduct = bucket->bucket.products[i];}
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Collects all products of a vendor.
+ *
+ * @param table The hash table.
+ * @param vendorId The vendor ID to scan.
+ * @param foProducts Output array; may be NULL when only the count is needed.
+ * @param maxCount Capacity of foProducts.
+ * @return The total number of products of the vendor (may exceed maxCount).
+ */
+int linearHashScanVendor(LinearHashTable* table, int vendorId, Product foProducts[], int maxCount) {
+    if (table == NULL) {return 0;}
+    int found = 0;
+    for (LinearHashBucket* bucket = linearHashBucketAt(table, linearHashAddress(table, vendorId)); bucket != NULL; bucket = bucket->overflow) {
+        for (int i = 0; i < bucket->bucket.productCount; i++) {
+            if (bucket->bucket.products[i].vendorId == vendorId) {
+                if (foProducts != NULL && found < maxCount) {foProducts[found] = bucket->bucket.products[i];}
+                found++;
+            }
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Removes one product of a vendor by name.
+ *
+ * The hole is filled with the last product of the chain so that only the tail bucket can become empty;
+ * an empty tail overflow bucket is freed.
+ *
+ * @param table The hash table.
+ * @param vendorId The vendor that owns the product.
+ * @param productName The product name to remove.
+ * @return true if a product was removed, false otherwise.
+ */
+bool linearHashRemove(LinearHashTable* table, int vendorId, const char* productName) {
+    if (table == NULL || productName == NULL) {return false;}
+    LinearHashBucket* primary = linearHashBucketAt(table, linearHashAddress(table, vendorId));
+
+    for (LinearHashBucket* bucket = primary; bucket != NULL; bucket = bucket->overflow) {
+        for (int i = 0; i < bucket->bucket.productCount; i++) {
+            Product* product = &bucket->bucket.products[i];
+            if (product->vendorId != vendorId || strcmp(product->productName, productName) != 0) {continue;}
+
+            LinearHashBucket* previous = NULL;
+            LinearHashBucket* tail = primary;
+            while (tail->overflow != NULL && tail->overflow->bucket.productCount > 0) {
+                previous = tail;
+                tail = tail->overflow;
+            }
+            *product = tail->bucket.products[--tail->bucket.productCount];
+            if (tail->bucket.productCount == 0 && previous != NULL) {
+                previous->overflow = tail->overflow;
+                free(tail);
+            }
+            table->productCount--;
+            return true;
+        }
+    }
+    return false;
+}
@@ -24,6 +24,14 @@
 
 // Includes necessary for functionality
 #include "../header/market.h"    // Main definitions and prototypes for the market application.
+#include "../header/pagedBPlusTree.h" // Paged product index kept in sync with products.bin.
+#include "../header/compressedSparseMatrix.h" // CSR/CSC views of the vendor-product matrix.
+#include "../header/productSort.h" // Key sorts for price comparisons and catalog reports.
+#include "../header/productPriceSummary.h" // Per-name price summaries kept next to products.bin.
+#include "../header/keywordSearch.h" // Multi-keyword automaton for keyword searches.
+#include "../header/searchIndex.h" // Inverted index over names and seasons kept next to products.bin.
+#include "mathUtility.h"          // Price statistics for the price comparison.
+#include "streamingStatistics.h"  // Running price statistics of the product feed.
 #include <stdexcept>             // Standard exception class for handling exceptions.
 #include <iostream>              // Standard I/O stream objects.
 #include <string.h>              // String class for operations on strings.
@@ -37,7 +45,6 @@
 #include <sstream>               // String stream.
 #include <time.h>                // Time functions.
 #include <ctype.h>               // Character handling functions.
-#include <stack>                 // Stack container for the C standard library.
 #include <stdint.h>              // Standard types with specified widths.
 #include <float.h>               // Limits of float types.
 #include <unordered_map>         // Standard hash table container.
@@ -268,7 +275,8 @@ bool mainMenu() {
 /**
  * @brief Lists local vendors and provides operations on them.
  *
- * This function allows users to list local vendors, add, update, delete vendors, or view the vendor list.
+ * This function allows users to list local vendors, add, update, delete vendors, or view the vendor list,
+ * and to list the products of a vendor or the vendors of a product from the vendor-product relations.
  *
  * @return Boolean indicating whether the vendor listing menu is still active.
  */
@@ -284,6 +292,8 @@ bool listingOfLocalVendors() {
         printf("| 2. Update Vendor                       |\n");
         printf("| 3. Delete Vendor                       |\n");
         printf("| 4. List Vendors                        |\n");
+        printf("| 5. Products of a Vendor                |\n");
+        printf("| 6. Vendors of a Product                |\n");
         printf("| 0. Return to Main Menu                 |\n");
         printf("==========================================\n");
         printf("Choose an option: ");
@@ -302,6 +312,20 @@ bool listingOfLocalVendors() {
         case 4:
             listVendors();
             break;
+        case 5:
+            printf("Enter Vendor ID: ");
+            listProductsByVendor(getInput());
+            while (getchar() != '\n');
+            printf("Press Enter to continue...");
+            getchar();
+            break;
+        case 6:
+            printf("Enter Product ID: ");
+            listVendorsByProduct(getInput());
+            while (getchar() != '\n');
+            printf("Press Enter to continue...");
+            getchar();
+            break;
         case 0:
             printf("Returning to main menu...\n");
             break;
@@ -317,12 +341,14 @@ bool listingOfLocalVendors() {
 /**
  * @brief Lists products available locally.
  *
- * This function allows users to list local products, add, update, delete products, or view the product list.
+ * This function allows users to list local products, add, update, delete products, view the product list, or
+ * write the whole catalog sorted by price, name or vendor to SORTED_PRODUCT_REPORT_FILE.
  *
  * @return Boolean indicating whether the product listing menu is still active.
  */
 bool listingOfLocalProducts() {
 int choice;
+int order;
 
 do {
     clearScreen();
@@ -333,6 +359,7 @@ do {
     printf("| 2. Update Product                      |\n");
     printf("| 3. Delete Product                      |\n");
     printf("| 4. Listing of Local Products           |\n");
+    printf("| 5. Sorted Product Report               |\n");
     printf("| 0. Return to Main Menu                 |\n");
     printf("==========================================\n");
     printf("Choose an option: ");
@@ -351,6 +378,20 @@ do {
     case 4:
         listingOfLocalVendorsandProducts();
         break;
+    case 5:
+        printf("Sort by (0. Price, 1. Name, 2. Vendor): ");
+        order = getInput();
+        if (order < PRODUCT_SORT_BY_PRICE || order > PRODUCT_SORT_BY_VENDOR) {printf("Invalid sort order.\n");}
+        else if (writeSortedProductReport("products.bin", (ProductSortOrder)order, 0, SORTED_PRODUCT_REPORT_FILE)) {
+            printf("Product report written to %s.\n", SORTED_PRODUCT_REPORT_FILE);
+        }
+        else {
+            printf("Product report could not be written.\n");
+        }
+        while (getchar() != '\n');
+        printf("Press Enter to continue...");
+        getchar();
+        break;
     case 0:
         printf("Returning to main menu...\n");
         break;
@@ -383,6 +424,11 @@ bool priceComparison() {
         printf("==========================================\n");
         printf("| 1. Select Product                      |\n");
         printf("| 2. Compare Prices                      |\n");
+        printf("| 3. Cheapest Offers                     |\n");
+        printf("| 4. Price Summary                       |\n");
+        printf("| 5. Price Report for All Products       |\n");
+        printf("| 6. Vendor Price Summary per Product    |\n");
+        printf("| 7. Catalog Price Statistics            |\n");
         printf("| 0. Return to Main Menu                 |\n");
         printf("==========================================\n");
         printf("Choose an option: ");
@@ -402,6 +448,30 @@ bool priceComparison() {
                 printf("No product selected. Please select a product first.\n");
             }
             break;
+        case 3:
+            if (strlen(selectedProductName) > 0) { showBestOffers(selectedProductName, CHEAPEST_OFFER_COUNT);}
+            else {
+                printf("No product selected. Please select a product first.\n");
+            }
+            break;
+        case 4:
+            if (strlen(selectedProductName) > 0) { showPriceSummary(selectedProductName);}
+            else {
+                printf("No product selected. Please select a product first.\n");
+            }
+            break;
+        case 5:
+            if (writePriceComparisonReport("products.bin", PRICE_COMPARISON_REPORT_FILE)) { printf("Price report written to %s.\n", PRICE_COMPARISON_REPORT_FILE);}
+            else {
+                printf("Price report could not be written.\n");
+            }
+            break;
+        case 6:
+            listProductPriceAggregates();
+            break;
+        case 7:
+            showProductPriceStatistics();
+            break;
         case 0:
             printf("Returning to main menu...\n");
             break;
@@ -848,6 +918,7 @@ bool addVendor() {
     // Write to file (ID and name)
     fwrite(&vendor, sizeof(Vendor), 1, file);
     fclose(file);
+    addVendorToSearchIndex(SEARCH_INDEX_FILE, "products.bin", "vendor.bin", &vendor);
 
     printf("Vendor added successfully!\n");
 
@@ -888,6 +959,7 @@ bool updateVendor() {
         printf("Vendor with ID %d not found.\n", id);
     }
     fclose(file); // Remember to close the file
+    if (found) {refreshSearchIndex(SEARCH_INDEX_FILE, "products.bin", "vendor.bin");}
     // Buffer clearing and waiting for key press to continue
     while (getchar() != '\n');  // Clear extra newline character
     printf("Press Enter to continue...");
@@ -928,7 +1000,7 @@ bool deleteVendor() {
     remove("vendor.bin");
     rename("temp.bin", "vendor.bin");
 
-    if (found) {printf("Vendor deleted successfully!\n");}
+    if (found) {refreshSearchIndex(SEARCH_INDEX_FILE, "products.bin", "vendor.bin");printf("Vendor deleted successfully!\n");}
     else {
         printf("Vendor with ID %d not found.\n", id);
     }
@@ -1260,6 +1332,171 @@ bool isDuplicate(Queue* queue, Vendor vendor) {
 
 
 
+/**
+ * @brief Running count, mean, deviation and extremes of the prices in products.bin.
+ */
+static Coruh::Utility::RunningStatistics catalogPriceStatistics;
+
+/**
+ * @brief Approximate median and percentiles of the same prices.
+ */
+static Coruh::Utility::QuantileDigest catalogPriceQuantiles;
+
+/**
+ * @brief Indicates that the accumulators hold every price of products.bin; cleared when a price leaves the file.
+ */
+static bool catalogPriceStatisticsCurrent = false;
+
+/**
+ * @brief Feeds the price of a product appended to products.bin into the running price statistics.
+ *
+ * Costs O(1). While the statistics are not current the price is skipped; the next view reads it from products.bin.
+ *
+ * @param price The price.
+ */
+void recordProductPrice(float price) {
+    if (!catalogPriceStatisticsCurrent) {return;}
+    catalogPriceStatistics.add(price);
+    catalogPriceQuantiles.add(price);
+}
+
+/**
+ * @brief Clears the running price statistics; the next view reads them again from products.bin.
+ *
+ * Called when a price is updated or a product deleted: a price cannot be taken out of the accumulators.
+ */
+void resetProductPriceStatistics() {
+    catalogPriceStatistics.reset();
+    catalogPriceQuantiles.reset();
+    catalogPriceStatisticsCurrent = false;
+}
+
+/**
+ * @brief Shows the count, mean, deviation, extremes and percentiles of the prices in products.bin.
+ *
+ * The accumulators are filled with one scan of products.bin the first time, and again after an update or a
+ * delete; products added in between are fed in by recordProductPrice(), so repeated views cost O(1).
+ *
+ * @return Always true.
+ */
+bool showProductPriceStatistics() {
+    if (!catalogPriceStatisticsCurrent) {
+        FILE* productFile = fopen("products.bin", "rb");
+        Product product;
+        while (productFile != NULL && fread(&product, sizeof(Product), 1, productFile)) {
+            catalogPriceStatistics.add(product.price);
+            catalogPriceQuantiles.add(product.price);
+        }
+        if (productFile != NULL) {fclose(productFile);}
+        catalogPriceStatisticsCurrent = true;
+    }
+
+    printf("\n--- Catalog price statistics ---\n");
+    if (catalogPriceStatistics.count() == 0) {
+        printf("No products in the catalog.\n");
+        return true;
+    }
+    printf("Prices: %llu\n", (unsigned long long)catalogPriceStatistics.count());
+    printf("Mean: %.2f, Standard deviation: %.2f\n", catalogPriceStatistics.mean(), catalogPriceStatistics.standardDeviation());
+    printf("Min: %.2f, Max: %.2f\n", catalogPriceStatistics.minimum(), catalogPriceStatistics.maximum());
+    printf("Median: %.2f, P90: %.2f, P99: %.2f\n", catalogPriceQuantiles.quantile(0.5), catalogPriceQuantiles.quantile(0.9),
+           catalogPriceQuantiles.quantile(0.99));
+    return true;
+}
+
+/**
+ * @brief Opens products.idx if it exists, rebuilding it first if products.bin changed behind its back.
+ *
+ * @return The open index, or NULL if there is none and callers have to scan products.bin.
+ */
+static PagedBPlusTree* openExistingProductIndex() {
+    FILE* existing = fopen(PRODUCT_INDEX_FILE, "rb");
+    if (existing == NULL) {return NULL;}
+    fclose(existing);
+    return openProductIndex(PRODUCT_INDEX_FILE, "products.bin", 0);
+}
+
+/**
+ * @brief Orders record offsets ascending for qsort().
+ */
+static int compareRecordOffsets(const void* a, const void* b) {
+    int64_t left = *(const int64_t*)a;
+    int64_t right = *(const int64_t*)b;
+    return left < right ? -1 : (left > right ? 1 : 0);
+}
+
+/**
+ * @brief Collects the record offsets of a product name, through products.idx when it exists.
+ *
+ * The index holds every record, so a vendor that listed the same product twice is found with both records.
+ * Without an index every record of the open file is read.
+ *
+ * @param productFile The open products file, used when there is no index.
+ * @param productName The product name.
+ * @param foOffsets Receives a malloc'ed array of offsets in ascending file order, or NULL if there are none.
+ * @return The number of records, or -1 on failure.
+ */
+static int findProductOffsetsByName(FILE* productFile, const char* productName, int64_t** foOffsets) {
+    *foOffsets = NULL;
+    PagedBPlusTree* index = openExistingProductIndex();
+    if (index != NULL) {
+        int count = pagedBPlusTreeFindName(index, productName, NULL, 0);
+        if (count > 0) {
+            *foOffsets = (int64_t*)malloc((size_t)count * sizeof(int64_t));
+            if (*foOffsets == NULL || pagedBPlusTreeFindName(index, productName, *foOffsets, count) != count) {count = -1;}
+        }
+        closePagedBPlusTree(index);
+        if (count < 0) {
+            free(*foOffsets);
+            *foOffsets = NULL;
+            return -1;
+        }
+        if (count > 1) {qsort(*foOffsets, (size_t)count, sizeof(int64_t), compareRecordOffsets);}
+        return count;
+    }
+
+    int count = 0;
+    int capacity = 0;
+    Product product;
+    rewind(productFile);
+    for (int64_t offset = 0; fread(&product, sizeof(Product), 1, productFile); offset += (int64_t)sizeof(Product)) {
+        if (strcmp(product.productName, productName) != 0) {continue;}
+        if (count == capacity) {
+            capacity = capacity == 0 ? 8 : capacity * 2;
+            int64_t* grown = (int64_t*)realloc(*foOffsets, (size_t)capacity * sizeof(int64_t));
+            if (grown == NULL) {
+                free(*foOffsets);
+                *foOffsets = NULL;
+                return -1;
+            }
+            *foOffsets = grown;
+        }
+        (*foOffsets)[count++] = offset;
+    }
+    return count;
+}
+
+/**
+ * @brief Appends a record and its offset to a growable list of index changes.
+ *
+ * @return true on success, false when out of memory; the caller then rebuilds the index instead.
+ */
+static bool appendProductChange(Product** records, int64_t** offsets, int* count, int* capacity, const Product* record, int64_t offset) {
+    if (*count == *capacity) {
+        int grownCapacity = *capacity == 0 ? 16 : *capacity * 2;
+        Product* grownRecords = (Product*)realloc(*records, (size_t)grownCapacity * sizeof(Product));
+        if (grownRecords == NULL) {return false;}
+        *records = grownRecords;
+        int64_t* grownOffsets = (int64_t*)realloc(*offsets, (size_t)grownCapacity * sizeof(int64_t));
+        if (grownOffsets == NULL) {return false;}
+        *offsets = grownOffsets;
+        *capacity = grownCapacity;
+    }
+    (*records)[*count] = *record;
+    (*offsets)[(*count)++] = offset;
+    return true;
+}
+
 /**
  * @brief Adds a new product to the products file.
  *
@@ -1308,6 +1545,10 @@ bool addProduct() {
     //We write the product information in the file
     fwrite(&product, sizeof(Product), 1, productFile);
     fclose(productFile);
+    appendToProductIndex(PRODUCT_INDEX_FILE, "products.bin", &product);
+    addToProductPriceSummaries(PRODUCT_PRICE_SUMMARY_FILE, &product);
+    addProductToSearchIndex(SEARCH_INDEX_FILE, "products.bin", "vendor.bin", &product);
+    recordProductPrice(product.price);
 
     printf("Product added successfully!\n");
 
@@ -1325,39 +1566,76 @@ bool addProduct() {
  *
  * This function updates a product's details in the "products.bin" file by asking for the product name.
  * If the product is found, it allows the user to modify the details of that product.
+ * Every record with that name is located through products.idx when it exists and is rewritten in place;
+ * repeated listings of the same vendor each get their own prompt, index entry and summary update.
  *
  * @return Returns true (1) if the product is updated successfully, false (0) otherwise.
  */
 bool updateProduct() {
-    FILE* productFile, * tempFile;
+    FILE* productFile;
     Product product;
     char productName[50];
     int found = 0;
+    Product* updatedProducts = NULL;
+    int updatedCount = 0;
 
-    productFile = fopen("products.bin", "rb"); 
+    productFile = fopen("products.bin", "r+b");
     if (productFile == NULL) {printf("Error opening product file.\n");return 1;}
 
-    tempFile = fopen("temp.bin", "wb");
-    if (tempFile == NULL) {printf("Error creating temporary file.\n");fclose(productFile);return 1;}
-
     printf("Enter Product Name to update: ");
     scanf("%s", productName);
 
-    // Read all products from the file and check the name
-    while (fread(&product, sizeof(Product), 1, productFile)) {if (strcmp(product.productName, productName) == 0) {found = 1;printf("Enter new Product Name: ");scanf("%s", product.productName);printf("Enter new Product Price: ");scanf("%f", &product.price);printf("Enter new Product Quantity: ");scanf("%d", &product.quantity);printf("Enter new Product Season: ");scanf("%s", product.season);}fwrite(&product, sizeof(Product), 1, tempFile);}
+    // Locate the records (through products.idx if it exists) and rewrite each one in place
+    int64_t* offsets = NULL;
+    int offsetCount = findProductOffsetsByName(productFile, productName, &offsets);
+    Product* previousProducts = NULL;
+    int64_t* updatedOffsets = NULL;
+    if (offsetCount > 0) {
+        previousProducts = (Product*)malloc((size_t)offsetCount * sizeof(Product));
+        updatedProducts = (Product*)malloc((size_t)offsetCount * sizeof(Product));
+        updatedOffsets = (int64_t*)malloc((size_t)offsetCount * sizeof(int64_t));
+    }
+    bool tracked = previousProducts != NULL && updatedProducts != NULL && updatedOffsets != NULL;
+    for (int i = 0; i < offsetCount; i++) {
+        if (!readProductAtOffset(productFile, offsets[i], &product)) {continue;}
+        if (tracked) {previousProducts[updatedCount] = product;}
+        found = 1;printf("Enter new Product Name: ");scanf("%s", product.productName);printf("Enter new Product Price: ");scanf("%f", &product.price);printf("Enter new Product Quantity: ");scanf("%d", &product.quantity);printf("Enter new Product Season: ");scanf("%s", product.season);
+        fseek(productFile, -(long)sizeof(Product), SEEK_CUR);
+        fwrite(&product, sizeof(Product), 1, productFile);
+        // Remember the old and new records for the index and the price summaries
+        if (tracked) {
+            updatedProducts[updatedCount] = product;
+            updatedOffsets[updatedCount++] = offsets[i];
+        }
+    }
+    free(offsets);
 
     fclose(productFile);
-    fclose(tempFile);
 
     if (!found) {
         printf("Product with name %s not found.\n", productName);
-        remove("temp.bin"); // Delete temporary file
     }
     else {
-        remove("products.bin"); // Delete original file
-        rename("temp.bin", "products.bin"); // Rename temporary file as original file
+        // Records stay where they are, so only the keys of the rewritten records change
+        if (tracked) {patchProductIndex(PRODUCT_INDEX_FILE, "products.bin", 0, previousProducts, updatedOffsets, updatedCount, updatedProducts, updatedOffsets, updatedCount);}
+        else {refreshProductIndex(PRODUCT_INDEX_FILE, "products.bin");}
+        // Every record of the old name was rewritten: drop its summary and add the new records. Without the
+        // rewritten records at hand an existing summary file is rebuilt instead
+        if (tracked) {
+            removeFromProductPriceSummaries(PRODUCT_PRICE_SUMMARY_FILE, productName);
+            for (int i = 0; i < updatedCount; i++) {addToProductPriceSummaries(PRODUCT_PRICE_SUMMARY_FILE, &updatedProducts[i]);}
+        }
+        else {
+            FILE* summaryFile = fopen(PRODUCT_PRICE_SUMMARY_FILE, "rb");
+            if (summaryFile != NULL) {fclose(summaryFile);buildProductPriceSummaries(PRODUCT_PRICE_SUMMARY_FILE, "products.bin");}
+        }
+        refreshSearchIndex(SEARCH_INDEX_FILE, "products.bin", "vendor.bin");
+        resetProductPriceStatistics();
         printf("Product updated successfully!\n");
     }
+    free(previousProducts);
+    free(updatedOffsets);
+    free(updatedProducts);
 
     printf("Press Enter to continue...");
     getchar();
@@ -1371,7 +1649,9 @@ bool updateProduct() {
  * @brief Deletes an existing product from the products file.
  *
  * This function deletes a product from the "products.bin" file by asking for the product name.
- * If the product is found, it is removed from the file.
+ * If the product is found, it is removed from the file. A name that products.idx does not know is reported
+ * as not found without reading products.bin; otherwise only the keys of the deleted and moved records are
+ * changed in the index.
  *
  * @return Returns true (1) if the product is deleted successfully, false (0) otherwise.
  */
@@ -1390,8 +1670,37 @@ bool deleteProduct() {
     printf("Enter Product Name to delete: ");
     scanf("%s", productName);
 
+    // A name products.idx does not know is not in the file, so the rewrite is skipped
+    PagedBPlusTree* index = openExistingProductIndex();
+    bool listed = index == NULL || pagedBPlusTreeFindName(index, productName, NULL, 0) != 0;
+    if (index != NULL) {closePagedBPlusTree(index);}
+
+    // Deleted records, and the records behind them that move up, are collected for the index; a moved record
+    // is removed at its old offset and placed at its new one
+    Product* removedProducts = NULL;
+    int64_t* removedOffsets = NULL;
+    int removedCount = 0, removedCapacity = 0, deletedCount = 0;
+    Product* movedProducts = NULL;
+    int64_t* movedOffsets = NULL;
+    int movedCount = 0, movedCapacity = 0;
+    bool tracked = true;
+    int64_t offset = 0, written = 0;
+
     // Read all products from the file and check the name
-    while (fread(&product, sizeof(Product), 1, productFile)) {if (strcmp(product.productName, productName) == 0) {found = 1;printf("Product with name %s deleted successfully!\n", productName);continue; }fwrite(&product, sizeof(Product), 1, tempFile); }
+    for (; listed && fread(&product, sizeof(Product), 1, productFile); offset += (int64_t)sizeof(Product)) {
+        if (strcmp(product.productName, productName) == 0) {
+            found = 1;printf("Product with name %s deleted successfully!\n", productName);
+            tracked = tracked && appendProductChange(&removedProducts, &removedOffsets, &removedCount, &removedCapacity, &product, offset);
+            deletedCount++;
+            continue;
+        }
+        fwrite(&product, sizeof(Product), 1, tempFile);
+        if (found) {
+            tracked = tracked && appendProductChange(&removedProducts, &removedOffsets, &removedCount, &removedCapacity, &product, offset);
+            tracked = tracked && appendProductChange(&movedProducts, &movedOffsets, &movedCount, &movedCapacity, &product, written);
+        }
+        written += (int64_t)sizeof(Product);
+    }
 
     fclose(productFile);
     fclose(tempFile);
@@ -1403,7 +1712,16 @@ bool deleteProduct() {
     else {
         remove("products.bin"); // Delete original file
         rename("temp.bin", "products.bin"); // Rename temporary file as original file
+        if (tracked) {patchProductIndex(PRODUCT_INDEX_FILE, "products.bin", -deletedCount, removedProducts, removedOffsets, removedCount, movedProducts, movedOffsets, movedCount);}
+        else {refreshProductIndex(PRODUCT_INDEX_FILE, "products.bin");}
+        removeFromProductPriceSummaries(PRODUCT_PRICE_SUMMARY_FILE, productName);
+        refreshSearchIndex(SEARCH_INDEX_FILE, "products.bin", "vendor.bin");
+        resetProductPriceStatistics();
     }
+    free(removedProducts);
+    free(removedOffsets);
+    free(movedProducts);
+    free(movedOffsets);
 
     printf("Press Enter to continue...");
     getchar();
@@ -1417,6 +1735,7 @@ bool deleteProduct() {
  * @brief Lists all vendors and their respective products.
  *
  * This function reads the "vendor.bin" file to list all vendors, and for each vendor, lists the products associated with them from "products.bin".
+ * With products.idx each vendor's products are read directly at their offsets instead of scanning the file per vendor.
  * It provides the user an option to select a collision resolution strategy for vendor products.
  *
  * @return Returns true (1) when listing is complete.
@@ -1456,18 +1775,36 @@ bool listingOfLocalVendorsandProducts() {
         return true;
     }
 
-    rewind(productFile); // Reset file pointer for products
+    // products.idx lists each vendor's products directly; without it the file is read once per vendor
+    PagedBPlusTree* index = openExistingProductIndex();
+    int64_t* offsets = NULL;
+    int offsetCapacity = 0;
 
     // Loop through all vendors
     while (fread(&vendor, sizeof(Vendor), 1, vendorFile)) {
         printf("\nVendor: %s (ID: %d)\n", vendor.name, vendor.id);
         printf("--------------------------\n");
 
+        int offsetCount = -1;
+        if (index != NULL) {
+            offsetCount = pagedBPlusTreeScanVendor(index, vendor.id, offsets, offsetCapacity);
+            if (offsetCount > offsetCapacity) {
+                int64_t* grown = (int64_t*)realloc(offsets, (size_t)offsetCount * sizeof(int64_t));
+                if (grown == NULL) {offsetCount = -1;}
+                else {
+                    offsets = grown;
+                    offsetCapacity = offsetCount;
+                    offsetCount = pagedBPlusTreeScanVendor(index, vendor.id, offsets, offsetCapacity);
+                }
+            }
+        }
+
         // Loop through all products for the current vendor
         rewind(productFile); // Reset product file pointer for each vendor
         int productFound = 0;
 
-        while (fread(&product, sizeof(Product), 1, productFile)) {
+        for (int i = 0; offsetCount < 0 ? fread(&product, sizeof(Product), 1, productFile) == 1 : i < offsetCount; i++) {
+            if (offsetCount >= 0 && !readProductAtOffset(productFile, offsets[i], &product)) {continue;}
             if (product.vendorId == vendor.id && product.price != 0 && product.quantity != 0) {
                 switch (strategy) {
                 case 1: // Linear Probing
@@ -1493,6 +1830,8 @@ bool listingOfLocalVendorsandProducts() {
                     break;
                 default:
                     printf("Invalid strategy selected.\n");
+                    free(offsets);
+                    if (index != NULL) {closePagedBPlusTree(index);}
                     fclose(vendorFile);
                     fclose(productFile);
                     return false;
@@ -1508,6 +1847,8 @@ bool listingOfLocalVendorsandProducts() {
             printf("No products available for this vendor.\n");
         }
     }
+    free(offsets);
+    if (index != NULL) {closePagedBPlusTree(index);}
 
     if (!found) {printf("No products found for any vendor.\n");}
 
@@ -1523,17 +1864,146 @@ bool listingOfLocalVendorsandProducts() {
 
 
 /**
- * @brief Represents a sparse matrix entry for vendor-product relationships.
- * @details Used to store non-zero relationships between vendors and products, including prices.
+ * @brief Vendor-product relationships with their prices.
+ * @details Grows without a fixed limit; duplicate (vendor, product) pairs keep the last price once finalised.
+ */
+SparseMatrixBuilder vendorProductRelations = {NULL, 0, 0, true};
+
+/**
+ * @brief Relations file mapped by loadVendorProductRelations().
+ * @details While mapped it is the source of the relations and vendorProductRelations is empty; the first change
+ * copies the relations into vendorProductRelations and releases the mapping.
+ */
+static MappedSparseMatrix mappedVendorProductRelations;
+
+/**
+ * @brief Relations file the relations were last loaded from or saved to, "" if none.
+ * @details addVendorProductRelation() writes every change through to it while it exists.
+ */
+static char vendorProductRelationsPath[260] = "";
+
+/**
+ * @brief Remembers the relations file that later changes are written to.
  */
-SparseMatrixEntry sparseMatrix[MAX_VENDORS * MAX_PRODUCTS];
+static void setVendorProductRelationsPath(const char* path) {
+    strncpy(vendorProductRelationsPath, path, sizeof(vendorProductRelationsPath) - 1);
+    vendorProductRelationsPath[sizeof(vendorProductRelationsPath) - 1] = '\0';
+}
 
 /**
- * @brief The current size of the sparse matrix containing vendor-product relationships.
+ * @brief Incremented on every change to the relations; the compressed views are rebuilt when it moves on.
  */
-int sparseMatrixSize = 0;
+static unsigned long sparseMatrixVersion = 0;
+
+/** @brief vendorProductRelations grouped by vendor (CSR), built on demand. */
+static CompressedSparseMatrix vendorProductRows = {SPARSE_BY_VENDOR, 0, 0, NULL, NULL, NULL, NULL};
+
+/** @brief The relations grouped by product (CSC), built on demand. */
+static CompressedSparseMatrix vendorProductColumns = {SPARSE_BY_PRODUCT, 0, 0, NULL, NULL, NULL, NULL};
+
+/** @brief Value of sparseMatrixVersion vendorProductRows was built from. */
+static unsigned long vendorProductRowsVersion = (unsigned long)-1;
 
+/** @brief Value of sparseMatrixVersion vendorProductColumns was built from. */
+static unsigned long vendorProductColumnsVersion = (unsigned long)-1;
+
+/**
+ * @brief Returns the relations grouped by vendor, rebuilding them if relations were added since the last build.
+ *
+ * A mapped relations file is used in place. Duplicate relations are resolved here, in one batch, rather than
+ * on every insertion.
+ *
+ * @return The CSR view, or NULL if it could not be built.
+ */
+static const CompressedSparseMatrix* vendorProductRowView() {
+    if (mappedVendorProductRelations.address != NULL) {return &mappedVendorProductRelations.matrix;}
+    if (vendorProductRowsVersion != sparseMatrixVersion) {
+        freeCompressedSparseMatrix(&vendorProductRows);
+        if (!freezeSparseMatrixBuilder(&vendorProductRelations, SPARSE_BY_VENDOR, &vendorProductRows)) {return NULL;}
+        vendorProductRowsVersion = sparseMatrixVersion;
+    }
+    return &vendorProductRows;
+}
 
+/**
+ * @brief Returns the relations grouped by product, rebuilding them if relations were added since the last build.
+ *
+ * @return The CSC view, or NULL if it could not be built.
+ */
+static const CompressedSparseMatrix* vendorProductColumnView() {
+    if (vendorProductColumnsVersion != sparseMatrixVersion) {
+        freeCompressedSparseMatrix(&vendorProductColumns);
+        bool built;
+        if (mappedVendorProductRelations.address != NULL) {
+            // The file only holds the CSR layout; transpose it through a temporary builder
+            SparseMatrixBuilder transposed;
+            built = initSparseMatrixBuilder(&transposed, mappedVendorProductRelations.matrix.entryCount) &&
+                    appendCompressedSparseMatrixToBuilder(&mappedVendorProductRelations.matrix, &transposed) &&
+                    freezeSparseMatrixBuilder(&transposed, SPARSE_BY_PRODUCT, &vendorProductColumns);
+            freeSparseMatrixBuilder(&transposed);
+        }
+        else {
+            built = freezeSparseMatrixBuilder(&vendorProductRelations, SPARSE_BY_PRODUCT, &vendorProductColumns);
+        }
+        if (!built) {return NULL;}
+        vendorProductColumnsVersion = sparseMatrixVersion;
+    }
+    return &vendorProductColumns;
+}
+
+/**
+ * @brief Copies the relations of a mapped relations file into vendorProductRelations and releases the mapping.
+ *
+ * @return true on success or if no file is mapped, false if memory ran out.
+ */
+static bool detachVendorProductRelations() {
+    if (mappedVendorProductRelations.address == NULL) {return true;}
+    if (!appendCompressedSparseMatrixToBuilder(&mappedVendorProductRelations.matrix, &vendorProductRelations)) {return false;}
+    unmapCompressedSparseMatrixFile(&mappedVendorProductRelations);
+    sparseMatrixVersion++;
+    return true;
+}
+
+/**
+ * @brief Replaces the vendor-product relations with the contents of a relations file.
+ *
+ * The file is memory mapped and used in place, so loading takes the same time for any number of relations.
+ * Relations added afterwards are saved back to the same file.
+ *
+ * @param path The relations file, e.g. VENDOR_PRODUCT_RELATIONS_FILE.
+ * @return true on success, false if the file is missing or invalid (the current relations are kept).
+ */
+bool loadVendorProductRelations(const char* path) {
+    MappedSparseMatrix mapped;
+    if (!mapCompressedSparseMatrixFile(path, &mapped)) {return false;}
+    if (mapped.matrix.axis != SPARSE_BY_VENDOR) {
+        unmapCompressedSparseMatrixFile(&mapped);
+        return false;
+    }
+    unmapCompressedSparseMatrixFile(&mappedVendorProductRelations);
+    freeSparseMatrixBuilder(&vendorProductRelations);
+    mappedVendorProductRelations = mapped;
+    sparseMatrixVersion++;
+    setVendorProductRelationsPath(path);
+    return true;
+}
+
+/**
+ * @brief Saves the vendor-product relations to a relations file, replacing it atomically.
+ *
+ * Relations added afterwards are saved to the same file.
+ *
+ * @param path The relations file, e.g. VENDOR_PRODUCT_RELATIONS_FILE.
+ * @return true on success, false on I/O errors.
+ */
+bool saveVendorProductRelations(const char* path) {
+    // A mapped file may be the one being replaced, so the relations are copied out first
+    if (!detachVendorProductRelations()) {return false;}
+    const CompressedSparseMatrix* rows = vendorProductRowView();
+    if (rows == NULL || !writeCompressedSparseMatrixFile(rows, path)) {return false;}
+    setVendorProductRelationsPath(path);
+    return true;
+}
 
 /**
  * @brief Adds a relationship between a vendor and a product.
@@ -1541,37 +2011,109 @@ int sparseMatrixSize = 0;
  * @param vendorId The ID of the vendor.
  * @param productId The ID of the product.
  * @param price The price of the product from the vendor.
+ * If the relations were loaded from or saved to a relations file and that file still exists, it is rewritten
+ * with the new relation (atomically, through a temporary file), so it never falls behind the relations in memory.
  *
- * @note The function ignores the relation if the price is zero.
+ * @return true if the relation was stored or ignored because of a zero price, false if memory ran out or the
+ * relations file could not be written (the relation is kept in memory).
+ *
+ * @note The function ignores the relation if the price is zero. Adding a pair again replaces its price.
  */
-void addVendorProductRelation(int vendorId, int productId, float price) {
+bool addVendorProductRelation(int vendorId, int productId, float price) {
 
-    if (price == 0) {return;
+    if (price == 0) {return true;
     }
     // We add a new relation to the sparse matrix
-    sparseMatrix[sparseMatrixSize].vendorId = vendorId;
-    sparseMatrix[sparseMatrixSize].productId = productId;
-    sparseMatrix[sparseMatrixSize].price = price;
-    sparseMatrixSize++;
+    if (!detachVendorProductRelations() || !sparseMatrixBuilderAdd(&vendorProductRelations, vendorId, productId, price)) {
+        printf("Not enough memory, relation %d-%d was not added.\n", vendorId, productId);
+        return false;
+    }
+    sparseMatrixVersion++;
+    if (vendorProductRelationsPath[0] == '\0') {return true;}
+
+    FILE* existing = fopen(vendorProductRelationsPath, "rb");
+    if (existing == NULL) {return true;}
+    fclose(existing);
+    if (!saveVendorProductRelations(vendorProductRelationsPath)) {
+        printf("Relation %d-%d could not be saved to %s.\n", vendorId, productId, vendorProductRelationsPath);
+        return false;
+    }
+    return true;
 }
 
 /**
  * @brief Lists all products offered by a specific vendor.
  *
+ * Reads the vendor's row of the CSR view, so the cost depends on the number of products of the vendor
+ * rather than on the size of the whole matrix.
+ *
  * @param vendorId The ID of the vendor whose products are to be listed.
  *
  * @note If no products are found for the vendor, a corresponding message is displayed.
  */
 bool listProductsByVendor(int vendorId) {
     printf("\n--- Products offered by Vendor %d ---\n", vendorId);
-    int found = 0;
-    for (int i = 0; i < sparseMatrixSize; i++) { if (sparseMatrix[i].vendorId == vendorId) {  printf("Product ID: %d, Price: %.2f\n", sparseMatrix[i].productId, sparseMatrix[i].price); found = 1;}}
-    if (!found) {
+    const CompressedSparseMatrix* rows = vendorProductRowView();
+    if (rows == NULL) {return false;}
+    const int* productIds = NULL;
+    const float* prices = NULL;
+    int count = compressedSparseMatrixRow(rows, vendorId, &productIds, &prices);
+    for (int i = 0; i < count; i++) {printf("Product ID: %d, Price: %.2f\n", productIds[i], prices[i]);}
+    if (count == 0) {
         printf("No products found for Vendor %d.\n", vendorId);
     }
     return true;
 }
 
+/**
+ * @brief Lists all vendors selling a specific product.
+ *
+ * Reads the product's column of the CSC view.
+ *
+ * @param productId The ID of the product.
+ *
+ * @note If no vendor sells the product, a corresponding message is displayed.
+ */
+bool listVendorsByProduct(int productId) {
+    printf("\n--- Vendors selling Product %d ---\n", productId);
+    const CompressedSparseMatrix* columns = vendorProductColumnView();
+    if (columns == NULL) {return false;}
+    const int* vendorIds = NULL;
+    const float* prices = NULL;
+    int count = compressedSparseMatrixRow(columns, productId, &vendorIds, &prices);
+    for (int i = 0; i < count; i++) {printf("Vendor ID: %d, Price: %.2f\n", vendorIds[i], prices[i]);}
+    if (count == 0) {
+        printf("No vendors found for Product %d.\n", productId);
+    }
+    return true;
+}
+
+/**
+ * @brief Lists the lowest, highest and average price and the number of vendors of every product.
+ *
+ * The statistics come from vectorized reductions over the columns of the CSC view instead of a scan of
+ * products.bin per product.
+ */
+bool listProductPriceAggregates() {
+    printf("\n--- Price summary per product ---\n");
+    const CompressedSparseMatrix* columns = vendorProductColumnView();
+    if (columns == NULL) {return false;}
+    int count = aggregateProductPrices(columns, NULL, 0);
+    if (count <= 0) {
+        printf("No vendor-product relations found.\n");
+        return true;
+    }
+    ProductPriceAggregate* aggregates = (ProductPriceAggregate*)malloc((size_t)count * sizeof(ProductPriceAggregate));
+    if (aggregates == NULL) {return false;}
+    aggregateProductPrices(columns, aggregates, count);
+    for (int i = 0; i < count; i++) {
+        printf("Product ID: %d, Vendors: %d, Min: %.2f, Max: %.2f, Mean: %.2f\n", aggregates[i].productId, aggregates[i].count,
+               aggregates[i].minPrice, aggregates[i].maxPrice, aggregates[i].meanPrice);
+    }
+    free(aggregates);
+    return true;
+}
+
 /**
  * @brief Hash function to determine the index for a given key.
  *
@@ -1705,6 +2247,24 @@ int brentsMethodSearch(int key) {
 }
 
 
+/**
+ * @brief Queries the search index kept next to products.bin and vendor.bin, building it first if needed.
+ *
+ * @return The number of matching records, or -1 if there is no usable index and the caller has to scan the files.
+ */
+static int searchMarketIndex(const SearchField fields[], int fieldCount, const char* const terms[], int termCount, SearchTermMatch match, bool matchAll, uint32_t** foRecords) {
+    *foRecords = NULL;
+    if (!openSearchIndex(SEARCH_INDEX_FILE, "products.bin", "vendor.bin")) {return -1;}
+    return querySearchIndex(SEARCH_INDEX_FILE, fields, fieldCount, terms, termCount, match, matchAll, foRecords);
+}
+
+/**
+ * @brief Reads a fixed-size record by its record number.
+ */
+static bool readRecordAt(FILE* file, uint32_t record, void* foRecord, size_t recordSize) {
+    return fseek(file, (long)(record * recordSize), SEEK_SET) == 0 && fread(foRecord, recordSize, 1, file) == 1;
+}
+
 /**
  * @brief Selects a product from the list of available products.
  *
@@ -1743,14 +2303,12 @@ bool selectProduct(char* selectedProductName) {
         return 1;
     }
 
-    bool found = false;
-    while (fread(&product, sizeof(Product), 1, productFile)) {
-        if (strcmp(product.productName, selectedProductName) == 0) {
-            printf("Selected Product: %s, Price: %.2f\n", product.productName, product.price);
-            found = true;
-            break;
-        }
-    }
+    // products.idx names the record of every vendor offering the product; the first one in the file is selected
+    int64_t* offsets = NULL;
+    int offsetCount = findProductOffsetsByName(productFile, selectedProductName, &offsets);
+    bool found = offsetCount > 0 && readProductAtOffset(productFile, offsets[0], &product);
+    free(offsets);
+    if (found) {printf("Selected Product: %s, Price: %.2f\n", product.productName, product.price);}
 
     fclose(productFile);
 
@@ -1790,71 +2348,353 @@ bool heapify(Product arr[], int n, int i) {
 }
 
 
+/**
+ * @brief Returns true if key a sorts before key b: lower price first, record order among equal prices.
+ */
+static bool priceKeyBefore(const PriceSortKey* a, const PriceSortKey* b) {
+    return a->price < b->price || (a->price == b->price && a->index < b->index);
+}
+
+/**
+ * @brief Moves the key at index i down a max-heap of n keys until the heap order holds.
+ *
+ * The moving key is held aside and children are shifted up into the hole, so each level costs one 8-byte
+ * move instead of a swap.
+ */
+static void siftDownPriceKeys(PriceSortKey keys[], int n, int i) {
+    PriceSortKey moving = keys[i];
+    while (true) {
+        int child = 2 * i + 1;
+        if (child >= n) {break;}
+        if (child + 1 < n && priceKeyBefore(&keys[child], &keys[child + 1])) {child++;}
+        if (!priceKeyBefore(&moving, &keys[child])) {break;}
+        keys[i] = keys[child];
+        i = child;
+    }
+    keys[i] = moving;
+}
+
+/**
+ * @brief Sorts (price, record index) keys by ascending price with an in-place heap sort.
+ *
+ * Equal prices are ordered by record index, so the result is the same as a stable sort.
+ *
+ * @param keys Keys to be sorted.
+ * @param n Number of keys.
+ */
+void heapSortPriceKeys(PriceSortKey keys[], int n) {
+    for (int i = n / 2 - 1; i >= 0; i--) {siftDownPriceKeys(keys, n, i);}
+    for (int end = n - 1; end > 0; end--) {
+        PriceSortKey largest = keys[0];
+        keys[0] = keys[end];
+        keys[end] = largest;
+        siftDownPriceKeys(keys, end, 0);
+    }
+}
+
 /**
  * @brief Performs heap sort algorithm.
  *
- * This function sorts the given array by creating a max-heap and applying heap sort.
+ * This function sorts the given array by price. The heap is built over compact (price, index) keys; the
+ * products themselves are moved once, into their final positions, after the keys are sorted.
  *
  * @param arr Array of products to be sorted.
  * @param n Number of elements in the array.
  */
 void heapSort(Product arr[], int n) {
-    // Create max-heap for array
-    for (int i = n / 2 - 1; i >= 0; i--)
-        heapify(arr, n, i);
+    if (n < 2) {return;}
+    PriceSortKey* keys = (PriceSortKey*)malloc((size_t)n * sizeof(PriceSortKey));
+    Product* sorted = (Product*)malloc((size_t)n * sizeof(Product));
+    if (keys == NULL || sorted == NULL) {
+        free(keys);
+        free(sorted);
+        // Without memory for the keys, sort the products in place
+        for (int i = n / 2 - 1; i >= 0; i--) {heapify(arr, n, i);}
+        for (int i = n - 1; i > 0; i--) {Product temp = arr[0]; arr[0] = arr[i]; arr[i] = temp; heapify(arr, i, 0);}
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        keys[i].price = arr[i].price;
+        keys[i].index = i;
+    }
+    heapSortPriceKeys(keys, n);
+    for (int i = 0; i < n; i++) {sorted[i] = arr[keys[i].index];}
+    memcpy(arr, sorted, (size_t)n * sizeof(Product));
+    free(keys);
+    free(sorted);
+}
+
+
+/**
+ * @brief A heap of at most capacity products that keeps the cheapest or the most expensive products offered to it.
+ *
+ * To keep the cheapest products the heap is ordered with the most expensive kept product at the root, so a new
+ * offer only has to beat the root; keeping the most expensive products works the other way round.
+ */
+typedef struct {
+    Product* items;    ///< Heap storage for capacity products.
+    int count;         ///< Number of products kept.
+    int capacity;      ///< Maximum number of products kept (k).
+    bool keepCheapest; ///< true to keep the cheapest products, false for the most expensive ones.
+} BoundedPriceHeap;
+
+/**
+ * @brief Returns true if product a belongs closer to the root than product b.
+ */
+static bool boundedPriceHeapAbove(const BoundedPriceHeap* heap, const Product* a, const Product* b) {
+    return heap->keepCheapest ? a->price > b->price : a->price < b->price;
+}
+
+/**
+ * @brief Moves the product at index i down until the heap order holds, without recursion.
+ */
+static void boundedPriceHeapSiftDown(BoundedPriceHeap* heap, int count, int i) {
+    Product moving = heap->items[i];
+    while (true) {
+        int child = 2 * i + 1;
+        if (child >= count) {break;}
+        if (child + 1 < count && boundedPriceHeapAbove(heap, &heap->items[child + 1], &heap->items[child])) {child++;}
+        if (!boundedPriceHeapAbove(heap, &heap->items[child], &moving)) {break;}
+        heap->items[i] = heap->items[child];
+        i = child;
+    }
+    heap->items[i] = moving;
+}
+
+/**
+ * @brief Offers a product to the heap; it is kept if the heap is not full or it beats the worst kept product.
+ *
+ * On equal prices the product offered first is kept.
+ */
+static void boundedPriceHeapOffer(BoundedPriceHeap* heap, const Product* product) {
+    if (heap->count < heap->capacity) {
+        // Sift up from the new leaf
+        int i = heap->count++;
+        while (i > 0) {
+            int parent = (i - 1) / 2;
+            if (!boundedPriceHeapAbove(heap, product, &heap->items[parent])) {break;}
+            heap->items[i] = heap->items[parent];
+            i = parent;
+        }
+        heap->items[i] = *product;
+        return;
+    }
+    if (heap->capacity > 0 && boundedPriceHeapAbove(heap, &heap->items[0], product)) {
+        heap->items[0] = *product;
+        boundedPriceHeapSiftDown(heap, heap->count, 0);
+    }
+}
 
-    // Pull elements from the heap one by one
-    for (int i = n - 1; i >= 0; i--) {
-        Product temp = arr[0];
-        arr[0] = arr[i];
-        arr[i] = temp;
+/**
+ * @brief Sorts the kept products in place, best first: cheapest first or most expensive first.
+ */
+static void boundedPriceHeapSort(BoundedPriceHeap* heap) {
+    for (int end = heap->count - 1; end > 0; end--) {
+        Product root = heap->items[0];
+        heap->items[0] = heap->items[end];
+        heap->items[end] = root;
+        boundedPriceHeapSiftDown(heap, end, 0);
+    }
+}
 
-        // Apply heapify for the remaining tree
-        heapify(arr, i, 0);
+/**
+ * @brief Streams the products of a file into bounded heaps for the k cheapest and the k most expensive offers.
+ *
+ * @param productFilePath The product file.
+ * @param productName Name of the products to consider.
+ * @param cheapest Heap for the cheapest products, or NULL.
+ * @param mostExpensive Heap for the most expensive products, or NULL.
+ * @return The number of matching products, -1 if the file cannot be opened.
+ */
+static int streamProductsByPrice(const char* productFilePath, const char* productName, BoundedPriceHeap* cheapest, BoundedPriceHeap* mostExpensive) {
+    FILE* productFile = fopen(productFilePath, "rb");
+    if (productFile == NULL) {return -1;}
+    Product product;
+    int matchCount = 0;
+    while (fread(&product, sizeof(Product), 1, productFile)) {
+        if (strcmp(product.productName, productName) != 0) {continue;}
+        matchCount++;
+        if (cheapest != NULL) {boundedPriceHeapOffer(cheapest, &product);}
+        if (mostExpensive != NULL) {boundedPriceHeapOffer(mostExpensive, &product);}
     }
+    fclose(productFile);
+    if (cheapest != NULL) {boundedPriceHeapSort(cheapest);}
+    if (mostExpensive != NULL) {boundedPriceHeapSort(mostExpensive);}
+    return matchCount;
 }
 
+/**
+ * @brief Finds the k cheapest or the k most expensive offers of a product.
+ *
+ * The file is read once, record by record, through a heap of k products: memory is O(k) and the cost
+ * O(n log k), independent of how many vendors offer the product.
+ *
+ * @param productFilePath The product file, normally "products.bin".
+ * @param productName Name of the product.
+ * @param k Number of offers wanted.
+ * @param cheapest true for the cheapest offers in ascending price, false for the most expensive ones in
+ *        descending price.
+ * @param foProducts Receives up to k products.
+ * @return The number of products stored (less than k if fewer vendors offer the product), -1 if the file
+ *         cannot be opened.
+ */
+int selectProductsByPrice(const char* productFilePath, const char* productName, int k, bool cheapest, Product foProducts[]) {
+    BoundedPriceHeap heap = {foProducts, 0, k > 0 ? k : 0, cheapest};
+    int matchCount = streamProductsByPrice(productFilePath, productName, &heap, NULL);
+    return matchCount < 0 ? -1 : heap.count;
+}
+
+/**
+ * @brief Shows the k cheapest and the k most expensive offers of a product.
+ *
+ * Both lists come from one pass over products.bin with two bounded heaps. A k of 0 or less falls back to
+ * the full sorted comparison of comparePricesByName().
+ *
+ * @param productName Name of the product.
+ * @param k Number of offers per list, CHEAPEST_OFFER_COUNT in the price comparison menu.
+ * @return True if offers are found and shown, false otherwise.
+ */
+bool showBestOffers(const char* productName, int k) {
+    if (k <= 0) {return comparePricesByName(productName);}
+
+    Product* offers = (Product*)malloc(2 * (size_t)k * sizeof(Product));
+    if (offers == NULL) {return false;}
+    BoundedPriceHeap cheapest = {offers, 0, k, true};
+    BoundedPriceHeap mostExpensive = {offers + k, 0, k, false};
+    int matchCount = streamProductsByPrice("products.bin", productName, &cheapest, &mostExpensive);
+    if (matchCount < 0) {
+        printf("Error opening product file.\n");
+        free(offers);
+        return false;
+    }
+    if (matchCount == 0) {
+        printf("No prices found for Product Name '%s'.\n", productName);
+        free(offers);
+        return false;
+    }
+
+    printf("\n--- %d cheapest of %d offers for '%s' ---\n", cheapest.count, matchCount, productName);
+    for (int i = 0; i < cheapest.count; i++) {printf("Vendor ID: %d, Price: %.2f\n", cheapest.items[i].vendorId, cheapest.items[i].price);}
+    printf("\n--- %d most expensive of %d offers for '%s' ---\n", mostExpensive.count, matchCount, productName);
+    for (int i = 0; i < mostExpensive.count; i++) {printf("Vendor ID: %d, Price: %.2f\n", mostExpensive.items[i].vendorId, mostExpensive.items[i].price);}
+    free(offers);
+    return true;
+}
+
+/**
+ * @brief Shows the lowest, highest and average price of a product and the vendors offering the extremes.
+ *
+ * The answer is read from the price summary file, which is built from products.bin on first use and kept
+ * up to date by addProduct(), updateProduct() and deleteProduct() afterwards; no product record is read.
+ *
+ * @param productName Name of the product.
+ * @return True if the product has offers, false otherwise.
+ */
+bool showPriceSummary(const char* productName) {
+    if (!openProductPriceSummaries(PRODUCT_PRICE_SUMMARY_FILE, "products.bin")) {
+        printf("Error opening price summary file.\n");
+        return false;
+    }
+    ProductPriceSummary summary;
+    if (!findProductPriceSummary(PRODUCT_PRICE_SUMMARY_FILE, productName, &summary)) {
+        printf("No prices found for Product Name '%s'.\n", productName);
+        return false;
+    }
+    printf("\n--- Price Summary for Product Name '%s' ---\n", productName);
+    printf("Offers: %d\n", summary.count);
+    printf("Lowest Price: %.2f (Vendor ID: %d)\n", summary.minPrice, summary.minVendorId);
+    printf("Highest Price: %.2f (Vendor ID: %d)\n", summary.maxPrice, summary.maxVendorId);
+    printf("Average Price: %.2f\n", summary.priceSum / summary.count);
+    return true;
+}
 
 /**
  * @brief Compares prices of products with a given name.
  *
  * This function reads products from a binary file, filters those that match the given product name,
- * and sorts them by price using heap sort. It then prints the sorted list of products and their prices.
+ * and sorts them by price using radixSortPriceKeys(). Only (price, index) keys are sorted; products are looked up by
+ * index when they are printed. It then prints the sorted list of products and their prices,
+ * followed by the lowest, highest, average and median price.
  *
  * @param productName Name of the product to compare prices.
  * @return True if products are found and compared, false otherwise.
  */
 bool comparePricesByName(const char* productName) {
     FILE* productFile;
-    Product products[100];
+    Product product;
+    Product* products = NULL;
     int productCount = 0;
-    bool found = false;
+    int productCapacity = 0;
 
     productFile = fopen("products.bin", "rb");
     if (productFile == NULL) {printf("Error opening product file.\n");getchar();return 1;}
 
     // Read products from the file and add the ones that match the given name to the products array
-    while (fread(&products[productCount], sizeof(Product), 1, productFile)) {if (strcmp(products[productCount].productName, productName) == 0) {productCount++;found = true;}}
+    while (fread(&product, sizeof(Product), 1, productFile)) {
+        if (strcmp(product.productName, productName) != 0) {continue;}
+        if (productCount == productCapacity) {
+            int capacity = productCapacity > 0 ? 2 * productCapacity : 16;
+            Product* grown = (Product*)realloc(products, (size_t)capacity * sizeof(Product));
+            if (grown == NULL) {
+                // Comparing only the offers read so far would print wrong extremes, so nothing is compared
+                printf("Not enough memory to compare the prices of Product Name '%s'.\n", productName);
+                fclose(productFile);
+                free(products);
+                getchar();
+                return false;
+            }
+            products = grown;
+            productCapacity = capacity;
+        }
+        products[productCount++] = product;
+    }
 
     fclose(productFile);
 
-    if (!found) {
+    if (productCount == 0) {
         printf("No prices found for Product Name '%s'.\n", productName);
+        free(products);
         getchar();
         return 1;
     }
 
-    // Sort products by price (using heap sort)
-    heapSort(products, productCount);
+    PriceSortKey* keys = (PriceSortKey*)malloc((size_t)productCount * sizeof(PriceSortKey));
+    float* prices = (float*)malloc((size_t)productCount * sizeof(float));
+    if (keys == NULL || prices == NULL) {
+        printf("Not enough memory to compare %d prices.\n", productCount);
+        free(products);
+        free(keys);
+        free(prices);
+        getchar();
+        return false;
+    }
+
+    // Sort the price keys (radix sort, heap sort for few offers)
+    for (int i = 0; i < productCount; i++) {
+        keys[i].price = products[i].price;
+        keys[i].index = i;
+    }
+    radixSortPriceKeys(keys, productCount);
 
     // Sıralanmış ürünleri yazdır
     printf("\n--- Price Comparison for Product Name '%s' (Sorted by Price) ---\n", productName);
     for (int i = 0; i < productCount; i++) {
-        printf("Vendor ID: %d, Price: %.2f\n", products[i].vendorId, products[i].price);
+        printf("Vendor ID: %d, Price: %.2f\n", products[keys[i].index].vendorId, keys[i].price);
+        prices[i] = keys[i].price;
     }
 
-    printf("\nLowest Price: %.2f\n", products[0].price);
-    printf("Highest Price: %.2f\n", products[productCount - 1].price);
+    // The prices are sorted, so the extremes and the median are read off the ends and the middle
+    int middle = productCount / 2;
+    double medianPrice = productCount % 2 != 0 ? prices[middle] : ((double)prices[middle - 1] + prices[middle]) / 2.0;
+
+    printf("\nLowest Price: %.2f\n", prices[0]);
+    printf("Highest Price: %.2f\n", prices[productCount - 1]);
+    printf("Average Price: %.2f\n", Coruh::Utility::MathUtility::calculateMean(prices, productCount));
+    printf("Median Price: %.2f\n", medianPrice);
+    free(products);
+    free(keys);
+    free(prices);
     getchar();
     return true;
 }
@@ -1879,11 +2719,86 @@ BPlusTreeNode* createNode(bool isLeaf) {
     return newNode;
 }
 
+/**
+ * @brief Inserts a key into the subtree rooted at the given node.
+ *
+ * Leaves and internal nodes that overflow MAX_KEYS are split in half. For a leaf the first key of the new
+ * right sibling is copied up to the parent; for an internal node the middle key is moved up.
+ *
+ * @param node Root of the subtree.
+ * @param key Key to be inserted.
+ * @param promotedKey Receives the separator key for the parent when the node splits.
+ * @return The new right sibling if the node was split, NULL otherwise.
+ */
+static BPlusTreeNode* insertIntoSubtree(BPlusTreeNode* node, int key, int* promotedKey) {
+    int keys[MAX_KEYS + 1];
+    BPlusTreeNode* children[MAX_KEYS + 2];
+    int count = node->keyCount;
+
+    if (node->isLeaf) {
+        int position = 0;
+        while (position < count && node->keys[position] <= key) {position++;}
+        for (int i = 0, source = 0; i <= count; i++) {keys[i] = i == position ? key : node->keys[source++];}
+
+        if (count < MAX_KEYS) {
+            for (int i = 0; i <= count; i++) {node->keys[i] = keys[i];}
+            node->keyCount++;
+            return NULL;
+        }
+
+        // Leaf overflow: keep the lower half, move the upper half to a new leaf
+        BPlusTreeNode* newLeaf = createNode(true);
+        int mid = (MAX_KEYS + 1) / 2;
+        node->keyCount = mid;
+        for (int i = 0; i < mid; i++) {node->keys[i] = keys[i];}
+        newLeaf->keyCount = MAX_KEYS + 1 - mid;
+        for (int i = mid; i <= MAX_KEYS; i++) {newLeaf->keys[i - mid] = keys[i];}
+        newLeaf->next = node->next;
+        node->next = newLeaf;
+        *promotedKey = newLeaf->keys[0];
+        return newLeaf;
+    }
+
+    int childIndex = 0;
+    while (childIndex < count && key >= node->keys[childIndex]) {childIndex++;}
+
+    int childKey;
+    BPlusTreeNode* sibling = insertIntoSubtree(node->children[childIndex], key, &childKey);
+    if (sibling == NULL) {return NULL;}
+
+    for (int i = 0, source = 0; i <= count; i++) {keys[i] = i == childIndex ? childKey : node->keys[source++];}
+    for (int i = 0, source = 0; i <= count + 1; i++) {children[i] = i == childIndex + 1 ? sibling : node->children[source++];}
+
+    if (count < MAX_KEYS) {
+        for (int i = 0; i <= count; i++) {node->keys[i] = keys[i];}
+        for (int i = 0; i <= count + 1; i++) {node->children[i] = children[i];}
+        node->keyCount++;
+        return NULL;
+    }
+
+    // Internal overflow: the middle key moves up, the keys and children to its right go to a new node
+    BPlusTreeNode* newInternal = createNode(false);
+    int mid = (MAX_KEYS + 1) / 2;
+    node->keyCount = mid;
+    for (int i = 0; i < mid; i++) {node->keys[i] = keys[i]; node->children[i] = children[i];}
+    node->children[mid] = children[mid];
+    for (int i = mid + 1; i <= MAX_KEYS; i++) {node->children[i] = NULL;}
+
+    newInternal->keyCount = MAX_KEYS - mid;
+    for (int i = mid + 1; i <= MAX_KEYS; i++) {
+        newInternal->keys[i - mid - 1] = keys[i];
+        newInternal->children[i - mid - 1] = children[i];
+    }
+    newInternal->children[MAX_KEYS - mid] = children[MAX_KEYS + 1];
+    *promotedKey = keys[mid];
+    return newInternal;
+}
+
 /**
  * @brief Inserts a key into the B+ Tree.
  *
- * This function inserts a given key into the B+ Tree, handling the splitting of nodes
- * if the maximum number of keys is exceeded.
+ * This function inserts a given key into the B+ Tree, splitting leaves and internal nodes
+ * if the maximum number of keys is exceeded and growing a new root when the old root splits.
  *
  * @param root Pointer to the root of the B+ Tree.
  * @param key Key to be inserted.
@@ -1897,57 +2812,15 @@ BPlusTreeNode* insert(BPlusTreeNode* root, int key) {
         return root;
     }
 
-    BPlusTreeNode* current = root;
-    BPlusTreeNode* parent = NULL;
-    while (!current->isLeaf) {
-        parent = current;
-        for (int i = 0; i < current->keyCount; i++) {
-            if (key < current->keys[i]) {
-                current = current->children[i];
-                break;
-            }
-            if (i == current->keyCount - 1) {
-                current = current->children[i + 1];
-                break;
-            }
-        }
-    }
-
-    // Leaf reached, add the key
-    int i = current->keyCount - 1;
-    while (i >= 0 && current->keys[i] > key) {
-        current->keys[i + 1] = current->keys[i];
-        i--;
-    }
-    current->keys[i + 1] = key;
-    current->keyCount++;
-
-    // Division if the sheet is full
-    if (current->keyCount == MAX_KEYS) {
-        BPlusTreeNode* newLeaf = createNode(true);
-        int mid = (MAX_KEYS + 1) / 2;
-        current->keyCount = mid;
-        for (int j = mid; j < MAX_KEYS; j++) {
-            newLeaf->keys[j - mid] = current->keys[j];
-        }
-        newLeaf->keyCount = MAX_KEYS - mid;
-        newLeaf->next = current->next;
-        current->next = newLeaf;
-
-        // Add new key to parent
-        if (parent == NULL) {
-            parent = createNode(false);
-            parent->keys[0] = newLeaf->keys[0];
-            parent->children[0] = current;
-            parent->children[1] = newLeaf;
-            parent->keyCount = 1;
-            root = parent;
-        }
-        else {
-            // Add new key to parent
-            int newKey = newLeaf->keys[0];
-            return insert(root, newKey);
-        }
+    int promotedKey;
+    BPlusTreeNode* sibling = insertIntoSubtree(root, key, &promotedKey);
+    if (sibling != NULL) {
+        BPlusTreeNode* newRoot = createNode(false);
+        newRoot->keys[0] = promotedKey;
+        newRoot->children[0] = root;
+        newRoot->children[1] = sibling;
+        newRoot->keyCount = 1;
+        root = newRoot;
     }
 
     return root;
@@ -2364,41 +3237,106 @@ void computeLPSArray(const char* pattern, int M, int* lps) {
     }
 }
 
+/**
+ * @brief Compiles a pattern for repeated KMP searches: copies it and computes its LPS array once.
+ *
+ * The copy and the LPS array share one allocation, so searching a whole catalog costs a single malloc.
+ *
+ * @param pattern The pattern to search for.
+ * @param foCompiled Receives the compiled pattern; release it with freeKMPPattern().
+ * @return true on success, false if pattern is NULL or memory is exhausted.
+ */
+bool compileKMPPattern(const char* pattern, KMPPattern* foCompiled) {
+    if (pattern == NULL || foCompiled == NULL) {return false;}
+    int length = (int)strlen(pattern);
+    // LPS values first so they stay aligned, then the pattern and its terminator
+    size_t lpsBytes = (size_t)(length > 0 ? length : 1) * sizeof(int);
+    char* block = (char*)malloc(lpsBytes + (size_t)length + 1);
+    if (block == NULL) {return false;}
+    foCompiled->lps = (int*)block;
+    foCompiled->pattern = block + lpsBytes;
+    foCompiled->length = length;
+    memcpy(foCompiled->pattern, pattern, (size_t)length + 1);
+    if (length > 0) {computeLPSArray(foCompiled->pattern, length, foCompiled->lps);}
+    return true;
+}
+
+/**
+ * @brief Releases a compiled pattern and leaves it empty.
+ *
+ * @param compiled The compiled pattern; NULL or an empty pattern is ignored.
+ */
+void freeKMPPattern(KMPPattern* compiled) {
+    if (compiled == NULL) {return;}
+    free(compiled->lps);
+    compiled->lps = NULL;
+    compiled->pattern = NULL;
+    compiled->length = 0;
+}
+
+/**
+ * @brief Finds the first occurrence of a compiled pattern in a text of known length.
+ *
+ * The text is read once and never backed up; it does not have to be zero terminated.
+ *
+ * @param compiled The compiled pattern.
+ * @param text The text to search within.
+ * @param textLength Number of characters of text to search.
+ * @return Offset of the first match in text, 0 for an empty pattern, -1 if the pattern does not occur.
+ */
+int findKMPPattern(const KMPPattern* compiled, const char* text, int textLength) {
+    int M = compiled->length;
+    if (M == 0) {return 0;}
+    const char* pattern = compiled->pattern;
+    const int* lps = compiled->lps;
+    int j = 0;
+    for (int i = 0; i < textLength; i++) {
+        while (j > 0 && text[i] != pattern[j]) {j = lps[j - 1];}
+        if (text[i] == pattern[j]) {j++;}
+        if (j == M) {return i - M + 1;}
+    }
+    return -1; // Pattern not found
+}
+
 /**
  * @brief Searches for a pattern in the given text using the Knuth-Morris-Pratt (KMP) algorithm.
  *
+ * Compiles the pattern for this one search; loops over many texts should compile it once with
+ * compileKMPPattern() and call findKMPPattern().
+ *
  * @param pattern The pattern to search for.
  * @param text The text to search within.
  * @return true if the pattern is found, false otherwise.
  */
 bool KMPSearch(const char* pattern, const char* text) {
-    int M = strlen(pattern);
-    int N = strlen(text);
-
-    int* lps = (int*)malloc(M * sizeof(int));
-    computeLPSArray(pattern, M, lps);
-
-    int i = 0;
-    int j = 0;
-    while (i < N) {
-        if (pattern[j] == text[i]) {j++;i++;}
-
-        if (j == M) {free(lps);return true;}
-        else if (i < N && pattern[j] != text[i]) {
-            if (j != 0) {j = lps[j - 1];}
-            else {
-                i++;
-            }
-        }
-    }
+    KMPPattern compiled;
+    if (!compileKMPPattern(pattern, &compiled)) {return false;}
+    bool found = findKMPPattern(&compiled, text, (int)strlen(text)) >= 0;
+    freeKMPPattern(&compiled);
+    return found;
+}
 
-    free(lps);
-    return false; // Pattern not found
+/**
+ * @brief Prints the vendor of a product found by enterSearchProducts(), unless it was already printed.
+ *
+ * @param vendors The vendors not printed yet, by ID; the printed vendor is removed.
+ * @return true if the vendor was printed.
+ */
+static bool printProductVendor(const Product* product, std::unordered_map<int, Vendor>& vendors) {
+    std::unordered_map<int, Vendor>::iterator vendor = vendors.find(product->vendorId);
+    if (vendor == vendors.end()) {return false;}
+    printf("Vendor: %s, ID: %d\n", vendor->second.name, vendor->second.id);
+    vendors.erase(vendor);
+    return true;
 }
 
 /**
  * @brief Lists vendors offering a user's favorite product by searching the product file.
  *
+ * The products whose name contains the text come from the search index, or from a KMP scan of products.bin
+ * when there is no usable index. vendor.bin is read once, and each vendor is listed once, in the order of
+ * its first matching product.
+ *
  * @return true if the function executes successfully, false otherwise.
  */
 bool enterSearchProducts() {
@@ -2421,18 +3359,41 @@ bool enterSearchProducts() {
     vendorFile = fopen("vendor.bin", "rb");
     if (vendorFile == NULL) {printf("Error opening vendor file.\n");fclose(productFile);return 1;}
 
+    // Read the vendors once; the first record of an ID is the one listed, as in a scan of the file
+    std::unordered_map<int, Vendor> vendors;
+    while (fread(&vendor, sizeof(Vendor), 1, vendorFile)) {vendors.insert(std::make_pair(vendor.id, vendor));}
+    fclose(vendorFile);
+
     printf("\n--- Vendors Offering '%s' ---\n", favoriteProduct);
 
-    // Search with KMP by scanning the product file
-    while (fread(&product, sizeof(Product), 1, productFile)) {if (KMPSearch(favoriteProduct, product.productName)) {rewind(vendorFile); while (fread(&vendor, sizeof(Vendor), 1, vendorFile)) {if (vendor.id == product.vendorId) {printf("Vendor: %s, ID: %d\n", vendor.name, vendor.id);found = true;break;}}}}
+    // The search index gives the products whose name contains the text
+    const SearchField nameField[1] = {SEARCH_FIELD_PRODUCT_NAME};
+    const char* nameTerm[1] = {favoriteProduct};
+    uint32_t* records = NULL;
+    int recordCount = searchMarketIndex(nameField, 1, nameTerm, 1, SEARCH_TERM_SUBSTRING, true, &records);
+    if (recordCount >= 0) {
+        for (int i = 0; i < recordCount; i++) {
+            if (readRecordAt(productFile, records[i], &product, sizeof(Product)) && printProductVendor(&product, vendors)) {found = true;}
+        }
+    }
+    // Without an index, search with KMP by scanning the product file; the pattern is compiled once for all records
+    else {
+        KMPPattern pattern;
+        if (!compileKMPPattern(favoriteProduct, &pattern)) {printf("Error preparing search.\n");fclose(productFile);return 1;}
+        while (fread(&product, sizeof(Product), 1, productFile)) {
+            if (findKMPPattern(&pattern, product.productName, (int)strnlen(product.productName, sizeof(product.productName))) >= 0 &&
+                printProductVendor(&product, vendors)) {found = true;}
+        }
+        freeKMPPattern(&pattern);
+    }
+    free(records);
 
     if (!found) {
         printf("No vendors found offering '%s'.\n", favoriteProduct);
     }
 
-    // Close the files
+    // Close the product file
     fclose(productFile);
-    fclose(vendorFile);
 
     printf("\nPress Enter to return to menu...");
     getchar();
@@ -2443,85 +3404,166 @@ bool enterSearchProducts() {
 
 
 /**
- * @brief Performs a Depth-First Search (DFS) on a graph of nodes to find a keyword.
- *
- * @param node The starting node for the DFS.
- * @param keyword The keyword to search for.
- * @param visited An array of nodes that have been visited.
- * @param visitedCount The number of nodes visited so far.
- * @return true if the keyword is found, false otherwise.
+ * @brief Characters a product description can hold outside its name and season: the labels, the numbers and
+ *        the "inf" and "nan" a price may print as.
  */
-bool DFS(Node* node, const char* keyword, Node** visited, int* visitedCount) {
-    // Start a stack for DFS
-    std::stack<Node*> stack;
-    stack.push(node);
+static const char PRODUCT_INFO_UNINDEXED_CHARACTERS[] = "Product: ,SesonVndrIDicQuatyf0123456789.-";
 
-    while (!stack.empty()) {
-        Node* currentNode = stack.top();
-        stack.pop();
+/**
+ * @brief Characters a vendor description can hold outside its name: the labels and the ID.
+ */
+static const char VENDOR_INFO_UNINDEXED_CHARACTERS[] = "Vendor: ,ID0123456789-";
 
-        // Skip if the node has been visited
-        bool isVisited = false;
-        for (int i = 0; i < *visitedCount; i++) {
-            if (visited[i] == currentNode) {
-                isVisited = true;
-                break;
-            }
-        }
-        if (isVisited) continue;
+/**
+ * @brief Formats the description of a product used by the keyword search.
+ */
+static void formatProductInfo(char* info, size_t size, const Product* product) {
+    snprintf(info, size, "Product: %s, Season: %s, Vendor ID: %d, Price: %.2f, Quantity: %d", product->productName, product->season, product->vendorId, product->price, product->quantity);
+}
 
-        // Mark node as visited
-        visited[*visitedCount] = currentNode;
-        (*visitedCount)++;
+/**
+ * @brief Formats the description of a vendor used by the keyword search.
+ */
+static void formatVendorInfo(char* info, size_t size, const Vendor* vendor) {
+    snprintf(info, size, "Vendor: %s, ID: %d", vendor->name, vendor->id);
+}
 
-        // Return if the keyword is present in the node information
-        if (strstr(currentNode->info, keyword) != NULL) {printf("Match found: %s\n", currentNode->info);return true;}
+/**
+ * @brief Prints a record description with the offsets of the keywords in it, if it matches the query.
+ *
+ * @return true if the description matches.
+ */
+static bool printKeywordMatches(const KeywordAutomaton* automaton, char* const keywords[], KeywordMatchMode mode, const char* info) {
+    // At most every keyword ends at every position, so this holds all matches of the description
+    int infoLength = (int)strlen(info);
+    int maxMatches = infoLength * automaton->keywordCount;
+    KeywordMatch* matches = (KeywordMatch*)malloc((size_t)(maxMatches > 0 ? maxMatches : 1) * sizeof(KeywordMatch));
+    if (matches == NULL) {return false;}
+    uint64_t foundKeywords;
+    int matchCount = findKeywords(automaton, info, infoLength, matches, maxMatches, &foundKeywords);
+    if (!keywordsSatisfied(automaton, foundKeywords, mode)) {free(matches);return false;}
 
-        // Add neighbor nodes to the stack
-        for (int i = 0; i < currentNode->neighborCount; i++) {
-            stack.push(currentNode->neighbors[i]);
-        }
+    printf("Match found: %s\n", info);
+    for (int m = 0; m < matchCount; m++) {
+        printf("    '%s' at offset %d\n", keywords[matches[m].keyword], matches[m].offset);
     }
+    free(matches);
+    return true;
+}
 
-    return false;
+/**
+ * @brief Asks the search index for the records that may match a keyword query.
+ *
+ * A keyword can only be looked up in the index if it cannot occur in a description outside the indexed fields,
+ * which holds when it has none of the characters found there: the fields are then the only place it can
+ * occur, and they are separated by labels it cannot span. When all keywords are required, the records holding
+ * the keywords that can be looked up are the candidates; when any keyword is enough, every keyword has to be
+ * one that can be looked up.
+ *
+ * @param unindexedCharacters Characters the descriptions hold outside the indexed fields.
+ * @return The number of candidate records, or -1 if every record has to be read.
+ */
+static int searchKeywordCandidates(const SearchField fields[], int fieldCount, char* const keywords[], int keywordCount, KeywordMatchMode mode,
+                                   const char* unindexedCharacters, uint32_t** foRecords) {
+    *foRecords = NULL;
+    const char* terms[KEYWORD_SEARCH_MAX_KEYWORDS];
+    int termCount = 0;
+    for (int k = 0; k < keywordCount && k < KEYWORD_SEARCH_MAX_KEYWORDS; k++) {
+        if (strpbrk(keywords[k], unindexedCharacters) == NULL) {terms[termCount++] = keywords[k];}
+    }
+    if (termCount == 0 || (mode == KEYWORD_MATCH_ANY && termCount < keywordCount)) {return -1;}
+    return searchMarketIndex(fields, fieldCount, terms, termCount, SEARCH_TERM_SUBSTRING, mode == KEYWORD_MATCH_ALL, foRecords);
 }
 
+/**
+ * @brief Reads the next candidate record of a keyword search.
+ *
+ * @param records The records named by the search index, or NULL with recordCount -1 to read every record.
+ * @param recordCount Number of records, or -1.
+ * @param candidate Number of the candidate, counting from 0.
+ * @return true if the candidate was read, false after the last one.
+ */
+static bool readKeywordCandidate(FILE* file, const uint32_t* records, int recordCount, int candidate, void* foRecord, size_t recordSize) {
+    if (recordCount < 0) {return readRecordAt(file, (uint32_t)candidate, foRecord, recordSize);}
+    return candidate < recordCount && readRecordAt(file, records[candidate], foRecord, recordSize);
+}
+
+/**
+ * @brief Adds a node with a copy of a record description to the keyword search graph.
+ */
+static void addKeywordNode(Node* nodes[], int* nodeCount, int maxNodes, const char* info) {
+    if (*nodeCount >= maxNodes) {return;}
+    Node* node = (Node*)malloc(sizeof(Node));
+    node->info = (char*)malloc(strlen(info) + 1);
+    strcpy(node->info, info);
+    node->neighborCount = 0;
+    node->neighbors = NULL;
+    nodes[(*nodeCount)++] = node;
+}
 
 /**
- * @brief Searches for a keyword among products and vendors, using DFS and finding SCC.
+ * @brief Searches for keywords among products and vendors and finds the SCCs of the matching records.
+ *
+ * The query is split into keywords that must all occur in a record, or of which any may occur when they are
+ * separated by '|'. Keywords are looked for in the whole description of each product and vendor, so labels,
+ * vendor IDs, prices and quantities match as well as names and seasons. The search index narrows the records
+ * to read where a keyword can only occur in the indexed names and seasons (see searchKeywordCandidates());
+ * otherwise every record is read. The keywords are compiled into one automaton, which checks each candidate in
+ * one pass however many keywords the query has; each matching record is printed with the offsets of its
+ * matches and becomes a node of the graph whose SCCs are listed.
  *
  * @return true if the function executes successfully, false otherwise.
  */
 bool enterKeywords() {
-    char keyword[100];
-    printf("\nEnter a keyword to search: ");
-    scanf("%s", keyword);
+    char query[100];
+    printf("\nEnter keywords to search (separate alternatives with '%c'): ", KEYWORD_QUERY_ANY_SEPARATOR);
+    if (scanf(" %99[^\n]", query) != 1) {printf("No keywords entered.\n");return false;}
+
+    char* keywords[KEYWORD_SEARCH_MAX_KEYWORDS];
+    KeywordMatchMode mode;
+    int keywordCount = splitKeywordQuery(query, keywords, KEYWORD_SEARCH_MAX_KEYWORDS, &mode);
+    KeywordAutomaton automaton;
+    if (keywordCount == 0 || !buildKeywordAutomaton(keywords, keywordCount, &automaton)) {printf("No keywords entered.\n");return false;}
 
-    // Read product and vendor information from file and create nodes
     FILE* productFile = fopen("products.bin", "rb");
     FILE* vendorFile = fopen("vendor.bin", "rb");
 
-    if (productFile == NULL || vendorFile == NULL) {printf("Error opening product or vendor file.\n");return false;
+    if (productFile == NULL || vendorFile == NULL) {
+        printf("Error opening product or vendor file.\n");
+        if (productFile != NULL) {fclose(productFile);}
+        if (vendorFile != NULL) {fclose(vendorFile);}
+        freeKeywordAutomaton(&automaton);
+        return false;
     }
 
-    Product product;
-    Vendor vendor;
+    // The index names the candidate records where it can, and the automaton confirms each in one pass
+    const SearchField productFields[2] = {SEARCH_FIELD_PRODUCT_NAME, SEARCH_FIELD_SEASON};
+    const SearchField vendorFields[1] = {SEARCH_FIELD_VENDOR_NAME};
+    uint32_t* productRecords = NULL;
+    uint32_t* vendorRecords = NULL;
+    int productCount = searchKeywordCandidates(productFields, 2, keywords, keywordCount, mode, PRODUCT_INFO_UNINDEXED_CHARACTERS, &productRecords);
+    int vendorCount = searchKeywordCandidates(vendorFields, 1, keywords, keywordCount, mode, VENDOR_INFO_UNINDEXED_CHARACTERS, &vendorRecords);
 
-    // Create an array for all nodes (with a maximum of 100 nodes)
+    // The matching records become the nodes of the graph (with a maximum of 100 nodes)
     Node* nodes[100];
     int nodeCount = 0;
+    Product product;
+    Vendor vendor;
+    char info[200];
+    for (int i = 0; readKeywordCandidate(productFile, productRecords, productCount, i, &product, sizeof(Product)); ++i) {
+        formatProductInfo(info, sizeof(info), &product);
+        if (printKeywordMatches(&automaton, keywords, mode, info)) {addKeywordNode(nodes, &nodeCount, 100, info);}
+    }
+    for (int i = 0; readKeywordCandidate(vendorFile, vendorRecords, vendorCount, i, &vendor, sizeof(Vendor)); ++i) {
+        formatVendorInfo(info, sizeof(info), &vendor);
+        if (printKeywordMatches(&automaton, keywords, mode, info)) {addKeywordNode(nodes, &nodeCount, 100, info);}
+    }
+    free(productRecords);
+    free(vendorRecords);
+    freeKeywordAutomaton(&automaton);
 
-    // Adding products as nodes
-    while (fread(&product, sizeof(Product), 1, productFile) && nodeCount < 100) {Node* productNode = (Node*)malloc(sizeof(Node));productNode->info = (char*)malloc(200 * sizeof(char));snprintf(productNode->info, 200, "Product: %s, Season: %s, Vendor ID: %d, Price: %.2f, Quantity: %d",product.productName, product.season, product.vendorId, product.price, product.quantity);productNode->neighborCount = 0;productNode->neighbors = NULL;nodes[nodeCount++] = productNode;}
-
-    // Adding vendors as nodes
-    while (fread(&vendor, sizeof(Vendor), 1, vendorFile) && nodeCount < 100) {
-        Node* vendorNode = (Node*)malloc(sizeof(Node));
-        vendorNode->info = (char*)malloc(100 * sizeof(char));
-        snprintf(vendorNode->info, 100, "Vendor: %s, ID: %d", vendor.name, vendor.id);
-        vendorNode->neighborCount = 0;
-        vendorNode->neighbors = NULL;
-        nodes[nodeCount++] = vendorNode;
+    if (nodeCount == 0) {
+        printf("No matches found for %s of the keywords.\n", mode == KEYWORD_MATCH_ALL ? "all" : "any");
     }
 
     fclose(productFile);
@@ -2541,21 +3583,6 @@ bool enterKeywords() {
         }
     }
 
-    // Search keyword with DFS
-    Node* visited[100];
-    int visitedCount = 0;
-    bool found = false;
-
-    for (int i = 0; i < nodeCount; ++i) {
-        visitedCount = 0;
-        if (DFS(nodes[i], keyword, visited, &visitedCount)) {found = true;
-        }
-    }
-
-    if (!found) {
-        printf("No matches found for keyword '%s'.\n", keyword);
-    }
-
     // Running the SCC Algorithm
     printf("\nFinding Strongly Connected Components (SCC)...\n");
     findSCC(nodes, nodeCount);
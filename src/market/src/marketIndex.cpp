@@ -0,0 +1,178 @@
+/**
+ * @file marketIndex.cpp
+ * @brief Builders and range queries for the B+ tree indexes over vendor.bin and products.bin.
+ */
+
+#include "../header/marketIndex.h"
+#include <algorithm>
+#include <limits.h>
+#include <limits>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Coruh
+{
+    namespace Market
+    {
+        bool buildVendorIdIndex(const char* fiVendorPath, VendorIdIndex& foIndex)
+        {
+            FILE* vendorFile = fopen(fiVendorPath, "rb");
+            if (vendorFile == NULL) {return false;}
+
+            std::vector<std::pair<int, long> > entries;
+            Vendor vendor;
+            bool sorted = true;
+            while (fread(&vendor, sizeof(Vendor), 1, vendorFile)) {
+                if (!entries.empty() && vendor.id <= entries.back().first) {sorted = false;}
+                entries.push_back(std::make_pair(vendor.id, (long)entries.size()));
+            }
+            fclose(vendorFile);
+
+            if (!sorted) {
+                // Stable sort keeps the earliest record first among equal IDs
+                std::stable_sort(entries.begin(), entries.end(),
+                    [](const std::pair<int, long>& lhs, const std::pair<int, long>& rhs) { return lhs.first < rhs.first; });
+            }
+
+            std::vector<int> keys;
+            std::vector<long> values;
+            keys.reserve(entries.size());
+            values.reserve(entries.size());
+            for (size_t i = 0; i < entries.size(); i++) {
+                if (!keys.empty() && keys.back() == entries[i].first) {continue;}
+                keys.push_back(entries[i].first);
+                values.push_back(entries[i].second);
+            }
+
+            return foIndex.bulkLoad(keys.data(), values.data(), keys.size());
+        }
+
+        int findVendorIdsInRange(const VendorIdIndex& fiIndex, int fiFirstId, int fiLastId, long foPositions[], int fiMaxCount)
+        {
+            int found = 0;
+            for (VendorIdIndex::Iterator it = fiIndex.lowerBound(fiFirstId); it.valid() && it.key() < fiLastId; ++it) {
+                if (foPositions != NULL && found < fiMaxCount) {foPositions[found] = it.value();}
+                found++;
+            }
+            return found;
+        }
+
+        bool buildProductPriceIndex(const char* fiProductsPath, ProductPriceIndex& foIndex)
+        {
+            FILE* productsFile = fopen(fiProductsPath, "rb");
+            if (productsFile == NULL) {return false;}
+
+            std::vector<ProductPriceKey> keys;
+            Product product;
+            while (fread(&product, sizeof(Product), 1, productsFile)) {
+                ProductPriceKey key;
+                memset(&key, 0, sizeof(key));
+                strncpy(key.productName, product.productName, sizeof(key.productName));
+                key.price = product.price;
+                key.recordIndex = (long)keys.size();
+                keys.push_back(key);
+            }
+            fclose(productsFile);
+
+            std::sort(keys.begin(), keys.end());
+
+            std::vector<long> values;
+            values.reserve(keys.size());
+            for (size_t i = 0; i < keys.size(); i++) {values.push_back(keys[i].recordIndex);}
+
+            return foIndex.bulkLoad(keys.data(), values.data(), keys.size());
+        }
+
+        /**
+         * @brief Collects the records of one product name in [fiMinPrice, fiMaxPrice] and returns the iterator past them.
+         */
+        static ProductPriceIndex::Iterator collectNamePriceRange(const ProductPriceIndex& fiIndex, const char* fiProductName, float fiMinPrice,
+                                                                 float fiMaxPrice, long foPositions[], int fiMaxCount, int& foFound)
+        {
+            ProductPriceKey first;
+            memset(&first, 0, sizeof(first));
+            strncpy(first.productName, fiProductName, sizeof(first.productName));
+            first.price = fiMinPrice;
+            first.recordIndex = LONG_MIN;
+
+            ProductPriceIndex::Iterator it = fiIndex.lowerBound(first);
+            for (; it.valid(); ++it) {
+                const ProductPriceKey& key = it.key();
+                if (strncmp(key.productName, first.productName, sizeof(key.productName)) != 0 || fiMaxPrice < key.price) {break;}
+                if (foPositions != NULL && foFound < fiMaxCount) {foPositions[foFound] = it.value();}
+                foFound++;
+            }
+            return it;
+        }
+
+        int findProductsInPriceRange(const ProductPriceIndex& fiIndex, const char* fiProductName, float fiMinPrice, float fiMaxPrice,
+                                     long foPositions[], int fiMaxCount)
+        {
+            int found = 0;
+            if (fiProductName != NULL) {
+                collectNamePriceRange(fiIndex, fiProductName, fiMinPrice, fiMaxPrice, foPositions, fiMaxCount, found);
+                return found;
+            }
+
+            // One descent per distinct name, then skip the rest of that name's offers
+            ProductPriceIndex::Iterator it = fiIndex.begin();
+            while (it.valid()) {
+                ProductPriceKey last = it.key();
+                it = collectNamePriceRange(fiIndex, last.productName, fiMinPrice, fiMaxPrice, foPositions, fiMaxCount, found);
+                if (it.valid() && strncmp(it.key().productName, last.productName, sizeof(last.productName)) == 0) {
+                    last.price = std::numeric_limits<float>::infinity();
+                    last.recordIndex = LONG_MAX;
+                    it = fiIndex.upperBound(last);
+                }
+            }
+            return found;
+        }
+
+        bool buildProductNameIndex(const char* fiProductsPath, ProductNameIndex& foIndex)
+        {
+            FILE* productsFile = fopen(fiProductsPath, "rb");
+            if (productsFile == NULL) {return false;}
+
+            std::vector<std::pair<std::string, long> > records;
+            Product product;
+            while (fread(&product, sizeof(Product), 1, productsFile)) {
+                records.push_back(std::make_pair(std::string(product.productName, strnlen(product.productName, sizeof(product.productName))),
+                                                 (long)records.size()));
+            }
+            fclose(productsFile);
+
+            // Sorted by name and then record, so each run starts with the first record of its name
+            std::sort(records.begin(), records.end());
+
+            std::vector<std::string> keys;
+            std::vector<ProductNameEntry> values;
+            for (size_t i = 0; i < records.size(); i++) {
+                if (!keys.empty() && keys.back() == records[i].first) {
+                    values.back().productCount++;
+                    continue;
+                }
+                ProductNameEntry entry = {records[i].second, 1};
+                keys.push_back(records[i].first);
+                values.push_back(entry);
+            }
+
+            return foIndex.bulkLoad(keys, values);
+        }
+
+        int findProductNamesWithPrefix(const ProductNameIndex& fiIndex, const char* fiPrefix, char foNames[][50], int fiMaxCount)
+        {
+            int found = 0;
+            for (ProductNameIndex::Iterator it = fiIndex.lowerBound(fiPrefix); it.valid() && it.keyStartsWith(fiPrefix); ++it) {
+                if (foNames != NULL && found < fiMaxCount) {
+                    strncpy(foNames[found], it.key().c_str(), 49);
+                    foNames[found][49] = '\0';
+                }
+                found++;
+            }
+            return found;
+        }
+    }
+}
@@ -0,0 +1,1131 @@
+/**
+ * @file pagedBPlusTree.cpp
+ * @brief Paged on-disk B+ tree over the (vendor ID, product name, record offset) keys of products.bin.
+ *
+ * @details Page 0 of the index file is the meta page; every other page is a leaf or an internal node of
+ * BTREE_PAGE_SIZE bytes at offset pageId * BTREE_PAGE_SIZE. Nodes are never accessed directly on disk: they
+ * are fetched into a frame of the buffer pool, pinned while in use and written back when a dirty frame is
+ * evicted or the tree is flushed. Inserts descend with page ids only and re-fetch the parent after a child
+ * split, so no more than two node pages are pinned at any time. Erases descend the same way and, on the way
+ * back up, pin a parent with the underfull child and its siblings to borrow or merge.
+ */
+
+#include "../header/pagedBPlusTree.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/** @brief Magic number identifying a paged B+ tree file whose keys carry the record offset. */
+#define BTREE_FILE_MAGIC 0x42505453
+/** @brief Fewest keys a leaf other than the root keeps after an erase. */
+#define BTREE_LEAF_MIN_KEYS ((int)BTREE_LEAF_CAPACITY / 2)
+/** @brief Fewest separator keys an internal page other than the root keeps after an erase. */
+#define BTREE_INTERNAL_MIN_KEYS ((int)BTREE_INTERNAL_CAPACITY / 2)
+
+static_assert(sizeof(BTreeLeafPage) == BTREE_PAGE_SIZE, "BTreeLeafPage must fill exactly one page");
+static_assert(sizeof(BTreeInternalPage) == BTREE_PAGE_SIZE, "BTreeInternalPage must fill exactly one page");
+static_assert(sizeof(BTreeMetaPage) == BTREE_PAGE_SIZE, "BTreeMetaPage must fill exactly one page");
+
+/**
+ * @brief Positions a file at a byte offset, using 64-bit offsets on every platform.
+ *
+ * @param file The file.
+ * @param offset Byte offset from the start of the file.
+ * @return true on success, false otherwise.
+ */
+static bool seekBTreeFile(FILE* file, int64_t offset) {
+#ifdef _WIN32
+    return _fseeki64(file, offset, SEEK_SET) == 0;
+#else
+    return fseeko(file, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+/**
+ * @brief Builds a zero padded index key from a vendor ID, product name and record offset.
+ *
+ * @param vendorId The vendor ID.
+ * @param productName The product name; NULL yields the smallest key of the vendor.
+ * @param offset The record offset; -1 yields the smallest key of the vendor and name.
+ * @return The key.
+ */
+static PagedProductKey makeProductKey(int vendorId, const char* productName, int64_t offset) {
+    PagedProductKey key;
+    memset(&key, 0, sizeof(key));
+    key.vendorId = vendorId;
+    if (productName != NULL) {strncpy(key.productName, productName, sizeof(key.productName) - 1);}
+    key.offset = offset;
+    return key;
+}
+
+/**
+ * @brief Compares the vendor IDs and product names of two index keys, ignoring the record offsets.
+ *
+ * @return Negative, zero or positive if left is smaller than, equal to or greater than right.
+ */
+static int compareProductKeyNames(const PagedProductKey* left, const PagedProductKey* right) {
+    if (left->vendorId != right->vendorId) {return left->vendorId < right->vendorId ? -1 : 1;}
+    return strncmp(left->productName, right->productName, sizeof(left->productName));
+}
+
+/**
+ * @brief Compares two index keys.
+ *
+ * @return Negative, zero or positive if left is smaller than, equal to or greater than right.
+ */
+static int compareProductKeys(const PagedProductKey* left, const PagedProductKey* right) {
+    int order = compareProductKeyNames(left, right);
+    if (order != 0) {return order;}
+    return left->offset < right->offset ? -1 : (left->offset > right->offset ? 1 : 0);
+}
+
+/**
+ * @brief Returns the index of the first key not less than key.
+ */
+static int lowerBoundProductKey(const PagedProductKey* keys, int count, const PagedProductKey* key) {
+    int low = 0;
+    int high = count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (compareProductKeys(&keys[mid], key) < 0) {low = mid + 1;}
+        else {high = mid;}
+    }
+    return low;
+}
+
+/**
+ * @brief Returns the index of the first key greater than key; used to pick the child to descend into.
+ */
+static int upperBoundProductKey(const PagedProductKey* keys, int count, const PagedProductKey* key) {
+    int low = 0;
+    int high = count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (compareProductKeys(key, &keys[mid]) < 0) {high = mid;}
+        else {low = mid + 1;}
+    }
+    return low;
+}
+
+/**
+ * @brief Writes the page held by a frame back to disk.
+ *
+ * @param tree The tree.
+ * @param frame The frame to write.
+ * @return true on success, false otherwise.
+ */
+static bool writeBTreeFrame(PagedBPlusTree* tree, BTreeFrame* frame) {
+    if (!seekBTreeFile(tree->file, (int64_t)frame->pageId * BTREE_PAGE_SIZE)) {return false;}
+    if (fwrite(&frame->page, sizeof(BTreePage), 1, tree->file) != 1) {return false;}
+    tree->pageWrites++;
+    frame->dirty = false;
+    return true;
+}
+
+/**
+ * @brief Picks a frame for a page that is not resident, writing back its previous page if dirty.
+ *
+ * Empty frames are used first, otherwise the least recently used unpinned frame is evicted.
+ *
+ * @param tree The tree.
+ * @return The frame, or NULL if every frame is pinned or the write-back fails.
+ */
+static BTreeFrame* findVictimFrame(PagedBPlusTree* tree) {
+    BTreeFrame* victim = NULL;
+    for (int i = 0; i < tree->frameCount; i++) {
+        BTreeFrame* frame = &tree->frames[i];
+        if (frame->pinCount > 0) {continue;}
+        if (frame->pageId == BTREE_NO_PAGE) {return frame;}
+        if (victim == NULL || frame->lastUsed < victim->lastUsed) {victim = frame;}
+    }
+    if (victim != NULL && victim->dirty && !writeBTreeFrame(tree, victim)) {return NULL;}
+    return victim;
+}
+
+/**
+ * @brief Returns a pinned frame holding the given page, reading it from disk on a pool miss.
+ *
+ * @param tree The tree.
+ * @param pageId The page to fetch.
+ * @return The pinned frame, or NULL on failure.
+ */
+static BTreeFrame* fetchBTreePage(PagedBPlusTree* tree, int32_t pageId) {
+    for (int i = 0; i < tree->frameCount; i++) {
+        if (tree->frames[i].pageId == pageId) {
+            tree->frames[i].pinCount++;
+            tree->frames[i].lastUsed = ++tree->accessClock;
+            return &tree->frames[i];
+        }
+    }
+
+    BTreeFrame* frame = findVictimFrame(tree);
+    if (frame == NULL) {return NULL;}
+    frame->pageId = BTREE_NO_PAGE;
+    if (!seekBTreeFile(tree->file, (int64_t)pageId * BTREE_PAGE_SIZE) ||
+        fread(&frame->page, sizeof(BTreePage), 1, tree->file) != 1) {
+        return NULL;
+    }
+    tree->pageReads++;
+    frame->pageId = pageId;
+    frame->dirty = false;
+    frame->pinCount = 1;
+    frame->lastUsed = ++tree->accessClock;
+    return frame;
+}
+
+/**
+ * @brief Allocates a new node page at the end of the file and returns it pinned and dirty.
+ *
+ * @param tree The tree.
+ * @param isLeaf true for a leaf page, false for an internal page.
+ * @return The pinned frame, or NULL on failure.
+ */
+static BTreeFrame* newBTreePage(PagedBPlusTree* tree, bool isLeaf) {
+    BTreeFrame* frame = findVictimFrame(tree);
+    if (frame == NULL) {return NULL;}
+    memset(&frame->page, 0, sizeof(BTreePage));
+    frame->page.header.isLeaf = isLeaf ? 1 : 0;
+    frame->page.header.nextLeaf = BTREE_NO_PAGE;
+    frame->pageId = tree->pageCount++;
+    frame->dirty = true;
+    frame->pinCount = 1;
+    frame->lastUsed = ++tree->accessClock;
+    return frame;
+}
+
+/**
+ * @brief Releases a pinned frame.
+ *
+ * @param frame The frame.
+ * @param dirty true if the caller modified the page.
+ */
+static void unpinBTreePage(BTreeFrame* frame, bool dirty) {
+    if (dirty) {frame->dirty = true;}
+    frame->pinCount--;
+}
+
+/**
+ * @brief Writes the meta page from the in-memory tree fields.
+ *
+ * @param tree The tree.
+ * @return true on success, false otherwise.
+ */
+static bool writeBTreeMeta(PagedBPlusTree* tree) {
+    BTreeMetaPage meta;
+    memset(&meta, 0, sizeof(meta));
+    meta.magic = BTREE_FILE_MAGIC;
+    meta.pageSize = BTREE_PAGE_SIZE;
+    meta.rootPage = tree->rootPage;
+    meta.height = tree->height;
+    meta.pageCount = tree->pageCount;
+    meta.keyCount = tree->keyCount;
+    meta.sourceRecords = tree->sourceRecords;
+    meta.sourceModified = tree->sourceModified;
+    return seekBTreeFile(tree->file, 0) && fwrite(&meta, sizeof(meta), 1, tree->file) == 1;
+}
+
+/**
+ * @brief Opens a paged B+ tree file, creating an empty tree if the file does not exist or is not an index file.
+ *
+ * @param path Path of the index file.
+ * @param poolSize Number of buffer pool frames (values below BTREE_MIN_POOL_SIZE select BTREE_DEFAULT_POOL_SIZE).
+ * @return Pointer to the open tree, or NULL on failure.
+ */
+PagedBPlusTree* openPagedBPlusTree(const char* path, int poolSize) {
+    PagedBPlusTree* tree = (PagedBPlusTree*)calloc(1, sizeof(PagedBPlusTree));
+    if (tree == NULL) {return NULL;}
+
+    tree->frameCount = poolSize >= BTREE_MIN_POOL_SIZE ? poolSize : BTREE_DEFAULT_POOL_SIZE;
+    tree->frames = (BTreeFrame*)calloc(tree->frameCount, sizeof(BTreeFrame));
+    if (tree->frames == NULL) {free(tree); return NULL;}
+    for (int i = 0; i < tree->frameCount; i++) {
+        tree->frames[i].pageId = BTREE_NO_PAGE;
+    }
+
+    tree->file = fopen(path, "r+b");
+    if (tree->file != NULL) {
+        BTreeMetaPage meta;
+        if (fread(&meta, sizeof(meta), 1, tree->file) == 1 && meta.magic == BTREE_FILE_MAGIC &&
+            meta.pageSize == BTREE_PAGE_SIZE && meta.rootPage > 0 && meta.rootPage < meta.pageCount && meta.height > 0) {
+            tree->rootPage = meta.rootPage;
+            tree->height = meta.height;
+            tree->pageCount = meta.pageCount;
+            tree->keyCount = meta.keyCount;
+            tree->sourceRecords = meta.sourceRecords;
+            tree->sourceModified = meta.sourceModified;
+            return tree;
+        }
+        fclose(tree->file);
+    }
+
+    // Missing or foreign file: start over with an empty root leaf in page 1
+    tree->file = fopen(path, "w+b");
+    if (tree->file == NULL) {free(tree->frames); free(tree); return NULL;}
+    tree->pageCount = 1;
+    tree->sourceRecords = -1;
+    BTreeFrame* root = newBTreePage(tree, true);
+    tree->rootPage = root->pageId;
+    tree->height = 1;
+    unpinBTreePage(root, true);
+    if (!flushPagedBPlusTree(tree)) {
+        closePagedBPlusTree(tree);
+        return NULL;
+    }
+    return tree;
+}
+
+/**
+ * @brief Writes every dirty page and the meta page to disk.
+ *
+ * @param tree The tree.
+ * @return true on success, false otherwise.
+ */
+bool flushPagedBPlusTree(PagedBPlusTree* tree) {
+    if (tree == NULL) {return false;}
+    bool ok = true;
+    for (int i = 0; i < tree->frameCount; i++) {
+        if (tree->frames[i].pageId != BTREE_NO_PAGE && tree->frames[i].dirty && !writeBTreeFrame(tree, &tree->frames[i])) {
+            ok = false;
+        }
+    }
+    if (!writeBTreeMeta(tree)) {ok = false;}
+    return fflush(tree->file) == 0 && ok;
+}
+
+/**
+ * @brief Flushes and closes the tree.
+ *
+ * @param tree The tree to close; the handle is freed.
+ * @return true if everything was written successfully, false otherwise.
+ */
+bool closePagedBPlusTree(PagedBPlusTree* tree) {
+    if (tree == NULL) {return false;}
+    bool ok = flushPagedBPlusTree(tree);
+    if (fclose(tree->file) != 0) {ok = false;}
+    free(tree->frames);
+    free(tree);
+    return ok;
+}
+
+/**
+ * @brief Inserts into a leaf page, splitting it if it is full.
+ *
+ * @return 1 if the key was new, 0 if it was already indexed, -1 on failure.
+ */
+static int insertIntoBTreeLeaf(PagedBPlusTree* tree, BTreeFrame* frame, const PagedProductKey* key,
+                               PagedProductKey* foSeparator, int32_t* foSibling) {
+    BTreeLeafPage* leaf = &frame->page.leaf;
+    int count = leaf->header.keyCount;
+    int position = lowerBoundProductKey(leaf->keys, count, key);
+    if (position < count && compareProductKeys(&leaf->keys[position], key) == 0) {return 0;}
+
+    if (count < (int)BTREE_LEAF_CAPACITY) {
+        memmove(&leaf->keys[position + 1], &leaf->keys[position], (count - position) * sizeof(PagedProductKey));
+        leaf->keys[position] = *key;
+        leaf->header.keyCount++;
+        return 1;
+    }
+
+    // Full leaf: lay out all entries in order, keep the lower half and move the upper half to a new page
+    PagedProductKey keys[BTREE_LEAF_CAPACITY + 1];
+    memcpy(keys, leaf->keys, position * sizeof(PagedProductKey));
+    keys[position] = *key;
+    memcpy(&keys[position + 1], &leaf->keys[position], (count - position) * sizeof(PagedProductKey));
+
+    BTreeFrame* rightFrame = newBTreePage(tree, true);
+    if (rightFrame == NULL) {return -1;}
+    BTreeLeafPage* right = &rightFrame->page.leaf;
+    int total = count + 1;
+    int leftCount = total / 2;
+    memcpy(leaf->keys, keys, leftCount * sizeof(PagedProductKey));
+    memcpy(right->keys, &keys[leftCount], (total - leftCount) * sizeof(PagedProductKey));
+    leaf->header.keyCount = leftCount;
+    right->header.keyCount = total - leftCount;
+    right->header.nextLeaf = leaf->header.nextLeaf;
+    leaf->header.nextLeaf = rightFrame->pageId;
+
+    *foSeparator = right->keys[0];
+    *foSibling = rightFrame->pageId;
+    unpinBTreePage(rightFrame, true);
+    return 1;
+}
+
+/**
+ * @brief Adds a separator and child id to an internal page, splitting it if it is full.
+ *
+ * @return true on success, false on failure.
+ */
+static bool insertIntoBTreeInternal(PagedBPlusTree* tree, BTreeFrame* frame, int childIndex, const PagedProductKey* separator,
+                                    int32_t child, PagedProductKey* foSeparator, int32_t* foSibling) {
+    BTreeInternalPage* node = &frame->page.internal;
+    int count = node->header.keyCount;
+    if (count < (int)BTREE_INTERNAL_CAPACITY) {
+        memmove(&node->keys[childIndex + 1], &node->keys[childIndex], (count - childIndex) * sizeof(PagedProductKey));
+        memmove(&node->children[childIndex + 2], &node->children[childIndex + 1], (count - childIndex) * sizeof(int32_t));
+        node->keys[childIndex] = *separator;
+        node->children[childIndex + 1] = child;
+        node->header.keyCount++;
+        return true;
+    }
+
+    // Full internal page: lay out count + 1 keys, push the middle key up to the parent
+    PagedProductKey keys[BTREE_INTERNAL_CAPACITY + 1];
+    int32_t children[BTREE_INTERNAL_CAPACITY + 2];
+    memcpy(keys, node->keys, childIndex * sizeof(PagedProductKey));
+    keys[childIndex] = *separator;
+    memcpy(&keys[childIndex + 1], &node->keys[childIndex], (count - childIndex) * sizeof(PagedProductKey));
+    memcpy(children, node->children, (childIndex + 1) * sizeof(int32_t));
+    children[childIndex + 1] = child;
+    memcpy(&children[childIndex + 2], &node->children[childIndex + 1], (count - childIndex) * sizeof(int32_t));
+
+    BTreeFrame* rightFrame = newBTreePage(tree, false);
+    if (rightFrame == NULL) {return false;}
+    BTreeInternalPage* right = &rightFrame->page.internal;
+    int total = count + 1;
+    int middle = total / 2;
+    memcpy(node->keys, keys, middle * sizeof(PagedProductKey));
+    memcpy(node->children, children, (middle + 1) * sizeof(int32_t));
+    node->header.keyCount = middle;
+    right->header.keyCount = total - middle - 1;
+    memcpy(right->keys, &keys[middle + 1], right->header.keyCount * sizeof(PagedProductKey));
+    memcpy(right->children, &children[middle + 1], (right->header.keyCount + 1) * sizeof(int32_t));
+
+    *foSeparator = keys[middle];
+    *foSibling = rightFrame->pageId;
+    unpinBTreePage(rightFrame, true);
+    return true;
+}
+
+/**
+ * @brief Inserts into the subtree rooted at pageId.
+ *
+ * The page is unpinned while the insert descends and fetched again only if the child split, so the pool
+ * never has to hold the whole path.
+ *
+ * @return 1 if the key was new, 0 if it was already indexed, -1 on failure.
+ */
+static int insertIntoBTreePage(PagedBPlusTree* tree, int32_t pageId, const PagedProductKey* key,
+                               PagedProductKey* foSeparator, int32_t* foSibling) {
+    BTreeFrame* frame = fetchBTreePage(tree, pageId);
+    if (frame == NULL) {return -1;}
+
+    if (frame->page.header.isLeaf) {
+        int result = insertIntoBTreeLeaf(tree, frame, key, foSeparator, foSibling);
+        unpinBTreePage(frame, result >= 0);
+        return result;
+    }
+
+    int childIndex = upperBoundProductKey(frame->page.internal.keys, frame->page.header.keyCount, key);
+    int32_t child = frame->page.internal.children[childIndex];
+    unpinBTreePage(frame, false);
+
+    PagedProductKey childSeparator;
+    int32_t childSibling = BTREE_NO_PAGE;
+    int result = insertIntoBTreePage(tree, child, key, &childSeparator, &childSibling);
+    if (result < 0 || childSibling == BTREE_NO_PAGE) {return result;}
+
+    frame = fetchBTreePage(tree, pageId);
+    if (frame == NULL) {return -1;}
+    bool ok = insertIntoBTreeInternal(tree, frame, childIndex, &childSeparator, childSibling, foSeparator, foSibling);
+    unpinBTreePage(frame, true);
+    return ok ? result : -1;
+}
+
+/**
+ * @brief Indexes a product record.
+ *
+ * Records of the same vendor and product name are kept side by side, ordered by offset.
+ *
+ * @param tree The tree.
+ * @param vendorId Vendor that owns the product.
+ * @param productName Product name.
+ * @param offset Byte offset of the product record in products.bin.
+ * @return 1 if the record was new, 0 if it was already indexed, -1 on failure.
+ */
+int pagedBPlusTreeInsert(PagedBPlusTree* tree, int vendorId, const char* productName, int64_t offset) {
+    if (tree == NULL || productName == NULL || offset < 0) {return -1;}
+    PagedProductKey key = makeProductKey(vendorId, productName, offset);
+    PagedProductKey separator;
+    int32_t sibling = BTREE_NO_PAGE;
+    int result = insertIntoBTreePage(tree, tree->rootPage, &key, &separator, &sibling);
+    if (result < 0) {return -1;}
+
+    if (sibling != BTREE_NO_PAGE) {
+        // The root split: grow the tree by one level
+        BTreeFrame* rootFrame = newBTreePage(tree, false);
+        if (rootFrame == NULL) {return -1;}
+        rootFrame->page.internal.header.keyCount = 1;
+        rootFrame->page.internal.keys[0] = separator;
+        rootFrame->page.internal.children[0] = tree->rootPage;
+        rootFrame->page.internal.children[1] = sibling;
+        tree->rootPage = rootFrame->pageId;
+        tree->height++;
+        unpinBTreePage(rootFrame, true);
+    }
+
+    if (result == 1) {tree->keyCount++;}
+    return result;
+}
+
+/**
+ * @brief Returns the minimum occupancy of a node page.
+ */
+static int minBTreeKeys(const BTreePage* page) {
+    return page->header.isLeaf ? BTREE_LEAF_MIN_KEYS : BTREE_INTERNAL_MIN_KEYS;
+}
+
+/**
+ * @brief Moves the last entry of the left sibling into the child at childIndex.
+ */
+static void borrowFromLeftBTreePage(BTreeInternalPage* parent, int childIndex, BTreePage* child, BTreePage* left) {
+    int count = child->header.keyCount;
+    int leftCount = left->header.keyCount;
+    if (child->header.isLeaf) {
+        memmove(&child->leaf.keys[1], &child->leaf.keys[0], count * sizeof(PagedProductKey));
+        child->leaf.keys[0] = left->leaf.keys[leftCount - 1];
+        parent->keys[childIndex - 1] = child->leaf.keys[0];
+    }
+    else {
+        // Rotate through the parent: the separator comes down, the sibling's last key goes up
+        memmove(&child->internal.keys[1], &child->internal.keys[0], count * sizeof(PagedProductKey));
+        memmove(&child->internal.children[1], &child->internal.children[0], (count + 1) * sizeof(int32_t));
+        child->internal.keys[0] = parent->keys[childIndex - 1];
+        child->internal.children[0] = left->internal.children[leftCount];
+        parent->keys[childIndex - 1] = left->internal.keys[leftCount - 1];
+    }
+    child->header.keyCount++;
+    left->header.keyCount--;
+}
+
+/**
+ * @brief Moves the first entry of the right sibling into the child at childIndex.
+ */
+static void borrowFromRightBTreePage(BTreeInternalPage* parent, int childIndex, BTreePage* child, BTreePage* right) {
+    int count = child->header.keyCount;
+    int rightCount = right->header.keyCount;
+    if (child->header.isLeaf) {
+        child->leaf.keys[count] = right->leaf.keys[0];
+        memmove(&right->leaf.keys[0], &right->leaf.keys[1], (rightCount - 1) * sizeof(PagedProductKey));
+        parent->keys[childIndex] = right->leaf.keys[0];
+    }
+    else {
+        child->internal.keys[count] = parent->keys[childIndex];
+        child->internal.children[count + 1] = right->internal.children[0];
+        parent->keys[childIndex] = right->internal.keys[0];
+        memmove(&right->internal.keys[0], &right->internal.keys[1], (rightCount - 1) * sizeof(PagedProductKey));
+        memmove(&right->internal.children[0], &right->internal.children[1], rightCount * sizeof(int32_t));
+    }
+    child->header.keyCount++;
+    right->header.keyCount--;
+}
+
+/**
+ * @brief Appends the page right into its left neighbour left and drops their separator from the parent.
+ *
+ * The emptied page stays in the file unused until the index is rebuilt; the file never shrinks.
+ */
+static void mergeBTreePages(BTreeInternalPage* parent, int leftIndex, BTreePage* left, BTreePage* right) {
+    int leftCount = left->header.keyCount;
+    int rightCount = right->header.keyCount;
+    if (left->header.isLeaf) {
+        memcpy(&left->leaf.keys[leftCount], right->leaf.keys, rightCount * sizeof(PagedProductKey));
+        left->header.keyCount = leftCount + rightCount;
+        left->header.nextLeaf = right->header.nextLeaf;
+    }
+    else {
+        left->internal.keys[leftCount] = parent->keys[leftIndex];
+        memcpy(&left->internal.keys[leftCount + 1], right->internal.keys, rightCount * sizeof(PagedProductKey));
+        memcpy(&left->internal.children[leftCount + 1], right->internal.children, (rightCount + 1) * sizeof(int32_t));
+        left->header.keyCount = leftCount + 1 + rightCount;
+    }
+    right->header.keyCount = 0;
+
+    int parentCount = parent->header.keyCount;
+    memmove(&parent->keys[leftIndex], &parent->keys[leftIndex + 1], (parentCount - leftIndex - 1) * sizeof(PagedProductKey));
+    memmove(&parent->children[leftIndex + 1], &parent->children[leftIndex + 2], (parentCount - leftIndex - 1) * sizeof(int32_t));
+    parent->header.keyCount--;
+}
+
+/**
+ * @brief Restores minimum occupancy of the child at childIndex of a pinned internal page.
+ *
+ * Borrowing is tried first (left sibling, then right); otherwise the child is merged with a sibling, which
+ * removes one separator from the parent. At most the parent, the child and both siblings are pinned.
+ *
+ * @return true on success, false if a page cannot be fetched.
+ */
+static bool rebalanceBTreeChild(PagedBPlusTree* tree, BTreeFrame* parentFrame, int childIndex) {
+    BTreeInternalPage* parent = &parentFrame->page.internal;
+    BTreeFrame* childFrame = fetchBTreePage(tree, parent->children[childIndex]);
+    if (childFrame == NULL) {return false;}
+
+    BTreeFrame* leftFrame = NULL;
+    if (childIndex > 0) {
+        leftFrame = fetchBTreePage(tree, parent->children[childIndex - 1]);
+        if (leftFrame == NULL) {unpinBTreePage(childFrame, false); return false;}
+        if (leftFrame->page.header.keyCount > minBTreeKeys(&leftFrame->page)) {
+            borrowFromLeftBTreePage(parent, childIndex, &childFrame->page, &leftFrame->page);
+            unpinBTreePage(leftFrame, true);
+            unpinBTreePage(childFrame, true);
+            return true;
+        }
+    }
+
+    BTreeFrame* rightFrame = NULL;
+    if (childIndex < parent->header.keyCount) {
+        rightFrame = fetchBTreePage(tree, parent->children[childIndex + 1]);
+        if (rightFrame == NULL) {
+            if (leftFrame != NULL) {unpinBTreePage(leftFrame, false);}
+            unpinBTreePage(childFrame, false);
+            return false;
+        }
+        if (rightFrame->page.header.keyCount > minBTreeKeys(&rightFrame->page)) {
+            borrowFromRightBTreePage(parent, childIndex, &childFrame->page, &rightFrame->page);
+            unpinBTreePage(rightFrame, true);
+            if (leftFrame != NULL) {unpinBTreePage(leftFrame, false);}
+            unpinBTreePage(childFrame, true);
+            return true;
+        }
+    }
+
+    if (leftFrame != NULL) {mergeBTreePages(parent, childIndex - 1, &leftFrame->page, &childFrame->page);}
+    else {mergeBTreePages(parent, childIndex, &childFrame->page, &rightFrame->page);}
+    if (leftFrame != NULL) {unpinBTreePage(leftFrame, true);}
+    if (rightFrame != NULL) {unpinBTreePage(rightFrame, leftFrame == NULL);}
+    unpinBTreePage(childFrame, true);
+    return true;
+}
+
+/**
+ * @brief Erases key from the subtree rooted at pageId and rebalances the child it descended into.
+ *
+ * Like inserts, the page is unpinned while the erase descends and fetched again only if the child fell
+ * below minimum occupancy.
+ *
+ * @param foUnderflow Set to true if the page itself is left below minimum occupancy.
+ * @return 1 if the key was erased, 0 if it was not indexed, -1 on failure.
+ */
+static int eraseFromBTreePage(PagedBPlusTree* tree, int32_t pageId, const PagedProductKey* key, bool* foUnderflow) {
+    *foUnderflow = false;
+    BTreeFrame* frame = fetchBTreePage(tree, pageId);
+    if (frame == NULL) {return -1;}
+
+    if (frame->page.header.isLeaf) {
+        BTreeLeafPage* leaf = &frame->page.leaf;
+        int count = leaf->header.keyCount;
+        int position = lowerBoundProductKey(leaf->keys, count, key);
+        if (position == count || compareProductKeys(&leaf->keys[position], key) != 0) {
+            unpinBTreePage(frame, false);
+            return 0;
+        }
+        memmove(&leaf->keys[position], &leaf->keys[position + 1], (count - position - 1) * sizeof(PagedProductKey));
+        leaf->header.keyCount--;
+        *foUnderflow = leaf->header.keyCount < BTREE_LEAF_MIN_KEYS;
+        unpinBTreePage(frame, true);
+        return 1;
+    }
+
+    int childIndex = upperBoundProductKey(frame->page.internal.keys, frame->page.header.keyCount, key);
+    int32_t child = frame->page.internal.children[childIndex];
+    unpinBTreePage(frame, false);
+
+    bool childUnderflow = false;
+    int result = eraseFromBTreePage(tree, child, key, &childUnderflow);
+    if (result <= 0 || !childUnderflow) {return result;}
+
+    frame = fetchBTreePage(tree, pageId);
+    if (frame == NULL) {return -1;}
+    bool ok = rebalanceBTreeChild(tree, frame, childIndex);
+    *foUnderflow = frame->page.header.keyCount < BTREE_INTERNAL_MIN_KEYS;
+    unpinBTreePage(frame, true);
+    return ok ? 1 : -1;
+}
+
+/**
+ * @brief Removes a product record from the index.
+ *
+ * A page that drops below half full borrows an entry from a sibling, or is merged with it when the sibling
+ * is at the minimum itself; merges can cascade up to the root, which is replaced by its only child when it
+ * runs out of separators. Separator keys are not rewritten: they stay valid bounds after their key is gone.
+ *
+ * @param tree The tree.
+ * @param vendorId Vendor that owns the product.
+ * @param productName Product name.
+ * @param offset Byte offset the record was indexed with.
+ * @return 1 if the record was erased, 0 if it was not indexed, -1 on failure.
+ */
+int pagedBPlusTreeErase(PagedBPlusTree* tree, int vendorId, const char* productName, int64_t offset) {
+    if (tree == NULL || productName == NULL) {return -1;}
+    PagedProductKey key = makeProductKey(vendorId, productName, offset);
+    bool underflow = false;
+    int result = eraseFromBTreePage(tree, tree->rootPage, &key, &underflow);
+    if (result <= 0) {return result;}
+    tree->keyCount--;
+
+    BTreeFrame* rootFrame = fetchBTreePage(tree, tree->rootPage);
+    if (rootFrame == NULL) {return -1;}
+    if (!rootFrame->page.header.isLeaf && rootFrame->page.header.keyCount == 0) {
+        // The root lost its last separator: its only child becomes the root
+        tree->rootPage = rootFrame->page.internal.children[0];
+        tree->height--;
+    }
+    unpinBTreePage(rootFrame, false);
+    return 1;
+}
+
+/**
+ * @brief Descends to the leaf that may contain key.
+ *
+ * @param tree The tree.
+ * @param key The key to locate.
+ * @return The pinned leaf frame, or NULL on failure.
+ */
+static BTreeFrame* findBTreeLeaf(PagedBPlusTree* tree, const PagedProductKey* key) {
+    BTreeFrame* frame = fetchBTreePage(tree, tree->rootPage);
+    while (frame != NULL && !frame->page.header.isLeaf) {
+        int childIndex = upperBoundProductKey(frame->page.internal.keys, frame->page.header.keyCount, key);
+        int32_t child = frame->page.internal.children[childIndex];
+        unpinBTreePage(frame, false);
+        frame = fetchBTreePage(tree, child);
+    }
+    return frame;
+}
+
+/**
+ * @brief Finds the first entry whose key is not less than key.
+ *
+ * @param tree The tree.
+ * @param key The key to locate.
+ * @param foKey Output for the entry key.
+ * @return 1 if there is such an entry, 0 if key is greater than every key, -1 on failure.
+ */
+static int lowerBoundBTreeEntry(PagedBPlusTree* tree, const PagedProductKey* key, PagedProductKey* foKey) {
+    BTreeFrame* frame = findBTreeLeaf(tree, key);
+    if (frame == NULL) {return -1;}
+    int position = lowerBoundProductKey(frame->page.leaf.keys, frame->page.header.keyCount, key);
+    while (position == frame->page.header.keyCount) {
+        int32_t next = frame->page.header.nextLeaf;
+        unpinBTreePage(frame, false);
+        if (next == BTREE_NO_PAGE) {return 0;}
+        frame = fetchBTreePage(tree, next);
+        if (frame == NULL) {return -1;}
+        position = 0;
+    }
+    *foKey = frame->page.leaf.keys[position];
+    unpinBTreePage(frame, false);
+    return 1;
+}
+
+/**
+ * @brief Looks up the first record of a product.
+ *
+ * @param tree The tree.
+ * @param vendorId Vendor that owns the product.
+ * @param productName Product name.
+ * @param foOffset Output for the offset of the vendor's first record of the product; may be NULL.
+ * @return true if the product is indexed, false otherwise.
+ */
+bool pagedBPlusTreeFind(PagedBPlusTree* tree, int vendorId, const char* productName, int64_t* foOffset) {
+    if (tree == NULL || productName == NULL) {return false;}
+    PagedProductKey key = makeProductKey(vendorId, productName, -1);
+    PagedProductKey entry;
+    bool found = lowerBoundBTreeEntry(tree, &key, &entry) == 1 && compareProductKeyNames(&entry, &key) == 0;
+    if (found && foOffset != NULL) {*foOffset = entry.offset;}
+    return found;
+}
+
+/**
+ * @brief Collects the record offsets of all products of a vendor, ordered by product name.
+ *
+ * @param tree The tree.
+ * @param vendorId The vendor ID to scan.
+ * @param foOffsets Output array; may be NULL when only the count is needed.
+ * @param maxCount Capacity of foOffsets.
+ * @return The total number of product records of the vendor (may exceed maxCount), or -1 on failure.
+ */
+int pagedBPlusTreeScanVendor(PagedBPlusTree* tree, int vendorId, int64_t foOffsets[], int maxCount) {
+    if (tree == NULL) {return -1;}
+    PagedProductKey key = makeProductKey(vendorId, NULL, -1);
+    BTreeFrame* frame = findBTreeLeaf(tree, &key);
+    if (frame == NULL) {return -1;}
+
+    int found = 0;
+    int position = lowerBoundProductKey(frame->page.leaf.keys, frame->page.header.keyCount, &key);
+    while (frame != NULL) {
+        const BTreeLeafPage* leaf = &frame->page.leaf;
+        for (; position < leaf->header.keyCount; position++) {
+            if (leaf->keys[position].vendorId != vendorId) {
+                unpinBTreePage(frame, false);
+                return found;
+            }
+            if (foOffsets != NULL && found < maxCount) {foOffsets[found] = leaf->keys[position].offset;}
+            found++;
+        }
+        int32_t next = leaf->header.nextLeaf;
+        unpinBTreePage(frame, false);
+        if (next == BTREE_NO_PAGE) {break;}
+        frame = fetchBTreePage(tree, next);
+        if (frame == NULL) {return -1;}
+        position = 0;
+    }
+    return found;
+}
+
+/**
+ * @brief Collects the record offsets of a product name across all vendors, in vendor order.
+ *
+ * Keys lead with the vendor ID, so the name is looked up once per indexed vendor: the entry at or after
+ * (vendor, name) either is the product or names the next vendor to try. A vendor's further records of the
+ * product follow with one more lookup each. The cost is one descent per vendor and record rather than a
+ * pass over every product.
+ *
+ * @param tree The tree.
+ * @param productName Product name to look up.
+ * @param foOffsets Output array; may be NULL when only the count is needed.
+ * @param maxCount Capacity of foOffsets.
+ * @return The number of records of the product (may exceed maxCount), or -1 on failure.
+ */
+int pagedBPlusTreeFindName(PagedBPlusTree* tree, const char* productName, int64_t foOffsets[], int maxCount) {
+    if (tree == NULL || productName == NULL) {return -1;}
+    int found = 0;
+    PagedProductKey key = makeProductKey(INT32_MIN, productName, -1);
+    while (true) {
+        PagedProductKey entry;
+        int result = lowerBoundBTreeEntry(tree, &key, &entry);
+        if (result < 0) {return -1;}
+        if (result == 0) {break;}
+        if (entry.vendorId != key.vendorId) {
+            key.vendorId = entry.vendorId;
+            key.offset = -1;
+            continue;
+        }
+        if (compareProductKeyNames(&entry, &key) == 0) {
+            if (foOffsets != NULL && found < maxCount) {foOffsets[found] = entry.offset;}
+            found++;
+            key.offset = entry.offset + 1;
+            continue;
+        }
+        if (key.vendorId == INT32_MAX) {break;}
+        key.vendorId++;
+        key.offset = -1;
+    }
+    return found;
+}
+
+/**
+ * @brief Reads the record count and modification time of a products file.
+ *
+ * @param productsPath Path of the products file.
+ * @param foRecords Output for the number of whole records.
+ * @param foModified Output for the modification time in nanoseconds (whole seconds on Windows).
+ * @return true on success, false if the file does not exist.
+ */
+static bool readProductsFileStamp(const char* productsPath, int64_t* foRecords, int64_t* foModified) {
+#ifdef _WIN32
+    struct _stat64 status;
+    if (_stat64(productsPath, &status) != 0) {return false;}
+    *foModified = (int64_t)status.st_mtime * 1000000000;
+#else
+    struct stat status;
+    if (stat(productsPath, &status) != 0) {return false;}
+#ifdef __APPLE__
+    *foModified = (int64_t)status.st_mtimespec.tv_sec * 1000000000 + status.st_mtimespec.tv_nsec;
+#else
+    *foModified = (int64_t)status.st_mtim.tv_sec * 1000000000 + status.st_mtim.tv_nsec;
+#endif
+#endif
+    *foRecords = (int64_t)status.st_size / (int64_t)sizeof(Product);
+    return true;
+}
+
+/**
+ * @brief Records the current state of the products file as the state the index is in sync with.
+ *
+ * The stamp reaches the file with the next flush of the tree.
+ */
+static void stampProductIndex(PagedBPlusTree* tree, const char* productsPath) {
+    if (!readProductsFileStamp(productsPath, &tree->sourceRecords, &tree->sourceModified)) {
+        tree->sourceRecords = -1;
+        tree->sourceModified = 0;
+    }
+}
+
+/**
+ * @brief Orders bulk load keys for qsort().
+ */
+static int compareBulkKeys(const void* a, const void* b) {
+    return compareProductKeys((const PagedProductKey*)a, (const PagedProductKey*)b);
+}
+
+/**
+ * @brief Writes sorted, distinct keys into an empty tree bottom-up.
+ *
+ * Leaves are filled in key order and linked as they are written, then every internal level is built over
+ * the first keys of the level below. Entries are spread evenly over the pages of a level, so every page but
+ * a lone root is at least half full and later erases start from a valid tree. Each page is written once.
+ *
+ * @return true on success, false on failure.
+ */
+static bool bulkLoadBTree(PagedBPlusTree* tree, const PagedProductKey* keys, int64_t count) {
+    if (count == 0) {return true;}
+    int64_t leafCount = (count + (int64_t)BTREE_LEAF_CAPACITY - 1) / (int64_t)BTREE_LEAF_CAPACITY;
+    int32_t* pages = (int32_t*)malloc((size_t)leafCount * sizeof(int32_t));
+    PagedProductKey* firstKeys = (PagedProductKey*)malloc((size_t)leafCount * sizeof(PagedProductKey));
+    bool ok = pages != NULL && firstKeys != NULL;
+
+    // Leaves; the empty root leaf of the new tree becomes the first one
+    BTreeFrame* previous = NULL;
+    int64_t next = 0;
+    for (int64_t i = 0; ok && i < leafCount; i++) {
+        BTreeFrame* frame = i == 0 ? fetchBTreePage(tree, tree->rootPage) : newBTreePage(tree, true);
+        if (frame == NULL) {ok = false; break;}
+        BTreeLeafPage* leaf = &frame->page.leaf;
+        int take = (int)(count / leafCount + (i < count % leafCount ? 1 : 0));
+        memcpy(leaf->keys, &keys[next], (size_t)take * sizeof(PagedProductKey));
+        leaf->header.keyCount = take;
+        leaf->header.nextLeaf = BTREE_NO_PAGE;
+        if (previous != NULL) {
+            previous->page.header.nextLeaf = frame->pageId;
+            unpinBTreePage(previous, true);
+        }
+        pages[i] = frame->pageId;
+        firstKeys[i] = keys[next];
+        next += take;
+        previous = frame;
+    }
+    if (previous != NULL) {unpinBTreePage(previous, true);}
+
+    // Internal levels; each level overwrites the page ids and first keys of the level below in place
+    int64_t levelCount = leafCount;
+    int32_t height = 1;
+    const int64_t fanOut = (int64_t)BTREE_INTERNAL_CAPACITY + 1;
+    while (ok && levelCount > 1) {
+        int64_t nodeCount = (levelCount + fanOut - 1) / fanOut;
+        int64_t child = 0;
+        for (int64_t i = 0; i < nodeCount; i++) {
+            BTreeFrame* frame = newBTreePage(tree, false);
+            if (frame == NULL) {ok = false; break;}
+            BTreeInternalPage* node = &frame->page.internal;
+            int take = (int)(levelCount / nodeCount + (i < levelCount % nodeCount ? 1 : 0));
+            for (int j = 0; j < take; j++) {
+                node->children[j] = pages[child + j];
+                if (j > 0) {node->keys[j - 1] = firstKeys[child + j];}
+            }
+            node->header.keyCount = take - 1;
+            pages[i] = frame->pageId;
+            firstKeys[i] = firstKeys[child];
+            child += take;
+            unpinBTreePage(frame, true);
+        }
+        levelCount = nodeCount;
+        height++;
+    }
+
+    if (ok) {
+        tree->rootPage = pages[0];
+        tree->height = height;
+        tree->keyCount = count;
+    }
+    free(pages);
+    free(firstKeys);
+    return ok;
+}
+
+/**
+ * @brief Indexes every record of a products file.
+ *
+ * An empty tree is bulk loaded: the keys are sorted in memory and the pages written bottom-up, once each.
+ * A tree that already holds keys gets one insert per record. Every record is indexed, including repeated
+ * listings of a product by the same vendor.
+ *
+ * @param tree The tree.
+ * @param productsPath Path of the products file (e.g. "products.bin").
+ * @return Number of records read, or -1 if the file cannot be opened or the index cannot be written.
+ */
+int64_t buildPagedBPlusTreeFromProducts(PagedBPlusTree* tree, const char* productsPath) {
+    FILE* productFile = fopen(productsPath, "rb");
+    if (productFile == NULL) {return -1;}
+
+    Product product;
+    int64_t records = 0;
+    if (tree->keyCount > 0) {
+        while (fread(&product, sizeof(Product), 1, productFile)) {
+            if (pagedBPlusTreeInsert(tree, product.vendorId, product.productName, records * (int64_t)sizeof(Product)) < 0) {
+                fclose(productFile);
+                return -1;
+            }
+            records++;
+        }
+    }
+    else {
+        PagedProductKey* keys = NULL;
+        int64_t capacity = 0;
+        while (fread(&product, sizeof(Product), 1, productFile)) {
+            if (records == capacity) {
+                capacity = capacity == 0 ? 1024 : capacity * 2;
+                PagedProductKey* grown = (PagedProductKey*)realloc(keys, (size_t)capacity * sizeof(PagedProductKey));
+                if (grown == NULL) {free(keys); fclose(productFile); return -1;}
+                keys = grown;
+            }
+            keys[records] = makeProductKey(product.vendorId, product.productName, records * (int64_t)sizeof(Product));
+            records++;
+        }
+
+        // The offsets make every key distinct, so the sorted keys load as they are
+        if (records > 1) {qsort(keys, (size_t)records, sizeof(PagedProductKey), compareBulkKeys);}
+        bool loaded = bulkLoadBTree(tree, keys, records);
+        free(keys);
+        if (!loaded) {fclose(productFile); return -1;}
+    }
+
+    fclose(productFile);
+    stampProductIndex(tree, productsPath);
+    return flushPagedBPlusTree(tree) ? records : -1;
+}
+
+/**
+ * @brief Opens the product index, building it from the products file if it is missing or out of date.
+ *
+ * This is the startup path: an index whose stamp matches the record count and modification time of the
+ * products file is used as is, so launching costs one meta page read instead of a scan of products.bin.
+ * An index left behind by another products.bin is rebuilt. If the products file does not exist, the index
+ * is opened as it is.
+ *
+ * @param indexPath Path of the index file.
+ * @param productsPath Path of the products file used when the index has to be built.
+ * @param poolSize Number of buffer pool frames.
+ * @return Pointer to the open tree, or NULL on failure.
+ */
+PagedBPlusTree* openProductIndex(const char* indexPath, const char* productsPath, int poolSize) {
+    PagedBPlusTree* tree = openPagedBPlusTree(indexPath, poolSize);
+    if (tree == NULL) {return NULL;}
+
+    int64_t records = 0;
+    int64_t modified = 0;
+    if (!readProductsFileStamp(productsPath, &records, &modified)) {return tree;}
+    if (tree->sourceRecords == records && tree->sourceModified == modified) {return tree;}
+
+    closePagedBPlusTree(tree);
+    remove(indexPath);
+    tree = openPagedBPlusTree(indexPath, poolSize);
+    if (tree == NULL) {return NULL;}
+    if (buildPagedBPlusTreeFromProducts(tree, productsPath) < 0) {
+        closePagedBPlusTree(tree);
+        remove(indexPath);
+        return NULL;
+    }
+    return tree;
+}
+
+/**
+ * @brief Reads the product record at a byte offset of a products file.
+ *
+ * @param productsFile The open products file.
+ * @param offset Byte offset returned by the index.
+ * @param foProduct Output for the product.
+ * @return true on success, false otherwise.
+ */
+bool readProductAtOffset(FILE* productsFile, int64_t offset, Product* foProduct) {
+    if (productsFile == NULL || foProduct == NULL || offset < 0) {return false;}
+    return seekBTreeFile(productsFile, offset) && fread(foProduct, sizeof(Product), 1, productsFile) == 1;
+}
+
+/**
+ * @brief Returns true if a file exists and can be read.
+ */
+static bool productIndexExists(const char* indexPath) {
+    FILE* file = fopen(indexPath, "rb");
+    if (file == NULL) {return false;}
+    fclose(file);
+    return true;
+}
+
+/**
+ * @brief Indexes the product that was just appended to the end of the products file.
+ *
+ * Does nothing if the index file does not exist, so callers can invoke it unconditionally after appending.
+ * If the index did not cover every record before the new one, it is rebuilt instead.
+ *
+ * @param indexPath Path of the index file.
+ * @param productsPath Path of the products file the product was appended to.
+ * @param product The appended product.
+ * @return true if the index is in sync (or absent), false if it could not be updated.
+ */
+bool appendToProductIndex(const char* indexPath, const char* productsPath, const Product* product) {
+    if (!productIndexExists(indexPath)) {return true;}
+
+    int64_t records = 0;
+    int64_t modified = 0;
+    if (!readProductsFileStamp(productsPath, &records, &modified) || records < 1) {return false;}
+
+    PagedBPlusTree* tree = openPagedBPlusTree(indexPath, 0);
+    if (tree == NULL) {return false;}
+    if (tree->sourceRecords != records - 1) {
+        // The index did not cover every record before this one
+        closePagedBPlusTree(tree);
+        return refreshProductIndex(indexPath, productsPath);
+    }
+    bool ok = pagedBPlusTreeInsert(tree, product->vendorId, product->productName, (records - 1) * (int64_t)sizeof(Product)) >= 0;
+    if (ok) {stampProductIndex(tree, productsPath);}
+    return closePagedBPlusTree(tree) && ok;
+}
+
+/**
+ * @brief Applies a change of the products file to the index by touching only the affected keys.
+ *
+ * The keys of the removed records are erased first, then the placed records are indexed at their offsets.
+ * A change that moves records lists the moved ones as removed with their old offsets and as placed with
+ * their new ones; a record rewritten in place is removed and placed at the same offset. If the index was not
+ * in sync with the file before the change, or a page cannot be written, the index is rebuilt instead. Does
+ * nothing if the index file does not exist.
+ *
+ * @param indexPath Path of the index file.
+ * @param productsPath Path of the changed products file.
+ * @param recordDelta Number of records the change added (negative if it removed records).
+ * @param removed Records as they were indexed before the change; may be NULL if removedCount is 0.
+ * @param removedOffsets Byte offsets the removed records were indexed with.
+ * @param removedCount Number of removed records.
+ * @param placed Records written at new positions; may be NULL if placedCount is 0.
+ * @param placedOffsets Byte offsets of the placed records.
+ * @param placedCount Number of placed records.
+ * @return true if the index is in sync (or absent), false if it could not be updated.
+ */
+bool patchProductIndex(const char* indexPath, const char* productsPath, int64_t recordDelta, const Product removed[],
+                       const int64_t removedOffsets[], int removedCount, const Product placed[], const int64_t placedOffsets[], int placedCount) {
+    if (!productIndexExists(indexPath)) {return true;}
+
+    int64_t records = 0;
+    int64_t modified = 0;
+    if (!readProductsFileStamp(productsPath, &records, &modified)) {return false;}
+
+    PagedBPlusTree* tree = openPagedBPlusTree(indexPath, 0);
+    if (tree == NULL) {return false;}
+    bool ok = tree->sourceRecords == records - recordDelta;
+    for (int i = 0; ok && i < removedCount; i++) {
+        ok = pagedBPlusTreeErase(tree, removed[i].vendorId, removed[i].productName, removedOffsets[i]) >= 0;
+    }
+    for (int i = 0; ok && i < placedCount; i++) {
+        ok = pagedBPlusTreeInsert(tree, placed[i].vendorId, placed[i].productName, placedOffsets[i]) >= 0;
+    }
+    if (ok) {stampProductIndex(tree, productsPath);}
+    if (closePagedBPlusTree(tree) && ok) {return true;}
+    return refreshProductIndex(indexPath, productsPath);
+}
+
+/**
+ * @brief Rebuilds the index from scratch after the products file changed in a way that cannot be patched.
+ *
+ * The index is bulk loaded from the products file. Does nothing if the index file does not exist.
+ *
+ * @param indexPath Path of the index file.
+ * @param productsPath Path of the products file.
+ * @return true if the index is in sync (or absent), false if it could not be rebuilt.
+ */
+bool refreshProductIndex(const char* indexPath, const char* productsPath) {
+    if (!productIndexExists(indexPath)) {return true;}
+    remove(indexPath);
+    PagedBPlusTree* tree = openProductIndex(indexPath, productsPath, 0);
+    return tree != NULL && closePagedBPlusTree(tree);
+}
@@ -0,0 +1,62 @@
+/**
+ * @file priceAggregates.cpp
+ * @brief Per-product minimum, maximum, mean and count of prices over the CSC view of the vendor-product matrix.
+ *
+ * @details In the CSC layout the prices of one product are contiguous, so the statistics of every product are
+ * reductions over one column slice. They use the vectorized MathUtility reductions, which pick the SSE2 or
+ * AVX2 variant for the running CPU and sum the floats in double precision.
+ */
+
+#include "../header/compressedSparseMatrix.h"
+#include "mathUtility.h"
+
+using Coruh::Utility::MathUtility;
+
+/**
+ * @brief Builds the aggregate of one column slice.
+ */
+static ProductPriceAggregate aggregateColumn(int productId, const float* prices, int count) {
+    ProductPriceAggregate aggregate;
+    aggregate.productId = productId;
+    aggregate.count = count;
+    MathUtility::calculateMinMax(prices, count, &aggregate.minPrice, &aggregate.maxPrice);
+    aggregate.meanPrice = (float)MathUtility::calculateMean(prices, count);
+    return aggregate;
+}
+
+/**
+ * @brief Computes the price statistics of every product in one pass over the columns.
+ *
+ * @param columns The matrix grouped by product (SPARSE_BY_PRODUCT).
+ * @param foAggregates Output array in ascending product ID order; may be NULL when only the count is needed.
+ * @param maxCount Capacity of foAggregates.
+ * @return The number of products (may exceed maxCount), or -1 if columns is NULL or not grouped by product.
+ */
+int aggregateProductPrices(const CompressedSparseMatrix* columns, ProductPriceAggregate foAggregates[], int maxCount) {
+    if (columns == NULL || columns->axis != SPARSE_BY_PRODUCT) {return -1;}
+    if (foAggregates != NULL) {
+        int limit = columns->rowCount < maxCount ? columns->rowCount : maxCount;
+        for (int row = 0; row < limit; row++) {
+            int start = columns->rowPointers[row];
+            foAggregates[row] = aggregateColumn(columns->rowIds[row], columns->prices + start, columns->rowPointers[row + 1] - start);
+        }
+    }
+    return columns->rowCount;
+}
+
+/**
+ * @brief Computes the price statistics of a single product.
+ *
+ * @param columns The matrix grouped by product (SPARSE_BY_PRODUCT).
+ * @param productId The product.
+ * @param foAggregate Receives the statistics.
+ * @return true if the product has at least one vendor, false otherwise.
+ */
+bool aggregateProductPrice(const CompressedSparseMatrix* columns, int productId, ProductPriceAggregate* foAggregate) {
+    if (columns == NULL || columns->axis != SPARSE_BY_PRODUCT || foAggregate == NULL) {return false;}
+    const float* prices = NULL;
+    int count = compressedSparseMatrixRow(columns, productId, NULL, &prices);
+    if (count == 0) {return false;}
+    *foAggregate = aggregateColumn(productId, prices, count);
+    return true;
+}
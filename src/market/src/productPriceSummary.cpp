@@ -0,0 +1,355 @@
+/**
+ * @file productPriceSummary.cpp
+ * @brief Hash file of per-product-name price summaries, maintained record by record.
+ *
+ * @details The file is a PriceSummaryFileHeader followed by slotCount ProductPriceSummary slots. A name is
+ * looked up by hashing it (FNV-1a) to a slot and probing linearly; removed summaries leave a deleted marker
+ * so that probe sequences through them stay intact. Adding a product to an existing name or removing a name
+ * rewrites one slot and the header. When used and deleted slots would exceed three quarters of the table, the
+ * live summaries are rehashed into a new file with at least twice as many slots as summaries, which replaces
+ * the old one by rename.
+ */
+
+#include "../header/atomicFile.h"
+#include "../header/productPriceSummary.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Returns the FNV-1a hash of a product name.
+ */
+static uint32_t priceSummaryNameHash(const char* productName) {
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < 50 && productName[i] != '\0'; i++) {
+        hash ^= (unsigned char)productName[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Returns true if a slot holds the summary of the given name.
+ */
+static bool priceSummaryMatches(const ProductPriceSummary* slot, const char* productName) {
+    return slot->state == PRICE_SUMMARY_USED && strncmp(slot->productName, productName, 50) == 0;
+}
+
+/**
+ * @brief Adds one offer to a summary, starting the summary if the slot is not in use.
+ */
+static void mergeProductIntoSummary(ProductPriceSummary* summary, const Product* product) {
+    if (summary->state != PRICE_SUMMARY_USED) {
+        memset(summary, 0, sizeof(ProductPriceSummary));
+        summary->state = PRICE_SUMMARY_USED;
+        strncpy(summary->productName, product->productName, 50);
+        summary->minPrice = product->price;
+        summary->minVendorId = product->vendorId;
+        summary->maxPrice = product->price;
+        summary->maxVendorId = product->vendorId;
+    }
+    else {
+        if (product->price < summary->minPrice) {
+            summary->minPrice = product->price;
+            summary->minVendorId = product->vendorId;
+        }
+        if (product->price > summary->maxPrice) {
+            summary->maxPrice = product->price;
+            summary->maxVendorId = product->vendorId;
+        }
+    }
+    summary->count++;
+    summary->priceSum += product->price;
+}
+
+/**
+ * @brief Returns the slot of a name in an in-memory table, or the empty slot where it would be inserted.
+ *
+ * The table never contains deleted markers, and always has an empty slot.
+ */
+static int findSummarySlot(const ProductPriceSummary* slots, int slotCount, const char* productName) {
+    int slot = (int)(priceSummaryNameHash(productName) & (uint32_t)(slotCount - 1));
+    while (slots[slot].state == PRICE_SUMMARY_USED && !priceSummaryMatches(&slots[slot], productName)) {
+        slot = (slot + 1) & (slotCount - 1);
+    }
+    return slot;
+}
+
+/**
+ * @brief Rehashes the used summaries of a table into a new table with room for extra more summaries.
+ *
+ * @return The new table (calloc'ed), or NULL if memory is exhausted; foSlotCount receives its size.
+ */
+static ProductPriceSummary* rehashSummaries(const ProductPriceSummary* slots, int slotCount, int usedCount, int extra, int* foSlotCount) {
+    int newSlotCount = PRICE_SUMMARY_INITIAL_SLOTS;
+    while (newSlotCount < 2 * (usedCount + extra)) {newSlotCount *= 2;}
+    ProductPriceSummary* table = (ProductPriceSummary*)calloc((size_t)newSlotCount, sizeof(ProductPriceSummary));
+    if (table == NULL) {return NULL;}
+    for (int i = 0; i < slotCount; i++) {
+        if (slots[i].state != PRICE_SUMMARY_USED) {continue;}
+        table[findSummarySlot(table, newSlotCount, slots[i].productName)] = slots[i];
+    }
+    *foSlotCount = newSlotCount;
+    return table;
+}
+
+/**
+ * @brief A summary table and its file header, passed to writeSummarySlots().
+ */
+typedef struct {
+    const PriceSummaryFileHeader* header;
+    const ProductPriceSummary* slots;
+} PriceSummaryFileContents;
+
+/**
+ * @brief Writes the header and the slots of a summary file.
+ */
+static bool writeSummarySlots(FILE* file, const void* context) {
+    const PriceSummaryFileContents* contents = (const PriceSummaryFileContents*)context;
+    size_t slotCount = (size_t)contents->header->slotCount;
+    return fwrite(contents->header, sizeof(PriceSummaryFileHeader), 1, file) == 1 &&
+           fwrite(contents->slots, sizeof(ProductPriceSummary), slotCount, file) == slotCount;
+}
+
+/**
+ * @brief Writes an in-memory table over the summary file, replacing it atomically.
+ */
+static bool writeSummaryTable(const char* summaryPath, const ProductPriceSummary* slots, int slotCount, int usedCount) {
+    PriceSummaryFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = PRICE_SUMMARY_FILE_MAGIC;
+    header.version = PRICE_SUMMARY_FILE_VERSION;
+    header.slotCount = slotCount;
+    header.usedCount = usedCount;
+    header.occupiedCount = usedCount;
+
+    PriceSummaryFileContents contents = {&header, slots};
+    return replaceFileAtomically(summaryPath, writeSummarySlots, &contents);
+}
+
+/**
+ * @brief Opens a summary file and reads and checks its header.
+ *
+ * @return The open file, or NULL if it is missing or not a summary file.
+ */
+static FILE* openSummaryFile(const char* summaryPath, const char* mode, PriceSummaryFileHeader* foHeader) {
+    FILE* file = fopen(summaryPath, mode);
+    if (file == NULL) {return NULL;}
+    if (fread(foHeader, sizeof(PriceSummaryFileHeader), 1, file) != 1 || foHeader->magic != PRICE_SUMMARY_FILE_MAGIC ||
+        foHeader->version != PRICE_SUMMARY_FILE_VERSION || foHeader->slotCount <= 0 ||
+        (foHeader->slotCount & (foHeader->slotCount - 1)) != 0) {
+        fclose(file);
+        return NULL;
+    }
+    return file;
+}
+
+/**
+ * @brief Reads or writes one slot of an open summary file.
+ */
+static bool readSummarySlot(FILE* file, int slot, ProductPriceSummary* foSummary) {
+    return fseek(file, (long)(sizeof(PriceSummaryFileHeader) + (size_t)slot * sizeof(ProductPriceSummary)), SEEK_SET) == 0 &&
+           fread(foSummary, sizeof(ProductPriceSummary), 1, file) == 1;
+}
+
+static bool writeSummarySlot(FILE* file, int slot, const ProductPriceSummary* summary) {
+    return fseek(file, (long)(sizeof(PriceSummaryFileHeader) + (size_t)slot * sizeof(ProductPriceSummary)), SEEK_SET) == 0 &&
+           fwrite(summary, sizeof(ProductPriceSummary), 1, file) == 1;
+}
+
+static bool writeSummaryHeader(FILE* file, const PriceSummaryFileHeader* header) {
+    return fseek(file, 0, SEEK_SET) == 0 && fwrite(header, sizeof(PriceSummaryFileHeader), 1, file) == 1;
+}
+
+/**
+ * @brief Probes an open summary file for a name.
+ *
+ * @param foSlot Receives the slot holding the name, or -1.
+ * @param foFreeSlot Receives the first empty or deleted slot on the probe sequence, or -1.
+ * @param foSummary Receives the summary of the name if it is found, or the free slot's contents.
+ * @return false on read errors.
+ */
+static bool probeSummaryFile(FILE* file, const PriceSummaryFileHeader* header, const char* productName, int* foSlot, int* foFreeSlot, ProductPriceSummary* foSummary) {
+    *foSlot = -1;
+    *foFreeSlot = -1;
+    int slot = (int)(priceSummaryNameHash(productName) & (uint32_t)(header->slotCount - 1));
+    ProductPriceSummary current;
+    for (int probes = 0; probes < header->slotCount; probes++) {
+        if (!readSummarySlot(file, slot, &current)) {return false;}
+        if (priceSummaryMatches(&current, productName)) {
+            *foSlot = slot;
+            *foSummary = current;
+            return true;
+        }
+        if (current.state != PRICE_SUMMARY_USED && *foFreeSlot < 0) {
+            *foFreeSlot = slot;
+            *foSummary = current;
+        }
+        if (current.state == PRICE_SUMMARY_EMPTY) {break;}
+        slot = (slot + 1) & (header->slotCount - 1);
+    }
+    return true;
+}
+
+/**
+ * @brief Creates the summary file from every record of a products file, replacing an existing one.
+ *
+ * @param summaryPath Path of the summary file.
+ * @param productsPath Path of the products file; a missing file gives an empty summary file.
+ * @return true on success, false on I/O errors or when memory is exhausted.
+ */
+bool buildProductPriceSummaries(const char* summaryPath, const char* productsPath) {
+    if (summaryPath == NULL) {return false;}
+    int slotCount = PRICE_SUMMARY_INITIAL_SLOTS;
+    int usedCount = 0;
+    ProductPriceSummary* slots = (ProductPriceSummary*)calloc((size_t)slotCount, sizeof(ProductPriceSummary));
+    if (slots == NULL) {return false;}
+
+    FILE* productsFile = productsPath != NULL ? fopen(productsPath, "rb") : NULL;
+    Product product;
+    while (productsFile != NULL && fread(&product, sizeof(Product), 1, productsFile) == 1) {
+        int slot = findSummarySlot(slots, slotCount, product.productName);
+        if (slots[slot].state != PRICE_SUMMARY_USED) {
+            if (2 * (usedCount + 1) > slotCount) {
+                int grownCount = 0;
+                ProductPriceSummary* grown = rehashSummaries(slots, slotCount, usedCount, usedCount + 1, &grownCount);
+                if (grown == NULL) {
+                    free(slots);
+                    fclose(productsFile);
+                    return false;
+                }
+                free(slots);
+                slots = grown;
+                slotCount = grownCount;
+                slot = findSummarySlot(slots, slotCount, product.productName);
+            }
+            usedCount++;
+        }
+        mergeProductIntoSummary(&slots[slot], &product);
+    }
+    if (productsFile != NULL) {fclose(productsFile);}
+
+    bool written = writeSummaryTable(summaryPath, slots, slotCount, usedCount);
+    free(slots);
+    return written;
+}
+
+/**
+ * @brief Makes sure the summary file exists, building it from the products file only if it does not.
+ *
+ * Like openProductIndex(), an existing file is used as is.
+ *
+ * @param summaryPath Path of the summary file.
+ * @param productsPath Path of the products file used when the summaries have to be built.
+ * @return true if the summary file exists or was built, false otherwise.
+ */
+bool openProductPriceSummaries(const char* summaryPath, const char* productsPath) {
+    PriceSummaryFileHeader header;
+    FILE* file = openSummaryFile(summaryPath, "rb", &header);
+    if (file != NULL) {
+        fclose(file);
+        return true;
+    }
+    return buildProductPriceSummaries(summaryPath, productsPath);
+}
+
+/**
+ * @brief Looks up the price summary of a product name.
+ *
+ * @param summaryPath Path of the summary file.
+ * @param productName Name of the product.
+ * @param foSummary Receives the summary.
+ * @return true if the name has offers, false if it has none or the file cannot be read.
+ */
+bool findProductPriceSummary(const char* summaryPath, const char* productName, ProductPriceSummary* foSummary) {
+    if (productName == NULL || foSummary == NULL) {return false;}
+    PriceSummaryFileHeader header;
+    FILE* file = openSummaryFile(summaryPath, "rb", &header);
+    if (file == NULL) {return false;}
+    int slot = -1;
+    int freeSlot = -1;
+    ProductPriceSummary summary;
+    bool read = probeSummaryFile(file, &header, productName, &slot, &freeSlot, &summary);
+    fclose(file);
+    if (!read || slot < 0) {return false;}
+    *foSummary = summary;
+    return true;
+}
+
+/**
+ * @brief Adds a product that was just written to products.bin to the summary of its name.
+ *
+ * Does nothing if the summary file does not exist, so callers can invoke it unconditionally.
+ *
+ * @param summaryPath Path of the summary file.
+ * @param product The new offer.
+ * @return true if the summaries are in sync (or absent), false if they could not be updated.
+ */
+bool addToProductPriceSummaries(const char* summaryPath, const Product* product) {
+    if (product == NULL) {return false;}
+    PriceSummaryFileHeader header;
+    FILE* file = openSummaryFile(summaryPath, "r+b", &header);
+    if (file == NULL) {return true;}
+
+    int slot = -1;
+    int freeSlot = -1;
+    ProductPriceSummary summary;
+    if (!probeSummaryFile(file, &header, product->productName, &slot, &freeSlot, &summary)) {
+        fclose(file);
+        return false;
+    }
+
+    if (slot >= 0 || (freeSlot >= 0 && (summary.state == PRICE_SUMMARY_DELETED || 4 * (header.occupiedCount + 1) <= 3 * header.slotCount))) {
+        bool newName = slot < 0;
+        if (newName) {
+            if (summary.state == PRICE_SUMMARY_EMPTY) {header.occupiedCount++;}
+            header.usedCount++;
+            slot = freeSlot;
+        }
+        mergeProductIntoSummary(&summary, product);
+        bool written = writeSummarySlot(file, slot, &summary) && (!newName || writeSummaryHeader(file, &header));
+        return fclose(file) == 0 && written;
+    }
+
+    // Too full for a new name: rehash the live summaries into a larger file
+    ProductPriceSummary* slots = (ProductPriceSummary*)malloc((size_t)header.slotCount * sizeof(ProductPriceSummary));
+    bool read = slots != NULL && fseek(file, (long)sizeof(PriceSummaryFileHeader), SEEK_SET) == 0 &&
+                fread(slots, sizeof(ProductPriceSummary), (size_t)header.slotCount, file) == (size_t)header.slotCount;
+    fclose(file);
+    int grownCount = 0;
+    ProductPriceSummary* grown = read ? rehashSummaries(slots, header.slotCount, header.usedCount, 1, &grownCount) : NULL;
+    free(slots);
+    if (grown == NULL) {return false;}
+    mergeProductIntoSummary(&grown[findSummarySlot(grown, grownCount, product->productName)], product);
+    bool written = writeSummaryTable(summaryPath, grown, grownCount, header.usedCount + 1);
+    free(grown);
+    return written;
+}
+
+/**
+ * @brief Removes the summary of a product name whose records were all deleted or rewritten.
+ *
+ * Does nothing if the summary file does not exist or holds no summary for the name.
+ *
+ * @param summaryPath Path of the summary file.
+ * @param productName Name of the product.
+ * @return true if the summaries are in sync (or absent), false if they could not be updated.
+ */
+bool removeFromProductPriceSummaries(const char* summaryPath, const char* productName) {
+    if (productName == NULL) {return false;}
+    PriceSummaryFileHeader header;
+    FILE* file = openSummaryFile(summaryPath, "r+b", &header);
+    if (file == NULL) {return true;}
+
+    int slot = -1;
+    int freeSlot = -1;
+    ProductPriceSummary summary;
+    bool ok = probeSummaryFile(file, &header, productName, &slot, &freeSlot, &summary);
+    if (ok && slot >= 0) {
+        memset(&summary, 0, sizeof(summary));
+        summary.state = PRICE_SUMMARY_DELETED;
+        header.usedCount--;
+        ok = writeSummarySlot(file, slot, &summary) && writeSummaryHeader(file, &header);
+    }
+    return fclose(file) == 0 && ok;
+}
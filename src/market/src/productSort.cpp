@@ -0,0 +1,494 @@
+/**
+ * @file productSort.cpp
+ * @brief Parallel sorting of product catalogs on key/index entries, and the sorted catalog report.
+ *
+ * @details Sorting by price, or by vendor and price, is decided by the 64-bit entry key alone. Sorting by
+ * name keys on the first 8 bytes of the name in big-endian order, which is strcmp order for the prefix; the
+ * records are only read to break ties between names that share those 8 bytes. Parallel sorting is a merge
+ * sort: with T threads the entries are cut into T runs, sorted concurrently, and merged in log2(T) rounds
+ * between two buffers. Runs are sorted with std::sort, or for price order with a stable LSD radix sort on
+ * the order-preserving price bits, which needs no comparisons at all.
+ *
+ * The catalog-wide price comparison report groups the records by name with a hash map while streaming
+ * products.bin once, places each group's (price, record) keys contiguously with a counting sort and radix
+ * sorts every group on its own.
+ */
+
+#include "../header/productSort.h"
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief Strict ordering of sort entries, with the record ties described in productSort.h.
+     */
+    struct ProductSortEntryLess
+    {
+        const Product* products;    ///< Records the entry indexes refer to.
+        ProductSortOrder order;     ///< Field being sorted.
+
+        bool operator()(const ProductSortEntry& a, const ProductSortEntry& b) const
+        {
+            if (a.key != b.key) {return a.key < b.key;}
+            if (order == PRODUCT_SORT_BY_NAME) {
+                const Product& left = products[a.index];
+                const Product& right = products[b.index];
+                int byName = strncmp(left.productName, right.productName, sizeof(left.productName));
+                if (byName != 0) {return byName < 0;}
+                uint32_t leftPrice = orderedPriceBits(left.price);
+                uint32_t rightPrice = orderedPriceBits(right.price);
+                if (leftPrice != rightPrice) {return leftPrice < rightPrice;}
+            }
+            return a.index < b.index;
+        }
+    };
+
+    /**
+     * @brief Returns the first 8 bytes of a name as a big-endian integer, padded with zero bytes.
+     */
+    uint64_t namePrefixKey(const char* name, size_t capacity)
+    {
+        uint64_t key = 0;
+        size_t i = 0;
+        for (; i < 8 && i < capacity && name[i] != '\0'; i++) {key = (key << 8) | (unsigned char)name[i];}
+        for (; i < 8; i++) {key <<= 8;}
+        return key;
+    }
+
+    /**
+     * @brief Builds the sort entries of products [begin, end).
+     */
+    void fillSortEntries(const Product* products, int begin, int end, ProductSortOrder order, ProductSortEntry* entries)
+    {
+        for (int i = begin; i < end; i++) {
+            const Product& product = products[i];
+            uint64_t key;
+            switch (order) {
+            case PRODUCT_SORT_BY_NAME:
+                key = namePrefixKey(product.productName, sizeof(product.productName));
+                break;
+            case PRODUCT_SORT_BY_VENDOR:
+                // Flipping the sign bit makes negative IDs order below positive ones as unsigned values
+                key = ((uint64_t)((uint32_t)product.vendorId ^ 0x80000000u) << 32) | orderedPriceBits(product.price);
+                break;
+            default:
+                key = orderedPriceBits(product.price);
+                break;
+            }
+            entries[i].key = key;
+            entries[i].index = i;
+            entries[i].reserved = 0;
+        }
+    }
+
+    /** @brief Key width of one radix sort pass. */
+    const int RadixBits = 8;
+    const int RadixBuckets = 1 << RadixBits;
+
+    /** @brief Ranges shorter than this are not worth the four histogram passes of the radix sort. */
+    const int RadixMinLength = 256;
+
+    /**
+     * @brief Stable LSD radix sort of n entries on a 32-bit key, one pass per byte.
+     *
+     * The histograms of all four bytes are counted in one read of the input. Passes whose byte is the same
+     * for every entry are skipped; catalog prices rarely use all four bytes. Entries move between data and
+     * scratch and end up in data.
+     */
+    template <typename Entry, typename KeyOf>
+    void lsdRadixSort(Entry* data, Entry* scratch, int n, KeyOf keyOf)
+    {
+        int counts[4][RadixBuckets];
+        memset(counts, 0, sizeof(counts));
+        for (int i = 0; i < n; i++) {
+            uint32_t key = keyOf(data[i]);
+            for (int pass = 0; pass < 4; pass++) {counts[pass][(key >> (pass * RadixBits)) & (RadixBuckets - 1)]++;}
+        }
+
+        Entry* source = data;
+        Entry* target = scratch;
+        for (int pass = 0; pass < 4; pass++) {
+            int shift = pass * RadixBits;
+            if (counts[pass][(keyOf(source[0]) >> shift) & (RadixBuckets - 1)] == n) {continue;}
+            int offsets[RadixBuckets];
+            int offset = 0;
+            for (int bucket = 0; bucket < RadixBuckets; bucket++) {
+                offsets[bucket] = offset;
+                offset += counts[pass][bucket];
+            }
+            for (int i = 0; i < n; i++) {target[offsets[(keyOf(source[i]) >> shift) & (RadixBuckets - 1)]++] = source[i];}
+            std::swap(source, target);
+        }
+        if (source != data) {memcpy(data, source, (size_t)n * sizeof(Entry));}
+    }
+
+    /** @brief Radix key of a price sort entry: the ordered price bits in its low half. */
+    struct SortEntryPriceBits
+    {
+        uint32_t operator()(const ProductSortEntry& entry) const {return (uint32_t)entry.key;}
+    };
+
+    /** @brief Radix key of a (price, index) key. */
+    struct PriceKeyBits
+    {
+        uint32_t operator()(const PriceSortKey& key) const {return orderedPriceBits(key.price);}
+    };
+
+    /**
+     * @brief Sorts entries [begin, end), which are in index order: radix sort for price order when scratch
+     *        space is given, std::sort otherwise.
+     */
+    void sortRun(ProductSortEntry* entries, ProductSortEntry* scratch, int begin, int end, ProductSortOrder order, const ProductSortEntryLess& less)
+    {
+        if (order == PRODUCT_SORT_BY_PRICE && scratch != NULL && end - begin >= RadixMinLength) {
+            // Stable on entries in index order, so equal prices stay in index order as the comparator requires
+            lsdRadixSort(entries + begin, scratch + begin, end - begin, SortEntryPriceBits());
+        }
+        else {
+            std::sort(entries + begin, entries + end, less);
+        }
+    }
+
+    /**
+     * @brief Runs the tasks concurrently, the first one on the calling thread, and waits for all of them.
+     *
+     * A task whose thread cannot be started runs on the calling thread instead.
+     */
+    void runConcurrently(std::vector<std::function<void()> >& tasks)
+    {
+        std::vector<std::thread> workers;
+        workers.reserve(tasks.size());
+        std::vector<size_t> unstarted;
+        for (size_t i = 1; i < tasks.size(); i++) {
+            try {
+                workers.push_back(std::thread(tasks[i]));
+            }
+            catch (const std::exception&) {
+                unstarted.push_back(i);
+            }
+        }
+        if (!tasks.empty()) {tasks[0]();}
+        for (size_t i = 0; i < unstarted.size(); i++) {tasks[unstarted[i]]();}
+        for (size_t i = 0; i < workers.size(); i++) {workers[i].join();}
+    }
+
+    /**
+     * @brief Returns the number of threads to sort count entries with.
+     */
+    int sortThreadCount(int count, int requested)
+    {
+        if (count < PARALLEL_SORT_THRESHOLD) {return 1;}
+        int threads = requested;
+        if (threads <= 0) {
+            threads = (int)std::thread::hardware_concurrency();
+            if (threads <= 0) {threads = 1;}
+        }
+        int byRunSize = count / PARALLEL_SORT_MIN_RUN;
+        if (threads > byRunSize) {threads = byRunSize;}
+        return threads > 1 ? threads : 1;
+    }
+}
+
+/**
+ * @brief Maps a price to an unsigned integer with the same order.
+ *
+ * Positive floats order like their bit patterns; negative ones in reverse. Setting the sign bit of
+ * positive values and inverting negative values gives one ascending unsigned order for all of them.
+ *
+ * @param price The price.
+ * @return The order-preserving key.
+ */
+uint32_t orderedPriceBits(float price) {
+    uint32_t bits;
+    memcpy(&bits, &price, sizeof(bits));
+    return (bits & 0x80000000u) != 0 ? ~bits : bits | 0x80000000u;
+}
+
+/**
+ * @brief Sorts (price, record index) keys by ascending price with an LSD radix sort.
+ *
+ * The prices are sorted as orderedPriceBits() integers, one byte per pass, in O(n) instead of the
+ * O(n log n) comparisons of heapSortPriceKeys(). The sort is stable: keys filled in index order come out
+ * in the same order as from heapSortPriceKeys(). -0.0 sorts before 0.0. Short arrays, and arrays whose
+ * scratch buffer cannot be allocated, are heap sorted.
+ *
+ * @param keys Keys to be sorted.
+ * @param n Number of keys.
+ */
+void radixSortPriceKeys(PriceSortKey keys[], int n) {
+    if (n < RadixMinLength) {
+        heapSortPriceKeys(keys, n);
+        return;
+    }
+    PriceSortKey* scratch = (PriceSortKey*)malloc((size_t)n * sizeof(PriceSortKey));
+    if (scratch == NULL) {
+        heapSortPriceKeys(keys, n);
+        return;
+    }
+    lsdRadixSort(keys, scratch, n, PriceKeyBits());
+    free(scratch);
+}
+
+/**
+ * @brief Reads every product record of a product file into memory.
+ *
+ * @param productFilePath The product file, normally "products.bin".
+ * @param foProducts Receives a malloc'ed array of the products (NULL for an empty file); release it with free().
+ * @return The number of products, -1 if the file cannot be read or memory is exhausted.
+ */
+int loadProductCatalog(const char* productFilePath, Product** foProducts) {
+    if (productFilePath == NULL || foProducts == NULL) {return -1;}
+    *foProducts = NULL;
+    FILE* productFile = fopen(productFilePath, "rb");
+    if (productFile == NULL) {return -1;}
+
+    Product* products = NULL;
+    int count = 0;
+    int capacity = 0;
+    while (true) {
+        if (count == capacity) {
+            int grown = capacity > 0 ? 2 * capacity : 1024;
+            Product* larger = (Product*)realloc(products, (size_t)grown * sizeof(Product));
+            if (larger == NULL) {
+                free(products);
+                fclose(productFile);
+                return -1;
+            }
+            products = larger;
+            capacity = grown;
+        }
+        size_t read = fread(products + count, sizeof(Product), (size_t)(capacity - count), productFile);
+        count += (int)read;
+        if (count < capacity) {break;}
+    }
+    fclose(productFile);
+
+    if (count == 0) {
+        free(products);
+        products = NULL;
+    }
+    *foProducts = products;
+    return count;
+}
+
+/**
+ * @brief Sorts a catalog and returns the order of its records.
+ *
+ * Catalogs smaller than PARALLEL_SORT_THRESHOLD are sorted on the calling thread; larger ones on up to
+ * threadCount threads, one per PARALLEL_SORT_MIN_RUN products at most. The products are not modified.
+ *
+ * @param products The records.
+ * @param count Number of records.
+ * @param order Field to sort by.
+ * @param threadCount Maximum number of threads, 0 or less for one per hardware thread.
+ * @param foOrder Receives count record indexes in sorted order.
+ * @return true on success, false for invalid arguments or when memory is exhausted.
+ */
+bool sortProductCatalog(const Product* products, int count, ProductSortOrder order, int threadCount, int* foOrder) {
+    if (count < 0 || (count > 0 && (products == NULL || foOrder == NULL))) {return false;}
+    if (count == 0) {return true;}
+
+    std::vector<ProductSortEntry> entries;
+    std::vector<ProductSortEntry> merged;
+    int threads = sortThreadCount(count, threadCount);
+    try {
+        entries.resize((size_t)count);
+        if (threads > 1) {merged.resize((size_t)count);}
+    }
+    catch (const std::bad_alloc&) {
+        return false;
+    }
+    if (threads == 1 && order == PRODUCT_SORT_BY_PRICE) {
+        // Scratch space for the radix sort; without it the comparison sort is used
+        try {merged.resize((size_t)count);}
+        catch (const std::bad_alloc&) {}
+    }
+
+    ProductSortEntryLess less = {products, order};
+    if (threads == 1) {
+        fillSortEntries(products, 0, count, order, entries.data());
+        sortRun(entries.data(), merged.empty() ? NULL : merged.data(), 0, count, order, less);
+    }
+    else {
+        std::vector<int> runStarts((size_t)threads + 1);
+        for (int t = 0; t <= threads; t++) {runStarts[t] = (int)((long long)count * t / threads);}
+
+        ProductSortEntry* source = entries.data();
+        ProductSortEntry* target = merged.data();
+        std::vector<std::function<void()> > tasks;
+        for (int t = 0; t < threads; t++) {
+            int begin = runStarts[t];
+            int end = runStarts[t + 1];
+            tasks.push_back([=]() {
+                fillSortEntries(products, begin, end, order, source);
+                sortRun(source, target, begin, end, order, less);
+            });
+        }
+        runConcurrently(tasks);
+
+        // Merge neighbouring runs until one is left; an unpaired last run is copied over
+        while (runStarts.size() > 2) {
+            std::vector<int> nextStarts;
+            tasks.clear();
+            for (size_t r = 0; r + 1 < runStarts.size(); r += 2) {
+                int begin = runStarts[r];
+                int middle = runStarts[r + 1];
+                int end = r + 2 < runStarts.size() ? runStarts[r + 2] : middle;
+                nextStarts.push_back(begin);
+                tasks.push_back([=]() {
+                    std::merge(source + begin, source + middle, source + middle, source + end, target + begin, less);
+                });
+            }
+            nextStarts.push_back(count);
+            runConcurrently(tasks);
+            std::swap(source, target);
+            runStarts.swap(nextStarts);
+        }
+        if (source != entries.data()) {entries.swap(merged);}
+    }
+
+    for (int i = 0; i < count; i++) {foOrder[i] = entries[i].index;}
+    return true;
+}
+
+/**
+ * @brief Writes a text report of every product in a product file, sorted by the given field.
+ *
+ * Each line holds the rank, vendor ID, name, price, quantity and season of one product.
+ *
+ * @param productFilePath The product file, normally "products.bin".
+ * @param order Field to sort by.
+ * @param threadCount Maximum number of sorting threads, 0 or less for one per hardware thread.
+ * @param reportPath The report file to create or overwrite.
+ * @return true on success, false if a file cannot be read or written or memory is exhausted.
+ */
+bool writeSortedProductReport(const char* productFilePath, ProductSortOrder order, int threadCount, const char* reportPath) {
+    if (reportPath == NULL) {return false;}
+    Product* products = NULL;
+    int count = loadProductCatalog(productFilePath, &products);
+    if (count < 0) {return false;}
+
+    int* sortedOrder = (int*)malloc((size_t)(count > 0 ? count : 1) * sizeof(int));
+    if (sortedOrder == NULL || !sortProductCatalog(products, count, order, threadCount, sortedOrder)) {
+        free(sortedOrder);
+        free(products);
+        return false;
+    }
+
+    FILE* report = fopen(reportPath, "w");
+    bool written = report != NULL;
+    if (written) {
+        static const char* const orderNames[] = {"price", "name", "vendor"};
+        const char* orderName = order == PRODUCT_SORT_BY_NAME || order == PRODUCT_SORT_BY_VENDOR ? orderNames[order] : orderNames[0];
+        written = fprintf(report, "--- %d products sorted by %s ---\n", count, orderName) > 0;
+        for (int i = 0; written && i < count; i++) {
+            const Product& product = products[sortedOrder[i]];
+            written = fprintf(report, "%d. Vendor ID: %d, Name: %.50s, Price: %.2f, Quantity: %d, Season: %.20s\n", i + 1,
+                              product.vendorId, product.productName, product.price, product.quantity, product.season) > 0;
+        }
+        written = fclose(report) == 0 && written;
+    }
+    free(sortedOrder);
+    free(products);
+    return written;
+}
+
+/**
+ * @brief Writes the price comparison of every product name in a products file to a report file.
+ *
+ * Produces for all names at once what comparePricesByName() prints for one: the offers sorted by price
+ * (equal prices in file order), then the lowest, highest, average and median price. Names are listed in
+ * strcmp order. products.bin is read once, record by record; per record only the vendor ID, the price and
+ * the group number are kept.
+ *
+ * @param productFilePath The product file, normally "products.bin".
+ * @param reportPath The report file to create or overwrite.
+ * @return true on success, false if a file cannot be read or written or memory is exhausted.
+ */
+bool writePriceComparisonReport(const char* productFilePath, const char* reportPath) {
+    if (productFilePath == NULL || reportPath == NULL) {return false;}
+    FILE* productFile = fopen(productFilePath, "rb");
+    if (productFile == NULL) {return false;}
+
+    std::unordered_map<std::string, int> groupByName;
+    std::vector<std::string> groupNames;
+    std::vector<int> groupSizes;
+    std::vector<int> recordGroups;
+    std::vector<int> vendorIds;
+    std::vector<float> prices;
+    std::vector<PriceSortKey> keys;
+    std::vector<int> groupStarts;
+    try {
+        Product product;
+        while (fread(&product, sizeof(Product), 1, productFile) == 1) {
+            std::string name(product.productName, strnlen(product.productName, sizeof(product.productName)));
+            std::unordered_map<std::string, int>::iterator found = groupByName.find(name);
+            int group;
+            if (found == groupByName.end()) {
+                group = (int)groupNames.size();
+                groupByName[name] = group;
+                groupNames.push_back(name);
+                groupSizes.push_back(0);
+            }
+            else {
+                group = found->second;
+            }
+            groupSizes[group]++;
+            recordGroups.push_back(group);
+            vendorIds.push_back(product.vendorId);
+            prices.push_back(product.price);
+        }
+        fclose(productFile);
+        productFile = NULL;
+
+        // Counting sort of the records into contiguous groups, in file order within each group
+        groupStarts.assign(groupNames.size() + 1, 0);
+        for (size_t g = 0; g < groupNames.size(); g++) {groupStarts[g + 1] = groupStarts[g] + groupSizes[g];}
+        std::vector<int> next(groupStarts.begin(), groupStarts.end() - 1);
+        keys.resize(prices.size());
+        for (size_t i = 0; i < prices.size(); i++) {
+            PriceSortKey& key = keys[next[recordGroups[i]]++];
+            key.price = prices[i];
+            key.index = (int)i;
+        }
+    }
+    catch (const std::bad_alloc&) {
+        if (productFile != NULL) {fclose(productFile);}
+        return false;
+    }
+
+    std::vector<int> groupOrder(groupNames.size());
+    for (size_t g = 0; g < groupOrder.size(); g++) {groupOrder[g] = (int)g;}
+    std::sort(groupOrder.begin(), groupOrder.end(), [&](int a, int b) {return strcmp(groupNames[a].c_str(), groupNames[b].c_str()) < 0;});
+
+    FILE* report = fopen(reportPath, "w");
+    if (report == NULL) {return false;}
+    bool written = true;
+    for (size_t o = 0; written && o < groupOrder.size(); o++) {
+        int group = groupOrder[o];
+        PriceSortKey* offers = keys.data() + groupStarts[group];
+        int count = groupSizes[group];
+        radixSortPriceKeys(offers, count);
+
+        double sum = 0.0;
+        written = fprintf(report, "--- Price Comparison for Product Name '%s' (Sorted by Price) ---\n", groupNames[group].c_str()) > 0;
+        for (int i = 0; written && i < count; i++) {
+            written = fprintf(report, "Vendor ID: %d, Price: %.2f\n", vendorIds[offers[i].index], offers[i].price) > 0;
+            sum += offers[i].price;
+        }
+        double median = count % 2 == 1 ? offers[count / 2].price : ((double)offers[count / 2 - 1].price + offers[count / 2].price) / 2.0;
+        written = written && fprintf(report, "Lowest Price: %.2f\nHighest Price: %.2f\nAverage Price: %.2f\nMedian Price: %.2f\n\n",
+                                     offers[0].price, offers[count - 1].price, sum / count, median) > 0;
+    }
+    written = fclose(report) == 0 && written;
+    return written;
+}
@@ -0,0 +1,600 @@
+/**
+ * @file searchIndex.cpp
+ * @brief Inverted index file over product and vendor terms, with compressed posting lists.
+ *
+ * @details The file is a SearchIndexFileHeader, the sorted SearchIndexTerm dictionary, the posting area and the
+ * tail. A posting list stores its first record number and then the gap to each following one, every number in
+ * little-endian base-128 bytes whose high bit marks a continuation, so the gaps of a frequent term mostly take
+ * one byte. Exact lookups binary search the dictionary in the file; substring lookups read it once. Both also
+ * read the tail, which is short.
+ *
+ * Adding a record writes its terms after the last tail entry and then the header with the new counts, so a
+ * crash before the header is written leaves the old index. When the tail is full, the dictionary, the encoded
+ * lists and the tail are loaded into a map, which keeps the terms sorted, and a new file replaces the old one by
+ * rename. Appending a record only needs the last record number of a list, so the lists are copied without
+ * decoding them.
+ */
+
+#include "../header/atomicFile.h"
+#include "../header/searchIndex.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    /** @brief Encoded posting list of one term while the index is changed in memory. */
+    struct SearchPostings {
+        std::vector<uint8_t> bytes;
+        uint32_t count;
+        uint32_t lastRecord;
+
+        SearchPostings() : count(0), lastRecord(0) {}
+    };
+
+    /** @brief Terms by field and text; std::string orders like strcmp, so the map order is the dictionary order. */
+    typedef std::map<std::pair<int32_t, std::string>, SearchPostings> SearchTermMap;
+}
+
+/**
+ * @brief Appends one number in base-128 bytes and returns the number of bytes written (at most 5).
+ */
+static size_t encodePostingNumber(uint32_t value, uint8_t* foBytes) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        foBytes[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    foBytes[length++] = (uint8_t)value;
+    return length;
+}
+
+/**
+ * @brief Encodes an ascending list of record numbers.
+ *
+ * @param records Strictly ascending record numbers.
+ * @param count Number of records.
+ * @param foBytes Receives the encoding; needs room for 5 bytes per record.
+ * @return The number of bytes written.
+ */
+size_t encodePostingList(const uint32_t records[], int count, uint8_t* foBytes) {
+    size_t length = 0;
+    uint32_t previous = 0;
+    for (int i = 0; i < count; i++) {
+        length += encodePostingNumber(i == 0 ? records[i] : records[i] - previous, foBytes + length);
+        previous = records[i];
+    }
+    return length;
+}
+
+/**
+ * @brief Decodes a posting list.
+ *
+ * @param bytes The encoded list.
+ * @param byteCount Length of the encoding.
+ * @param foRecords Receives the record numbers.
+ * @param maxRecords Capacity of foRecords.
+ * @return The number of records, or -1 if the encoding is damaged or holds more than maxRecords records.
+ */
+int decodePostingList(const uint8_t* bytes, size_t byteCount, uint32_t* foRecords, int maxRecords) {
+    int count = 0;
+    uint32_t previous = 0;
+    size_t position = 0;
+    while (position < byteCount) {
+        uint32_t value = 0;
+        int shift = 0;
+        while (true) {
+            if (position >= byteCount || shift > 28) {return -1;}
+            uint8_t byte = bytes[position++];
+            value |= (uint32_t)(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {break;}
+            shift += 7;
+        }
+        if (count >= maxRecords) {return -1;}
+        previous = count == 0 ? value : previous + value;
+        foRecords[count++] = previous;
+    }
+    return count;
+}
+
+/**
+ * @brief Intersects two ascending posting lists.
+ *
+ * Every record of the shorter list is looked up in the longer one by binary search from the position of the
+ * previous hit, so the cost grows with the shorter list and only logarithmically with the longer one.
+ *
+ * @param first First ascending list.
+ * @param firstCount Length of first.
+ * @param second Second ascending list.
+ * @param secondCount Length of second.
+ * @param foRecords Receives the common records; needs room for the shorter list and may be either input.
+ * @return The number of common records.
+ */
+int intersectPostingLists(const uint32_t first[], int firstCount, const uint32_t second[], int secondCount, uint32_t* foRecords) {
+    const uint32_t* shorter = first;
+    int shorterCount = firstCount;
+    const uint32_t* longer = second;
+    int longerCount = secondCount;
+    if (secondCount < firstCount) {
+        shorter = second;
+        shorterCount = secondCount;
+        longer = first;
+        longerCount = firstCount;
+    }
+
+    int count = 0;
+    const uint32_t* position = longer;
+    const uint32_t* end = longer + longerCount;
+    for (int i = 0; i < shorterCount && position != end; i++) {
+        uint32_t record = shorter[i];
+        position = std::lower_bound(position, end, record);
+        if (position != end && *position == record) {foRecords[count++] = record;}
+    }
+    return count;
+}
+
+/**
+ * @brief Returns the number of fixed-size records in a file, 0 if it does not exist.
+ */
+static int32_t searchRecordCount(const char* path, size_t recordSize) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {return 0;}
+    long size = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+    fclose(file);
+    return size < 0 ? -1 : (int32_t)(size / (long)recordSize);
+}
+
+/**
+ * @brief Appends a record to the posting list of a term; empty terms are not indexed.
+ */
+static void addSearchTerm(SearchTermMap& terms, SearchField field, const char* text, size_t maxLength, uint32_t record) {
+    size_t length = strnlen(text, maxLength);
+    if (length == 0) {return;}
+    SearchPostings& postings = terms[std::make_pair((int32_t)field, std::string(text, length))];
+    if (postings.count > 0 && record <= postings.lastRecord) {return;}
+
+    uint8_t encoded[5];
+    size_t encodedLength = encodePostingNumber(postings.count == 0 ? record : record - postings.lastRecord, encoded);
+    postings.bytes.insert(postings.bytes.end(), encoded, encoded + encodedLength);
+    postings.count++;
+    postings.lastRecord = record;
+}
+
+/**
+ * @brief Adds the terms of a product record.
+ */
+static void addProductTerms(SearchTermMap& terms, const Product* product, uint32_t record) {
+    addSearchTerm(terms, SEARCH_FIELD_PRODUCT_NAME, product->productName, sizeof(product->productName), record);
+    addSearchTerm(terms, SEARCH_FIELD_SEASON, product->season, sizeof(product->season), record);
+}
+
+/**
+ * @brief Adds the terms of a vendor record.
+ */
+static void addVendorTerms(SearchTermMap& terms, const Vendor* vendor, uint32_t record) {
+    char id[16];
+    snprintf(id, sizeof(id), "%d", vendor->id);
+    addSearchTerm(terms, SEARCH_FIELD_VENDOR_NAME, vendor->name, sizeof(vendor->name), record);
+    addSearchTerm(terms, SEARCH_FIELD_VENDOR_ID, id, sizeof(id), record);
+}
+
+/**
+ * @brief An index and its file header and dictionary, passed to writeSearchIndexContents().
+ */
+struct SearchIndexFileContents {
+    const SearchIndexFileHeader* header;
+    const std::vector<SearchIndexTerm>* dictionary;
+    const SearchTermMap* terms;
+};
+
+/**
+ * @brief Writes the header, the dictionary and the posting area of an index file.
+ */
+static bool writeSearchIndexContents(FILE* file, const void* context) {
+    const SearchIndexFileContents* contents = (const SearchIndexFileContents*)context;
+    const std::vector<SearchIndexTerm>& dictionary = *contents->dictionary;
+    bool written = fwrite(contents->header, sizeof(SearchIndexFileHeader), 1, file) == 1 &&
+                   (dictionary.empty() || fwrite(&dictionary[0], sizeof(SearchIndexTerm), dictionary.size(), file) == dictionary.size());
+    for (SearchTermMap::const_iterator it = contents->terms->begin(); written && it != contents->terms->end(); ++it) {
+        written = it->second.bytes.empty() || fwrite(&it->second.bytes[0], 1, it->second.bytes.size(), file) == it->second.bytes.size();
+    }
+    return written;
+}
+
+/**
+ * @brief Writes an in-memory index over the index file, replacing it atomically.
+ */
+static bool writeSearchIndex(const char* indexPath, const SearchTermMap& terms, int32_t productCount, int32_t vendorCount) {
+    SearchIndexFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = SEARCH_INDEX_FILE_MAGIC;
+    header.version = SEARCH_INDEX_FILE_VERSION;
+    header.termCount = (int32_t)terms.size();
+    header.productCount = productCount;
+    header.vendorCount = vendorCount;
+
+    std::vector<SearchIndexTerm> dictionary;
+    dictionary.reserve(terms.size());
+    for (SearchTermMap::const_iterator it = terms.begin(); it != terms.end(); ++it) {
+        SearchIndexTerm entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.field = it->first.first;
+        strncpy(entry.term, it->first.second.c_str(), sizeof(entry.term) - 1);
+        entry.postingCount = it->second.count;
+        entry.postingOffset = header.postingBytes;
+        entry.postingBytes = (uint32_t)it->second.bytes.size();
+        entry.lastRecord = it->second.lastRecord;
+        dictionary.push_back(entry);
+        header.postingBytes += entry.postingBytes;
+    }
+
+    SearchIndexFileContents contents = {&header, &dictionary, &terms};
+    return replaceFileAtomically(indexPath, writeSearchIndexContents, &contents);
+}
+
+/**
+ * @brief Opens an index file and reads and checks its header.
+ *
+ * @param mode "rb" for queries, "r+b" for appending to the tail.
+ * @return The open file, or NULL if it is missing or not a search index.
+ */
+static FILE* openSearchIndexFile(const char* indexPath, const char* mode, SearchIndexFileHeader* foHeader) {
+    FILE* file = fopen(indexPath, mode);
+    if (file == NULL) {return NULL;}
+    if (fread(foHeader, sizeof(SearchIndexFileHeader), 1, file) != 1 || foHeader->magic != SEARCH_INDEX_FILE_MAGIC ||
+        foHeader->version != SEARCH_INDEX_FILE_VERSION || foHeader->termCount < 0 || foHeader->tailCount < 0) {
+        fclose(file);
+        return NULL;
+    }
+    return file;
+}
+
+/**
+ * @brief Reads the whole dictionary of an open index file.
+ */
+static bool readSearchDictionary(FILE* file, const SearchIndexFileHeader* header, std::vector<SearchIndexTerm>& foDictionary) {
+    foDictionary.resize((size_t)header->termCount);
+    if (header->termCount == 0) {return true;}
+    return fseek(file, (long)sizeof(SearchIndexFileHeader), SEEK_SET) == 0 &&
+           fread(&foDictionary[0], sizeof(SearchIndexTerm), foDictionary.size(), file) == foDictionary.size();
+}
+
+/**
+ * @brief Returns the offset of the first tail entry of an index file.
+ */
+static long searchTailOffset(const SearchIndexFileHeader* header) {
+    return (long)(sizeof(SearchIndexFileHeader) + (size_t)header->termCount * sizeof(SearchIndexTerm) + header->postingBytes);
+}
+
+/**
+ * @brief Reads the tail entries of an open index file.
+ */
+static bool readSearchTail(FILE* file, const SearchIndexFileHeader* header, std::vector<SearchIndexTailEntry>& foTail) {
+    foTail.resize((size_t)header->tailCount);
+    if (header->tailCount == 0) {return true;}
+    return fseek(file, searchTailOffset(header), SEEK_SET) == 0 &&
+           fread(&foTail[0], sizeof(SearchIndexTailEntry), foTail.size(), file) == foTail.size();
+}
+
+/**
+ * @brief Loads an index file, tail included, into a term map for changing it.
+ */
+static bool loadSearchIndex(const char* indexPath, SearchTermMap& foTerms, SearchIndexFileHeader* foHeader) {
+    FILE* file = openSearchIndexFile(indexPath, "rb", foHeader);
+    if (file == NULL) {return false;}
+    std::vector<SearchIndexTerm> dictionary;
+    std::vector<uint8_t> postings(foHeader->postingBytes);
+    std::vector<SearchIndexTailEntry> tail;
+    bool read = readSearchDictionary(file, foHeader, dictionary) &&
+                (postings.empty() || fread(&postings[0], 1, postings.size(), file) == postings.size()) &&
+                readSearchTail(file, foHeader, tail);
+    fclose(file);
+    if (!read) {return false;}
+
+    for (size_t i = 0; i < dictionary.size(); i++) {
+        const SearchIndexTerm& entry = dictionary[i];
+        if ((uint64_t)entry.postingOffset + entry.postingBytes > postings.size()) {return false;}
+        SearchPostings& target = foTerms[std::make_pair(entry.field, std::string(entry.term, strnlen(entry.term, sizeof(entry.term))))];
+        target.bytes.assign(postings.begin() + entry.postingOffset, postings.begin() + entry.postingOffset + entry.postingBytes);
+        target.count = entry.postingCount;
+        target.lastRecord = entry.lastRecord;
+    }
+    // The tail holds records added after every record of the lists, in the order they were added
+    for (size_t i = 0; i < tail.size(); i++) {
+        addSearchTerm(foTerms, (SearchField)tail[i].field, tail[i].term, sizeof(tail[i].term), tail[i].record);
+    }
+    return true;
+}
+
+/**
+ * @brief Builds the search index from the products and vendors files.
+ *
+ * @param indexPath Path of the index file to create or replace.
+ * @param productsPath Path of the products file; a missing file counts as empty.
+ * @param vendorsPath Path of the vendors file; a missing file counts as empty.
+ * @return true on success, false otherwise.
+ */
+bool buildSearchIndex(const char* indexPath, const char* productsPath, const char* vendorsPath) {
+    SearchTermMap terms;
+    uint32_t productCount = 0;
+    uint32_t vendorCount = 0;
+
+    FILE* file = fopen(productsPath, "rb");
+    if (file != NULL) {
+        Product product;
+        while (fread(&product, sizeof(Product), 1, file) == 1) {addProductTerms(terms, &product, productCount++);}
+        fclose(file);
+    }
+    file = fopen(vendorsPath, "rb");
+    if (file != NULL) {
+        Vendor vendor;
+        while (fread(&vendor, sizeof(Vendor), 1, file) == 1) {addVendorTerms(terms, &vendor, vendorCount++);}
+        fclose(file);
+    }
+    return writeSearchIndex(indexPath, terms, (int32_t)productCount, (int32_t)vendorCount);
+}
+
+/**
+ * @brief Makes sure a search index exists and covers every record, building it otherwise.
+ *
+ * An index whose record counts differ from the data files was left behind by a change that did not maintain
+ * it and is rebuilt.
+ *
+ * @param indexPath Path of the index file.
+ * @param productsPath Path of the products file.
+ * @param vendorsPath Path of the vendors file.
+ * @return true if the index can be queried, false otherwise.
+ */
+bool openSearchIndex(const char* indexPath, const char* productsPath, const char* vendorsPath) {
+    SearchIndexFileHeader header;
+    FILE* file = openSearchIndexFile(indexPath, "rb", &header);
+    if (file != NULL) {
+        fclose(file);
+        if (header.productCount == searchRecordCount(productsPath, sizeof(Product)) &&
+            header.vendorCount == searchRecordCount(vendorsPath, sizeof(Vendor))) {return true;}
+    }
+    return buildSearchIndex(indexPath, productsPath, vendorsPath);
+}
+
+/**
+ * @brief Binary searches the dictionary of an open index file for a term.
+ */
+static bool findSearchTerm(FILE* file, const SearchIndexFileHeader* header, int32_t field, const char* term, SearchIndexTerm* foEntry) {
+    int low = 0;
+    int high = header->termCount - 1;
+    while (low <= high) {
+        int middle = low + (high - low) / 2;
+        if (fseek(file, (long)(sizeof(SearchIndexFileHeader) + (size_t)middle * sizeof(SearchIndexTerm)), SEEK_SET) != 0 ||
+            fread(foEntry, sizeof(SearchIndexTerm), 1, file) != 1) {return false;}
+        int order = foEntry->field != field ? (foEntry->field < field ? -1 : 1) : strncmp(foEntry->term, term, sizeof(foEntry->term));
+        if (order == 0) {return true;}
+        if (order < 0) {low = middle + 1;}
+        else {high = middle - 1;}
+    }
+    return false;
+}
+
+/**
+ * @brief Reads and decodes the posting list of a dictionary entry and appends it to a list.
+ */
+static bool readSearchPostings(FILE* file, const SearchIndexFileHeader* header, const SearchIndexTerm& entry, std::vector<uint32_t>& records) {
+    if (entry.postingCount == 0) {return true;}
+    std::vector<uint8_t> bytes(entry.postingBytes);
+    long offset = (long)(sizeof(SearchIndexFileHeader) + (size_t)header->termCount * sizeof(SearchIndexTerm) + entry.postingOffset);
+    if (bytes.empty() || fseek(file, offset, SEEK_SET) != 0 || fread(&bytes[0], 1, bytes.size(), file) != bytes.size()) {return false;}
+
+    size_t start = records.size();
+    records.resize(start + entry.postingCount);
+    int count = decodePostingList(&bytes[0], bytes.size(), &records[start], (int)entry.postingCount);
+    if (count != (int)entry.postingCount) {return false;}
+    return true;
+}
+
+/**
+ * @brief Finds the records matching a query of one or more terms.
+ *
+ * Each query term selects the index terms of the given fields that equal or contain it; the records of a query
+ * term are the union of their posting lists and of the tail entries of those terms. The results of the query terms are then intersected, starting
+ * with the shortest, or united. All fields of one query must post the same kind of record.
+ *
+ * @param indexPath Path of the index file.
+ * @param fields Fields to search.
+ * @param fieldCount Number of fields.
+ * @param terms Query terms.
+ * @param termCount Number of query terms.
+ * @param match Whether index terms must equal or only contain a query term.
+ * @param matchAll true if a record must match every query term, false if any suffices.
+ * @param foRecords Receives an ascending malloc'ed array of record numbers, or NULL if there are none.
+ * @return The number of records, or -1 if the index cannot be read.
+ */
+int querySearchIndex(const char* indexPath, const SearchField fields[], int fieldCount, const char* const terms[], int termCount,
+                     SearchTermMatch match, bool matchAll, uint32_t** foRecords) {
+    *foRecords = NULL;
+    SearchIndexFileHeader header;
+    FILE* file = openSearchIndexFile(indexPath, "rb", &header);
+    if (file == NULL) {return -1;}
+
+    std::vector<SearchIndexTerm> dictionary;
+    std::vector<SearchIndexTailEntry> tail;
+    if ((match == SEARCH_TERM_SUBSTRING && !readSearchDictionary(file, &header, dictionary)) || !readSearchTail(file, &header, tail)) {
+        fclose(file);
+        return -1;
+    }
+
+    std::vector<std::vector<uint32_t> > termRecords((size_t)(termCount > 0 ? termCount : 0));
+    bool read = true;
+    for (int t = 0; read && t < termCount; t++) {
+        int listCount = 0;
+        for (int f = 0; read && f < fieldCount; f++) {
+            for (size_t e = 0; e < tail.size(); e++) {
+                if (tail[e].field == fields[f] && (match == SEARCH_TERM_EXACT ? strncmp(tail[e].term, terms[t], sizeof(tail[e].term)) == 0
+                                                                                : strstr(tail[e].term, terms[t]) != NULL)) {
+                    termRecords[t].push_back(tail[e].record);
+                    listCount++;
+                }
+            }
+            SearchIndexTerm entry;
+            if (match == SEARCH_TERM_EXACT) {
+                if (findSearchTerm(file, &header, fields[f], terms[t], &entry)) {
+                    read = readSearchPostings(file, &header, entry, termRecords[t]);
+                    listCount++;
+                }
+                continue;
+            }
+            for (size_t d = 0; read && d < dictionary.size(); d++) {
+                if (dictionary[d].field == fields[f] && strstr(dictionary[d].term, terms[t]) != NULL) {
+                    read = readSearchPostings(file, &header, dictionary[d], termRecords[t]);
+                    listCount++;
+                }
+            }
+        }
+        if (listCount > 1) {
+            std::vector<uint32_t>& records = termRecords[t];
+            std::sort(records.begin(), records.end());
+            records.erase(std::unique(records.begin(), records.end()), records.end());
+        }
+    }
+    fclose(file);
+    if (!read) {return -1;}
+
+    std::vector<uint32_t> result;
+    if (termCount > 0) {
+        if (matchAll) {
+            // Intersect from the shortest list, so every step costs at most the size of the current result
+            std::vector<size_t> order;
+            for (int t = 0; t < termCount; t++) {order.push_back((size_t)t);}
+            std::sort(order.begin(), order.end(), [&termRecords](size_t fiLeft, size_t fiRight) {return termRecords[fiLeft].size() < termRecords[fiRight].size();});
+            result = termRecords[order[0]];
+            for (size_t i = 1; i < order.size() && !result.empty(); i++) {
+                const std::vector<uint32_t>& next = termRecords[order[i]];
+                int count = next.empty() ? 0 : intersectPostingLists(&result[0], (int)result.size(), &next[0], (int)next.size(), &result[0]);
+                result.resize((size_t)count);
+            }
+        }
+        else {
+            for (int t = 0; t < termCount; t++) {result.insert(result.end(), termRecords[t].begin(), termRecords[t].end());}
+            std::sort(result.begin(), result.end());
+            result.erase(std::unique(result.begin(), result.end()), result.end());
+        }
+    }
+
+    if (result.empty()) {return 0;}
+    *foRecords = (uint32_t*)malloc(result.size() * sizeof(uint32_t));
+    if (*foRecords == NULL) {return -1;}
+    memcpy(*foRecords, &result[0], result.size() * sizeof(uint32_t));
+    return (int)result.size();
+}
+
+/**
+ * @brief Appends the terms of a record to the tail of an open index and writes its new header.
+ *
+ * @param file The index, opened for update; it is closed.
+ * @param header The header read from the file, with the record counts already including the record.
+ * @param recordTerms The terms of the record.
+ * @param record The record number.
+ * @return true if the record was appended, false if the tail is full or writing failed.
+ */
+static bool appendSearchTail(FILE* file, SearchIndexFileHeader* header, const SearchTermMap& recordTerms, uint32_t record) {
+    bool appended = header->tailCount + (int32_t)recordTerms.size() <= SEARCH_INDEX_TAIL_LIMIT &&
+                    fseek(file, searchTailOffset(header) + (long)((size_t)header->tailCount * sizeof(SearchIndexTailEntry)), SEEK_SET) == 0;
+    for (SearchTermMap::const_iterator it = recordTerms.begin(); appended && it != recordTerms.end(); ++it) {
+        SearchIndexTailEntry entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.field = it->first.first;
+        strncpy(entry.term, it->first.second.c_str(), sizeof(entry.term) - 1);
+        entry.record = record;
+        appended = fwrite(&entry, sizeof(entry), 1, file) == 1;
+    }
+    // The entries are in place before the header counts them
+    header->tailCount += (int32_t)recordTerms.size();
+    appended = appended && fflush(file) == 0 && fseek(file, 0, SEEK_SET) == 0 &&
+               fwrite(header, sizeof(SearchIndexFileHeader), 1, file) == 1;
+    return fclose(file) == 0 && appended;
+}
+
+/**
+ * @brief Adds the product appended last to the products file to the index, if the index exists.
+ *
+ * The product's terms go to the tail; a full tail is merged into the posting lists first.
+ *
+ * @param indexPath Path of the index file.
+ * @param productsPath Path of the products file, which already holds the product as its last record.
+ * @param vendorsPath Path of the vendors file, for rebuilding an index that is out of date.
+ * @param product The appended product.
+ * @return true on success or if there is no index, false otherwise.
+ */
+bool addProductToSearchIndex(const char* indexPath, const char* productsPath, const char* vendorsPath, const Product* product) {
+    SearchTermMap terms;
+    SearchIndexFileHeader header;
+    FILE* file = fopen(indexPath, "rb");
+    if (file == NULL) {return true;}
+    fclose(file);
+
+    int32_t record = searchRecordCount(productsPath, sizeof(Product)) - 1;
+    file = openSearchIndexFile(indexPath, "r+b", &header);
+    if (record < 0 || file == NULL || header.productCount != record) {
+        if (file != NULL) {fclose(file);}
+        return buildSearchIndex(indexPath, productsPath, vendorsPath);
+    }
+    addProductTerms(terms, product, (uint32_t)record);
+    header.productCount++;
+    if (appendSearchTail(file, &header, terms, (uint32_t)record)) {return true;}
+
+    terms.clear();
+    if (!loadSearchIndex(indexPath, terms, &header)) {return buildSearchIndex(indexPath, productsPath, vendorsPath);}
+    addProductTerms(terms, product, (uint32_t)record);
+    return writeSearchIndex(indexPath, terms, (int32_t)record + 1, header.vendorCount);
+}
+
+/**
+ * @brief Adds the vendor appended last to the vendors file to the index, if the index exists.
+ *
+ * The vendor's terms go to the tail; a full tail is merged into the posting lists first.
+ *
+ * @param indexPath Path of the index file.
+ * @param productsPath Path of the products file, for rebuilding an index that is out of date.
+ * @param vendorsPath Path of the vendors file, which already holds the vendor as its last record.
+ * @param vendor The appended vendor.
+ * @return true on success or if there is no index, false otherwise.
+ */
+bool addVendorToSearchIndex(const char* indexPath, const char* productsPath, const char* vendorsPath, const Vendor* vendor) {
+    SearchTermMap terms;
+    SearchIndexFileHeader header;
+    FILE* file = fopen(indexPath, "rb");
+    if (file == NULL) {return true;}
+    fclose(file);
+
+    int32_t record = searchRecordCount(vendorsPath, sizeof(Vendor)) - 1;
+    file = openSearchIndexFile(indexPath, "r+b", &header);
+    if (record < 0 || file == NULL || header.vendorCount != record) {
+        if (file != NULL) {fclose(file);}
+        return buildSearchIndex(indexPath, productsPath, vendorsPath);
+    }
+    addVendorTerms(terms, vendor, (uint32_t)record);
+    header.vendorCount++;
+    if (appendSearchTail(file, &header, terms, (uint32_t)record)) {return true;}
+
+    terms.clear();
+    if (!loadSearchIndex(indexPath, terms, &header)) {return buildSearchIndex(indexPath, productsPath, vendorsPath);}
+    addVendorTerms(terms, vendor, (uint32_t)record);
+    return writeSearchIndex(indexPath, terms, header.productCount, (int32_t)record + 1);
+}
+
+/**
+ * @brief Rebuilds the index after a data file was rewritten, if the index exists.
+ *
+ * @param indexPath Path of the index file.
+ * @param productsPath Path of the products file.
+ * @param vendorsPath Path of the vendors file.
+ * @return true on success or if there is no index, false otherwise.
+ */
+bool refreshSearchIndex(const char* indexPath, const char* productsPath, const char* vendorsPath) {
+    FILE* file = fopen(indexPath, "rb");
+    if (file == NULL) {return true;}
+    fclose(file);
+    return buildSearchIndex(indexPath, productsPath, vendorsPath);
+}
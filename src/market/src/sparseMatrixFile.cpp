@@ -0,0 +1,226 @@
+/**
+ * @file sparseMatrixFile.cpp
+ * @brief Binary file format for compressed sparse matrices, read through a memory mapping.
+ *
+ * @details The file is a SparseMatrixFileHeader followed by the four arrays of a CompressedSparseMatrix, each
+ * starting at a SPARSE_MATRIX_FILE_ALIGNMENT boundary. Opening a file maps it read-only and points the matrix
+ * arrays into the mapping after checking the header, so the cost does not depend on the matrix size; pages
+ * are read by the OS when a row is first touched. Files are written to a temporary file that replaces the old
+ * one by rename, so readers see either the old or the new matrix, never a partial one.
+ */
+
+#include "../header/atomicFile.h"
+#include "../header/compressedSparseMatrix.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Rounds an offset up to the section alignment.
+ */
+static int64_t alignSectionOffset(int64_t offset) {
+    return (offset + SPARSE_MATRIX_FILE_ALIGNMENT - 1) / SPARSE_MATRIX_FILE_ALIGNMENT * SPARSE_MATRIX_FILE_ALIGNMENT;
+}
+
+/**
+ * @brief Fills in the section offsets and file size for the given dimensions.
+ */
+static void layoutSparseMatrixFile(SparseMatrixFileHeader* header) {
+    header->rowIdsOffset = alignSectionOffset((int64_t)sizeof(SparseMatrixFileHeader));
+    header->rowPointersOffset = alignSectionOffset(header->rowIdsOffset + (int64_t)header->rowCount * (int64_t)sizeof(int32_t));
+    header->minorIdsOffset = alignSectionOffset(header->rowPointersOffset + ((int64_t)header->rowCount + 1) * (int64_t)sizeof(int32_t));
+    header->pricesOffset = alignSectionOffset(header->minorIdsOffset + (int64_t)header->entryCount * (int64_t)sizeof(int32_t));
+    header->fileSize = header->pricesOffset + (int64_t)header->entryCount * (int64_t)sizeof(float);
+}
+
+/**
+ * @brief Writes a section at its offset, zero filling the alignment gap before it.
+ */
+static bool writeSection(FILE* file, int64_t* position, int64_t offset, const void* data, size_t bytes) {
+    static const char padding[SPARSE_MATRIX_FILE_ALIGNMENT] = {0};
+    size_t gap = (size_t)(offset - *position);
+    if (gap > 0 && fwrite(padding, 1, gap, file) != gap) {return false;}
+    if (bytes > 0 && fwrite(data, 1, bytes, file) != bytes) {return false;}
+    *position = offset + (int64_t)bytes;
+    return true;
+}
+
+/**
+ * @brief A matrix and its file header, passed to writeSparseMatrixSections().
+ */
+typedef struct {
+    const SparseMatrixFileHeader* header;
+    const CompressedSparseMatrix* matrix;
+    const int32_t* rowPointers;
+} SparseMatrixFileContents;
+
+/**
+ * @brief Writes the header and the sections of a matrix file.
+ */
+static bool writeSparseMatrixSections(FILE* file, const void* context) {
+    const SparseMatrixFileContents* contents = (const SparseMatrixFileContents*)context;
+    const SparseMatrixFileHeader* header = contents->header;
+    const CompressedSparseMatrix* matrix = contents->matrix;
+    int64_t position = 0;
+    return writeSection(file, &position, 0, header, sizeof(*header)) &&
+           writeSection(file, &position, header->rowIdsOffset, matrix->rowIds, (size_t)header->rowCount * sizeof(int32_t)) &&
+           writeSection(file, &position, header->rowPointersOffset, contents->rowPointers, ((size_t)header->rowCount + 1) * sizeof(int32_t)) &&
+           writeSection(file, &position, header->minorIdsOffset, matrix->minorIds, (size_t)header->entryCount * sizeof(int32_t)) &&
+           writeSection(file, &position, header->pricesOffset, matrix->prices, (size_t)header->entryCount * sizeof(float));
+}
+
+/**
+ * @brief Saves a compressed matrix to a file, replacing it atomically.
+ *
+ * @param matrix The matrix to save.
+ * @param path Destination file.
+ * @return true on success, false on I/O errors (path is left unchanged).
+ */
+bool writeCompressedSparseMatrixFile(const CompressedSparseMatrix* matrix, const char* path) {
+    if (matrix == NULL || path == NULL) {return false;}
+
+    SparseMatrixFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = SPARSE_MATRIX_FILE_MAGIC;
+    header.version = SPARSE_MATRIX_FILE_VERSION;
+    header.axis = (int32_t)matrix->axis;
+    header.rowCount = matrix->rowCount;
+    header.entryCount = matrix->entryCount;
+    layoutSparseMatrixFile(&header);
+
+    // An empty matrix has no row pointer array; its single row pointer is 0
+    static const int32_t emptyRowPointers[1] = {0};
+    SparseMatrixFileContents contents = {&header, matrix, matrix->rowPointers != NULL ? matrix->rowPointers : emptyRowPointers};
+    return replaceFileAtomically(path, writeSparseMatrixSections, &contents);
+}
+
+/**
+ * @brief Checks that a mapped header describes a well-formed file of the mapped size.
+ */
+static bool validSparseMatrixHeader(const SparseMatrixFileHeader* header, size_t size) {
+    if (header->magic != SPARSE_MATRIX_FILE_MAGIC || header->version != SPARSE_MATRIX_FILE_VERSION) {return false;}
+    if (header->axis != SPARSE_BY_VENDOR && header->axis != SPARSE_BY_PRODUCT) {return false;}
+    if (header->rowCount < 0 || header->entryCount < 0) {return false;}
+
+    SparseMatrixFileHeader expected = *header;
+    layoutSparseMatrixFile(&expected);
+    return expected.rowIdsOffset == header->rowIdsOffset && expected.rowPointersOffset == header->rowPointersOffset &&
+           expected.minorIdsOffset == header->minorIdsOffset && expected.pricesOffset == header->pricesOffset &&
+           expected.fileSize == header->fileSize && header->fileSize == (int64_t)size;
+}
+
+/**
+ * @brief Maps a compressed matrix file read-only and points a matrix view at its sections.
+ *
+ * Only the header is validated, so opening takes constant time; the sections are trusted as written by
+ * writeCompressedSparseMatrixFile().
+ *
+ * @param path The file.
+ * @param foMapped Receives the mapping; release it with unmapCompressedSparseMatrixFile().
+ * @return true on success, false if the file is missing, cannot be mapped or is not a matrix file.
+ */
+bool mapCompressedSparseMatrixFile(const char* path, MappedSparseMatrix* foMapped) {
+    if (path == NULL || foMapped == NULL) {return false;}
+    memset(foMapped, 0, sizeof(MappedSparseMatrix));
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {return false;}
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(SparseMatrixFileHeader)) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    void* address = mapping != NULL ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (address == NULL) {
+        if (mapping != NULL) {CloseHandle(mapping);}
+        CloseHandle(file);
+        return false;
+    }
+    foMapped->fileHandle = file;
+    foMapped->mappingHandle = mapping;
+    size_t size = (size_t)fileSize.QuadPart;
+#else
+    int descriptor = open(path, O_RDONLY);
+    if (descriptor < 0) {return false;}
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || status.st_size < (off_t)sizeof(SparseMatrixFileHeader)) {
+        close(descriptor);
+        return false;
+    }
+    size_t size = (size_t)status.st_size;
+    void* address = mmap(NULL, size, PROT_READ, MAP_SHARED, descriptor, 0);
+    // The mapping keeps the file contents reachable after the descriptor is closed
+    close(descriptor);
+    if (address == MAP_FAILED) {return false;}
+#endif
+
+    foMapped->address = address;
+    foMapped->size = size;
+
+    const SparseMatrixFileHeader* header = (const SparseMatrixFileHeader*)address;
+    if (!validSparseMatrixHeader(header, size)) {
+        unmapCompressedSparseMatrixFile(foMapped);
+        return false;
+    }
+
+    char* base = (char*)address;
+    foMapped->matrix.axis = (SparseMatrixAxis)header->axis;
+    foMapped->matrix.rowCount = header->rowCount;
+    foMapped->matrix.entryCount = header->entryCount;
+    foMapped->matrix.rowIds = (int*)(base + header->rowIdsOffset);
+    foMapped->matrix.rowPointers = (int*)(base + header->rowPointersOffset);
+    foMapped->matrix.minorIds = (int*)(base + header->minorIdsOffset);
+    foMapped->matrix.prices = (float*)(base + header->pricesOffset);
+    return true;
+}
+
+/**
+ * @brief Releases a mapping created by mapCompressedSparseMatrixFile() and leaves it empty.
+ *
+ * @param mapped The mapping; NULL or an empty mapping is ignored.
+ */
+void unmapCompressedSparseMatrixFile(MappedSparseMatrix* mapped) {
+    if (mapped == NULL || mapped->address == NULL) {return;}
+#ifdef _WIN32
+    UnmapViewOfFile(mapped->address);
+    CloseHandle((HANDLE)mapped->mappingHandle);
+    CloseHandle((HANDLE)mapped->fileHandle);
+#else
+    munmap(mapped->address, mapped->size);
+#endif
+    memset(mapped, 0, sizeof(MappedSparseMatrix));
+}
+
+/**
+ * @brief Appends every entry of a compressed matrix to a builder as (vendor, product, price) triplets.
+ *
+ * Used to turn a loaded matrix back into editable relations, or to build the other axis from it.
+ *
+ * @param matrix The matrix.
+ * @param builder The builder.
+ * @return true on success, false if the builder cannot grow.
+ */
+bool appendCompressedSparseMatrixToBuilder(const CompressedSparseMatrix* matrix, SparseMatrixBuilder* builder) {
+    if (matrix == NULL || builder == NULL) {return false;}
+    if (!sparseMatrixBuilderReserve(builder, builder->entryCount + matrix->entryCount)) {return false;}
+    for (int row = 0; row < matrix->rowCount; row++) {
+        for (int i = matrix->rowPointers[row]; i < matrix->rowPointers[row + 1]; i++) {
+            int vendorId = matrix->axis == SPARSE_BY_VENDOR ? matrix->rowIds[row] : matrix->minorIds[i];
+            int productId = matrix->axis == SPARSE_BY_VENDOR ? matrix->minorIds[i] : matrix->rowIds[row];
+            if (!sparseMatrixBuilderAdd(builder, vendorId, productId, matrix->prices[i])) {return false;}
+        }
+    }
+    return true;
+}
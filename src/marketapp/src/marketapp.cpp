@@ -32,24 +32,29 @@
 /**
  * @brief Main function of the application which serves as the entry point of the program.
  *
- * The main function calls the userAuthentication to handle user login, and populates the system
- * with predefined vendor-product relationships. This serves as a setup example for managing market operations.
+ * The main function opens the product index, loads the vendor-product relationships from their file (creating
+ * it from predefined relationships on the first run) and then calls userAuthentication, which runs the menus
+ * until the user exits. This serves as a setup example for managing market operations.
  *
  * @return int Returns 0 to indicate successful execution of the program.
  */
 int main() {
-    // Authenticate the user before proceeding.
-    userAuthentication();
+    // Product lookups go through products.idx; opening it builds it, or rebuilds it if products.bin changed.
+    closePagedBPlusTree(openProductIndex(PRODUCT_INDEX_FILE, "products.bin", 0));
 
-    // Adding relationships between vendors and products with specified vendor IDs, product IDs, and prices.
-    addVendorProductRelation(1, 101, 10.5);    // Adds a relationship for vendor 1 with product 101 priced at $10.5.
-    addVendorProductRelation(1, 102, 20.0);    // Adds a relationship for vendor 1 with product 102 priced at $20.0.
-    addVendorProductRelation(2, 101, 11.0);    // Adds a relationship for vendor 2 with product 101 priced at $11.0.
-    addVendorProductRelation(3, 103, 15.0);     // Adds a relationship for vendor 3 with product 103 priced at $15.0.
+    // Vendor-product relations are kept in a memory-mapped file; the first run seeds it with sample relations.
+    // Relations added later are written through to the file.
+    if (!loadVendorProductRelations(VENDOR_PRODUCT_RELATIONS_FILE)) {
+        addVendorProductRelation(1, 101, 10.5);    // Adds a relationship for vendor 1 with product 101 priced at $10.5.
+        addVendorProductRelation(1, 102, 20.0);    // Adds a relationship for vendor 1 with product 102 priced at $20.0.
+        addVendorProductRelation(2, 101, 11.0);    // Adds a relationship for vendor 2 with product 101 priced at $11.0.
+        addVendorProductRelation(3, 103, 15.0);    // Adds a relationship for vendor 3 with product 103 priced at $15.0.
+        saveVendorProductRelations(VENDOR_PRODUCT_RELATIONS_FILE);
+    }
 
+    // Authenticate the user before proceeding; the menus run until the user exits.
+    userAuthentication();
 
-    
-   
     // Return 0 to indicate successful completion of the program.
     return 0;
 }
\ No newline at end of file
@@ -7,8 +7,21 @@
  * inputs and verify the expected results of the functions.
  */
 #include "gtest/gtest.h"
+#include "../../utility/header/cpuFeatures.h"
 #include "../../market/header/market.h"
 #include "../../market/src/market.cpp"
+#include "../../market/header/searchIndex.h"
+#include "../../market/header/keywordSearch.h"
+#include "../../market/header/productPriceSummary.h"
+#include "../../market/header/productSort.h"
+#include "../../market/header/compressedSparseMatrix.h"
+#include "../../market/header/prefixBPlusTree.h"
+#include "../../market/header/concurrentBPlusTree.h"
+#include "../../market/header/pagedBPlusTree.h"
+#include "../../market/header/marketIndex.h"
+#include "../../market/header/bPlusTree.h"
+#include "../../market/header/linearHash.h"
+#include "../../market/header/extendibleHash.h"
 
  // Global test dosyaları
 const char* userFile = "test_users.bin";
@@ -34,6 +47,10 @@ class MarketTest : public ::testing::Test {
 protected:
     const char* inputTest = "inputTest.txt";
     const char* outputTest = "outputTest.txt";
+    bool productsFileReplaced = false;   ///< writeProductsFile() moved products.bin aside.
+    bool productsFileSaved = false;      ///< products.bin existed and was renamed to products.bin.bak.
+    bool vendorsFileReplaced = false;    ///< writeVendorsFile() moved vendor.bin aside.
+    bool vendorsFileSaved = false;       ///< vendor.bin existed and was renamed to vendor.bin.bak.
 
 
     /**
@@ -51,6 +68,50 @@ protected:
     void TearDown() override {
         remove(inputTest);
         remove(outputTest);
+        // The search functions build the index as they go; tests rewrite the data files behind its back
+        remove(SEARCH_INDEX_FILE);
+        remove(PRODUCT_INDEX_FILE);
+        // Put back the data files a test replaced, also when an assertion ended the test early
+        if (productsFileReplaced) {
+            remove("products.bin");
+            if (productsFileSaved) {rename("products.bin.bak", "products.bin");}
+        }
+        if (vendorsFileReplaced) {
+            remove("vendor.bin");
+            if (vendorsFileSaved) {rename("vendor.bin.bak", "vendor.bin");}
+        }
+    }
+
+    /**
+     * @brief Replaces products.bin with the given products for the rest of the test; TearDown() restores it.
+     * @param products The product records.
+     * @param count Number of records.
+     */
+    void writeProductsFile(const Product* products, int count) {
+        if (!productsFileReplaced) {
+            productsFileSaved = rename("products.bin", "products.bin.bak") == 0;
+            productsFileReplaced = true;
+        }
+        FILE* file = fopen("products.bin", "wb");
+        ASSERT_NE(file, nullptr);
+        fwrite(products, sizeof(Product), (size_t)count, file);
+        fclose(file);
+    }
+
+    /**
+     * @brief Replaces vendor.bin with the given vendors for the rest of the test; TearDown() restores it.
+     * @param vendors The vendor records.
+     * @param count Number of records.
+     */
+    void writeVendorsFile(const Vendor* vendors, int count) {
+        if (!vendorsFileReplaced) {
+            vendorsFileSaved = rename("vendor.bin", "vendor.bin.bak") == 0;
+            vendorsFileReplaced = true;
+        }
+        FILE* file = fopen("vendor.bin", "wb");
+        ASSERT_NE(file, nullptr);
+        fwrite(vendors, sizeof(Vendor), (size_t)count, file);
+        fclose(file);
     }
 
     /**
@@ -483,7 +544,7 @@ TEST_F(MarketTest, listingOfLocalVendorsTEST5) {
  */
 TEST_F(MarketTest, listingOfLocalVendorsInvalidTEST) {
     // Simulate invalid and then valid exit inputs
-    simulateUserInput("5\n0\n0\n0\n0\n");
+    simulateUserInput("7\n0\n0\n0\n0\n");
 
     // Execute the listing function
     bool result = listingOfLocalVendors();
@@ -713,7 +774,7 @@ TEST_F(MarketTest, ListingOfLocalProductsTEST5) {
  */
 TEST_F(MarketTest, ListingOfLocalProductsInvalidTEST) {
     // Simulate invalid and then valid exit inputs
-    simulateUserInput("5\n0\n0\n4\n");
+    simulateUserInput("6\n0\n0\n4\n");
 
     // Execute the listing function
     bool result = listingOfLocalProducts();
@@ -1786,6 +1847,7 @@ TEST_F(MarketTest, listProductsByVendorTEST) {
     testing::internal::CaptureStdout();
 
     bool result = listProductsByVendor(testVendorId);
+    testing::internal::GetCapturedStdout();
 
     EXPECT_TRUE(result);
 
@@ -2366,6 +2428,2661 @@ TEST_F(MarketTest, TraverseXORListGroupedByIDTest) {
 }
 
 
+/**
+ * @brief Removes an extendible hash file and its directory sidecar.
+ *
+ * @param path Path of the bucket page file.
+ */
+static void removeExtendibleHashFiles(const char* path) {
+    char directoryPath[300];
+    snprintf(directoryPath, sizeof(directoryPath), "%s.dir", path);
+    remove(path);
+    remove(directoryPath);
+}
+
+/**
+ * @test ExtendibleHashInsertFindTest
+ * @brief Tests point lookups and per-vendor scans after many bucket splits.
+ *
+ * Inserts four products for each of 500 vendors, which forces several splits and directory doublings,
+ * then verifies that every vendor is found with all of its products and that each lookup costs at most
+ * two page reads.
+ */
+TEST_F(MarketTest, ExtendibleHashInsertFindTest) {
+    const char* hashPath = "test_vendor_hash.bin";
+    removeExtendibleHashFiles(hashPath);
+    ExtendibleHashFile* hashFile = openExtendibleHashFile(hashPath);
+    ASSERT_NE(hashFile, nullptr);
+
+    for (int vendorId = 1; vendorId <= 500; vendorId++) {
+        for (int i = 0; i < 4; i++) {
+            Product product = { vendorId, "", 1.5f * i, i, "Summer" };
+            snprintf(product.productName, sizeof(product.productName), "Product%d", i);
+            ASSERT_TRUE(extendibleHashInsert(hashFile, &product));
+        }
+    }
+
+    EXPECT_GT(hashFile->globalDepth, 0);
+
+    Product products[8];
+    for (int vendorId = 1; vendorId <= 500; vendorId++) {
+        long readsBefore = hashFile->pageReads;
+        EXPECT_EQ(extendibleHashScanVendor(hashFile, vendorId, products, 8), 4);
+        EXPECT_LE(hashFile->pageReads - readsBefore, 2);
+        EXPECT_EQ(products[0].vendorId, vendorId);
+    }
+
+    Product found;
+    EXPECT_TRUE(extendibleHashFind(hashFile, 250, &found));
+    EXPECT_EQ(found.vendorId, 250);
+    EXPECT_FALSE(extendibleHashFind(hashFile, 501, &found));
+
+    EXPECT_TRUE(closeExtendibleHashFile(hashFile));
+    removeExtendibleHashFiles(hashPath);
+}
+
+/**
+ * @test ExtendibleHashOverflowChainTest
+ * @brief Tests that a vendor larger than one bucket page is kept in an overflow chain.
+ *
+ * A single vendor cannot be separated by splitting, so its products must be chained and a
+ * per-vendor scan must still return every one of them.
+ */
+TEST_F(MarketTest, ExtendibleHashOverflowChainTest) {
+    const char* hashPath = "test_vendor_hash_chain.bin";
+    removeExtendibleHashFiles(hashPath);
+    ExtendibleHashFile* hashFile = openExtendibleHashFile(hashPath);
+    ASSERT_NE(hashFile, nullptr);
+
+    int productCount = (int)HASH_BUCKET_CAPACITY + 10;
+    for (int i = 0; i < productCount; i++) {
+        Product product = { 42, "", 2.0f, i, "Winter" };
+        snprintf(product.productName, sizeof(product.productName), "Item%d", i);
+        ASSERT_TRUE(extendibleHashInsert(hashFile, &product));
+    }
+    Product other = { 7, "Apple", 3.0f, 1, "Fall" };
+    ASSERT_TRUE(extendibleHashInsert(hashFile, &other));
+
+    long readsBefore = hashFile->pageReads;
+    EXPECT_EQ(extendibleHashScanVendor(hashFile, 42, NULL, 0), productCount);
+    EXPECT_EQ(hashFile->pageReads - readsBefore, 2);
+    EXPECT_TRUE(extendibleHashFind(hashFile, 7, NULL));
+
+    EXPECT_TRUE(closeExtendibleHashFile(hashFile));
+    removeExtendibleHashFiles(hashPath);
+}
+
+/**
+ * @test ExtendibleHashPersistenceTest
+ * @brief Tests that the hash file survives a close/reopen cycle and supports removal.
+ */
+TEST_F(MarketTest, ExtendibleHashPersistenceTest) {
+    const char* hashPath = "test_vendor_hash_persist.bin";
+    removeExtendibleHashFiles(hashPath);
+    ExtendibleHashFile* hashFile = openExtendibleHashFile(hashPath);
+    ASSERT_NE(hashFile, nullptr);
+
+    for (int vendorId = 1; vendorId <= 200; vendorId++) {
+        Product product = { vendorId, "Tomato", 5.0f, 10, "Summer" };
+        ASSERT_TRUE(extendibleHashInsert(hashFile, &product));
+    }
+    int32_t depth = hashFile->globalDepth;
+    ASSERT_TRUE(closeExtendibleHashFile(hashFile));
+
+    hashFile = openExtendibleHashFile(hashPath);
+    ASSERT_NE(hashFile, nullptr);
+    EXPECT_EQ(hashFile->globalDepth, depth);
+    for (int vendorId = 1; vendorId <= 200; vendorId++) {
+        EXPECT_TRUE(extendibleHashFind(hashFile, vendorId, NULL));
+    }
+
+    EXPECT_TRUE(extendibleHashRemove(hashFile, 100, "Tomato"));
+    EXPECT_FALSE(extendibleHashRemove(hashFile, 100, "Tomato"));
+    EXPECT_FALSE(extendibleHashFind(hashFile, 100, NULL));
+    EXPECT_TRUE(extendibleHashFind(hashFile, 101, NULL));
+
+    EXPECT_TRUE(closeExtendibleHashFile(hashFile));
+    removeExtendibleHashFiles(hashPath);
+}
+
+/**
+ * @test BuildExtendibleHashFromProductsTest
+ * @brief Tests loading a binary products file into the hash file.
+ */
+TEST_F(MarketTest, BuildExtendibleHashFromProductsTest) {
+    const char* hashPath = "test_vendor_hash_build.bin";
+    removeExtendibleHashFiles(hashPath);
+    createTestProductFile();
+
+    ExtendibleHashFile* hashFile = openExtendibleHashFile(hashPath);
+    ASSERT_NE(hashFile, nullptr);
+    EXPECT_EQ(buildExtendibleHashFromProducts(hashFile, productFile), 2);
+
+    Product found;
+    EXPECT_TRUE(extendibleHashFind(hashFile, 2, &found));
+    EXPECT_STREQ(found.productName, "Apple");
+    EXPECT_EQ(buildExtendibleHashFromProducts(hashFile, "missing_products.bin"), -1);
+
+    EXPECT_TRUE(closeExtendibleHashFile(hashFile));
+    removeExtendibleHashFiles(hashPath);
+}
+
+/**
+ * @test LinearHashIncrementalGrowthTest
+ * @brief Tests that the linear hash table grows one bucket at a time and keeps every product reachable.
+ *
+ * Inserts products for 2000 vendors into a table that starts with four buckets. After each insert the
+ * bucket count may grow by at most one and the load factor must stay within the configured limit.
+ */
+TEST_F(MarketTest, LinearHashIncrementalGrowthTest) {
+    LinearHashTable* table = createLinearHashTable(4, 0.75);
+    ASSERT_NE(table, nullptr);
+
+    for (int vendorId = 1; vendorId <= 2000; vendorId++) {
+        for (int i = 0; i < 3; i++) {
+            Product product = { vendorId, "", 1.0f + i, i, "Spring" };
+            snprintf(product.productName, sizeof(product.productName), "Product%d", i);
+            int bucketsBefore = table->bucketCount;
+            ASSERT_TRUE(linearHashInsert(table, &product));
+            EXPECT_LE(table->bucketCount - bucketsBefore, 1);
+            EXPECT_LE(linearHashLoadFactor(table), 0.75);
+        }
+    }
+
+    EXPECT_EQ(table->productCount, 6000);
+    EXPECT_GT(table->level, 0);
+    EXPECT_EQ(table->failedSplitCount, 0);
+
+    Product products[4];
+    for (int vendorId = 1; vendorId <= 2000; vendorId++) {
+        EXPECT_EQ(linearHashScanVendor(table, vendorId, products, 4), 3);
+    }
+    EXPECT_FALSE(linearHashSearch(table, 2001, NULL));
+
+    freeLinearHashTable(table);
+}
+
+/**
+ * @test LinearHashOverflowAndRemoveTest
+ * @brief Tests overflow chains and removal in the linear hash table.
+ *
+ * Stores more products for one vendor than a Bucket can hold, then removes them one by one and checks
+ * that the remaining products are still found.
+ */
+TEST_F(MarketTest, LinearHashOverflowAndRemoveTest) {
+    LinearHashTable* table = createLinearHashTable(2, 0);
+    ASSERT_NE(table, nullptr);
+
+    for (int i = 0; i < 3 * BUCKET_SIZE; i++) {
+        Product product = { 9, "", 4.0f, i, "Fall" };
+        snprintf(product.productName, sizeof(product.productName), "Item%d", i);
+        ASSERT_TRUE(linearHashInsert(table, &product));
+    }
+    Product other = { 10, "Pear", 2.0f, 5, "Fall" };
+    ASSERT_TRUE(linearHashInsert(table, &other));
+
+    EXPECT_EQ(linearHashScanVendor(table, 9, NULL, 0), 3 * BUCKET_SIZE);
+    EXPECT_TRUE(linearHashRemove(table, 9, "Item0"));
+    EXPECT_FALSE(linearHashRemove(table, 9, "Item0"));
+    EXPECT_TRUE(linearHashRemove(table, 9, "Item7"));
+    EXPECT_EQ(linearHashScanVendor(table, 9, NULL, 0), 3 * BUCKET_SIZE - 2);
+
+    Product found;
+    EXPECT_TRUE(linearHashSearch(table, 10, &found));
+    EXPECT_STREQ(found.productName, "Pear");
+    EXPECT_EQ(table->productCount, 3 * BUCKET_SIZE - 1);
+
+    freeLinearHashTable(table);
+}
+
+/**
+ * @test BPlusTreeNodeSizeFanOutTest
+ * @brief Tests that node capacities follow the target node size.
+ *
+ * A cache-line node must still hold at least three keys, and larger nodes must hold proportionally more.
+ */
+TEST_F(MarketTest, BPlusTreeNodeSizeFanOutTest) {
+    EXPECT_GE((Coruh::Market::BPlusTree<int, int, 64>::leafCapacity()), 3);
+    EXPECT_GE((Coruh::Market::BPlusTree<int, int, 64>::internalCapacity()), 3);
+    EXPECT_GT((Coruh::Market::BPlusTree<int, int, 256>::leafCapacity()), (Coruh::Market::BPlusTree<int, int, 64>::leafCapacity()));
+    EXPECT_GT((Coruh::Market::BPlusTree<int, int, 4096>::internalCapacity()), 300);
+    EXPECT_LE(sizeof(Coruh::Market::BPlusTree<int, int, 4096>::LeafNode), 4096u);
+    EXPECT_LE(sizeof(Coruh::Market::BPlusTree<int, int, 4096>::InternalNode), 4096u);
+}
+
+/**
+ * @test BPlusTreeInsertFindTest
+ * @brief Tests inserting 100000 keys in scrambled order into B+ trees of different node sizes.
+ *
+ * Every key must be found with its value afterwards, and the height of the 4 KiB tree must stay at three
+ * levels or less, which requires internal nodes to split and the root to grow correctly.
+ */
+TEST_F(MarketTest, BPlusTreeInsertFindTest) {
+    const int keyCount = 100000;
+    Coruh::Market::BPlusTree<int, int, 64> smallTree;
+    Coruh::Market::BPlusTree<int, int, 4096> pageTree;
+
+    for (int i = 0; i < keyCount; i++) {
+        int key = (int)(((long long)i * 7919) % keyCount);
+        ASSERT_TRUE(smallTree.insert(key, key * 2));
+        ASSERT_TRUE(pageTree.insert(key, key * 2));
+    }
+
+    EXPECT_EQ(smallTree.size(), (size_t)keyCount);
+    EXPECT_EQ(pageTree.size(), (size_t)keyCount);
+    EXPECT_GT(smallTree.height(), pageTree.height());
+    EXPECT_LE(pageTree.height(), 3);
+
+    for (int key = 0; key < keyCount; key++) {
+        int value = -1;
+        ASSERT_TRUE(smallTree.find(key, &value));
+        EXPECT_EQ(value, key * 2);
+        ASSERT_TRUE(pageTree.find(key, &value));
+        EXPECT_EQ(value, key * 2);
+    }
+    EXPECT_FALSE(pageTree.contains(keyCount));
+    EXPECT_FALSE(smallTree.contains(-1));
+}
+
+/**
+ * @test BPlusTreeReplaceValueTest
+ * @brief Tests that inserting an existing key replaces its value without growing the tree.
+ */
+TEST_F(MarketTest, BPlusTreeReplaceValueTest) {
+    Coruh::Market::BPlusTree<int, float> tree;
+    EXPECT_EQ(tree.height(), 0);
+    EXPECT_TRUE(tree.insert(101, 10.5f));
+    EXPECT_FALSE(tree.insert(101, 11.0f));
+    EXPECT_EQ(tree.size(), 1u);
+    EXPECT_EQ(tree.height(), 1);
+
+    float price = 0;
+    EXPECT_TRUE(tree.find(101, &price));
+    EXPECT_FLOAT_EQ(price, 11.0f);
+
+    tree.clear();
+    EXPECT_TRUE(tree.empty());
+    EXPECT_FALSE(tree.contains(101));
+}
+
+/**
+ * @test LegacyBPlusTreeInternalSplitTest
+ * @brief Tests that the MAX_KEYS B+ tree splits internal nodes and finds every inserted key.
+ *
+ * Inserting 500 keys into an order-3 tree needs several internal levels; every key must be reachable
+ * and the leaf chain must visit all keys in ascending order.
+ */
+TEST_F(MarketTest, LegacyBPlusTreeInternalSplitTest) {
+    BPlusTreeNode* root = NULL;
+    for (int i = 0; i < 500; i++) {
+        root = insert(root, (i * 37) % 500);
+    }
+
+    for (int key = 0; key < 500; key++) {
+        EXPECT_TRUE(search(root, key));
+    }
+    EXPECT_FALSE(search(root, 500));
+
+    BPlusTreeNode* leaf = root;
+    while (!leaf->isLeaf) {leaf = leaf->children[0];}
+    int expected = 0;
+    for (; leaf != NULL; leaf = leaf->next) {
+        for (int i = 0; i < leaf->keyCount; i++) {
+            EXPECT_EQ(leaf->keys[i], expected++);
+        }
+    }
+    EXPECT_EQ(expected, 500);
+}
+
+/**
+ * @test BPlusTreeBulkLoadTest
+ * @brief Tests bulk loading 100000 sorted keys into B+ trees of different node sizes.
+ *
+ * Every key must be found afterwards, the 4 KiB tree must need no more than three levels, and regular
+ * inserts must keep working on a bulk loaded tree, including inserts that split its packed leaves.
+ */
+TEST_F(MarketTest, BPlusTreeBulkLoadTest) {
+    const int keyCount = 100000;
+    std::vector<int> keys(keyCount);
+    std::vector<int> values(keyCount);
+    for (int i = 0; i < keyCount; i++) {
+        keys[i] = i * 2;
+        values[i] = i * 3;
+    }
+
+    Coruh::Market::BPlusTree<int, int, 64> smallTree;
+    Coruh::Market::BPlusTree<int, int, 4096> pageTree;
+    ASSERT_TRUE(smallTree.bulkLoad(keys.data(), values.data(), keys.size()));
+    ASSERT_TRUE(pageTree.bulkLoad(keys.data(), values.data(), keys.size()));
+    EXPECT_EQ(smallTree.size(), (size_t)keyCount);
+    EXPECT_EQ(pageTree.size(), (size_t)keyCount);
+    EXPECT_LE(pageTree.height(), 3);
+
+    for (int i = 0; i < keyCount; i++) {
+        int value = -1;
+        ASSERT_TRUE(smallTree.find(i * 2, &value));
+        EXPECT_EQ(value, i * 3);
+        ASSERT_TRUE(pageTree.find(i * 2, &value));
+        EXPECT_EQ(value, i * 3);
+        EXPECT_FALSE(smallTree.contains(i * 2 + 1));
+    }
+
+    for (int i = 0; i < keyCount; i += 7) {
+        ASSERT_TRUE(smallTree.insert(i * 2 + 1, -i));
+        ASSERT_TRUE(pageTree.insert(i * 2 + 1, -i));
+    }
+    for (int i = 0; i < keyCount; i += 7) {
+        int value = 0;
+        ASSERT_TRUE(smallTree.find(i * 2 + 1, &value));
+        EXPECT_EQ(value, -i);
+        ASSERT_TRUE(pageTree.find(i * 2 + 1, &value));
+        EXPECT_EQ(value, -i);
+    }
+    EXPECT_TRUE(smallTree.contains(0));
+    EXPECT_TRUE(pageTree.contains((keyCount - 1) * 2));
+}
+
+/**
+ * @test BPlusTreeBulkLoadRejectsUnsortedTest
+ * @brief Tests that bulk loading rejects unsorted or duplicate keys and leaves the tree unchanged.
+ */
+TEST_F(MarketTest, BPlusTreeBulkLoadRejectsUnsortedTest) {
+    Coruh::Market::BPlusTree<int, int, 64> tree;
+    ASSERT_TRUE(tree.insert(42, 1));
+
+    int unsortedKeys[] = {1, 3, 2};
+    int duplicateKeys[] = {1, 2, 2};
+    int values[] = {10, 20, 30};
+    EXPECT_FALSE(tree.bulkLoad(unsortedKeys, values, 3));
+    EXPECT_FALSE(tree.bulkLoad(duplicateKeys, values, 3));
+    EXPECT_EQ(tree.size(), (size_t)1);
+    EXPECT_TRUE(tree.contains(42));
+
+    EXPECT_TRUE(tree.bulkLoad(unsortedKeys, values, 0));
+    EXPECT_TRUE(tree.empty());
+    EXPECT_FALSE(tree.contains(42));
+    EXPECT_TRUE(tree.insert(5, 50));
+    EXPECT_TRUE(tree.contains(5));
+}
+
+/**
+ * @test BuildVendorIdIndexTest
+ * @brief Tests building the vendor ID index from a vendor file, including a file with unsorted IDs.
+ */
+TEST_F(MarketTest, BuildVendorIdIndexTest) {
+    createTestVendorFile();
+    Coruh::Market::VendorIdIndex index;
+    ASSERT_TRUE(Coruh::Market::buildVendorIdIndex(vendorFile, index));
+    EXPECT_EQ(index.size(), (size_t)2);
+    long position = -1;
+    ASSERT_TRUE(index.find(2, &position));
+    EXPECT_EQ(position, 1);
+    EXPECT_FALSE(index.contains(3));
+
+    const char* unsortedPath = "test_vendors_unsorted.bin";
+    FILE* file = fopen(unsortedPath, "wb");
+    ASSERT_NE(file, nullptr);
+    Vendor vendors[] = {{7, "Seven"}, {3, "Three"}, {7, "SevenAgain"}, {5, "Five"}};
+    fwrite(vendors, sizeof(Vendor), 4, file);
+    fclose(file);
+
+    ASSERT_TRUE(Coruh::Market::buildVendorIdIndex(unsortedPath, index));
+    EXPECT_EQ(index.size(), (size_t)3);
+    ASSERT_TRUE(index.find(7, &position));
+    EXPECT_EQ(position, 0);
+    ASSERT_TRUE(index.find(5, &position));
+    EXPECT_EQ(position, 3);
+    EXPECT_FALSE(index.contains(1));
+    remove(unsortedPath);
+
+    EXPECT_FALSE(Coruh::Market::buildVendorIdIndex("missing_vendors.bin", index));
+}
+
+/**
+ * @test BPlusTreeRangeIteratorTest
+ * @brief Tests forward iteration and lowerBound/upperBound across the linked leaves of a small-node tree.
+ */
+TEST_F(MarketTest, BPlusTreeRangeIteratorTest) {
+    Coruh::Market::BPlusTree<int, int, 64> tree;
+    EXPECT_TRUE(tree.begin() == tree.end());
+    EXPECT_FALSE(tree.lowerBound(0).valid());
+
+    // Even keys 0..1998 inserted in scrambled order
+    for (int i = 0; i < 1000; i++) {
+        int key = ((i * 389) % 1000) * 2;
+        tree.insert(key, key + 1);
+    }
+
+    int expected = 0;
+    for (Coruh::Market::BPlusTree<int, int, 64>::Iterator it = tree.begin(); it != tree.end(); ++it) {
+        ASSERT_EQ(it.key(), expected);
+        EXPECT_EQ(it.value(), expected + 1);
+        expected += 2;
+    }
+    EXPECT_EQ(expected, 2000);
+
+    EXPECT_EQ(tree.lowerBound(500).key(), 500);
+    EXPECT_EQ(tree.lowerBound(501).key(), 502);
+    EXPECT_EQ(tree.upperBound(500).key(), 502);
+    EXPECT_EQ(tree.lowerBound(-10).key(), 0);
+    EXPECT_FALSE(tree.lowerBound(1999).valid());
+    EXPECT_FALSE(tree.upperBound(1998).valid());
+
+    // Keys in [100, 200) span several leaves of this tree
+    int count = 0;
+    for (Coruh::Market::BPlusTree<int, int, 64>::Iterator it = tree.lowerBound(100); it.valid() && it.key() < 200; ++it) {
+        EXPECT_EQ(it.key(), 100 + count * 2);
+        count++;
+    }
+    EXPECT_EQ(count, 50);
+}
+
+/**
+ * @test FindVendorIdsInRangeTest
+ * @brief Tests the half-open vendor ID range query over a bulk loaded vendor index.
+ */
+TEST_F(MarketTest, FindVendorIdsInRangeTest) {
+    const char* path = "test_vendors_range.bin";
+    FILE* file = fopen(path, "wb");
+    ASSERT_NE(file, nullptr);
+    for (int i = 0; i < 3000; i++) {
+        Vendor vendor = {100 * i, "Vendor"};
+        fwrite(&vendor, sizeof(Vendor), 1, file);
+    }
+    fclose(file);
+
+    Coruh::Market::VendorIdIndex index;
+    ASSERT_TRUE(Coruh::Market::buildVendorIdIndex(path, index));
+
+    long positions[2000];
+    EXPECT_EQ(Coruh::Market::findVendorIdsInRange(index, 100000, 200000, positions, 2000), 1000);
+    EXPECT_EQ(positions[0], 1000);
+    EXPECT_EQ(positions[999], 1999);
+    EXPECT_EQ(Coruh::Market::findVendorIdsInRange(index, 150, 250, positions, 2000), 1);
+    EXPECT_EQ(positions[0], 2);
+    EXPECT_EQ(Coruh::Market::findVendorIdsInRange(index, 300000, 400000, NULL, 0), 0);
+    EXPECT_EQ(Coruh::Market::findVendorIdsInRange(index, 0, 300000, positions, 10), 3000);
+    remove(path);
+}
+
+/**
+ * @test FindProductsInPriceRangeTest
+ * @brief Tests the price index: inclusive price ranges, per-name runs and ascending price order.
+ */
+TEST_F(MarketTest, FindProductsInPriceRangeTest) {
+    const char* path = "test_products_prices.bin";
+    FILE* file = fopen(path, "wb");
+    ASSERT_NE(file, nullptr);
+    for (int i = 0; i < 1000; i++) {
+        Product product = {i % 10, "", (float)((i * 7) % 1000) / 100.0f, 10, "Summer"};
+        strcpy(product.productName, i % 2 == 0 ? "Tomato" : "Apple");
+        fwrite(&product, sizeof(Product), 1, file);
+    }
+    fclose(file);
+
+    Coruh::Market::ProductPriceIndex index;
+    ASSERT_TRUE(Coruh::Market::buildProductPriceIndex(path, index));
+    EXPECT_EQ(index.size(), (size_t)1000);
+
+    long positions[1000];
+    int count = Coruh::Market::findProductsInPriceRange(index, "Tomato", 5.0f, 8.0f, positions, 1000);
+    int expected = 0;
+    for (int i = 0; i < 1000; i += 2) {
+        float price = (float)((i * 7) % 1000) / 100.0f;
+        if (price >= 5.0f && price <= 8.0f) {expected++;}
+    }
+    EXPECT_EQ(count, expected);
+    for (int i = 0; i < count; i++) {
+        float price = (float)((positions[i] * 7) % 1000) / 100.0f;
+        EXPECT_EQ(positions[i] % 2, 0);
+        EXPECT_GE(price, 5.0f);
+        EXPECT_LE(price, 8.0f);
+        if (i > 0) {EXPECT_LE((float)((positions[i - 1] * 7) % 1000) / 100.0f, price);}
+    }
+
+    // Without a name the runs come grouped by name: every Apple (odd record) before every Tomato
+    int tomatoes = count;
+    count = Coruh::Market::findProductsInPriceRange(index, NULL, 5.0f, 8.0f, positions, 1000);
+    EXPECT_EQ(count, tomatoes + Coruh::Market::findProductsInPriceRange(index, "Apple", 5.0f, 8.0f, NULL, 0));
+    for (int i = 0; i < count; i++) {EXPECT_EQ(positions[i] % 2, i < count - tomatoes ? 1 : 0);}
+    EXPECT_EQ(Coruh::Market::findProductsInPriceRange(index, NULL, 0.0f, 100.0f, NULL, 0), 1000);
+    EXPECT_EQ(Coruh::Market::findProductsInPriceRange(index, "Pear", 0.0f, 100.0f, NULL, 0), 0);
+    EXPECT_EQ(Coruh::Market::findProductsInPriceRange(index, NULL, 20.0f, 30.0f, NULL, 0), 0);
+    remove(path);
+
+    EXPECT_FALSE(Coruh::Market::buildProductPriceIndex("missing_products.bin", index));
+}
+
+/**
+ * @test PagedBPlusTreePersistenceTest
+ * @brief Tests the paged B+ tree with a buffer pool far smaller than the tree, then reopens the file.
+ *
+ * With only eight frames most inserts evict pages, so every key must survive write-back and re-reading;
+ * after closing and reopening, all keys must still be found and the per-vendor scan must be name ordered.
+ */
+TEST_F(MarketTest, PagedBPlusTreePersistenceTest) {
+    const char* path = "test_products_index.bt";
+    remove(path);
+    const int keyCount = 20000;
+
+    PagedBPlusTree* tree = openPagedBPlusTree(path, 8);
+    ASSERT_NE(tree, nullptr);
+    char name[50];
+    for (int i = 0; i < keyCount; i++) {
+        int key = (int)(((long long)i * 7919) % keyCount);
+        snprintf(name, sizeof(name), "Product%05d", key);
+        ASSERT_EQ(pagedBPlusTreeInsert(tree, key % 100, name, (int64_t)key * 1000), 1);
+    }
+    // A second record of the same vendor and name gets its own entry; the same record is indexed once
+    snprintf(name, sizeof(name), "Product%05d", 42);
+    EXPECT_EQ(pagedBPlusTreeInsert(tree, 42, name, 42000), 0);
+    EXPECT_EQ(pagedBPlusTreeInsert(tree, 42, name, 7), 1);
+    EXPECT_EQ(tree->keyCount, keyCount + 1);
+    EXPECT_GE(tree->height, 3);
+    EXPECT_GT(tree->pageReads, 0);
+    ASSERT_TRUE(closePagedBPlusTree(tree));
+
+    tree = openPagedBPlusTree(path, 16);
+    ASSERT_NE(tree, nullptr);
+    EXPECT_EQ(tree->keyCount, keyCount + 1);
+    for (int key = 0; key < keyCount; key++) {
+        snprintf(name, sizeof(name), "Product%05d", key);
+        int64_t offset = -1;
+        ASSERT_TRUE(pagedBPlusTreeFind(tree, key % 100, name, &offset));
+        EXPECT_EQ(offset, key == 42 ? 7 : (int64_t)key * 1000);
+    }
+    EXPECT_FALSE(pagedBPlusTreeFind(tree, 1, "Product00000", NULL));
+
+    int64_t offsets[300];
+    snprintf(name, sizeof(name), "Product%05d", 42);
+    ASSERT_EQ(pagedBPlusTreeFindName(tree, name, offsets, 300), 2);
+    EXPECT_EQ(offsets[0], 7);
+    EXPECT_EQ(offsets[1], 42000);
+    EXPECT_EQ(pagedBPlusTreeScanVendor(tree, 42, NULL, 0), keyCount / 100 + 1);
+    ASSERT_EQ(pagedBPlusTreeScanVendor(tree, 37, offsets, 300), keyCount / 100);
+    for (int i = 0; i < keyCount / 100; i++) {
+        EXPECT_EQ(offsets[i], (int64_t)(37 + i * 100) * 1000);
+    }
+    EXPECT_EQ(pagedBPlusTreeScanVendor(tree, 100, NULL, 0), 0);
+    EXPECT_TRUE(closePagedBPlusTree(tree));
+    remove(path);
+}
+
+/**
+ * @test PagedBPlusTreeEraseTest
+ * @brief Tests erasing most keys from a paged tree with a small buffer pool, down to an empty tree.
+ *
+ * Erases borrow from and merge with siblings at every level; the remaining keys must still be found, the
+ * per-vendor scans must stay in order and the tree must shrink back to a single leaf.
+ */
+TEST_F(MarketTest, PagedBPlusTreeEraseTest) {
+    const char* path = "test_products_erase.bt";
+    remove(path);
+    const int keyCount = 20000;
+    PagedBPlusTree* tree = openPagedBPlusTree(path, BTREE_MIN_POOL_SIZE);
+    ASSERT_NE(tree, nullptr);
+    char name[50];
+    for (int key = 0; key < keyCount; key++) {
+        snprintf(name, sizeof(name), "Product%05d", key);
+        ASSERT_EQ(pagedBPlusTreeInsert(tree, key % 100, name, (int64_t)key), 1);
+    }
+    int fullHeight = tree->height;
+    EXPECT_GE(fullHeight, 3);
+
+    // Erase every key not divisible by 3, in a scattered order
+    for (int i = 0; i < keyCount; i++) {
+        int key = (int)(((long long)i * 7919) % keyCount);
+        if (key % 3 == 0) {continue;}
+        snprintf(name, sizeof(name), "Product%05d", key);
+        ASSERT_EQ(pagedBPlusTreeErase(tree, key % 100, name, (int64_t)key), 1);
+    }
+    snprintf(name, sizeof(name), "Product%05d", 1);
+    EXPECT_EQ(pagedBPlusTreeErase(tree, 1, name, 1), 0);
+    snprintf(name, sizeof(name), "Product%05d", 3);
+    EXPECT_EQ(pagedBPlusTreeErase(tree, 3, name, 4), 0);
+    EXPECT_EQ(tree->keyCount, (keyCount + 2) / 3);
+    ASSERT_TRUE(closePagedBPlusTree(tree));
+
+    tree = openPagedBPlusTree(path, 8);
+    ASSERT_NE(tree, nullptr);
+    for (int key = 0; key < keyCount; key++) {
+        snprintf(name, sizeof(name), "Product%05d", key);
+        int64_t offset = -1;
+        EXPECT_EQ(pagedBPlusTreeFind(tree, key % 100, name, &offset), key % 3 == 0);
+        if (key % 3 == 0) {EXPECT_EQ(offset, (int64_t)key);}
+    }
+    int64_t offsets[300];
+    int count = pagedBPlusTreeScanVendor(tree, 42, offsets, 300);
+    ASSERT_EQ(count, (keyCount / 100 + 2) / 3);
+    for (int i = 0; i < count; i++) {EXPECT_EQ(offsets[i], (int64_t)(42 + i * 300));}
+
+    for (int key = 0; key < keyCount; key += 3) {
+        snprintf(name, sizeof(name), "Product%05d", key);
+        ASSERT_EQ(pagedBPlusTreeErase(tree, key % 100, name, (int64_t)key), 1);
+    }
+    EXPECT_EQ(tree->keyCount, 0);
+    EXPECT_EQ(tree->height, 1);
+    EXPECT_EQ(pagedBPlusTreeScanVendor(tree, 42, NULL, 0), 0);
+    EXPECT_EQ(pagedBPlusTreeInsert(tree, 5, "Pear", 84), 1);
+    EXPECT_TRUE(pagedBPlusTreeFind(tree, 5, "Pear", NULL));
+    EXPECT_TRUE(closePagedBPlusTree(tree));
+    remove(path);
+}
+
+/**
+ * @test BuildPagedBPlusTreeBulkLoadTest
+ * @brief Tests that building the index of a large products file writes each page once and indexes repeated listings.
+ */
+TEST_F(MarketTest, BuildPagedBPlusTreeBulkLoadTest) {
+    const char* path = "test_products_bulk.bt";
+    const char* productsPath = "test_products_bulk.bin";
+    remove(path);
+    const int recordCount = 30000;
+    FILE* file = fopen(productsPath, "wb");
+    ASSERT_NE(file, nullptr);
+    for (int i = 0; i < recordCount; i++) {
+        // The last ten records repeat the vendor and name of the first ten
+        Product product = {((i % (recordCount - 10)) * 37) % 500, "", 1.0f, 1, "Summer"};
+        snprintf(product.productName, sizeof(product.productName), "Product%05d", i % (recordCount - 10));
+        fwrite(&product, sizeof(Product), 1, file);
+    }
+    fclose(file);
+
+    PagedBPlusTree* tree = openPagedBPlusTree(path, 8);
+    ASSERT_NE(tree, nullptr);
+    ASSERT_EQ(buildPagedBPlusTreeFromProducts(tree, productsPath), recordCount);
+    EXPECT_EQ(tree->keyCount, recordCount);
+    EXPECT_EQ(tree->sourceRecords, recordCount);
+    EXPECT_LE(tree->pageWrites, (long)tree->pageCount);
+    ASSERT_TRUE(closePagedBPlusTree(tree));
+
+    tree = openPagedBPlusTree(path, 8);
+    ASSERT_NE(tree, nullptr);
+    char name[50];
+    for (int i = 0; i < recordCount - 10; i++) {
+        snprintf(name, sizeof(name), "Product%05d", i);
+        int64_t offset = -1;
+        ASSERT_TRUE(pagedBPlusTreeFind(tree, (i * 37) % 500, name, &offset));
+        EXPECT_EQ(offset, (int64_t)i * (int64_t)sizeof(Product));
+    }
+    // Both records of a repeated vendor and name are indexed
+    int64_t offsets[2];
+    ASSERT_EQ(pagedBPlusTreeFindName(tree, "Product00003", offsets, 2), 2);
+    EXPECT_EQ(offsets[0], 3 * (int64_t)sizeof(Product));
+    EXPECT_EQ(offsets[1], (int64_t)(recordCount - 7) * (int64_t)sizeof(Product));
+    EXPECT_EQ(pagedBPlusTreeScanVendor(tree, 0, NULL, 0), (recordCount - 10 + 499) / 500 + 1);
+    EXPECT_TRUE(closePagedBPlusTree(tree));
+    remove(path);
+    remove(productsPath);
+}
+
+/**
+ * @test PagedBPlusTreeFindNameTest
+ * @brief Tests looking up a product name across vendors, one descent per vendor, in vendor order.
+ */
+TEST_F(MarketTest, PagedBPlusTreeFindNameTest) {
+    const char* path = "test_products_names.bt";
+    remove(path);
+    PagedBPlusTree* tree = openPagedBPlusTree(path, 8);
+    ASSERT_NE(tree, nullptr);
+    char name[50];
+    for (int vendor = 0; vendor < 300; vendor++) {
+        for (int product = 0; product < 20; product++) {
+            snprintf(name, sizeof(name), "Product%02d", product);
+            if (product == 7 && vendor % 3 != 0) {continue;}
+            ASSERT_EQ(pagedBPlusTreeInsert(tree, vendor * 10, name, (int64_t)(vendor * 20 + product)), 1);
+        }
+    }
+
+    int64_t offsets[300];
+    ASSERT_EQ(pagedBPlusTreeFindName(tree, "Product07", offsets, 300), 100);
+    for (int i = 0; i < 100; i++) {EXPECT_EQ(offsets[i], (int64_t)(i * 3 * 20 + 7));}
+    EXPECT_EQ(pagedBPlusTreeFindName(tree, "Product19", NULL, 0), 300);
+    EXPECT_EQ(pagedBPlusTreeFindName(tree, "Product", NULL, 0), 0);
+    EXPECT_EQ(pagedBPlusTreeFindName(tree, "Product99", NULL, 0), 0);
+    EXPECT_TRUE(closePagedBPlusTree(tree));
+    remove(path);
+}
+
+/**
+ * @test OpenProductIndexRebuildsStaleIndexTest
+ * @brief Tests that an index left behind by a different products file is rebuilt on open.
+ */
+TEST_F(MarketTest, OpenProductIndexRebuildsStaleIndexTest) {
+    const char* path = "test_products_stale.bt";
+    const char* productsPath = "test_products_stale.bin";
+    remove(path);
+    Product products[] = {{1, "Tomato", 25, 100, "Winter"}, {2, "Apple", 30, 50, "Fall"}, {2, "Pear", 12, 40, "Fall"}};
+    FILE* file = fopen(productsPath, "wb");
+    ASSERT_NE(file, nullptr);
+    fwrite(products, sizeof(Product), 2, file);
+    fclose(file);
+
+    PagedBPlusTree* tree = openProductIndex(path, productsPath, 0);
+    ASSERT_NE(tree, nullptr);
+    EXPECT_EQ(tree->keyCount, 2);
+    EXPECT_EQ(tree->sourceRecords, 2);
+    ASSERT_TRUE(closePagedBPlusTree(tree));
+
+    // Replaced behind the index's back
+    file = fopen(productsPath, "wb");
+    ASSERT_NE(file, nullptr);
+    fwrite(products, sizeof(Product), 3, file);
+    fclose(file);
+
+    tree = openProductIndex(path, productsPath, 0);
+    ASSERT_NE(tree, nullptr);
+    EXPECT_EQ(tree->keyCount, 3);
+    EXPECT_EQ(tree->sourceRecords, 3);
+    EXPECT_TRUE(pagedBPlusTreeFind(tree, 2, "Pear", NULL));
+    EXPECT_TRUE(closePagedBPlusTree(tree));
+    remove(path);
+    remove(productsPath);
+}
+
+/**
+ * @test OpenProductIndexTest
+ * @brief Tests building the product index from products.bin once and reusing the file on the next open.
+ */
+TEST_F(MarketTest, OpenProductIndexTest) {
+    const char* path = "test_products_primary.bt";
+    remove(path);
+
+    PagedBPlusTree* tree = openProductIndex(path, productFile, 0);
+    ASSERT_NE(tree, nullptr);
+    EXPECT_EQ(tree->keyCount, 2);
+    ASSERT_TRUE(closePagedBPlusTree(tree));
+
+    tree = openProductIndex(path, "missing_products.bin", 0);
+    ASSERT_NE(tree, nullptr);
+    EXPECT_EQ(tree->keyCount, 2);
+    EXPECT_EQ(tree->pageReads, 0);
+
+    int64_t offset = -1;
+    ASSERT_TRUE(pagedBPlusTreeFind(tree, 2, "Apple", &offset));
+    EXPECT_EQ(offset, (int64_t)sizeof(Product));
+    FILE* products = fopen(productFile, "rb");
+    ASSERT_NE(products, nullptr);
+    Product product;
+    ASSERT_TRUE(readProductAtOffset(products, offset, &product));
+    EXPECT_STREQ(product.productName, "Apple");
+    EXPECT_FLOAT_EQ(product.price, 30.0f);
+    EXPECT_FALSE(readProductAtOffset(products, 100 * (int64_t)sizeof(Product), &product));
+    fclose(products);
+
+    EXPECT_TRUE(closePagedBPlusTree(tree));
+    remove(path);
+}
+
+/**
+ * @test BPlusTreeEraseTest
+ * @brief Tests erasing keys in scrambled order from a small-node tree until it is empty.
+ *
+ * Small nodes make borrows and merges happen at every level; the structural invariants are checked
+ * after every batch of erases, and the remaining keys must stay reachable in order through the leaf chain.
+ */
+TEST_F(MarketTest, BPlusTreeEraseTest) {
+    const int keyCount = 5000;
+    Coruh::Market::BPlusTree<int, int, 64> tree;
+    for (int i = 0; i < keyCount; i++) {
+        tree.insert(i, i * 10);
+    }
+    ASSERT_TRUE(tree.checkInvariants());
+    int initialHeight = tree.height();
+    EXPECT_FALSE(tree.erase(keyCount));
+
+    // Erase the odd keys in scrambled order
+    for (int i = 0; i < keyCount; i++) {
+        int key = (int)(((long long)i * 2741) % keyCount);
+        if (key % 2 == 0) {continue;}
+        ASSERT_TRUE(tree.erase(key));
+        EXPECT_FALSE(tree.erase(key));
+        if (i % 100 == 0) {ASSERT_TRUE(tree.checkInvariants());}
+    }
+    ASSERT_TRUE(tree.checkInvariants());
+    EXPECT_EQ(tree.size(), (size_t)keyCount / 2);
+
+    int expected = 0;
+    for (Coruh::Market::BPlusTree<int, int, 64>::Iterator it = tree.begin(); it != tree.end(); ++it) {
+        ASSERT_EQ(it.key(), expected);
+        EXPECT_EQ(it.value(), expected * 10);
+        expected += 2;
+    }
+    EXPECT_EQ(expected, keyCount);
+
+    for (int key = keyCount - 2; key >= 0; key -= 2) {
+        ASSERT_TRUE(tree.erase(key));
+        if (key % 500 == 0) {ASSERT_TRUE(tree.checkInvariants());}
+    }
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.height(), 0);
+    EXPECT_TRUE(tree.checkInvariants());
+    EXPECT_TRUE(tree.begin() == tree.end());
+    EXPECT_GT(initialHeight, 2);
+
+    EXPECT_TRUE(tree.insert(7, 70));
+    EXPECT_TRUE(tree.contains(7));
+}
+
+/**
+ * @test BPlusTreeEraseAfterBulkLoadTest
+ * @brief Tests erasing from a bulk loaded page-sized tree from the front, which forces borrows from the right and merges.
+ */
+TEST_F(MarketTest, BPlusTreeEraseAfterBulkLoadTest) {
+    const int keyCount = 50000;
+    std::vector<int> keys(keyCount);
+    std::vector<int> values(keyCount);
+    for (int i = 0; i < keyCount; i++) {
+        keys[i] = i;
+        values[i] = -i;
+    }
+    Coruh::Market::BPlusTree<int, int, 4096> tree;
+    ASSERT_TRUE(tree.bulkLoad(keys.data(), values.data(), keys.size()));
+    ASSERT_TRUE(tree.checkInvariants());
+
+    for (int key = 0; key < keyCount - 10; key++) {
+        ASSERT_TRUE(tree.erase(key));
+        if (key % 5000 == 0) {ASSERT_TRUE(tree.checkInvariants());}
+    }
+    ASSERT_TRUE(tree.checkInvariants());
+    EXPECT_EQ(tree.size(), (size_t)10);
+    EXPECT_EQ(tree.height(), 1);
+    EXPECT_EQ(tree.begin().key(), keyCount - 10);
+    int value = 0;
+    ASSERT_TRUE(tree.find(keyCount - 1, &value));
+    EXPECT_EQ(value, -(keyCount - 1));
+}
+
+/**
+ * @test ProductIndexFollowsProductChangesTest
+ * @brief Tests that adding, deleting and updating products keeps an existing products.idx in sync with products.bin.
+ */
+TEST_F(MarketTest, ProductIndexFollowsProductChangesTest) {
+    remove(PRODUCT_INDEX_FILE);
+    Product products[] = {{1, "Tomato", 25, 100, "Winter"}, {2, "Apple", 30, 50, "Fall"}, {2, "Pear", 12, 40, "Fall"}};
+    writeProductsFile(products, 3);
+    Vendor vendors[] = {{1, "Vendor1"}, {2, "Vendor2"}};
+    writeVendorsFile(vendors, 2);
+
+    PagedBPlusTree* index = openProductIndex(PRODUCT_INDEX_FILE, "products.bin", 0);
+    ASSERT_NE(index, nullptr);
+    EXPECT_EQ(index->keyCount, 3);
+    closePagedBPlusTree(index);
+
+    simulateUserInput("Apple\n\n\n");
+    EXPECT_TRUE(deleteProduct());
+    resetStdinStdout();
+
+    simulateUserInput("1\nCarrot\n8\n20\nSpring\n\n\n");
+    EXPECT_TRUE(addProduct());
+    resetStdinStdout();
+
+    index = openPagedBPlusTree(PRODUCT_INDEX_FILE, 0);
+    ASSERT_NE(index, nullptr);
+    EXPECT_EQ(index->keyCount, 3);
+    EXPECT_FALSE(pagedBPlusTreeFind(index, 2, "Apple", NULL));
+    int64_t offset = -1;
+    ASSERT_TRUE(pagedBPlusTreeFind(index, 2, "Pear", &offset));
+    EXPECT_EQ(offset, (int64_t)sizeof(Product));
+    ASSERT_TRUE(pagedBPlusTreeFind(index, 1, "Carrot", &offset));
+    EXPECT_EQ(offset, 2 * (int64_t)sizeof(Product));
+    closePagedBPlusTree(index);
+
+    // The update finds Pear through the index and rewrites its record in place
+    simulateUserInput("Pear\nPlum\n14\n30\nFall\n\n\n");
+    EXPECT_TRUE(updateProduct());
+    resetStdinStdout();
+    FILE* file = fopen("products.bin", "rb");
+    ASSERT_NE(file, nullptr);
+    Product stored[4];
+    ASSERT_EQ(fread(stored, sizeof(Product), 4, file), (size_t)3);
+    fclose(file);
+    EXPECT_STREQ(stored[1].productName, "Plum");
+    EXPECT_FLOAT_EQ(stored[1].price, 14.0f);
+    index = openProductIndex(PRODUCT_INDEX_FILE, "products.bin", 0);
+    ASSERT_NE(index, nullptr);
+    EXPECT_EQ(index->pageReads, 0);
+    EXPECT_FALSE(pagedBPlusTreeFind(index, 2, "Pear", NULL));
+    ASSERT_TRUE(pagedBPlusTreeFind(index, 2, "Plum", &offset));
+    EXPECT_EQ(offset, (int64_t)sizeof(Product));
+    closePagedBPlusTree(index);
+}
+
+/**
+ * @test ProductIndexKeepsRepeatedListingsTest
+ * @brief Tests that a vendor listing the same product twice keeps both records through an update and a delete,
+ *        in products.bin, products.idx and products.sum.
+ */
+TEST_F(MarketTest, ProductIndexKeepsRepeatedListingsTest) {
+    remove(PRODUCT_INDEX_FILE);
+    remove(PRODUCT_PRICE_SUMMARY_FILE);
+    Product products[] = {{1, "Apple", 10, 5, "Fall"}, {2, "Pear", 12, 4, "Fall"}, {1, "Apple", 14, 6, "Fall"}, {2, "Plum", 9, 3, "Summer"}};
+    writeProductsFile(products, 4);
+    PagedBPlusTree* index = openProductIndex(PRODUCT_INDEX_FILE, "products.bin", 0);
+    ASSERT_NE(index, nullptr);
+    EXPECT_EQ(index->keyCount, 4);
+    closePagedBPlusTree(index);
+    ASSERT_TRUE(openProductPriceSummaries(PRODUCT_PRICE_SUMMARY_FILE, "products.bin"));
+
+    // Both Apple records are found and rewritten
+    simulateUserInput("Apple\nQuince\n11\n7\nFall\nQuince\n15\n8\nFall\n\n\n");
+    EXPECT_TRUE(updateProduct());
+    resetStdinStdout();
+    FILE* file = fopen("products.bin", "rb");
+    ASSERT_NE(file, nullptr);
+    Product stored[5];
+    ASSERT_EQ(fread(stored, sizeof(Product), 5, file), (size_t)4);
+    fclose(file);
+    EXPECT_STREQ(stored[0].productName, "Quince");
+    EXPECT_FLOAT_EQ(stored[0].price, 11.0f);
+    EXPECT_STREQ(stored[2].productName, "Quince");
+    EXPECT_FLOAT_EQ(stored[2].price, 15.0f);
+
+    index = openProductIndex(PRODUCT_INDEX_FILE, "products.bin", 0);
+    ASSERT_NE(index, nullptr);
+    EXPECT_EQ(index->pageReads, 0);
+    EXPECT_EQ(index->keyCount, 4);
+    EXPECT_EQ(pagedBPlusTreeFindName(index, "Apple", NULL, 0), 0);
+    int64_t offsets[4];
+    ASSERT_EQ(pagedBPlusTreeFindName(index, "Quince", offsets, 4), 2);
+    EXPECT_EQ(offsets[0], 0);
+    EXPECT_EQ(offsets[1], 2 * (int64_t)sizeof(Product));
+    closePagedBPlusTree(index);
+    ProductPriceSummary summary;
+    EXPECT_FALSE(findProductPriceSummary(PRODUCT_PRICE_SUMMARY_FILE, "Apple", &summary));
+    ASSERT_TRUE(findProductPriceSummary(PRODUCT_PRICE_SUMMARY_FILE, "Quince", &summary));
+    EXPECT_EQ(summary.count, 2);
+    EXPECT_NEAR(summary.priceSum, 26.0, 1e-9);
+
+    // Deleting the record between them moves the second Quince and Plum up
+    simulateUserInput("Pear\n\n\n");
+    EXPECT_TRUE(deleteProduct());
+    resetStdinStdout();
+    index = openProductIndex(PRODUCT_INDEX_FILE, "products.bin", 0);
+    ASSERT_NE(index, nullptr);
+    EXPECT_EQ(index->pageReads, 0);
+    EXPECT_EQ(index->keyCount, 3);
+    ASSERT_EQ(pagedBPlusTreeFindName(index, "Quince", offsets, 4), 2);
+    EXPECT_EQ(offsets[0], 0);
+    EXPECT_EQ(offsets[1], (int64_t)sizeof(Product));
+    int64_t offset = -1;
+    ASSERT_TRUE(pagedBPlusTreeFind(index, 2, "Plum", &offset));
+    EXPECT_EQ(offset, 2 * (int64_t)sizeof(Product));
+    closePagedBPlusTree(index);
+
+    remove(PRODUCT_PRICE_SUMMARY_FILE);
+}
+
+/**
+ * @test BPlusTreeIntSearchVariantsTest
+ * @brief Tests that the SSE2 and AVX2 node searches agree with the scalar search on every node width.
+ *
+ * Node widths from 0 to 520 keys cover empty nodes, partial vector blocks and 4 KiB leaves; keys include
+ * duplicates and negative values, and probes cover every position plus values outside the node.
+ */
+TEST_F(MarketTest, BPlusTreeIntSearchVariantsTest) {
+    using Coruh::Market::BPlusTreeIntSearch;
+    std::vector<int> keys;
+    for (int count = 0; count <= 520; count += (count < 40 ? 1 : 37)) {
+        keys.resize(count);
+        for (int i = 0; i < count; i++) {
+            keys[i] = (i / 3) * 5 - 200;
+        }
+        const int* data = count > 0 ? keys.data() : NULL;
+        for (int probe = -210; probe <= count * 2 + 10; probe++) {
+            int lower = BPlusTreeIntSearch::lowerBoundScalar(data, count, probe);
+            int upper = BPlusTreeIntSearch::upperBoundScalar(data, count, probe);
+            ASSERT_EQ(lower, (int)(std::lower_bound(keys.begin(), keys.end(), probe) - keys.begin()));
+            ASSERT_EQ(upper, (int)(std::upper_bound(keys.begin(), keys.end(), probe) - keys.begin()));
+            ASSERT_EQ(BPlusTreeIntSearch::lowerBoundSse2(data, count, probe), lower);
+            ASSERT_EQ(BPlusTreeIntSearch::upperBoundSse2(data, count, probe), upper);
+            if (Coruh::Utility::CpuFeatures::hasAvx2()) {
+                ASSERT_EQ(BPlusTreeIntSearch::lowerBoundAvx2(data, count, probe), lower);
+                ASSERT_EQ(BPlusTreeIntSearch::upperBoundAvx2(data, count, probe), upper);
+            }
+            ASSERT_EQ(BPlusTreeIntSearch::lowerBound(data, count, probe), lower);
+            ASSERT_EQ(BPlusTreeIntSearch::upperBound(data, count, probe), upper);
+        }
+    }
+    EXPECT_TRUE(strcmp(BPlusTreeIntSearch::implementationName(), "scalar") == 0 ||
+                strcmp(BPlusTreeIntSearch::implementationName(), "sse2") == 0 ||
+                strcmp(BPlusTreeIntSearch::implementationName(), "avx2") == 0);
+}
+
+/**
+ * @test BPlusTreeIntSearchExtremeKeysTest
+ * @brief Tests the vector searches with INT_MIN and INT_MAX, where a signed compare must not wrap.
+ */
+TEST_F(MarketTest, BPlusTreeIntSearchExtremeKeysTest) {
+    using Coruh::Market::BPlusTreeIntSearch;
+    int keys[40];
+    for (int i = 0; i < 40; i++) {
+        keys[i] = i < 20 ? INT_MIN + i : INT_MAX - 39 + i;
+    }
+    EXPECT_EQ(BPlusTreeIntSearch::lowerBound(keys, 40, INT_MIN), 0);
+    EXPECT_EQ(BPlusTreeIntSearch::upperBound(keys, 40, INT_MIN), 1);
+    EXPECT_EQ(BPlusTreeIntSearch::lowerBound(keys, 40, 0), 20);
+    EXPECT_EQ(BPlusTreeIntSearch::lowerBound(keys, 40, INT_MAX), 39);
+    EXPECT_EQ(BPlusTreeIntSearch::upperBound(keys, 40, INT_MAX), 40);
+    EXPECT_EQ(BPlusTreeIntSearch::lowerBoundSse2(keys, 40, INT_MAX), 39);
+    EXPECT_EQ(BPlusTreeIntSearch::upperBoundSse2(keys, 40, INT_MIN), 1);
+}
+
+/**
+ * @test ConcurrentBPlusTreeStressTest
+ * @brief Tests concurrent inserts and lock-free lookups on a small-node tree.
+ *
+ * Four writers insert interleaved key sets while four readers keep looking up a pre-loaded key range and
+ * the keys being inserted. Readers must always find the pre-loaded keys with their values and must never see
+ * a wrong value for a key in flight; afterwards every key must be present exactly once.
+ */
+TEST_F(MarketTest, ConcurrentBPlusTreeStressTest) {
+    typedef Coruh::Market::ConcurrentBPlusTree<int, int, 64> Tree;
+    const int writerCount = 4;
+    const int readerCount = 4;
+    const int keysPerWriter = 20000;
+    const int preloadCount = 10000;
+    Tree tree;
+    for (int key = -preloadCount; key < 0; key++) {
+        ASSERT_TRUE(tree.insert(key, key * 3));
+    }
+
+    std::atomic<int> writersDone(0);
+    std::atomic<int> readerErrors(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < writerCount; t++) {
+        threads.push_back(std::thread([&tree, &writersDone, t, keysPerWriter, writerCount]() {
+            for (int i = 0; i < keysPerWriter; i++) {
+                int key = (int)(((long long)i * 7919) % keysPerWriter) * writerCount + t;
+                tree.insert(key, key * 3);
+            }
+            writersDone++;
+        }));
+    }
+    for (int t = 0; t < readerCount; t++) {
+        threads.push_back(std::thread([&tree, &writersDone, &readerErrors, t, preloadCount, writerCount, keysPerWriter]() {
+            unsigned int seed = 12345u + t;
+            while (writersDone.load() < writerCount) {
+                seed = seed * 1103515245u + 12345u;
+                int preloaded = -1 - (int)(seed % preloadCount);
+                int value = 0;
+                if (!tree.find(preloaded, &value) || value != preloaded * 3) {readerErrors++;}
+                int inFlight = (int)((seed >> 8) % (unsigned int)(writerCount * keysPerWriter));
+                if (tree.find(inFlight, &value) && value != inFlight * 3) {readerErrors++;}
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+
+    EXPECT_EQ(readerErrors.load(), 0);
+    EXPECT_EQ(tree.size(), (size_t)(preloadCount + writerCount * keysPerWriter));
+    for (int key = -preloadCount; key < writerCount * keysPerWriter; key++) {
+        int value = 0;
+        ASSERT_TRUE(tree.find(key, &value));
+        EXPECT_EQ(value, key * 3);
+    }
+    EXPECT_GT(tree.height(), 3);
+}
+
+/**
+ * @test ConcurrentBPlusTreeOverlappingInsertTest
+ * @brief Tests threads inserting the same keys concurrently: each key must be counted once.
+ */
+TEST_F(MarketTest, ConcurrentBPlusTreeOverlappingInsertTest) {
+    Coruh::Market::ConcurrentBPlusTree<int, int, 128> tree;
+    const int keyCount = 30000;
+    std::atomic<int> newKeys(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.push_back(std::thread([&tree, &newKeys, t, keyCount]() {
+            for (int i = 0; i < keyCount; i++) {
+                int key = t % 2 == 0 ? i : keyCount - 1 - i;
+                if (tree.insert(key, key + 1)) {newKeys++;}
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+
+    EXPECT_EQ(newKeys.load(), keyCount);
+    EXPECT_EQ(tree.size(), (size_t)keyCount);
+    for (int key = 0; key < keyCount; key++) {
+        int value = 0;
+        ASSERT_TRUE(tree.find(key, &value));
+        EXPECT_EQ(value, key + 1);
+    }
+    EXPECT_FALSE(tree.contains(keyCount));
+}
+
+/**
+ * @test PrefixBPlusTreeOrderAndPrefixTest
+ * @brief Tests the prefix-compressed string tree against std::map: exact lookups, ordered iteration, prefix scans and compression.
+ */
+TEST_F(MarketTest, PrefixBPlusTreeOrderAndPrefixTest) {
+    Coruh::Market::PrefixBPlusTree<int, 2048> tree;
+    EXPECT_TRUE(tree.begin() == tree.end());
+    EXPECT_FALSE(tree.contains("Tomato"));
+
+    // Long shared prefixes, as in product names, inserted in scrambled order
+    const char* stems[] = {"Tomato ", "Tomato Cherry ", "Potato ", "Apple Granny Smith ", "Apricot "};
+    std::map<std::string, int> expected;
+    size_t rawBytes = 0;
+    for (int i = 0; i < 5000; i++) {
+        int n = (i * 7919) % 5000;
+        char key[64];
+        snprintf(key, sizeof(key), "%s%04d", stems[n % 5], n / 5);
+        EXPECT_TRUE(tree.insert(key, n));
+        expected[key] = n;
+        rawBytes += strlen(key);
+    }
+    EXPECT_FALSE(tree.insert("Tomato 0001", -1));
+    expected["Tomato 0001"] = -1;
+    EXPECT_EQ(tree.size(), expected.size());
+    EXPECT_EQ(tree.height(), 2);
+    EXPECT_LT(tree.encodedBytes(), rawBytes + expected.size() * sizeof(int));
+
+    int value = 0;
+    ASSERT_TRUE(tree.find("Tomato 0001", &value));
+    EXPECT_EQ(value, -1);
+    ASSERT_TRUE(tree.find("Apricot 0999", &value));
+    EXPECT_EQ(value, 999 * 5 + 4);
+    EXPECT_FALSE(tree.contains("Tomato"));
+    EXPECT_FALSE(tree.contains("Tomato 00010"));
+    EXPECT_FALSE(tree.insert(std::string(300, 'x').c_str(), 0));
+
+    std::map<std::string, int>::const_iterator reference = expected.begin();
+    for (Coruh::Market::PrefixBPlusTree<int, 2048>::Iterator it = tree.begin(); it.valid(); ++it, ++reference) {
+        ASSERT_TRUE(reference != expected.end());
+        EXPECT_EQ(it.key(), reference->first);
+        EXPECT_EQ(it.value(), reference->second);
+    }
+    EXPECT_TRUE(reference == expected.end());
+
+    // "Tomato " also covers "Tomato Cherry ...": both stems share the prefix
+    int matches = 0;
+    for (Coruh::Market::PrefixBPlusTree<int, 2048>::Iterator it = tree.lowerBound("Tomato "); it.valid() && it.keyStartsWith("Tomato "); ++it) {
+        matches++;
+    }
+    EXPECT_EQ(matches, 2000);
+    EXPECT_EQ(tree.lowerBound("Ap").key(), "Apple Granny Smith 0000");
+    EXPECT_EQ(tree.lowerBound("Apq").key(), "Apricot 0000");
+    EXPECT_FALSE(tree.lowerBound("Zucchini").valid());
+
+    // Long keys that barely compress fill leaves quickly and split internal nodes at their fanout limit
+    tree.clear();
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.height(), 0);
+    std::string tail(200, 'x');
+    for (int i = 0; i < 3000; i++) {
+        char key[8];
+        snprintf(key, sizeof(key), "%04d", (i * 1999) % 3000);
+        EXPECT_TRUE(tree.insert((key + tail).c_str(), i));
+    }
+    EXPECT_EQ(tree.size(), (size_t)3000);
+    EXPECT_GE(tree.height(), 3);
+    int previous = -1;
+    for (Coruh::Market::PrefixBPlusTree<int, 2048>::Iterator it = tree.begin(); it.valid(); ++it) {
+        int number = atoi(it.key().substr(0, 4).c_str());
+        EXPECT_EQ(number, previous + 1);
+        previous = number;
+    }
+    EXPECT_EQ(previous, 2999);
+    EXPECT_TRUE(tree.contains(("2500" + tail).c_str()));
+
+    // Bulk loading the same sorted keys builds an equivalent tree that still accepts inserts
+    std::vector<std::string> sortedKeys;
+    std::vector<int> sortedValues;
+    for (int i = 0; i < 3000; i++) {
+        char key[8];
+        snprintf(key, sizeof(key), "%04d", i);
+        sortedKeys.push_back(key + tail);
+        sortedValues.push_back(i);
+    }
+    ASSERT_TRUE(tree.bulkLoad(sortedKeys, sortedValues));
+    EXPECT_EQ(tree.size(), (size_t)3000);
+    EXPECT_GE(tree.height(), 3);
+    ASSERT_TRUE(tree.find(("2500" + tail).c_str(), &value));
+    EXPECT_EQ(value, 2500);
+    EXPECT_EQ(tree.lowerBound("25").key(), "2500" + tail);
+    EXPECT_TRUE(tree.insert(("1234a" + tail).c_str(), -2));
+    previous = -1;
+    int visited = 0;
+    for (Coruh::Market::PrefixBPlusTree<int, 2048>::Iterator it = tree.begin(); it.valid(); ++it, ++visited) {
+        EXPECT_GE(atoi(it.key().substr(0, 4).c_str()), previous);
+        previous = atoi(it.key().substr(0, 4).c_str());
+    }
+    EXPECT_EQ(visited, 3001);
+
+    std::swap(sortedKeys[10], sortedKeys[11]);
+    EXPECT_FALSE(tree.bulkLoad(sortedKeys, sortedValues));
+    EXPECT_EQ(tree.size(), (size_t)3001);
+}
+
+/**
+ * @test FindProductNamesWithPrefixTest
+ * @brief Tests the product name index: distinct sorted names, per-name counts and autocomplete by prefix.
+ */
+TEST_F(MarketTest, FindProductNamesWithPrefixTest) {
+    const char* path = "test_products_names.bin";
+    FILE* file = fopen(path, "wb");
+    ASSERT_NE(file, nullptr);
+    const char* names[] = {"Tomato", "Apple", "Tomatillo", "Apricot", "Tomato"};
+    for (int i = 0; i < 5; i++) {
+        Product product = {i, "", 1.0f, 10, "Summer"};
+        strcpy(product.productName, names[i]);
+        fwrite(&product, sizeof(Product), 1, file);
+    }
+    fclose(file);
+
+    Coruh::Market::ProductNameIndex index;
+    ASSERT_TRUE(Coruh::Market::buildProductNameIndex(path, index));
+    EXPECT_EQ(index.size(), (size_t)4);
+
+    Coruh::Market::ProductNameEntry entry;
+    ASSERT_TRUE(index.find("Tomato", &entry));
+    EXPECT_EQ(entry.firstRecord, 0);
+    EXPECT_EQ(entry.productCount, 2);
+
+    char found[4][50];
+    ASSERT_EQ(Coruh::Market::findProductNamesWithPrefix(index, "", found, 4), 4);
+    EXPECT_STREQ(found[0], "Apple");
+    EXPECT_STREQ(found[1], "Apricot");
+    EXPECT_STREQ(found[2], "Tomatillo");
+    EXPECT_STREQ(found[3], "Tomato");
+
+    ASSERT_EQ(Coruh::Market::findProductNamesWithPrefix(index, "Tomat", found, 4), 2);
+    EXPECT_STREQ(found[0], "Tomatillo");
+    EXPECT_STREQ(found[1], "Tomato");
+    EXPECT_EQ(Coruh::Market::findProductNamesWithPrefix(index, "Ap", NULL, 0), 2);
+    EXPECT_EQ(Coruh::Market::findProductNamesWithPrefix(index, "Pear", NULL, 0), 0);
+    remove(path);
+
+    EXPECT_FALSE(Coruh::Market::buildProductNameIndex("missing_products.bin", index));
+}
+
+/**
+ * @test CompressedSparseMatrixTest
+ * @brief Tests the CSR and CSC views: sorted row IDs, row pointers, per-row insertion order and missing rows.
+ */
+TEST_F(MarketTest, CompressedSparseMatrixTest) {
+    SparseMatrixEntry entries[] = {{7, 101, 1.0f}, {3, 102, 2.0f}, {7, 103, 3.0f}, {5, 101, 4.0f}, {3, 101, 5.0f}};
+    CompressedSparseMatrix rows;
+    CompressedSparseMatrix columns;
+    ASSERT_TRUE(buildCompressedSparseMatrix(entries, 5, SPARSE_BY_VENDOR, &rows));
+    ASSERT_TRUE(buildCompressedSparseMatrix(entries, 5, SPARSE_BY_PRODUCT, &columns));
+
+    ASSERT_EQ(rows.rowCount, 3);
+    EXPECT_EQ(rows.rowIds[0], 3);
+    EXPECT_EQ(rows.rowIds[1], 5);
+    EXPECT_EQ(rows.rowIds[2], 7);
+    EXPECT_EQ(rows.rowPointers[0], 0);
+    EXPECT_EQ(rows.rowPointers[3], 5);
+
+    const int* ids = NULL;
+    const float* prices = NULL;
+    ASSERT_EQ(compressedSparseMatrixRow(&rows, 7, &ids, &prices), 2);
+    EXPECT_EQ(ids[0], 101);
+    EXPECT_EQ(ids[1], 103);
+    EXPECT_FLOAT_EQ(prices[1], 3.0f);
+    ASSERT_EQ(compressedSparseMatrixRow(&rows, 3, &ids, &prices), 2);
+    EXPECT_EQ(ids[0], 102);
+    EXPECT_EQ(ids[1], 101);
+
+    ASSERT_EQ(compressedSparseMatrixRow(&columns, 101, &ids, &prices), 3);
+    EXPECT_EQ(ids[0], 7);
+    EXPECT_EQ(ids[1], 5);
+    EXPECT_EQ(ids[2], 3);
+    EXPECT_FLOAT_EQ(prices[2], 5.0f);
+    EXPECT_EQ(compressedSparseMatrixRow(&columns, 104, &ids, &prices), 0);
+    EXPECT_EQ(ids, nullptr);
+    EXPECT_EQ(compressedSparseMatrixRow(&rows, 4, NULL, NULL), 0);
+
+    freeCompressedSparseMatrix(&rows);
+    freeCompressedSparseMatrix(&columns);
+    EXPECT_EQ(rows.rowCount, 0);
+
+    ASSERT_TRUE(buildCompressedSparseMatrix(NULL, 0, SPARSE_BY_VENDOR, &rows));
+    EXPECT_EQ(compressedSparseMatrixRow(&rows, 1, NULL, NULL), 0);
+    freeCompressedSparseMatrix(&rows);
+    EXPECT_FALSE(buildCompressedSparseMatrix(NULL, 3, SPARSE_BY_VENDOR, &rows));
+}
+
+/**
+ * @test ListVendorsByProductTest
+ * @brief Tests that both listings follow relations added after an earlier listing.
+ */
+TEST_F(MarketTest, ListVendorsByProductTest) {
+    ASSERT_TRUE(addVendorProductRelation(41, 901, 3.5f));
+    testing::internal::CaptureStdout();
+    EXPECT_TRUE(listVendorsByProduct(901));
+    std::string output = testing::internal::GetCapturedStdout();
+    EXPECT_NE(output.find("Vendor ID: 41, Price: 3.50"), std::string::npos);
+
+    ASSERT_TRUE(addVendorProductRelation(42, 901, 4.0f));
+    testing::internal::CaptureStdout();
+    EXPECT_TRUE(listVendorsByProduct(901));
+    EXPECT_TRUE(listProductsByVendor(42));
+    EXPECT_TRUE(listVendorsByProduct(902));
+    output = testing::internal::GetCapturedStdout();
+    EXPECT_NE(output.find("Vendor ID: 42, Price: 4.00"), std::string::npos);
+    EXPECT_NE(output.find("Product ID: 901, Price: 4.00"), std::string::npos);
+    EXPECT_NE(output.find("No vendors found for Product 902."), std::string::npos);
+}
+
+/**
+ * @test VendorMenuListsRelationsTest
+ * @brief Tests that the vendor menu lists the vendors of a product and the products of a vendor.
+ */
+TEST_F(MarketTest, VendorMenuListsRelationsTest) {
+    ASSERT_TRUE(addVendorProductRelation(43, 903, 2.5f));
+    simulateUserInput("6\n903\n\n5\n43\n\n0\n");
+    EXPECT_TRUE(listingOfLocalVendors());
+    resetStdinStdout();
+
+    FILE* file = fopen(outputTest, "rb");
+    ASSERT_NE(file, nullptr);
+    char buffer[4096] = { 0 };
+    fread(buffer, sizeof(char), sizeof(buffer) - 1, file);
+    fclose(file);
+    std::string output = buffer;
+    EXPECT_NE(output.find("Vendor ID: 43, Price: 2.50"), std::string::npos) << output;
+    EXPECT_NE(output.find("Product ID: 903, Price: 2.50"), std::string::npos) << output;
+}
+
+/**
+ * @test PriceMenuListsProductPriceAggregatesTest
+ * @brief Tests that the price comparison menu reaches the per-product summary of the vendor-product relations.
+ */
+TEST_F(MarketTest, PriceMenuListsProductPriceAggregatesTest) {
+    ASSERT_TRUE(addVendorProductRelation(44, 904, 2.0f));
+    ASSERT_TRUE(addVendorProductRelation(45, 904, 4.0f));
+    simulateUserInput("6\n\n0\n\n");
+    EXPECT_TRUE(priceComparison());
+    resetStdinStdout();
+
+    FILE* file = fopen(outputTest, "rb");
+    ASSERT_NE(file, nullptr);
+    char buffer[4096] = { 0 };
+    fread(buffer, sizeof(char), sizeof(buffer) - 1, file);
+    fclose(file);
+    std::string output = buffer;
+    EXPECT_NE(output.find("Product ID: 904, Vendors: 2, Min: 2.00, Max: 4.00, Mean: 3.00"), std::string::npos) << output;
+}
+
+/**
+ * @test SparseMatrixBuilderTest
+ * @brief Tests that the builder grows past its initial capacity and keeps the last price of duplicate pairs.
+ */
+TEST_F(MarketTest, SparseMatrixBuilderTest) {
+    SparseMatrixBuilder builder;
+    ASSERT_TRUE(initSparseMatrixBuilder(&builder, 2));
+    EXPECT_EQ(finalizeSparseMatrixBuilder(&builder), 0);
+
+    // 30000 triplets over 300 vendors and 50 products in scrambled order, every pair written twice
+    for (int round = 0; round < 2; round++) {
+        for (int k = 0; k < 15000; k++) {
+            int i = (k * 7919) % 15000;
+            ASSERT_TRUE(sparseMatrixBuilderAdd(&builder, i % 300, i / 300, (float)(round * 100000 + i)));
+        }
+    }
+    EXPECT_EQ(builder.entryCount, 30000);
+    EXPECT_GE(builder.capacity, 30000);
+    ASSERT_EQ(finalizeSparseMatrixBuilder(&builder), 15000);
+    for (int i = 1; i < builder.entryCount; i++) {
+        const SparseMatrixEntry* previous = &builder.entries[i - 1];
+        const SparseMatrixEntry* current = &builder.entries[i];
+        EXPECT_TRUE(previous->vendorId < current->vendorId ||
+                    (previous->vendorId == current->vendorId && previous->productId < current->productId));
+    }
+
+    CompressedSparseMatrix columns;
+    ASSERT_TRUE(freezeSparseMatrixBuilder(&builder, SPARSE_BY_PRODUCT, &columns));
+    const int* vendorIds = NULL;
+    const float* prices = NULL;
+    ASSERT_EQ(compressedSparseMatrixRow(&columns, 0, &vendorIds, &prices), 300);
+    for (int i = 0; i < 300; i++) {
+        EXPECT_EQ(vendorIds[i], i);
+        EXPECT_FLOAT_EQ(prices[i], 100000.0f + (float)i);
+    }
+    freeCompressedSparseMatrix(&columns);
+
+    // Adding after a freeze reopens the builder
+    ASSERT_TRUE(sparseMatrixBuilderAdd(&builder, 0, 0, 1.5f));
+    EXPECT_FALSE(builder.finalized);
+    EXPECT_EQ(finalizeSparseMatrixBuilder(&builder), 15000);
+    EXPECT_FLOAT_EQ(builder.entries[0].price, 1.5f);
+
+    freeSparseMatrixBuilder(&builder);
+    EXPECT_EQ(builder.entryCount, 0);
+    EXPECT_EQ(builder.entries, nullptr);
+}
+
+/**
+ * @test AddVendorProductRelationReplacesPriceTest
+ * @brief Tests that relations are no longer capped at MAX_VENDORS * MAX_PRODUCTS and that re-adding a pair updates its price.
+ */
+TEST_F(MarketTest, AddVendorProductRelationReplacesPriceTest) {
+    for (int i = 0; i < MAX_VENDORS * MAX_PRODUCTS + 10; i++) {
+        ASSERT_TRUE(addVendorProductRelation(500 + i % 3, 2000 + i, 1.0f));
+    }
+    EXPECT_TRUE(addVendorProductRelation(7, 901, 2.0f));
+    EXPECT_TRUE(addVendorProductRelation(7, 901, 2.5f));
+    EXPECT_TRUE(addVendorProductRelation(7, 902, 0.0f));
+
+    testing::internal::CaptureStdout();
+    EXPECT_TRUE(listProductsByVendor(7));
+    EXPECT_TRUE(listVendorsByProduct(2000 + MAX_VENDORS * MAX_PRODUCTS + 9));
+    std::string output = testing::internal::GetCapturedStdout();
+    EXPECT_NE(output.find("Product ID: 901, Price: 2.50"), std::string::npos);
+    EXPECT_EQ(output.find("Price: 2.00"), std::string::npos);
+    EXPECT_EQ(output.find("Product ID: 902"), std::string::npos);
+    EXPECT_NE(output.find("Vendor ID: 501, Price: 1.00"), std::string::npos);
+}
+
+/**
+ * @test AggregateProductPricesTest
+ * @brief Tests per-product min/max/mean/count over the CSC view, for all products and for a single product.
+ */
+TEST_F(MarketTest, AggregateProductPricesTest) {
+    SparseMatrixBuilder builder;
+    ASSERT_TRUE(initSparseMatrixBuilder(&builder, 0));
+    // Product p is sold by p + 1 vendors at prices p, p + 1, ..., 2p
+    for (int p = 0; p < 40; p++) {
+        for (int v = 0; v <= p; v++) {
+            ASSERT_TRUE(sparseMatrixBuilderAdd(&builder, v, 1000 + p, (float)(p + v)));
+        }
+    }
+    CompressedSparseMatrix columns;
+    ASSERT_TRUE(freezeSparseMatrixBuilder(&builder, SPARSE_BY_PRODUCT, &columns));
+
+    ProductPriceAggregate aggregates[40];
+    ASSERT_EQ(aggregateProductPrices(&columns, aggregates, 40), 40);
+    for (int p = 0; p < 40; p++) {
+        EXPECT_EQ(aggregates[p].productId, 1000 + p);
+        EXPECT_EQ(aggregates[p].count, p + 1);
+        EXPECT_FLOAT_EQ(aggregates[p].minPrice, (float)p);
+        EXPECT_FLOAT_EQ(aggregates[p].maxPrice, (float)(2 * p));
+        EXPECT_FLOAT_EQ(aggregates[p].meanPrice, 1.5f * (float)p);
+    }
+    EXPECT_EQ(aggregateProductPrices(&columns, NULL, 0), 40);
+
+    ProductPriceAggregate single;
+    ASSERT_TRUE(aggregateProductPrice(&columns, 1039, &single));
+    EXPECT_EQ(single.count, 40);
+    EXPECT_FLOAT_EQ(single.maxPrice, 78.0f);
+    EXPECT_FALSE(aggregateProductPrice(&columns, 2000, &single));
+
+    CompressedSparseMatrix rows;
+    ASSERT_TRUE(freezeSparseMatrixBuilder(&builder, SPARSE_BY_VENDOR, &rows));
+    EXPECT_EQ(aggregateProductPrices(&rows, aggregates, 40), -1);
+    freeCompressedSparseMatrix(&rows);
+    freeCompressedSparseMatrix(&columns);
+    freeSparseMatrixBuilder(&builder);
+
+    testing::internal::CaptureStdout();
+    EXPECT_TRUE(addVendorProductRelation(61, 951, 2.0f));
+    EXPECT_TRUE(addVendorProductRelation(62, 951, 4.0f));
+    EXPECT_TRUE(listProductPriceAggregates());
+    std::string output = testing::internal::GetCapturedStdout();
+    EXPECT_NE(output.find("Product ID: 951, Vendors: 2, Min: 2.00, Max: 4.00, Mean: 3.00"), std::string::npos);
+}
+
+/**
+ * @test CompressedSparseMatrixFileTest
+ * @brief Tests writing a matrix file and mapping it back: identical arrays, aligned sections and rejected invalid files.
+ */
+TEST_F(MarketTest, CompressedSparseMatrixFileTest) {
+    const char* path = "test_relations.csr";
+    SparseMatrixBuilder builder;
+    ASSERT_TRUE(initSparseMatrixBuilder(&builder, 0));
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_TRUE(sparseMatrixBuilderAdd(&builder, i % 37, (i * 13) % 101, (float)i / 8.0f));
+    }
+    CompressedSparseMatrix rows;
+    ASSERT_TRUE(freezeSparseMatrixBuilder(&builder, SPARSE_BY_VENDOR, &rows));
+    ASSERT_TRUE(writeCompressedSparseMatrixFile(&rows, path));
+    FILE* temporary = fopen("test_relations.csr.tmp", "rb");
+    EXPECT_EQ(temporary, nullptr);
+    if (temporary != NULL) {fclose(temporary);}
+
+    MappedSparseMatrix mapped;
+    ASSERT_TRUE(mapCompressedSparseMatrixFile(path, &mapped));
+    EXPECT_EQ(mapped.matrix.axis, SPARSE_BY_VENDOR);
+    ASSERT_EQ(mapped.matrix.rowCount, rows.rowCount);
+    ASSERT_EQ(mapped.matrix.entryCount, rows.entryCount);
+    EXPECT_EQ(memcmp(mapped.matrix.rowIds, rows.rowIds, (size_t)rows.rowCount * sizeof(int)), 0);
+    EXPECT_EQ(memcmp(mapped.matrix.rowPointers, rows.rowPointers, ((size_t)rows.rowCount + 1) * sizeof(int)), 0);
+    EXPECT_EQ(memcmp(mapped.matrix.minorIds, rows.minorIds, (size_t)rows.entryCount * sizeof(int)), 0);
+    EXPECT_EQ(memcmp(mapped.matrix.prices, rows.prices, (size_t)rows.entryCount * sizeof(float)), 0);
+    EXPECT_EQ(((uintptr_t)mapped.matrix.prices - (uintptr_t)mapped.address) % SPARSE_MATRIX_FILE_ALIGNMENT, (uintptr_t)0);
+    const int* productIds = NULL;
+    EXPECT_EQ(compressedSparseMatrixRow(&mapped.matrix, 36, &productIds, NULL), compressedSparseMatrixRow(&rows, 36, NULL, NULL));
+    unmapCompressedSparseMatrixFile(&mapped);
+    EXPECT_EQ(mapped.address, nullptr);
+
+    // An empty matrix round-trips as well
+    CompressedSparseMatrix empty;
+    ASSERT_TRUE(buildCompressedSparseMatrix(NULL, 0, SPARSE_BY_PRODUCT, &empty));
+    ASSERT_TRUE(writeCompressedSparseMatrixFile(&empty, path));
+    ASSERT_TRUE(mapCompressedSparseMatrixFile(path, &mapped));
+    EXPECT_EQ(mapped.matrix.axis, SPARSE_BY_PRODUCT);
+    EXPECT_EQ(mapped.matrix.rowCount, 0);
+    EXPECT_EQ(compressedSparseMatrixRow(&mapped.matrix, 1, NULL, NULL), 0);
+    unmapCompressedSparseMatrixFile(&mapped);
+    freeCompressedSparseMatrix(&empty);
+
+    // Truncated files and files of another kind are rejected
+    ASSERT_TRUE(writeCompressedSparseMatrixFile(&rows, path));
+    FILE* file = fopen(path, "r+b");
+    ASSERT_NE(file, nullptr);
+    uint32_t wrongMagic = 0x12345678;
+    fwrite(&wrongMagic, sizeof(wrongMagic), 1, file);
+    fclose(file);
+    EXPECT_FALSE(mapCompressedSparseMatrixFile(path, &mapped));
+    file = fopen(path, "wb");
+    ASSERT_NE(file, nullptr);
+    fwrite("short", 1, 5, file);
+    fclose(file);
+    EXPECT_FALSE(mapCompressedSparseMatrixFile(path, &mapped));
+    EXPECT_FALSE(mapCompressedSparseMatrixFile("missing_relations.csr", &mapped));
+
+    remove(path);
+    freeCompressedSparseMatrix(&rows);
+    freeSparseMatrixBuilder(&builder);
+}
+
+/**
+ * @test LoadVendorProductRelationsTest
+ * @brief Tests saving the relations, loading them back from the mapped file and writing later changes through to it.
+ */
+TEST_F(MarketTest, LoadVendorProductRelationsTest) {
+    const char* path = "test_market_relations.csr";
+    remove(path);
+    ASSERT_TRUE(addVendorProductRelation(71, 981, 6.0f));
+    ASSERT_TRUE(addVendorProductRelation(72, 981, 8.0f));
+    ASSERT_TRUE(saveVendorProductRelations(path));
+
+    // Loading replaces the relations in memory with the saved ones
+    ASSERT_TRUE(loadVendorProductRelations(path));
+    testing::internal::CaptureStdout();
+    EXPECT_TRUE(listVendorsByProduct(981));
+    EXPECT_TRUE(listProductsByVendor(72));
+    std::string output = testing::internal::GetCapturedStdout();
+    EXPECT_NE(output.find("Vendor ID: 71, Price: 6.00"), std::string::npos);
+    EXPECT_NE(output.find("Product ID: 981, Price: 8.00"), std::string::npos);
+
+    // A change after loading copies the relations out of the mapping and is written through to the file
+    ASSERT_TRUE(addVendorProductRelation(73, 981, 9.0f));
+    MappedSparseMatrix mapped;
+    ASSERT_TRUE(mapCompressedSparseMatrixFile(path, &mapped));
+    EXPECT_EQ(compressedSparseMatrixRow(&mapped.matrix, 73, NULL, NULL), 1);
+    unmapCompressedSparseMatrixFile(&mapped);
+    ASSERT_TRUE(addVendorProductRelation(71, 981, 7.0f));
+    ASSERT_TRUE(loadVendorProductRelations(path));
+    testing::internal::CaptureStdout();
+    EXPECT_TRUE(listProductPriceAggregates());
+    output = testing::internal::GetCapturedStdout();
+    EXPECT_NE(output.find("Product ID: 981, Vendors: 3, Min: 7.00, Max: 9.00, Mean: 8.00"), std::string::npos);
+
+    // Once the file is gone, changes stay in memory
+    EXPECT_FALSE(loadVendorProductRelations("missing_relations.csr"));
+    remove(path);
+    ASSERT_TRUE(addVendorProductRelation(74, 982, 1.0f));
+    FILE* file = fopen(path, "rb");
+    EXPECT_EQ(file, nullptr);
+    if (file != NULL) {fclose(file);}
+}
+
+/**
+ * @test ProductPriceStatisticsFollowCatalogTest
+ * @brief Tests that the price statistics are read from products.bin, follow added products and are read again after a delete.
+ */
+TEST_F(MarketTest, ProductPriceStatisticsFollowCatalogTest) {
+    Product products[] = {{1, "Apple", 10.0f, 5, "Fall"}, {2, "Pear", 20.0f, 5, "Fall"}, {1, "Plum", 30.0f, 5, "Summer"}};
+    writeProductsFile(products, 3);
+    resetProductPriceStatistics();
+
+    testing::internal::CaptureStdout();
+    EXPECT_TRUE(showProductPriceStatistics());
+    std::string output = testing::internal::GetCapturedStdout();
+    EXPECT_NE(output.find("Prices: 3"), std::string::npos) << output;
+    EXPECT_NE(output.find("Mean: 20.00"), std::string::npos) << output;
+    EXPECT_NE(output.find("Min: 10.00, Max: 30.00"), std::string::npos) << output;
+
+    // An appended product is fed in; the file is not read again
+    recordProductPrice(40.0f);
+    testing::internal::CaptureStdout();
+    EXPECT_TRUE(showProductPriceStatistics());
+    output = testing::internal::GetCapturedStdout();
+    EXPECT_NE(output.find("Prices: 4"), std::string::npos) << output;
+    EXPECT_NE(output.find("Min: 10.00, Max: 40.00"), std::string::npos) << output;
+
+    // A delete drops the accumulators, and the price comparison menu reads the remaining catalog
+    simulateUserInput("Plum\n");
+    EXPECT_TRUE(deleteProduct());
+    resetStdinStdout();
+    simulateUserInput("7\n\n0\n\n");
+    EXPECT_TRUE(priceComparison());
+    resetStdinStdout();
+    FILE* file = fopen(outputTest, "rb");
+    ASSERT_NE(file, nullptr);
+    char buffer[4096] = { 0 };
+    fread(buffer, sizeof(char), sizeof(buffer) - 1, file);
+    fclose(file);
+    output = buffer;
+    EXPECT_NE(output.find("Prices: 2"), std::string::npos) << output;
+    EXPECT_NE(output.find("Mean: 15.00, Standard deviation: 5.00"), std::string::npos) << output;
+    EXPECT_NE(output.find("Min: 10.00, Max: 20.00"), std::string::npos) << output;
+    resetProductPriceStatistics();
+}
+
+/**
+ * @test SelectProductsByPriceTest
+ * @brief Tests the bounded-heap selection of the cheapest and most expensive offers against a full sort.
+ */
+TEST_F(MarketTest, SelectProductsByPriceTest) {
+    const char* path = "topk_products.bin";
+    std::vector<float> tomatoPrices;
+    FILE* file = fopen(path, "wb");
+    ASSERT_NE(file, nullptr);
+    for (int i = 0; i < 500; i++) {
+        Product product = {i, "Tomato", (float)((i * 7919) % 1013) * 0.25f, 10, "Winter"};
+        if (i % 4 == 3) {strcpy(product.productName, "Apple");}
+        else {tomatoPrices.push_back(product.price);}
+        fwrite(&product, sizeof(Product), 1, file);
+    }
+    fclose(file);
+    std::vector<float> ascending = tomatoPrices;
+    std::sort(ascending.begin(), ascending.end());
+
+    const int sizes[] = {1, 3, 10, 375, 600};
+    for (int s = 0; s < 5; s++) {
+        int k = sizes[s];
+        std::vector<Product> cheapest(k);
+        std::vector<Product> mostExpensive(k);
+        int expected = std::min(k, (int)ascending.size());
+        ASSERT_EQ(selectProductsByPrice(path, "Tomato", k, true, cheapest.data()), expected);
+        ASSERT_EQ(selectProductsByPrice(path, "Tomato", k, false, mostExpensive.data()), expected);
+        for (int i = 0; i < expected; i++) {
+            EXPECT_EQ(cheapest[i].price, ascending[i]) << "k " << k << " rank " << i;
+            EXPECT_EQ(mostExpensive[i].price, ascending[ascending.size() - 1 - i]) << "k " << k << " rank " << i;
+            EXPECT_STREQ(cheapest[i].productName, "Tomato");
+        }
+    }
+
+    Product unused;
+    EXPECT_EQ(selectProductsByPrice(path, "Tomato", 0, true, &unused), 0);
+    EXPECT_EQ(selectProductsByPrice(path, "Pear", 3, true, &unused), 0);
+    EXPECT_EQ(selectProductsByPrice("missing_products.bin", "Tomato", 3, true, &unused), -1);
+    remove(path);
+}
+
+/**
+ * @test SelectProductsByPriceTieTest
+ * @brief Tests that of equally priced offers the one read first is kept.
+ */
+TEST_F(MarketTest, SelectProductsByPriceTieTest) {
+    const char* path = "topk_products.bin";
+    Product products[] = {{1, "Tomato", 20, 10, "Winter"}, {2, "Tomato", 10, 10, "Winter"}, {3, "Tomato", 20, 10, "Winter"},
+                          {4, "Tomato", 30, 10, "Winter"}, {5, "Tomato", 10, 10, "Winter"}};
+    FILE* file = fopen(path, "wb");
+    ASSERT_NE(file, nullptr);
+    fwrite(products, sizeof(Product), 5, file);
+    fclose(file);
+
+    Product selected[2];
+    ASSERT_EQ(selectProductsByPrice(path, "Tomato", 2, true, selected), 2);
+    EXPECT_EQ(selected[0].price, 10.0f);
+    EXPECT_EQ(selected[1].price, 10.0f);
+    ASSERT_EQ(selectProductsByPrice(path, "Tomato", 2, false, selected), 2);
+    EXPECT_EQ(selected[0].vendorId, 4);
+    EXPECT_EQ(selected[1].vendorId, 1);
+    remove(path);
+}
+
+/**
+ * @test ShowBestOffersTest
+ * @brief Tests the cheapest and most expensive offer lists printed for the price comparison menu.
+ */
+TEST_F(MarketTest, ShowBestOffersTest) {
+    Product products[] = {{1, "Tomato", 25, 100, "Winter"}, {2, "Apple", 30, 50, "Fall"}, {3, "Tomato", 12, 40, "Winter"},
+                          {4, "Tomato", 40, 40, "Winter"}, {5, "Tomato", 18, 40, "Winter"}};
+    writeProductsFile(products, 5);
+
+    simulateUserInput("");
+    EXPECT_TRUE(showBestOffers("Tomato", 2));
+    EXPECT_FALSE(showBestOffers("Pear", 2));
+    resetStdinStdout();
+    FILE* file = fopen(outputTest, "rb");
+    ASSERT_NE(file, nullptr);
+    char buffer[1024] = { 0 };
+    fread(buffer, sizeof(char), sizeof(buffer) - 1, file);
+    fclose(file);
+    std::string output = buffer;
+    EXPECT_NE(output.find("--- 2 cheapest of 4 offers for 'Tomato' ---\nVendor ID: 3, Price: 12.00\nVendor ID: 5, Price: 18.00\n"), std::string::npos) << output;
+    EXPECT_NE(output.find("--- 2 most expensive of 4 offers for 'Tomato' ---\nVendor ID: 4, Price: 40.00\nVendor ID: 1, Price: 25.00\n"), std::string::npos) << output;
+    EXPECT_NE(output.find("No prices found for Product Name 'Pear'."), std::string::npos) << output;
+}
+
+/**
+ * @test HeapSortPriceKeysTest
+ * @brief Tests the key heap sort against a stable sort, for every small length and a long input with many
+ *        equal prices.
+ */
+TEST_F(MarketTest, HeapSortPriceKeysTest) {
+    const int lengths[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 15, 16, 17, 100, 5000};
+    for (int l = 0; l < 14; l++) {
+        int n = lengths[l];
+        std::vector<PriceSortKey> keys(n + 1);
+        for (int i = 0; i < n; i++) {
+            keys[i].price = (float)((i * 7919) % 37) * 0.5f;
+            keys[i].index = i;
+        }
+        std::vector<PriceSortKey> expected(keys.begin(), keys.begin() + n);
+        std::stable_sort(expected.begin(), expected.end(), [](const PriceSortKey& a, const PriceSortKey& b) {return a.price < b.price;});
+
+        heapSortPriceKeys(keys.data(), n);
+        for (int i = 0; i < n; i++) {
+            EXPECT_EQ(keys[i].price, expected[i].price) << "length " << n << " position " << i;
+            EXPECT_EQ(keys[i].index, expected[i].index) << "length " << n << " position " << i;
+        }
+    }
+}
+
+/**
+ * @test HeapSortKeepsRecordsTest
+ * @brief Tests that heapSort moves whole records and keeps equally priced records in their original order.
+ */
+TEST_F(MarketTest, HeapSortKeepsRecordsTest) {
+    std::vector<Product> products(300);
+    for (int i = 0; i < 300; i++) {
+        Product product = {i, "", (float)((i * 31) % 17), i * 2, "Winter"};
+        snprintf(product.productName, sizeof(product.productName), "product%d", i);
+        products[i] = product;
+    }
+    heapSort(products.data(), (int)products.size());
+    for (int i = 0; i < 300; i++) {
+        char name[50];
+        snprintf(name, sizeof(name), "product%d", products[i].vendorId);
+        EXPECT_STREQ(products[i].productName, name);
+        EXPECT_EQ(products[i].quantity, products[i].vendorId * 2);
+        EXPECT_EQ(products[i].price, (float)((products[i].vendorId * 31) % 17));
+        if (i > 0) {
+            EXPECT_LE(products[i - 1].price, products[i].price);
+            if (products[i - 1].price == products[i].price) {EXPECT_LT(products[i - 1].vendorId, products[i].vendorId);}
+        }
+    }
+}
+
+/**
+ * @test ComparePricesByNameManyOffersTest
+ * @brief Tests the price comparison with more offers than the former fixed array of 100 products could hold.
+ */
+TEST_F(MarketTest, ComparePricesByNameManyOffersTest) {
+    std::vector<Product> products;
+    for (int i = 0; i < 250; i++) {
+        Product product = {i, "Tomato", (float)(250 - i), 10, "Winter"};
+        if (i % 5 == 0) {strcpy(product.productName, "Apple");}
+        products.push_back(product);
+    }
+    writeProductsFile(products.data(), (int)products.size());
+
+    simulateUserInput("\n");
+    EXPECT_TRUE(comparePricesByName("Tomato"));
+    resetStdinStdout();
+    FILE* file = fopen(outputTest, "rb");
+    ASSERT_NE(file, nullptr);
+    std::string output;
+    char buffer[1024];
+    size_t bytes;
+    while ((bytes = fread(buffer, 1, sizeof(buffer), file)) > 0) {output.append(buffer, bytes);}
+    fclose(file);
+
+    EXPECT_NE(output.find("(Sorted by Price) ---\nVendor ID: 249, Price: 1.00\nVendor ID: 248, Price: 2.00\n"), std::string::npos);
+    EXPECT_NE(output.find("Vendor ID: 1, Price: 249.00\n\nLowest Price: 1.00\nHighest Price: 249.00\n"), std::string::npos);
+    EXPECT_NE(output.find("Average Price: 125.00"), std::string::npos);
+    EXPECT_NE(output.find("Median Price: 125.00"), std::string::npos);
+}
+
+/**
+ * @test OrderedPriceBitsTest
+ * @brief Tests that the integer price keys order like the prices, across zero and for negative prices.
+ */
+TEST_F(MarketTest, OrderedPriceBitsTest) {
+    const float prices[] = {-1000.5f, -2.0f, -0.25f, 0.0f, 1e-30f, 0.25f, 2.0f, 19.99f, 20.0f, 1e30f};
+    for (int i = 0; i + 1 < 10; i++) {
+        EXPECT_LT(orderedPriceBits(prices[i]), orderedPriceBits(prices[i + 1])) << prices[i] << " < " << prices[i + 1];
+    }
+}
+
+/**
+ * @test SortProductCatalogTest
+ * @brief Tests the parallel catalog sort for every order and several thread counts against a stable sort of
+ *        the records, on a catalog above the parallel threshold with many equal keys and shared name prefixes.
+ */
+TEST_F(MarketTest, SortProductCatalogTest) {
+    const int count = PARALLEL_SORT_THRESHOLD + 12345;
+    const char* names[] = {"Tomato", "Tomatoes", "TomatoesRed", "TomatoesGreen", "Apple", "", "Zucchini"};
+    std::vector<Product> products(count);
+    unsigned int state = 99u;
+    for (int i = 0; i < count; i++) {
+        state = state * 1103515245u + 12345u;
+        memset(&products[i], 0, sizeof(Product));
+        products[i].vendorId = (int)((state >> 16) % 200) - 20;
+        products[i].price = (float)((state >> 4) % 400) * 0.5f - 10.0f;
+        strcpy(products[i].productName, names[(state >> 12) % 7]);
+    }
+
+    for (int order = PRODUCT_SORT_BY_PRICE; order <= PRODUCT_SORT_BY_VENDOR; order++) {
+        std::vector<int> expected(count);
+        for (int i = 0; i < count; i++) {expected[i] = i;}
+        std::stable_sort(expected.begin(), expected.end(), [&](int a, int b) {
+            const Product& left = products[a];
+            const Product& right = products[b];
+            if (order == PRODUCT_SORT_BY_NAME) {
+                int byName = strcmp(left.productName, right.productName);
+                if (byName != 0) {return byName < 0;}
+            }
+            if (order == PRODUCT_SORT_BY_VENDOR && left.vendorId != right.vendorId) {return left.vendorId < right.vendorId;}
+            return left.price < right.price;
+        });
+
+        const int threadCounts[] = {1, 2, 3, 4, 7, 0};
+        for (int t = 0; t < 6; t++) {
+            std::vector<int> sorted(count, -1);
+            ASSERT_TRUE(sortProductCatalog(products.data(), count, (ProductSortOrder)order, threadCounts[t], sorted.data()));
+            EXPECT_TRUE(sorted == expected) << "order " << order << " threads " << threadCounts[t];
+        }
+    }
+
+    int small[3];
+    EXPECT_TRUE(sortProductCatalog(products.data(), 3, PRODUCT_SORT_BY_PRICE, 4, small));
+    EXPECT_TRUE(sortProductCatalog(NULL, 0, PRODUCT_SORT_BY_PRICE, 4, NULL));
+    EXPECT_FALSE(sortProductCatalog(NULL, 3, PRODUCT_SORT_BY_PRICE, 4, small));
+}
+
+/**
+ * @test WriteSortedProductReportTest
+ * @brief Tests the sorted catalog report read back from its file.
+ */
+TEST_F(MarketTest, WriteSortedProductReportTest) {
+    const char* path = "report_products.bin";
+    const char* reportPath = "report_products.txt";
+    Product products[] = {{2, "Tomato", 25, 100, "Winter"}, {1, "Apple", 30, 50, "Fall"}, {3, "Pear", 12, 40, "Fall"}};
+    FILE* file = fopen(path, "wb");
+    ASSERT_NE(file, nullptr);
+    fwrite(products, sizeof(Product), 3, file);
+    fclose(file);
+
+    Product* loaded = NULL;
+    ASSERT_EQ(loadProductCatalog(path, &loaded), 3);
+    EXPECT_STREQ(loaded[2].productName, "Pear");
+    free(loaded);
+    EXPECT_EQ(loadProductCatalog("missing_products.bin", &loaded), -1);
+
+    ASSERT_TRUE(writeSortedProductReport(path, PRODUCT_SORT_BY_VENDOR, 0, reportPath));
+    std::ifstream report(reportPath);
+    std::stringstream contents;
+    contents << report.rdbuf();
+    report.close();
+    EXPECT_EQ(contents.str(), "--- 3 products sorted by vendor ---\n"
+                              "1. Vendor ID: 1, Name: Apple, Price: 30.00, Quantity: 50, Season: Fall\n"
+                              "2. Vendor ID: 2, Name: Tomato, Price: 25.00, Quantity: 100, Season: Winter\n"
+                              "3. Vendor ID: 3, Name: Pear, Price: 12.00, Quantity: 40, Season: Fall\n");
+
+    ASSERT_TRUE(writeSortedProductReport(path, PRODUCT_SORT_BY_PRICE, 0, reportPath));
+    report.open(reportPath);
+    std::string line;
+    std::getline(report, line);
+    std::getline(report, line);
+    EXPECT_EQ(line, "1. Vendor ID: 3, Name: Pear, Price: 12.00, Quantity: 40, Season: Fall");
+    report.close();
+
+    EXPECT_FALSE(writeSortedProductReport("missing_products.bin", PRODUCT_SORT_BY_PRICE, 0, reportPath));
+    remove(path);
+    remove(reportPath);
+
+    // The product menu writes the report of products.bin in the chosen order
+    writeProductsFile(products, 3);
+    simulateUserInput("5\n1\n\n0\n");
+    EXPECT_TRUE(listingOfLocalProducts());
+    resetStdinStdout();
+    report.open(SORTED_PRODUCT_REPORT_FILE);
+    std::getline(report, line);
+    EXPECT_EQ(line, "--- 3 products sorted by name ---");
+    std::getline(report, line);
+    EXPECT_EQ(line, "1. Vendor ID: 1, Name: Apple, Price: 30.00, Quantity: 50, Season: Fall");
+    report.close();
+    remove(SORTED_PRODUCT_REPORT_FILE);
+}
+
+/**
+ * @test RadixSortPriceKeysTest
+ * @brief Tests the radix sort against the key heap sort for short and long inputs, negative prices, prices
+ *        that differ in one byte only and constant prices.
+ */
+TEST_F(MarketTest, RadixSortPriceKeysTest) {
+    const int lengths[] = {0, 1, 2, 255, 256, 257, 1000, 70000};
+    for (int l = 0; l < 8; l++) {
+        int n = lengths[l];
+        for (int pattern = 0; pattern < 4; pattern++) {
+            std::vector<PriceSortKey> keys(n + 1);
+            unsigned int state = 3u + (unsigned int)pattern;
+            for (int i = 0; i < n; i++) {
+                state = state * 1664525u + 1013904223u;
+                switch (pattern) {
+                case 0: keys[i].price = (float)((state >> 8) % 100000) * 0.01f; break;
+                case 1: keys[i].price = (float)((int)((state >> 8) % 2001) - 1000) * 0.5f + 0.25f; break;
+                case 2: keys[i].price = 1.0f + (float)((state >> 8) % 256) / 8388608.0f; break;
+                default: keys[i].price = 9.99f; break;
+                }
+                keys[i].index = i;
+            }
+            std::vector<PriceSortKey> expected = keys;
+            heapSortPriceKeys(expected.data(), n);
+            radixSortPriceKeys(keys.data(), n);
+            for (int i = 0; i < n; i++) {
+                ASSERT_EQ(keys[i].price, expected[i].price) << "length " << n << " pattern " << pattern << " position " << i;
+                ASSERT_EQ(keys[i].index, expected[i].index) << "length " << n << " pattern " << pattern << " position " << i;
+            }
+        }
+    }
+}
+
+/**
+ * @test ProductPriceSummaryFileTest
+ * @brief Tests building, growing, looking up and removing summaries against brute-force summaries of the
+ *        same offers.
+ */
+TEST_F(MarketTest, ProductPriceSummaryFileTest) {
+    const char* productsPath = "summary_products.bin";
+    const char* summaryPath = "summary_products.sum";
+    remove(summaryPath);
+    std::map<std::string, std::vector<Product> > offers;
+    FILE* file = fopen(productsPath, "wb");
+    ASSERT_NE(file, nullptr);
+    for (int i = 0; i < 3000; i++) {
+        Product product = {i % 97, "", (float)((i * 7919) % 1000) * 0.5f + 1.0f, 10, "Winter"};
+        snprintf(product.productName, sizeof(product.productName), "product%d", (i * 31) % 150);
+        fwrite(&product, sizeof(Product), 1, file);
+        offers[product.productName].push_back(product);
+    }
+    fclose(file);
+
+    EXPECT_FALSE(findProductPriceSummary(summaryPath, "product1", NULL));
+    EXPECT_TRUE(addToProductPriceSummaries(summaryPath, &offers["product1"][0]));
+    ASSERT_TRUE(openProductPriceSummaries(summaryPath, productsPath));
+
+    // Offers added later, including enough new names to grow the table twice
+    for (int i = 0; i < 400; i++) {
+        Product product = {1000 + i, "", (float)(i % 50) + 0.25f, 5, "Summer"};
+        snprintf(product.productName, sizeof(product.productName), "product%d", i % 2 == 0 ? i % 150 : 150 + i);
+        ASSERT_TRUE(addToProductPriceSummaries(summaryPath, &product));
+        offers[product.productName].push_back(product);
+    }
+    ASSERT_TRUE(removeFromProductPriceSummaries(summaryPath, "product7"));
+    ASSERT_TRUE(removeFromProductPriceSummaries(summaryPath, "product161"));
+    ASSERT_TRUE(removeFromProductPriceSummaries(summaryPath, "product-missing"));
+    offers.erase("product7");
+    offers.erase("product161");
+
+    for (std::map<std::string, std::vector<Product> >::const_iterator it = offers.begin(); it != offers.end(); ++it) {
+        const std::vector<Product>& list = it->second;
+        int minIndex = 0;
+        int maxIndex = 0;
+        double sum = 0.0;
+        for (size_t i = 0; i < list.size(); i++) {
+            if (list[i].price < list[minIndex].price) {minIndex = (int)i;}
+            if (list[i].price > list[maxIndex].price) {maxIndex = (int)i;}
+            sum += list[i].price;
+        }
+        ProductPriceSummary summary;
+        ASSERT_TRUE(findProductPriceSummary(summaryPath, it->first.c_str(), &summary)) << it->first;
+        EXPECT_EQ(summary.count, (int)list.size()) << it->first;
+        EXPECT_EQ(summary.minPrice, list[minIndex].price) << it->first;
+        EXPECT_EQ(summary.minVendorId, list[minIndex].vendorId) << it->first;
+        EXPECT_EQ(summary.maxPrice, list[maxIndex].price) << it->first;
+        EXPECT_EQ(summary.maxVendorId, list[maxIndex].vendorId) << it->first;
+        EXPECT_NEAR(summary.priceSum, sum, 1e-6) << it->first;
+    }
+    ProductPriceSummary summary;
+    EXPECT_FALSE(findProductPriceSummary(summaryPath, "product7", &summary));
+    EXPECT_FALSE(findProductPriceSummary(summaryPath, "product161", &summary));
+
+    // A removed name can come back, reusing its deleted slot
+    Product returning = {5, "product7", 3.5f, 1, "Spring"};
+    ASSERT_TRUE(addToProductPriceSummaries(summaryPath, &returning));
+    ASSERT_TRUE(findProductPriceSummary(summaryPath, "product7", &summary));
+    EXPECT_EQ(summary.count, 1);
+    EXPECT_EQ(summary.minVendorId, 5);
+
+    remove(productsPath);
+    remove(summaryPath);
+}
+
+/**
+ * @test ProductPriceSummaryFollowsProductChangesTest
+ * @brief Tests that addProduct, updateProduct and deleteProduct keep the price summaries in step, and the
+ *        price summary shown for the price comparison.
+ */
+TEST_F(MarketTest, ProductPriceSummaryFollowsProductChangesTest) {
+    remove(PRODUCT_PRICE_SUMMARY_FILE);
+    Product products[] = {{1, "Tomato", 25, 100, "Winter"}, {2, "Apple", 30, 50, "Fall"}, {3, "Tomato", 12, 40, "Winter"}};
+    writeProductsFile(products, 3);
+    Vendor vendors[] = {{1, "Vendor1"}, {2, "Vendor2"}};
+    writeVendorsFile(vendors, 2);
+
+    simulateUserInput("");
+    EXPECT_TRUE(showPriceSummary("Tomato"));
+    resetStdinStdout();
+    FILE* file = fopen(outputTest, "rb");
+    ASSERT_NE(file, nullptr);
+    char buffer[1024] = { 0 };
+    fread(buffer, sizeof(char), sizeof(buffer) - 1, file);
+    fclose(file);
+    EXPECT_NE(strstr(buffer, "Offers: 2\nLowest Price: 12.00 (Vendor ID: 3)\nHighest Price: 25.00 (Vendor ID: 1)\nAverage Price: 18.50\n"), nullptr) << buffer;
+
+    simulateUserInput("1\nTomato\n8\n20\nSpring\n\n\n");
+    EXPECT_TRUE(addProduct());
+    resetStdinStdout();
+    ProductPriceSummary summary;
+    ASSERT_TRUE(findProductPriceSummary(PRODUCT_PRICE_SUMMARY_FILE, "Tomato", &summary));
+    EXPECT_EQ(summary.count, 3);
+    EXPECT_EQ(summary.minPrice, 8.0f);
+    EXPECT_EQ(summary.minVendorId, 1);
+
+    simulateUserInput("Apple\nTomato\n40\n5\nFall\n\n\n");
+    EXPECT_TRUE(updateProduct());
+    resetStdinStdout();
+    EXPECT_FALSE(findProductPriceSummary(PRODUCT_PRICE_SUMMARY_FILE, "Apple", &summary));
+    ASSERT_TRUE(findProductPriceSummary(PRODUCT_PRICE_SUMMARY_FILE, "Tomato", &summary));
+    EXPECT_EQ(summary.count, 4);
+    EXPECT_EQ(summary.maxPrice, 40.0f);
+    EXPECT_EQ(summary.maxVendorId, 2);
+    EXPECT_NEAR(summary.priceSum, 85.0, 1e-9);
+
+    simulateUserInput("Tomato\n\n\n");
+    EXPECT_TRUE(deleteProduct());
+    resetStdinStdout();
+    EXPECT_FALSE(findProductPriceSummary(PRODUCT_PRICE_SUMMARY_FILE, "Tomato", &summary));
+
+    remove(PRODUCT_PRICE_SUMMARY_FILE);
+}
+
+/**
+ * @test WritePriceComparisonReportTest
+ * @brief Tests the catalog-wide price comparison report: names in order, offers sorted by price with equal
+ *        prices in file order, and the statistics of every name.
+ */
+TEST_F(MarketTest, WritePriceComparisonReportTest) {
+    const char* path = "report_products.bin";
+    const char* reportPath = "report_prices.txt";
+    Product products[] = {{1, "Tomato", 25, 100, "Winter"}, {2, "Apple", 30, 50, "Fall"}, {3, "Tomato", 12, 40, "Winter"},
+                          {4, "Pear", 8, 10, "Fall"}, {5, "Tomato", 25, 10, "Winter"}, {6, "Apple", 20, 5, "Fall"}};
+    FILE* file = fopen(path, "wb");
+    ASSERT_NE(file, nullptr);
+    fwrite(products, sizeof(Product), 6, file);
+    fclose(file);
+
+    ASSERT_TRUE(writePriceComparisonReport(path, reportPath));
+    std::ifstream report(reportPath);
+    std::stringstream contents;
+    contents << report.rdbuf();
+    report.close();
+    EXPECT_EQ(contents.str(), "--- Price Comparison for Product Name 'Apple' (Sorted by Price) ---\n"
+                              "Vendor ID: 6, Price: 20.00\n"
+                              "Vendor ID: 2, Price: 30.00\n"
+                              "Lowest Price: 20.00\nHighest Price: 30.00\nAverage Price: 25.00\nMedian Price: 25.00\n\n"
+                              "--- Price Comparison for Product Name 'Pear' (Sorted by Price) ---\n"
+                              "Vendor ID: 4, Price: 8.00\n"
+                              "Lowest Price: 8.00\nHighest Price: 8.00\nAverage Price: 8.00\nMedian Price: 8.00\n\n"
+                              "--- Price Comparison for Product Name 'Tomato' (Sorted by Price) ---\n"
+                              "Vendor ID: 3, Price: 12.00\n"
+                              "Vendor ID: 1, Price: 25.00\n"
+                              "Vendor ID: 5, Price: 25.00\n"
+                              "Lowest Price: 12.00\nHighest Price: 25.00\nAverage Price: 20.67\nMedian Price: 25.00\n\n");
+
+    EXPECT_FALSE(writePriceComparisonReport("missing_products.bin", reportPath));
+    remove(path);
+    remove(reportPath);
+}
+
+/**
+ * @test WritePriceComparisonReportLargeGroupsTest
+ * @brief Tests a catalog with groups large enough for the radix sort against comparePricesByName's order.
+ */
+TEST_F(MarketTest, WritePriceComparisonReportLargeGroupsTest) {
+    const char* path = "report_products.bin";
+    const char* reportPath = "report_prices.txt";
+    std::vector<std::pair<float, int> > tomatoOffers;
+    FILE* file = fopen(path, "wb");
+    ASSERT_NE(file, nullptr);
+    for (int i = 0; i < 2000; i++) {
+        Product product = {i, "", (float)((i * 7919) % 300) * 0.5f, 1, "Winter"};
+        strcpy(product.productName, i % 3 == 0 ? "Apple" : "Tomato");
+        if (i % 3 != 0) {tomatoOffers.push_back(std::make_pair(product.price, i));}
+        fwrite(&product, sizeof(Product), 1, file);
+    }
+    fclose(file);
+    std::stable_sort(tomatoOffers.begin(), tomatoOffers.end(), [](const std::pair<float, int>& a, const std::pair<float, int>& b) {return a.first < b.first;});
+
+    ASSERT_TRUE(writePriceComparisonReport(path, reportPath));
+    std::ifstream report(reportPath);
+    std::string line;
+    while (std::getline(report, line) && line.find("'Tomato'") == std::string::npos) {}
+    for (size_t i = 0; i < tomatoOffers.size(); i++) {
+        ASSERT_TRUE(std::getline(report, line));
+        char expected[64];
+        snprintf(expected, sizeof(expected), "Vendor ID: %d, Price: %.2f", tomatoOffers[i].second, tomatoOffers[i].first);
+        ASSERT_EQ(line, expected) << "offer " << i;
+    }
+    ASSERT_TRUE(std::getline(report, line));
+    char lowest[64];
+    snprintf(lowest, sizeof(lowest), "Lowest Price: %.2f", tomatoOffers.front().first);
+    EXPECT_EQ(line, lowest);
+    report.close();
+    remove(path);
+    remove(reportPath);
+}
+
+/**
+ * @test KMPPatternTest
+ * @brief Tests compiled KMP patterns against strstr on texts over a two-letter alphabet, where partial
+ *        matches overlap a lot, and a text that is not zero terminated.
+ */
+TEST_F(MarketTest, KMPPatternTest) {
+    KMPPattern compiled;
+    ASSERT_TRUE(compileKMPPattern("abab", &compiled));
+    EXPECT_EQ(compiled.length, 4);
+    EXPECT_EQ(compiled.lps[0], 0);
+    EXPECT_EQ(compiled.lps[1], 0);
+    EXPECT_EQ(compiled.lps[2], 1);
+    EXPECT_EQ(compiled.lps[3], 2);
+    const char unterminated[6] = {'x', 'a', 'b', 'a', 'b', 'a'};
+    EXPECT_EQ(findKMPPattern(&compiled, unterminated, 6), 1);
+    EXPECT_EQ(findKMPPattern(&compiled, unterminated, 4), -1);
+    freeKMPPattern(&compiled);
+    EXPECT_EQ(compiled.lps, nullptr);
+
+    ASSERT_TRUE(compileKMPPattern("", &compiled));
+    EXPECT_EQ(findKMPPattern(&compiled, "tomato", 6), 0);
+    freeKMPPattern(&compiled);
+    EXPECT_FALSE(compileKMPPattern(NULL, &compiled));
+
+    srand(13);
+    for (int round = 0; round < 2000; round++) {
+        char pattern[8];
+        char text[40];
+        int patternLength = 1 + rand() % 6;
+        int textLength = rand() % 39;
+        for (int i = 0; i < patternLength; i++) {pattern[i] = rand() % 2 ? 'a' : 'b';}
+        for (int i = 0; i < textLength; i++) {text[i] = rand() % 2 ? 'a' : 'b';}
+        pattern[patternLength] = '\0';
+        text[textLength] = '\0';
+
+        ASSERT_TRUE(compileKMPPattern(pattern, &compiled));
+        const char* expected = strstr(text, pattern);
+        EXPECT_EQ(findKMPPattern(&compiled, text, textLength), expected != NULL ? (int)(expected - text) : -1) << pattern << " in " << text;
+        EXPECT_EQ(KMPSearch(pattern, text), expected != NULL);
+        freeKMPPattern(&compiled);
+    }
+}
+
+/**
+ * @test KeywordAutomatonTest
+ * @brief Tests the keyword automaton on overlapping keywords, where some keywords are suffixes of others, and
+ *        against strstr on random texts over a small alphabet.
+ */
+TEST_F(MarketTest, KeywordAutomatonTest) {
+    const char* keywords[] = {"he", "she", "his", "hers"};
+    KeywordAutomaton automaton;
+    ASSERT_TRUE(buildKeywordAutomaton(keywords, 4, &automaton));
+    KeywordMatch matches[8];
+    uint64_t found = 0;
+    ASSERT_EQ(findKeywords(&automaton, "ushers", 6, matches, 8, &found), 3);
+    EXPECT_EQ(matches[0].keyword, 0);
+    EXPECT_EQ(matches[0].offset, 2);
+    EXPECT_EQ(matches[1].keyword, 1);
+    EXPECT_EQ(matches[1].offset, 1);
+    EXPECT_EQ(matches[2].keyword, 3);
+    EXPECT_EQ(matches[2].offset, 2);
+    EXPECT_EQ(found, 0xBu);
+    EXPECT_TRUE(keywordsSatisfied(&automaton, found, KEYWORD_MATCH_ANY));
+    EXPECT_FALSE(keywordsSatisfied(&automaton, found, KEYWORD_MATCH_ALL));
+    EXPECT_EQ(findKeywords(&automaton, "ushers his", 10, NULL, 0, &found), 0);
+    EXPECT_TRUE(keywordsSatisfied(&automaton, found, KEYWORD_MATCH_ALL));
+    freeKeywordAutomaton(&automaton);
+
+    const char* empty[] = {"apple", ""};
+    EXPECT_FALSE(buildKeywordAutomaton(empty, 2, &automaton));
+    EXPECT_FALSE(buildKeywordAutomaton(empty, 0, &automaton));
+
+    srand(29);
+    for (int round = 0; round < 300; round++) {
+        char keywordText[6][5];
+        const char* roundKeywords[6];
+        int keywordCount = 1 + rand() % 6;
+        for (int k = 0; k < keywordCount; k++) {
+            int length = 1 + rand() % 4;
+            for (int i = 0; i < length; i++) {keywordText[k][i] = "abc"[rand() % 3];}
+            keywordText[k][length] = '\0';
+            roundKeywords[k] = keywordText[k];
+        }
+        char text[41];
+        int textLength = rand() % 41;
+        for (int i = 0; i < textLength; i++) {text[i] = "abc"[rand() % 3];}
+        text[textLength] = '\0';
+
+        ASSERT_TRUE(buildKeywordAutomaton(roundKeywords, keywordCount, &automaton));
+        KeywordMatch roundMatches[256];
+        int matchCount = findKeywords(&automaton, text, textLength, roundMatches, 256, &found);
+        int expectedCount = 0;
+        for (int k = 0; k < keywordCount; k++) {
+            const char* first = strstr(text, roundKeywords[k]);
+            EXPECT_EQ((found >> k) & 1, first != NULL ? 1u : 0u) << roundKeywords[k] << " in " << text;
+            for (const char* at = first; at != NULL; at = strstr(at + 1, roundKeywords[k])) {expectedCount++;}
+        }
+        EXPECT_EQ(matchCount, expectedCount) << text;
+        for (int m = 0; m < matchCount; m++) {
+            EXPECT_EQ(strncmp(text + roundMatches[m].offset, roundKeywords[roundMatches[m].keyword], strlen(roundKeywords[roundMatches[m].keyword])), 0);
+        }
+        freeKeywordAutomaton(&automaton);
+    }
+}
+
+/**
+ * @test SplitKeywordQueryTest
+ * @brief Tests splitting queries into keywords for all and any matches.
+ */
+TEST_F(MarketTest, SplitKeywordQueryTest) {
+    char query[] = "  apple organic\tsummer ";
+    char* keywords[4];
+    KeywordMatchMode mode;
+    ASSERT_EQ(splitKeywordQuery(query, keywords, 4, &mode), 3);
+    EXPECT_EQ(mode, KEYWORD_MATCH_ALL);
+    EXPECT_STREQ(keywords[0], "apple");
+    EXPECT_STREQ(keywords[2], "summer");
+
+    char alternatives[] = "apple | pear|plum";
+    ASSERT_EQ(splitKeywordQuery(alternatives, keywords, 2, &mode), 2);
+    EXPECT_EQ(mode, KEYWORD_MATCH_ANY);
+    EXPECT_STREQ(keywords[1], "pear");
+}
+
+/**
+ * @test EnterKeywordsMultipleTest
+ * @brief Tests that a multi-keyword query lists only the records containing every keyword, with match offsets,
+ *        and that alternatives list records containing any of them.
+ */
+TEST_F(MarketTest, EnterKeywordsMultipleTest) {
+    Product products[] = {{1, "Tomato", 25, 100, "Winter"}, {2, "Apple", 30, 50, "Summer"}, {1, "Apple", 20, 5, "Fall"}};
+    writeProductsFile(products, 3);
+    Vendor vendors[] = {{1, "Vendor1"}, {2, "Vendor2"}};
+    writeVendorsFile(vendors, 2);
+
+    simulateUserInput("Apple Summer\n\n\nTomato | Vendor2\n\n\n");
+    EXPECT_TRUE(enterKeywords());
+    EXPECT_TRUE(enterKeywords());
+    resetStdinStdout();
+    FILE* file = fopen(outputTest, "rb");
+    ASSERT_NE(file, nullptr);
+    char buffer[4096] = { 0 };
+    fread(buffer, sizeof(char), sizeof(buffer) - 1, file);
+    fclose(file);
+    std::string output = buffer;
+    EXPECT_NE(output.find("Match found: Product: Apple, Season: Summer, Vendor ID: 2, Price: 30.00, Quantity: 50\n"
+                          "    'Apple' at offset 9\n    'Summer' at offset 24\n"), std::string::npos) << output;
+    EXPECT_EQ(output.find("Match found: Product: Apple, Season: Fall"), std::string::npos) << output;
+    EXPECT_NE(output.find("Match found: Product: Tomato"), std::string::npos) << output;
+    EXPECT_NE(output.find("Match found: Vendor: Vendor2, ID: 2\n    'Vendor2' at offset 8\n"), std::string::npos) << output;
+    EXPECT_EQ(output.find("Match found: Vendor: Vendor1"), std::string::npos) << output;
+
+    // Every occurrence is listed, however many a description holds
+    char* many[] = {(char*)"a", (char*)"aa"};
+    KeywordAutomaton automaton;
+    ASSERT_TRUE(buildKeywordAutomaton(many, 2, &automaton));
+    simulateUserInput("");
+    EXPECT_TRUE(printKeywordMatches(&automaton, many, KEYWORD_MATCH_ALL, "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"));
+    resetStdinStdout();
+    freeKeywordAutomaton(&automaton);
+    file = fopen(outputTest, "rb");
+    ASSERT_NE(file, nullptr);
+    memset(buffer, 0, sizeof(buffer));
+    fread(buffer, sizeof(char), sizeof(buffer) - 1, file);
+    fclose(file);
+    output = buffer;
+    size_t offsetLines = 0;
+    for (size_t at = output.find(" at offset "); at != std::string::npos; at = output.find(" at offset ", at + 1)) {offsetLines++;}
+    EXPECT_EQ(offsetLines, 59u) << output;
+    EXPECT_NE(output.find("'aa' at offset 28\n"), std::string::npos) << output;
+}
+
+/**
+ * @test EnterKeywordsFieldsTest
+ * @brief Tests that keywords are looked for in the whole product and vendor descriptions, labels, vendor IDs,
+ *        prices and quantities included, and that the search index only narrows the records to read for
+ *        keywords that can occur nowhere but in the indexed names and seasons.
+ */
+TEST_F(MarketTest, EnterKeywordsFieldsTest) {
+    Product products[] = {{1, "Tomato", 25, 100, "Winter"}, {2, "Apple", 30, 50, "Summer"}, {1, "Apple", 20, 5, "Fall"}};
+    writeProductsFile(products, 3);
+    Vendor vendors[] = {{1, "Vendor1"}, {2, "Vendor2"}};
+    writeVendorsFile(vendors, 2);
+    remove(SEARCH_INDEX_FILE);
+
+    // Labels, vendor IDs, prices and quantities match as well as names and seasons
+    simulateUserInput("30.00\n\n\nID:\n\n\nppl 5\n\n\nppl mm\n\n\n");
+    EXPECT_TRUE(enterKeywords());
+    EXPECT_TRUE(enterKeywords());
+    EXPECT_TRUE(enterKeywords());
+    EXPECT_TRUE(enterKeywords());
+    resetStdinStdout();
+    FILE* file = fopen(outputTest, "rb");
+    ASSERT_NE(file, nullptr);
+    char buffer[8192] = { 0 };
+    fread(buffer, sizeof(char), sizeof(buffer) - 1, file);
+    fclose(file);
+    std::vector<std::string> searches;
+    std::string output = buffer;
+    for (size_t at = output.find("Enter keywords"); at != std::string::npos;) {
+        size_t next = output.find("Enter keywords", at + 1);
+        searches.push_back(output.substr(at, next == std::string::npos ? std::string::npos : next - at));
+        at = next;
+    }
+    ASSERT_EQ(searches.size(), 4u) << output;
+    const char* expected[4][4] = {
+        {"Product: Apple, Season: Summer", NULL},
+        {"Product: Tomato", "Product: Apple, Season: Summer", "Product: Apple, Season: Fall", "Vendor: Vendor1"},
+        {"Product: Apple, Season: Summer", "Product: Apple, Season: Fall", NULL},
+        {"Product: Apple, Season: Summer", NULL}};
+    const int expectedCount[4] = {1, 5, 2, 1};
+    for (int s = 0; s < 4; s++) {
+        size_t matchCount = 0;
+        for (size_t at = searches[s].find("Match found: "); at != std::string::npos; at = searches[s].find("Match found: ", at + 1)) {matchCount++;}
+        EXPECT_EQ(matchCount, (size_t)expectedCount[s]) << searches[s];
+        for (int m = 0; m < 4 && expected[s][m] != NULL; m++) {
+            EXPECT_NE(searches[s].find(std::string("Match found: ") + expected[s][m]), std::string::npos) << searches[s];
+        }
+    }
+    EXPECT_NE(searches[0].find("'30.00' at offset 53\n"), std::string::npos) << searches[0];
+
+    // Only keywords without label or number characters are looked up in the index
+    const SearchField productFields[2] = {SEARCH_FIELD_PRODUCT_NAME, SEARCH_FIELD_SEASON};
+    char* both[2] = {(char*)"ppl", (char*)"mm"};
+    char* mixed[2] = {(char*)"ppl", (char*)"5"};
+    uint32_t* records = NULL;
+    EXPECT_EQ(searchKeywordCandidates(productFields, 2, both, 2, KEYWORD_MATCH_ALL, PRODUCT_INFO_UNINDEXED_CHARACTERS, &records), 1);
+    free(records);
+    EXPECT_EQ(searchKeywordCandidates(productFields, 2, mixed, 2, KEYWORD_MATCH_ALL, PRODUCT_INFO_UNINDEXED_CHARACTERS, &records), 2);
+    free(records);
+    EXPECT_EQ(searchKeywordCandidates(productFields, 2, mixed, 2, KEYWORD_MATCH_ANY, PRODUCT_INFO_UNINDEXED_CHARACTERS, &records), -1);
+    EXPECT_EQ(searchKeywordCandidates(productFields, 2, mixed + 1, 1, KEYWORD_MATCH_ALL, PRODUCT_INFO_UNINDEXED_CHARACTERS, &records), -1);
+    remove(SEARCH_INDEX_FILE);
+}
+
+/**
+ * @test PostingListCodingTest
+ * @brief Tests that posting lists survive encoding with small and large gaps, that damaged encodings are
+ *        rejected, and the posting list intersection against std::set_intersection.
+ */
+TEST_F(MarketTest, PostingListCodingTest) {
+    const uint32_t records[] = {0, 1, 127, 128, 16511, 16512, 2000000, 4294967295u};
+    uint8_t bytes[5 * 8];
+    size_t length = encodePostingList(records, 8, bytes);
+    EXPECT_EQ(bytes[0], 0u);
+    EXPECT_EQ(bytes[1], 1u);
+    EXPECT_EQ(bytes[2], 126u);
+    uint32_t decoded[8];
+    ASSERT_EQ(decodePostingList(bytes, length, decoded, 8), 8);
+    for (int i = 0; i < 8; i++) {EXPECT_EQ(decoded[i], records[i]);}
+    EXPECT_EQ(decodePostingList(bytes, length, decoded, 7), -1);
+    EXPECT_EQ(decodePostingList(bytes, length - 1, decoded, 8), -1);
+    EXPECT_EQ(decodePostingList(bytes, 0, decoded, 8), 0);
+
+    srand(41);
+    for (int round = 0; round < 200; round++) {
+        std::vector<uint32_t> first;
+        std::vector<uint32_t> second;
+        int firstCount = rand() % 50;
+        int secondCount = rand() % 500;
+        for (int i = 0; i < firstCount; i++) {first.push_back((uint32_t)(rand() % 1000));}
+        for (int i = 0; i < secondCount; i++) {second.push_back((uint32_t)(rand() % 1000));}
+        std::sort(first.begin(), first.end());
+        first.erase(std::unique(first.begin(), first.end()), first.end());
+        std::sort(second.begin(), second.end());
+        second.erase(std::unique(second.begin(), second.end()), second.end());
+
+        std::vector<uint32_t> expected;
+        std::set_intersection(first.begin(), first.end(), second.begin(), second.end(), std::back_inserter(expected));
+        std::vector<uint32_t> common(first.size() + 1);
+        int count = intersectPostingLists(first.data(), (int)first.size(), second.data(), (int)second.size(), common.data());
+        common.resize((size_t)count);
+        EXPECT_EQ(common, expected);
+    }
+}
+
+/**
+ * @test SearchIndexQueryTest
+ * @brief Tests exact, substring, all-terms and any-term queries on a built index, and that appending
+ *        products and vendors gives the same answers as building the index again.
+ */
+TEST_F(MarketTest, SearchIndexQueryTest) {
+    const char* productsPath = "search_products.bin";
+    const char* vendorsPath = "search_vendor.bin";
+    const char* indexPath = "search_test.inv";
+    const char* names[] = {"Tomato", "Apple", "Pear", "GreenApple", "Plum"};
+    const char* seasons[] = {"Winter", "Summer", "Fall"};
+    FILE* file = fopen(productsPath, "wb");
+    ASSERT_NE(file, nullptr);
+    for (int i = 0; i < 3000; i++) {
+        Product product;
+        memset(&product, 0, sizeof(product));
+        product.vendorId = i % 7;
+        strcpy(product.productName, names[i % 5]);
+        strcpy(product.season, seasons[i % 3]);
+        product.price = (float)i;
+        fwrite(&product, sizeof(Product), 1, file);
+    }
+    fclose(file);
+    Vendor vendors[] = {{11, "Farm"}, {12, "Orchard"}, {13, "FarmStand"}};
+    file = fopen(vendorsPath, "wb");
+    ASSERT_NE(file, nullptr);
+    fwrite(vendors, sizeof(Vendor), 3, file);
+    fclose(file);
+    remove(indexPath);
+
+    uint32_t* none = NULL;
+    EXPECT_EQ(querySearchIndex(indexPath, NULL, 0, NULL, 0, SEARCH_TERM_EXACT, true, &none), -1);
+    ASSERT_TRUE(openSearchIndex(indexPath, productsPath, vendorsPath));
+
+    const SearchField nameField[1] = {SEARCH_FIELD_PRODUCT_NAME};
+    const SearchField productFields[2] = {SEARCH_FIELD_PRODUCT_NAME, SEARCH_FIELD_SEASON};
+    const SearchField vendorField[1] = {SEARCH_FIELD_VENDOR_NAME};
+    const SearchField vendorIdField[1] = {SEARCH_FIELD_VENDOR_ID};
+    uint32_t* records = NULL;
+
+    const char* apple[1] = {"Apple"};
+    ASSERT_EQ(querySearchIndex(indexPath, nameField, 1, apple, 1, SEARCH_TERM_EXACT, true, &records), 600);
+    for (int i = 0; i < 600; i++) {EXPECT_EQ(records[i], (uint32_t)(5 * i + 1));}
+    free(records);
+    ASSERT_EQ(querySearchIndex(indexPath, nameField, 1, apple, 1, SEARCH_TERM_SUBSTRING, true, &records), 1200);
+    EXPECT_EQ(records[0], 1u);
+    EXPECT_EQ(records[1], 3u);
+    free(records);
+
+    // Apple or GreenApple in summer: i % 5 in {1, 3} and i % 3 == 1
+    const char* appleSummer[2] = {"Apple", "Summer"};
+    int count = querySearchIndex(indexPath, productFields, 2, appleSummer, 2, SEARCH_TERM_SUBSTRING, true, &records);
+    ASSERT_EQ(count, 400);
+    for (int i = 0; i < count; i++) {
+        EXPECT_TRUE(records[i] % 5 == 1 || records[i] % 5 == 3);
+        EXPECT_EQ(records[i] % 3, 1u);
+    }
+    free(records);
+
+    const char* pearOrPlum[2] = {"Pear", "Plum"};
+    EXPECT_EQ(querySearchIndex(indexPath, nameField, 1, pearOrPlum, 2, SEARCH_TERM_EXACT, false, &records), 1200);
+    free(records);
+    EXPECT_EQ(querySearchIndex(indexPath, nameField, 1, pearOrPlum, 2, SEARCH_TERM_EXACT, true, &records), 0);
+    EXPECT_EQ(records, nullptr);
+    const char* missing[1] = {"Banana"};
+    EXPECT_EQ(querySearchIndex(indexPath, nameField, 1, missing, 1, SEARCH_TERM_EXACT, true, &records), 0);
+
+    const char* farm[1] = {"Farm"};
+    ASSERT_EQ(querySearchIndex(indexPath, vendorField, 1, farm, 1, SEARCH_TERM_SUBSTRING, true, &records), 2);
+    EXPECT_EQ(records[0], 0u);
+    EXPECT_EQ(records[1], 2u);
+    free(records);
+    const char* vendorId[1] = {"12"};
+    ASSERT_EQ(querySearchIndex(indexPath, vendorIdField, 1, vendorId, 1, SEARCH_TERM_EXACT, true, &records), 1);
+    EXPECT_EQ(records[0], 1u);
+    free(records);
+
+    // Appending gives the same lists as a new build
+    Product added = {9, "Apple", 1.5f, 2, "Spring"};
+    file = fopen(productsPath, "ab");
+    ASSERT_NE(file, nullptr);
+    fwrite(&added, sizeof(Product), 1, file);
+    fclose(file);
+    ASSERT_TRUE(addProductToSearchIndex(indexPath, productsPath, vendorsPath, &added));
+    Vendor addedVendor = {14, "Farmers"};
+    file = fopen(vendorsPath, "ab");
+    ASSERT_NE(file, nullptr);
+    fwrite(&addedVendor, sizeof(Vendor), 1, file);
+    fclose(file);
+    ASSERT_TRUE(addVendorToSearchIndex(indexPath, productsPath, vendorsPath, &addedVendor));
+
+    const char* spring[1] = {"Spring"};
+    ASSERT_EQ(querySearchIndex(indexPath, productFields, 2, spring, 1, SEARCH_TERM_EXACT, true, &records), 1);
+    EXPECT_EQ(records[0], 3000u);
+    free(records);
+    uint32_t* rebuilt = NULL;
+    count = querySearchIndex(indexPath, nameField, 1, apple, 1, SEARCH_TERM_EXACT, true, &records);
+    ASSERT_TRUE(buildSearchIndex("search_rebuilt.inv", productsPath, vendorsPath));
+    ASSERT_EQ(querySearchIndex("search_rebuilt.inv", nameField, 1, apple, 1, SEARCH_TERM_EXACT, true, &rebuilt), count);
+    EXPECT_EQ(count, 601);
+    EXPECT_EQ(memcmp(records, rebuilt, (size_t)count * sizeof(uint32_t)), 0);
+    free(records);
+    free(rebuilt);
+    ASSERT_EQ(querySearchIndex(indexPath, vendorField, 1, farm, 1, SEARCH_TERM_SUBSTRING, true, &records), 3);
+    EXPECT_EQ(records[2], 3u);
+    free(records);
+    SearchIndexFileHeader header;
+    file = fopen(indexPath, "rb");
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(fread(&header, sizeof(header), 1, file), 1u);
+    fclose(file);
+    EXPECT_EQ(header.tailCount, 4);
+    EXPECT_EQ(header.productCount, 3001);
+    EXPECT_EQ(header.vendorCount, 4);
+
+    // Filling the tail merges it into the posting lists
+    for (int i = 0; i < SEARCH_INDEX_TAIL_LIMIT / 2 - 1; i++) {
+        Product more = {9, "Quince", 2.0f, 1, "Fall"};
+        if (i % 2 == 0) {strcpy(more.season, "Winter");}
+        file = fopen(productsPath, "ab");
+        ASSERT_NE(file, nullptr);
+        fwrite(&more, sizeof(Product), 1, file);
+        fclose(file);
+        ASSERT_TRUE(addProductToSearchIndex(indexPath, productsPath, vendorsPath, &more));
+    }
+    file = fopen(indexPath, "rb");
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(fread(&header, sizeof(header), 1, file), 1u);
+    fclose(file);
+    EXPECT_EQ(header.tailCount, 0);
+    ASSERT_TRUE(buildSearchIndex("search_rebuilt.inv", productsPath, vendorsPath));
+    const char* winterQuince[2] = {"Winter", "Quince"};
+    count = querySearchIndex(indexPath, productFields, 2, winterQuince, 2, SEARCH_TERM_SUBSTRING, true, &records);
+    ASSERT_EQ(querySearchIndex("search_rebuilt.inv", productFields, 2, winterQuince, 2, SEARCH_TERM_SUBSTRING, true, &rebuilt), count);
+    EXPECT_EQ(count, SEARCH_INDEX_TAIL_LIMIT / 4);
+    EXPECT_EQ(memcmp(records, rebuilt, (size_t)count * sizeof(uint32_t)), 0);
+    free(records);
+    free(rebuilt);
+
+    // An index that misses records is rebuilt when opened
+    file = fopen(productsPath, "ab");
+    ASSERT_NE(file, nullptr);
+    fwrite(&added, sizeof(Product), 1, file);
+    fclose(file);
+    ASSERT_TRUE(openSearchIndex(indexPath, productsPath, vendorsPath));
+    EXPECT_EQ(querySearchIndex(indexPath, productFields, 2, spring, 1, SEARCH_TERM_EXACT, true, &records), 2);
+    free(records);
+
+    remove(productsPath);
+    remove(vendorsPath);
+    remove(indexPath);
+    remove("search_rebuilt.inv");
+}
+
+/**
+ * @test SearchIndexFollowsMenuTest
+ * @brief Tests that the search menu functions answer from the index and that adding and deleting products
+ *        through the menu keeps the index up to date.
+ */
+TEST_F(MarketTest, SearchIndexFollowsMenuTest) {
+    Product products[] = {{1, "Tomato", 25, 100, "Winter"}, {2, "Apple", 30, 50, "Fall"}, {1, "Pineapple", 20, 5, "Summer"}};
+    writeProductsFile(products, 3);
+    Vendor vendors[] = {{1, "Vendor1"}, {2, "Vendor2"}};
+    writeVendorsFile(vendors, 2);
+    remove(SEARCH_INDEX_FILE);
+
+    char selected[100];
+    simulateUserInput("Apple\n2\nPear\n5\n3\nSpring\n\n\nTomato\n\n\npple\n\n\n");
+    EXPECT_TRUE(selectProduct(selected));
+    EXPECT_TRUE(addProduct());
+    EXPECT_TRUE(deleteProduct());
+    EXPECT_TRUE(enterSearchProducts());
+    resetStdinStdout();
+
+    const SearchField nameField[1] = {SEARCH_FIELD_PRODUCT_NAME};
+    const char* pear[1] = {"Pear"};
+    uint32_t* records = NULL;
+    ASSERT_EQ(querySearchIndex(SEARCH_INDEX_FILE, nameField, 1, pear, 1, SEARCH_TERM_EXACT, true, &records), 1);
+    EXPECT_EQ(records[0], 2u);
+    free(records);
+    const char* tomato[1] = {"Tomato"};
+    EXPECT_EQ(querySearchIndex(SEARCH_INDEX_FILE, nameField, 1, tomato, 1, SEARCH_TERM_EXACT, true, &records), 0);
+
+    FILE* file = fopen(outputTest, "rb");
+    ASSERT_NE(file, nullptr);
+    char buffer[4096] = { 0 };
+    fread(buffer, sizeof(char), sizeof(buffer) - 1, file);
+    fclose(file);
+    std::string output = buffer;
+    EXPECT_NE(output.find("Selected Product: Apple, Price: 30.00"), std::string::npos) << output;
+    EXPECT_NE(output.find("--- Vendors Offering 'pple' ---\nVendor: Vendor2, ID: 2\nVendor: Vendor1, ID: 1\n"), std::string::npos) << output;
+}
+
+/**
+ * @test EnterSearchProductsListsEachVendorOnceTest
+ * @brief Tests that a vendor offering several matching products is listed once, and that a product whose vendor
+ *        is not in vendor.bin lists no vendor.
+ */
+TEST_F(MarketTest, EnterSearchProductsListsEachVendorOnceTest) {
+    Product products[] = {{1, "Apple", 30, 50, "Fall"}, {2, "Pineapple", 20, 5, "Summer"}, {1, "Crabapple", 12, 8, "Fall"}, {3, "Apple", 28, 9, "Fall"}};
+    writeProductsFile(products, 4);
+    Vendor vendors[] = {{1, "Vendor1"}, {2, "Vendor2"}};
+    writeVendorsFile(vendors, 2);
+    remove(SEARCH_INDEX_FILE);
+
+    simulateUserInput("pple\n\n\n");
+    EXPECT_TRUE(enterSearchProducts());
+    resetStdinStdout();
+
+    FILE* file = fopen(outputTest, "rb");
+    ASSERT_NE(file, nullptr);
+    char buffer[4096] = { 0 };
+    fread(buffer, sizeof(char), sizeof(buffer) - 1, file);
+    fclose(file);
+    std::string output = buffer;
+    EXPECT_NE(output.find("--- Vendors Offering 'pple' ---\nVendor: Vendor1, ID: 1\nVendor: Vendor2, ID: 2\n\nPress Enter"), std::string::npos) << output;
+    remove(SEARCH_INDEX_FILE);
+}
+
 
 
 
@@ -2384,6 +5101,6 @@ int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 #else
-    return 0;
+    return 0;
 #endif
 }
\ No newline at end of file
@@ -0,0 +1,314 @@
+/**
+ * @file utility_test.cpp
+ * @brief Unit tests for the utility library using Google Test framework.
+ *
+ * This file contains unit tests for the statistics kernels of MathUtility, the CPU feature detection they
+ * rely on and the streaming accumulators. Results of the vectorized code paths are compared with straightforward scalar references.
+ */
+#include "gtest/gtest.h"
+#include "../../utility/header/mathUtility.h"
+#include "../../utility/header/cpuFeatures.h"
+#include "../../utility/header/streamingStatistics.h"
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using Coruh::Utility::MathUtility;
+using Coruh::Utility::QuantileDigest;
+using Coruh::Utility::RunningStatistics;
+
+/**
+ * @class UtilityTest
+ * @brief Test fixture for the utility library.
+ */
+class UtilityTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Returns the median of a sorted copy of the data, used as the reference for calculateMedian.
+     */
+    template <typename T>
+    static double sortedMedian(std::vector<T> data) {
+        std::sort(data.begin(), data.end());
+        size_t middle = data.size() / 2;
+        if (data.size() % 2 == 1) {return data[middle];}
+        return ((double)data[middle - 1] + (double)data[middle]) / 2.0;
+    }
+};
+
+/**
+ * @test CalculateMeanTest
+ * @brief Tests the mean of double and float arrays for every length around the vector widths.
+ */
+TEST_F(UtilityTest, CalculateMeanTest) {
+    EXPECT_EQ(MathUtility::calculateMean((const double*)NULL, 0), 0.0);
+    for (int length = 1; length <= 70; length++) {
+        std::vector<double> values(length);
+        std::vector<float> prices(length);
+        double sum = 0.0;
+        for (int i = 0; i < length; i++) {
+            values[i] = (double)((i * 37) % 29) - 7.5;
+            prices[i] = (float)((i * 53) % 41) * 0.25f;
+            sum += values[i];
+        }
+        double priceSum = 0.0;
+        for (int i = 0; i < length; i++) {priceSum += prices[i];}
+        EXPECT_NEAR(MathUtility::calculateMean(values.data(), length), sum / length, 1e-12) << "length " << length;
+        EXPECT_NEAR(MathUtility::calculateMean(prices.data(), length), priceSum / length, 1e-12) << "length " << length;
+    }
+}
+
+/**
+ * @test CalculateMeanFloatPrecisionTest
+ * @brief Tests that float prices are summed in double precision, where a float accumulator would drift.
+ */
+TEST_F(UtilityTest, CalculateMeanFloatPrecisionTest) {
+    std::vector<float> prices(1 << 22, 0.1f);
+    EXPECT_NEAR(MathUtility::calculateMean(prices.data(), (int)prices.size()), (double)0.1f, 1e-9);
+}
+
+/**
+ * @test CalculateMinMaxTest
+ * @brief Tests min/max for every position of the extremes and for lengths below and above the vector widths.
+ */
+TEST_F(UtilityTest, CalculateMinMaxTest) {
+    double minimum = 1.0;
+    double maximum = 1.0;
+    MathUtility::calculateMinMax((const double*)NULL, 0, &minimum, &maximum);
+    EXPECT_EQ(minimum, 0.0);
+    EXPECT_EQ(maximum, 0.0);
+
+    for (int length = 2; length <= 20; length++) {
+        for (int minimumAt = 0; minimumAt < length; minimumAt++) {
+            for (int maximumAt = 0; maximumAt < length; maximumAt++) {
+                if (minimumAt == maximumAt) {continue;}
+                std::vector<double> values(length, 5.0);
+                std::vector<float> prices(length, 5.0f);
+                values[minimumAt] = -3.0;
+                values[maximumAt] = 9.0;
+                prices[minimumAt] = 1.5f;
+                prices[maximumAt] = 12.5f;
+
+                MathUtility::calculateMinMax(values.data(), length, &minimum, &maximum);
+                EXPECT_EQ(minimum, -3.0);
+                EXPECT_EQ(maximum, 9.0);
+                float lowest = 0.0f;
+                float highest = 0.0f;
+                MathUtility::calculateMinMax(prices.data(), length, &lowest, &highest);
+                EXPECT_EQ(lowest, 1.5f);
+                EXPECT_EQ(highest, 12.5f);
+            }
+        }
+    }
+
+    float single = 4.0f;
+    float lowest = 0.0f;
+    float highest = 0.0f;
+    MathUtility::calculateMinMax(&single, 1, &lowest, &highest);
+    EXPECT_EQ(lowest, 4.0f);
+    EXPECT_EQ(highest, 4.0f);
+}
+
+/**
+ * @test CalculateMedianTest
+ * @brief Tests the selection-based median against sorting, for odd and even lengths and many duplicates.
+ */
+TEST_F(UtilityTest, CalculateMedianTest) {
+    EXPECT_EQ(MathUtility::calculateMedian((const double*)NULL, 0), 0.0);
+    srand(7);
+    for (int length = 1; length <= 300; length += 7) {
+        std::vector<double> values(length);
+        std::vector<float> prices(length);
+        for (int i = 0; i < length; i++) {
+            values[i] = (double)(rand() % 1000) / 10.0;
+            prices[i] = (float)(rand() % 20) * 0.5f;
+        }
+        std::vector<double> original = values;
+        EXPECT_DOUBLE_EQ(MathUtility::calculateMedian(values.data(), length), sortedMedian(values)) << "length " << length;
+        EXPECT_DOUBLE_EQ(MathUtility::calculateMedian(prices.data(), length), sortedMedian(prices)) << "length " << length;
+        EXPECT_TRUE(values == original);
+    }
+
+    double two[] = {4.0, 1.0};
+    EXPECT_DOUBLE_EQ(MathUtility::calculateMedian(two, 2), 2.5);
+}
+
+/**
+ * @test CalculateMedianAdversarialTest
+ * @brief Tests sorted, reversed, constant and organ-pipe inputs, which degrade plain quickselect pivots.
+ */
+TEST_F(UtilityTest, CalculateMedianAdversarialTest) {
+    const int length = 200001;
+    std::vector<double> ascending(length);
+    std::vector<double> descending(length);
+    std::vector<double> organPipe(length);
+    std::vector<double> constant(length, 3.25);
+    for (int i = 0; i < length; i++) {
+        ascending[i] = i;
+        descending[i] = length - i;
+        organPipe[i] = i < length / 2 ? i : length - i;
+    }
+    EXPECT_DOUBLE_EQ(MathUtility::calculateMedian(ascending.data(), length), sortedMedian(ascending));
+    EXPECT_DOUBLE_EQ(MathUtility::calculateMedian(descending.data(), length), sortedMedian(descending));
+    EXPECT_DOUBLE_EQ(MathUtility::calculateMedian(organPipe.data(), length), sortedMedian(organPipe));
+    EXPECT_DOUBLE_EQ(MathUtility::calculateMedian(constant.data(), length), 3.25);
+}
+
+/**
+ * @test CompareDoubleTest
+ * @brief Tests compareDouble as a qsort comparator.
+ */
+TEST_F(UtilityTest, CompareDoubleTest) {
+    double low = 1.5;
+    double high = 2.5;
+    EXPECT_EQ(MathUtility::compareDouble(&low, &high), -1);
+    EXPECT_EQ(MathUtility::compareDouble(&high, &low), 1);
+    EXPECT_EQ(MathUtility::compareDouble(&low, &low), 0);
+
+    double values[] = {3.0, -1.0, 2.0, 2.0, 0.5};
+    qsort(values, 5, sizeof(double), MathUtility::compareDouble);
+    EXPECT_TRUE(std::is_sorted(values, values + 5));
+}
+
+/**
+ * @test ReductionImplementationNameTest
+ * @brief Tests that the reported reduction variant matches the detected CPU features.
+ */
+TEST_F(UtilityTest, ReductionImplementationNameTest) {
+    const char* name = MathUtility::reductionImplementationName();
+    if (Coruh::Utility::CpuFeatures::hasAvx2()) {
+        EXPECT_STREQ(name, "avx2");
+    }
+    else if (Coruh::Utility::CpuFeatures::hasSse2()) {
+        EXPECT_STREQ(name, "sse2");
+    }
+    else {
+        EXPECT_STREQ(name, "scalar");
+    }
+}
+
+/**
+ * @test RunningStatisticsTest
+ * @brief Tests the running mean, variance and extremes against two-pass computations, including values with a
+ *        large common offset where the sum of squares would cancel.
+ */
+TEST_F(UtilityTest, RunningStatisticsTest) {
+    RunningStatistics empty;
+    EXPECT_EQ(empty.count(), 0u);
+    EXPECT_EQ(empty.mean(), 0.0);
+    EXPECT_EQ(empty.variance(), 0.0);
+    EXPECT_EQ(empty.minimum(), 0.0);
+    EXPECT_EQ(empty.maximum(), 0.0);
+
+    std::vector<double> values(10000);
+    RunningStatistics statistics;
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = 1e9 + (double)((i * 7919) % 1000) / 10.0;
+        statistics.add(values[i]);
+    }
+    double mean = MathUtility::calculateMean(values.data(), (int)values.size());
+    double squares = 0.0;
+    for (size_t i = 0; i < values.size(); i++) {squares += (values[i] - mean) * (values[i] - mean);}
+    double minimum = 0.0;
+    double maximum = 0.0;
+    MathUtility::calculateMinMax(values.data(), (int)values.size(), &minimum, &maximum);
+
+    EXPECT_EQ(statistics.count(), values.size());
+    EXPECT_NEAR(statistics.mean(), mean, 1e-6);
+    EXPECT_NEAR(statistics.variance(), squares / values.size(), 1e-6);
+    EXPECT_NEAR(statistics.sampleVariance(), squares / (values.size() - 1), 1e-6);
+    EXPECT_NEAR(statistics.standardDeviation(), sqrt(squares / values.size()), 1e-6);
+    EXPECT_EQ(statistics.minimum(), minimum);
+    EXPECT_EQ(statistics.maximum(), maximum);
+}
+
+/**
+ * @test RunningStatisticsMergeTest
+ * @brief Tests that merging per-thread accumulators gives the statistics of the whole stream.
+ */
+TEST_F(UtilityTest, RunningStatisticsMergeTest) {
+    RunningStatistics whole;
+    RunningStatistics shards[4];
+    for (int i = 0; i < 4001; i++) {
+        double value = (double)((i * 37) % 101) * 0.5 - 3.0;
+        whole.add(value);
+        shards[i % 7 == 0 ? 0 : (i < 2000 ? 1 : 2)].add(value);
+    }
+    RunningStatistics merged;
+    for (int i = 0; i < 4; i++) {merged.merge(shards[i]);}
+
+    EXPECT_EQ(merged.count(), whole.count());
+    EXPECT_NEAR(merged.mean(), whole.mean(), 1e-9);
+    EXPECT_NEAR(merged.variance(), whole.variance(), 1e-9);
+    EXPECT_EQ(merged.minimum(), whole.minimum());
+    EXPECT_EQ(merged.maximum(), whole.maximum());
+}
+
+/**
+ * @test QuantileDigestSmallStreamTest
+ * @brief Tests that short streams give the exact median and extremes.
+ */
+TEST_F(UtilityTest, QuantileDigestSmallStreamTest) {
+    QuantileDigest digest;
+    EXPECT_EQ(digest.quantile(0.5), 0.0);
+
+    double values[] = {7.0, 1.0, 4.0, 9.0, 3.0};
+    for (int i = 0; i < 5; i++) {digest.add(values[i]);}
+    EXPECT_DOUBLE_EQ(digest.quantile(0.5), 4.0);
+    EXPECT_DOUBLE_EQ(digest.quantile(0.0), 1.0);
+    EXPECT_DOUBLE_EQ(digest.quantile(1.0), 9.0);
+    EXPECT_EQ(digest.centroidCount(), 5u);
+
+    digest.add(5.0);
+    EXPECT_DOUBLE_EQ(digest.quantile(0.5), 4.5);
+    EXPECT_EQ(digest.totalWeight(), 6.0);
+}
+
+/**
+ * @test QuantileDigestAccuracyTest
+ * @brief Tests median and tail percentiles of a long shuffled stream against the sorted values, and that the
+ *        digest stays bounded.
+ */
+TEST_F(UtilityTest, QuantileDigestAccuracyTest) {
+    const int length = 200000;
+    std::vector<double> values(length);
+    for (int i = 0; i < length; i++) {values[i] = (double)i;}
+    srand(11);
+    for (int i = length - 1; i > 0; i--) {std::swap(values[i], values[rand() % (i + 1)]);}
+
+    QuantileDigest digest;
+    for (int i = 0; i < length; i++) {digest.add(values[i]);}
+    EXPECT_LE(digest.centroidCount(), 100u);
+
+    const double quantiles[] = {0.01, 0.1, 0.5, 0.9, 0.99, 0.999};
+    for (int i = 0; i < 6; i++) {
+        double rank = digest.quantile(quantiles[i]) / length;
+        double tolerance = 0.01 * sqrt(quantiles[i] * (1.0 - quantiles[i])) + 0.0002;
+        EXPECT_NEAR(rank, quantiles[i], tolerance) << "quantile " << quantiles[i];
+    }
+}
+
+/**
+ * @test QuantileDigestMergeTest
+ * @brief Tests that merged per-thread digests estimate the same quantiles as one digest over the whole stream.
+ */
+TEST_F(UtilityTest, QuantileDigestMergeTest) {
+    QuantileDigest whole;
+    QuantileDigest shards[3];
+    srand(5);
+    for (int i = 0; i < 60000; i++) {
+        double value = (double)(rand() % 10000) * 0.01;
+        whole.add(value);
+        shards[i % 3].add(value);
+    }
+    QuantileDigest merged;
+    for (int i = 0; i < 3; i++) {merged.merge(shards[i]);}
+
+    EXPECT_EQ(merged.totalWeight(), whole.totalWeight());
+    EXPECT_EQ(merged.quantile(0.0), whole.quantile(0.0));
+    EXPECT_EQ(merged.quantile(1.0), whole.quantile(1.0));
+    EXPECT_NEAR(merged.quantile(0.5), whole.quantile(0.5), 0.5);
+    EXPECT_NEAR(merged.quantile(0.95), whole.quantile(0.95), 0.3);
+    EXPECT_NEAR(merged.quantile(0.5), 50.0, 1.0);
+}
@@ -0,0 +1,57 @@
+/**
+ * @file cpuFeatures.h
+ *
+ * @brief Provides run-time detection of the SIMD instruction sets supported by the CPU
+ */
+
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#include "commonTypes.h"
+
+/** @brief Defined when compiling for an x86 or x86-64 target, where SSE/AVX code paths can be built. */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CORUH_X86 1
+#endif
+
+/**
+ * @brief Enables an instruction set for a single function so that it can be built without global compiler flags.
+ *
+ * GCC and Clang need the target attribute to emit AVX2 intrinsics in a translation unit compiled for the
+ * baseline ISA; MSVC accepts the intrinsics anywhere, so the macro expands to nothing there.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define CORUH_TARGET(isa) __attribute__((target(isa)))
+#else
+#define CORUH_TARGET(isa)
+#endif
+
+namespace Coruh
+{
+    namespace Utility
+    {
+        /**
+            @class CpuFeatures
+            @brief Reports which SIMD instruction sets the running CPU and operating system support.
+
+            Detection runs once; the results are cached. Callers use them to pick a vectorized code path at
+            run time and fall back to scalar code otherwise, so one binary runs on every x86 CPU.
+        */
+        class CpuFeatures
+        {
+        public:
+			/**
+			 * @brief Returns true if SSE2 instructions are available.
+			 * @return Always true on x86-64, false on non-x86 targets.
+			 */
+			static bool hasSse2();
+
+			/**
+			 * @brief Returns true if AVX2 instructions are available and the OS saves the AVX register state.
+			 */
+			static bool hasAvx2();
+        };
+    }
+}
+
+#endif // CPU_FEATURES_H
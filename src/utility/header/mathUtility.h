@@ -2,6 +2,10 @@
  * @file mathUtility.h
  * 
  * @brief Provides functions for math. utilities
+ *
+ * The mean and min/max reductions use SSE2 or AVX2 when the CPU supports them; the median uses an O(n)
+ * selection instead of sorting. Float overloads serve Product::price arrays without converting them first.
+ * For values that arrive one at a time, the accumulators in streamingStatistics.h avoid keeping the array.
  */
 
 #ifndef MATH_UTILITY_H
@@ -32,18 +36,39 @@ namespace Coruh
 			 */
 			static double calculateMean(const double fiArray[], int fiArrayLen);
 
+			/**
+			 * @brief Calculates the mean of an array of floats, accumulating in double precision.
+			 *
+			 * @param fiArray The array of data.
+			 * @param fiArrayLen The length of the data array.
+			 * @return The calculated mean, 0 for an empty array.
+			 */
+			static double calculateMean(const float fiArray[], int fiArrayLen);
+
 			/**
 			 * @brief Calculates the median of an array of data.
 			 *
 			 * This function calculates the median of the given array of data.
-			 * The data array should contain datalen elements.
+			 * The data array should contain datalen elements. A copy of the data is partitioned with
+			 * introselect (quickselect that switches to median-of-medians pivots when it degrades),
+			 * so the cost is O(n) instead of the O(n log n) of sorting; the input is not modified.
+			 * For an even length the median is the mean of the two middle values.
 			 *
 			 * @param fiArray The array of data.
 			 * @param fiArrayLen The length of the data array.
-			 * @return The calculated median.
+			 * @return The calculated median, 0 for an empty array.
 			 */
 			static double calculateMedian(const double fiArray[], int fiArrayLen);
 
+			/**
+			 * @brief Calculates the median of an array of floats.
+			 *
+			 * @param fiArray The array of data.
+			 * @param fiArrayLen The length of the data array.
+			 * @return The calculated median, 0 for an empty array.
+			 */
+			static double calculateMedian(const float fiArray[], int fiArrayLen);
+
 			/**
 			 * @brief Compares two double values for sorting purposes.
 			 *
@@ -71,8 +96,23 @@ namespace Coruh
 			 */
 			static void calculateMinMax(const double fiArray[], int fiArrayLen, double *foMin, double *foMax);
 
+			/**
+			 * @brief Calculates the minimum and maximum values in an array of floats.
+			 *
+			 * @param fiArray The array of data.
+			 * @param fiArrayLen The length of the data array; for an empty array both outputs are set to 0.
+			 * @param foMin Pointer to store the minimum value.
+			 * @param foMax Pointer to store the maximum value.
+			 */
+			static void calculateMinMax(const float fiArray[], int fiArrayLen, float *foMin, float *foMax);
+
+			/**
+			 * @brief Returns the instruction set used by the mean and min/max reductions ("avx2", "sse2" or "scalar").
+			 */
+			static const char* reductionImplementationName();
+
         };
     }
 }
 
-#endif // FILE_UTILITY_H
\ No newline at end of file
+#endif // MATH_UTILITY_H
\ No newline at end of file
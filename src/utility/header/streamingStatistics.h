@@ -0,0 +1,148 @@
+/**
+ * @file streamingStatistics.h
+ *
+ * @brief Provides streaming accumulators for statistics over values that arrive one at a time
+ *
+ * MathUtility computes statistics over a complete array. The accumulators here take one value at a time in
+ * constant memory, so live price feeds can be summarised without keeping or rescanning the values. Every
+ * accumulator can absorb another one: threads fill their own accumulators and merge them at the end.
+ * Accumulators are not synchronised; an accumulator must not be shared between threads while it is updated.
+ */
+
+#ifndef STREAMING_STATISTICS_H
+#define STREAMING_STATISTICS_H
+
+#include "commonTypes.h"
+#include <vector>
+
+namespace Coruh
+{
+    namespace Utility
+    {
+        /**
+            @class RunningStatistics
+            @brief Count, mean, variance, minimum and maximum of a stream, updated in O(1) per value.
+
+            The mean and variance use Welford's recurrence, which stays accurate where summing values and squares
+            would cancel. Merging uses the pairwise update of Chan et al.
+        */
+        class RunningStatistics
+        {
+        public:
+            /** @brief Creates an empty accumulator. */
+            RunningStatistics();
+
+            /** @brief Removes all values. */
+            void reset();
+
+            /**
+             * @brief Adds a value.
+             * @param fiValue The value.
+             */
+            void add(double fiValue);
+
+            /**
+             * @brief Adds all values summarised by another accumulator.
+             * @param fiOther The accumulator to absorb; it is not modified.
+             */
+            void merge(const RunningStatistics& fiOther);
+
+            /** @brief Returns the number of values. */
+            uint64_t count() const { return valueCount; }
+
+            /** @brief Returns the mean, 0 for an empty stream. */
+            double mean() const { return runningMean; }
+
+            /** @brief Returns the population variance, 0 for fewer than two values. */
+            double variance() const;
+
+            /** @brief Returns the sample variance (divided by n - 1), 0 for fewer than two values. */
+            double sampleVariance() const;
+
+            /** @brief Returns the population standard deviation. */
+            double standardDeviation() const;
+
+            /** @brief Returns the smallest value, 0 for an empty stream. */
+            double minimum() const { return valueCount > 0 ? smallest : 0.0; }
+
+            /** @brief Returns the largest value, 0 for an empty stream. */
+            double maximum() const { return valueCount > 0 ? largest : 0.0; }
+
+        private:
+            uint64_t valueCount;        ///< Number of values.
+            double runningMean;         ///< Mean of the values.
+            double squaredDeviations;   ///< Sum of squared deviations from the mean (M2).
+            double smallest;            ///< Smallest value.
+            double largest;             ///< Largest value.
+        };
+
+        /**
+            @class QuantileDigest
+            @brief Approximate quantiles (median, percentiles) of a stream in bounded memory, as a merging t-digest.
+
+            Values are collected in a small buffer; when it fills up, buffer and centroids are sorted and merged
+            into at most about compression centroids. The arcsine scale function keeps centroids near the tails
+            small, so extreme percentiles such as p99 stay accurate while the middle is summarised coarsely.
+            Streams of fewer than about 0.6 * compression values are kept exactly.
+        */
+        class QuantileDigest
+        {
+        public:
+            /**
+             * @brief Creates an empty digest.
+             * @param fiCompression Accuracy parameter; higher values keep more centroids (default 100).
+             */
+            explicit QuantileDigest(double fiCompression = 100.0);
+
+            /** @brief Removes all values. */
+            void reset();
+
+            /**
+             * @brief Adds a value with a weight.
+             * @param fiValue The value.
+             * @param fiWeight Its weight, 1 for a single observation.
+             */
+            void add(double fiValue, double fiWeight = 1.0);
+
+            /**
+             * @brief Adds all values summarised by another digest.
+             * @param fiOther The digest to absorb; it is not modified.
+             */
+            void merge(const QuantileDigest& fiOther);
+
+            /**
+             * @brief Returns the approximate value below which a fraction fiQuantile of the values lies.
+             * @param fiQuantile Fraction in [0, 1]; 0.5 is the median.
+             * @return The estimate, 0 for an empty digest.
+             */
+            double quantile(double fiQuantile);
+
+            /** @brief Returns the total weight of the added values. */
+            double totalWeight() const { return mergedWeight + bufferedWeight; }
+
+            /** @brief Returns the number of centroids after merging the buffer. */
+            size_t centroidCount();
+
+        private:
+            /** @brief A cluster of nearby values: their mean and total weight. */
+            struct Centroid
+            {
+                double mean;            ///< Mean of the values in the cluster.
+                double weight;          ///< Total weight of the values.
+            };
+
+            double compression;                 ///< Accuracy parameter.
+            std::vector<Centroid> centroids;    ///< Merged centroids in ascending mean order.
+            std::vector<Centroid> buffer;       ///< Values added since the last merge.
+            double mergedWeight;                ///< Weight of the centroids.
+            double bufferedWeight;              ///< Weight of the buffer.
+            double smallest;                    ///< Smallest value.
+            double largest;                     ///< Largest value.
+
+            /** @brief Merges the buffer into the centroids. */
+            void compress();
+        };
+    }
+}
+
+#endif // STREAMING_STATISTICS_H
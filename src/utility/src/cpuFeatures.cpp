@@ -0,0 +1,71 @@
+/**
+ * @file cpuFeatures.cpp
+ * @brief Run-time detection of SSE and AVX support.
+ *
+ * GCC and Clang (including MinGW) provide __builtin_cpu_supports, which also checks that the operating system
+ * enables the AVX register state. MSVC reads CPUID and XCR0 directly.
+ */
+
+#include "../header/cpuFeatures.h"
+
+#if defined(_MSC_VER) && defined(CORUH_X86)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+using namespace Coruh::Utility;
+
+namespace
+{
+    /** @brief Bit flags for the detected instruction sets. */
+    enum CpuFeatureBits
+    {
+        FeatureSse2 = 1,
+        FeatureAvx2 = 2
+    };
+
+    /**
+     * @brief Queries the CPU once.
+     * @return A combination of CpuFeatureBits.
+     */
+    int detectCpuFeatures()
+    {
+        int features = 0;
+#if defined(CORUH_X86) && (defined(__GNUC__) || defined(__clang__))
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("sse2")) {features |= FeatureSse2;}
+        if (__builtin_cpu_supports("avx2")) {features |= FeatureAvx2;}
+#elif defined(CORUH_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        int maxLeaf = info[0];
+        __cpuid(info, 1);
+        if (info[3] & (1 << 26)) {features |= FeatureSse2;}
+        bool osSavesAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 0x6) == 0x6;
+        if (osSavesAvx && maxLeaf >= 7) {
+            __cpuidex(info, 7, 0);
+            if (info[1] & (1 << 5)) {features |= FeatureAvx2;}
+        }
+#endif
+        return features;
+    }
+
+    /**
+     * @brief Returns the cached feature bits.
+     */
+    int cpuFeatures()
+    {
+        static const int features = detectCpuFeatures();
+        return features;
+    }
+}
+
+bool CpuFeatures::hasSse2()
+{
+    return (cpuFeatures() & FeatureSse2) != 0;
+}
+
+bool CpuFeatures::hasAvx2()
+{
+    return (cpuFeatures() & FeatureAvx2) != 0;
+}
@@ -3,15 +3,454 @@
  * @brief Utility functions for mathematical operations.
  *
  * Provides implementation for various mathematical utility functions that may be used across different
- * parts of the application. This file includes functions for operations like statistical calculations,
- * geometric transformations, or any other math-related utilities.
+ * parts of the application, such as the statistics shown by the price comparison.
  *
- * Current Status:
- * - This file has a test coverage of 0%, indicating that no lines of code in this file have been executed by tests.
- * - This suggests that either the tests are missing, incomplete, or not properly designed to cover the functionality provided by this file.
- * - Improving test coverage for this file is crucial to ensure reliability and correctness of the mathematical operations it provides.
- *
- * Note:
- * - The 'N/A' under branch coverage implies that the coverage for conditional branches within this file is not available,
- *   which might be due to missing test configurations or the coverage tool limitations in the free version.
+ * The mean and min/max reductions have scalar, SSE2 and AVX2 variants; the variant is chosen once from the
+ * CPU features. Vector loops keep several independent accumulators so consecutive additions do not wait for
+ * each other, and float sums are widened to double. The median copies the data and partitions it with an
+ * introselect: quickselect with a median-of-three pivot and three-way partitioning (prices repeat a lot),
+ * switching to median-of-medians pivots after 2 log2(n) rounds so that adversarial inputs stay O(n).
  */
+
+#include "../header/mathUtility.h"
+#include "../header/cpuFeatures.h"
+#include <vector>
+
+#ifdef CORUH_X86
+#include <immintrin.h>
+#endif
+
+using namespace Coruh::Utility;
+
+namespace
+{
+    /** @brief Ranges at most this long are finished by insertion sort. */
+    const int SelectInsertionThreshold = 16;
+
+    /** @brief Sum reduction over a double or float array. */
+    typedef double (*DoubleSumFunction)(const double* fiArray, int fiArrayLen);
+    typedef double (*FloatSumFunction)(const float* fiArray, int fiArrayLen);
+    /** @brief Min/max reduction over a non-empty double or float array. */
+    typedef void (*DoubleMinMaxFunction)(const double* fiArray, int fiArrayLen, double* foMin, double* foMax);
+    typedef void (*FloatMinMaxFunction)(const float* fiArray, int fiArrayLen, float* foMin, float* foMax);
+
+    template <typename T>
+    double sumScalar(const T* fiArray, int fiArrayLen)
+    {
+        double sum = 0.0;
+        for (int i = 0; i < fiArrayLen; i++) {sum += fiArray[i];}
+        return sum;
+    }
+
+    template <typename T>
+    void minMaxScalar(const T* fiArray, int fiArrayLen, T* foMin, T* foMax)
+    {
+        T minimum = fiArray[0];
+        T maximum = fiArray[0];
+        for (int i = 1; i < fiArrayLen; i++) {
+            if (fiArray[i] < minimum) {minimum = fiArray[i];}
+            if (fiArray[i] > maximum) {maximum = fiArray[i];}
+        }
+        *foMin = minimum;
+        *foMax = maximum;
+    }
+
+#ifdef CORUH_X86
+
+    /**
+     * @brief Combines the per-lane minimums and maximums of a vector loop.
+     */
+    template <typename T>
+    void foldLanes(const T* fiMinimums, const T* fiMaximums, int fiLanes, T* foMin, T* foMax)
+    {
+        T minimum = fiMinimums[0];
+        T maximum = fiMaximums[0];
+        for (int lane = 1; lane < fiLanes; lane++) {
+            if (fiMinimums[lane] < minimum) {minimum = fiMinimums[lane];}
+            if (fiMaximums[lane] > maximum) {maximum = fiMaximums[lane];}
+        }
+        *foMin = minimum;
+        *foMax = maximum;
+    }
+
+    CORUH_TARGET("sse2")
+    double sumDoubleSse2(const double* fiArray, int fiArrayLen)
+    {
+        __m128d sum0 = _mm_setzero_pd();
+        __m128d sum1 = _mm_setzero_pd();
+        int i = 0;
+        for (; i + 4 <= fiArrayLen; i += 4) {
+            sum0 = _mm_add_pd(sum0, _mm_loadu_pd(fiArray + i));
+            sum1 = _mm_add_pd(sum1, _mm_loadu_pd(fiArray + i + 2));
+        }
+        double lanes[2];
+        _mm_storeu_pd(lanes, _mm_add_pd(sum0, sum1));
+        double sum = lanes[0] + lanes[1];
+        for (; i < fiArrayLen; i++) {sum += fiArray[i];}
+        return sum;
+    }
+
+    CORUH_TARGET("sse2")
+    double sumFloatSse2(const float* fiArray, int fiArrayLen)
+    {
+        __m128d sum0 = _mm_setzero_pd();
+        __m128d sum1 = _mm_setzero_pd();
+        int i = 0;
+        for (; i + 4 <= fiArrayLen; i += 4) {
+            __m128 block = _mm_loadu_ps(fiArray + i);
+            sum0 = _mm_add_pd(sum0, _mm_cvtps_pd(block));
+            sum1 = _mm_add_pd(sum1, _mm_cvtps_pd(_mm_movehl_ps(block, block)));
+        }
+        double lanes[2];
+        _mm_storeu_pd(lanes, _mm_add_pd(sum0, sum1));
+        double sum = lanes[0] + lanes[1];
+        for (; i < fiArrayLen; i++) {sum += fiArray[i];}
+        return sum;
+    }
+
+    CORUH_TARGET("sse2")
+    void minMaxDoubleSse2(const double* fiArray, int fiArrayLen, double* foMin, double* foMax)
+    {
+        if (fiArrayLen < 2) {
+            minMaxScalar(fiArray, fiArrayLen, foMin, foMax);
+            return;
+        }
+        __m128d minimum = _mm_loadu_pd(fiArray);
+        __m128d maximum = minimum;
+        int i = 2;
+        for (; i + 2 <= fiArrayLen; i += 2) {
+            __m128d block = _mm_loadu_pd(fiArray + i);
+            minimum = _mm_min_pd(minimum, block);
+            maximum = _mm_max_pd(maximum, block);
+        }
+        double minimums[2];
+        double maximums[2];
+        _mm_storeu_pd(minimums, minimum);
+        _mm_storeu_pd(maximums, maximum);
+        foldLanes(minimums, maximums, 2, foMin, foMax);
+        for (; i < fiArrayLen; i++) {
+            if (fiArray[i] < *foMin) {*foMin = fiArray[i];}
+            if (fiArray[i] > *foMax) {*foMax = fiArray[i];}
+        }
+    }
+
+    CORUH_TARGET("sse2")
+    void minMaxFloatSse2(const float* fiArray, int fiArrayLen, float* foMin, float* foMax)
+    {
+        if (fiArrayLen < 4) {
+            minMaxScalar(fiArray, fiArrayLen, foMin, foMax);
+            return;
+        }
+        __m128 minimum = _mm_loadu_ps(fiArray);
+        __m128 maximum = minimum;
+        int i = 4;
+        for (; i + 4 <= fiArrayLen; i += 4) {
+            __m128 block = _mm_loadu_ps(fiArray + i);
+            minimum = _mm_min_ps(minimum, block);
+            maximum = _mm_max_ps(maximum, block);
+        }
+        float minimums[4];
+        float maximums[4];
+        _mm_storeu_ps(minimums, minimum);
+        _mm_storeu_ps(maximums, maximum);
+        foldLanes(minimums, maximums, 4, foMin, foMax);
+        for (; i < fiArrayLen; i++) {
+            if (fiArray[i] < *foMin) {*foMin = fiArray[i];}
+            if (fiArray[i] > *foMax) {*foMax = fiArray[i];}
+        }
+    }
+
+    CORUH_TARGET("avx2")
+    double sumDoubleAvx2(const double* fiArray, int fiArrayLen)
+    {
+        __m256d sum0 = _mm256_setzero_pd();
+        __m256d sum1 = _mm256_setzero_pd();
+        int i = 0;
+        for (; i + 8 <= fiArrayLen; i += 8) {
+            sum0 = _mm256_add_pd(sum0, _mm256_loadu_pd(fiArray + i));
+            sum1 = _mm256_add_pd(sum1, _mm256_loadu_pd(fiArray + i + 4));
+        }
+        double lanes[4];
+        _mm256_storeu_pd(lanes, _mm256_add_pd(sum0, sum1));
+        double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        for (; i < fiArrayLen; i++) {sum += fiArray[i];}
+        return sum;
+    }
+
+    CORUH_TARGET("avx2")
+    double sumFloatAvx2(const float* fiArray, int fiArrayLen)
+    {
+        __m256d sum0 = _mm256_setzero_pd();
+        __m256d sum1 = _mm256_setzero_pd();
+        int i = 0;
+        for (; i + 8 <= fiArrayLen; i += 8) {
+            __m256 block = _mm256_loadu_ps(fiArray + i);
+            sum0 = _mm256_add_pd(sum0, _mm256_cvtps_pd(_mm256_castps256_ps128(block)));
+            sum1 = _mm256_add_pd(sum1, _mm256_cvtps_pd(_mm256_extractf128_ps(block, 1)));
+        }
+        double lanes[4];
+        _mm256_storeu_pd(lanes, _mm256_add_pd(sum0, sum1));
+        double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        for (; i < fiArrayLen; i++) {sum += fiArray[i];}
+        return sum;
+    }
+
+    CORUH_TARGET("avx2")
+    void minMaxDoubleAvx2(const double* fiArray, int fiArrayLen, double* foMin, double* foMax)
+    {
+        if (fiArrayLen < 4) {
+            minMaxScalar(fiArray, fiArrayLen, foMin, foMax);
+            return;
+        }
+        __m256d minimum = _mm256_loadu_pd(fiArray);
+        __m256d maximum = minimum;
+        int i = 4;
+        for (; i + 4 <= fiArrayLen; i += 4) {
+            __m256d block = _mm256_loadu_pd(fiArray + i);
+            minimum = _mm256_min_pd(minimum, block);
+            maximum = _mm256_max_pd(maximum, block);
+        }
+        double minimums[4];
+        double maximums[4];
+        _mm256_storeu_pd(minimums, minimum);
+        _mm256_storeu_pd(maximums, maximum);
+        foldLanes(minimums, maximums, 4, foMin, foMax);
+        for (; i < fiArrayLen; i++) {
+            if (fiArray[i] < *foMin) {*foMin = fiArray[i];}
+            if (fiArray[i] > *foMax) {*foMax = fiArray[i];}
+        }
+    }
+
+    CORUH_TARGET("avx2")
+    void minMaxFloatAvx2(const float* fiArray, int fiArrayLen, float* foMin, float* foMax)
+    {
+        if (fiArrayLen < 8) {
+            minMaxScalar(fiArray, fiArrayLen, foMin, foMax);
+            return;
+        }
+        __m256 minimum = _mm256_loadu_ps(fiArray);
+        __m256 maximum = minimum;
+        int i = 8;
+        for (; i + 8 <= fiArrayLen; i += 8) {
+            __m256 block = _mm256_loadu_ps(fiArray + i);
+            minimum = _mm256_min_ps(minimum, block);
+            maximum = _mm256_max_ps(maximum, block);
+        }
+        float minimums[8];
+        float maximums[8];
+        _mm256_storeu_ps(minimums, minimum);
+        _mm256_storeu_ps(maximums, maximum);
+        foldLanes(minimums, maximums, 8, foMin, foMax);
+        for (; i < fiArrayLen; i++) {
+            if (fiArray[i] < *foMin) {*foMin = fiArray[i];}
+            if (fiArray[i] > *foMax) {*foMax = fiArray[i];}
+        }
+    }
+
+#endif
+
+    DoubleSumFunction doubleSumFunction()
+    {
+#ifdef CORUH_X86
+        static const DoubleSumFunction function = CpuFeatures::hasAvx2() ? sumDoubleAvx2
+                                                : CpuFeatures::hasSse2() ? sumDoubleSse2 : sumScalar<double>;
+#else
+        static const DoubleSumFunction function = sumScalar<double>;
+#endif
+        return function;
+    }
+
+    FloatSumFunction floatSumFunction()
+    {
+#ifdef CORUH_X86
+        static const FloatSumFunction function = CpuFeatures::hasAvx2() ? sumFloatAvx2
+                                               : CpuFeatures::hasSse2() ? sumFloatSse2 : sumScalar<float>;
+#else
+        static const FloatSumFunction function = sumScalar<float>;
+#endif
+        return function;
+    }
+
+    DoubleMinMaxFunction doubleMinMaxFunction()
+    {
+#ifdef CORUH_X86
+        static const DoubleMinMaxFunction function = CpuFeatures::hasAvx2() ? minMaxDoubleAvx2
+                                                   : CpuFeatures::hasSse2() ? minMaxDoubleSse2 : minMaxScalar<double>;
+#else
+        static const DoubleMinMaxFunction function = minMaxScalar<double>;
+#endif
+        return function;
+    }
+
+    FloatMinMaxFunction floatMinMaxFunction()
+    {
+#ifdef CORUH_X86
+        static const FloatMinMaxFunction function = CpuFeatures::hasAvx2() ? minMaxFloatAvx2
+                                                  : CpuFeatures::hasSse2() ? minMaxFloatSse2 : minMaxScalar<float>;
+#else
+        static const FloatMinMaxFunction function = minMaxScalar<float>;
+#endif
+        return function;
+    }
+
+    template <typename T>
+    void insertionSort(T* fiData, int fiLeft, int fiRight)
+    {
+        for (int i = fiLeft + 1; i <= fiRight; i++) {
+            T value = fiData[i];
+            int j = i - 1;
+            while (j >= fiLeft && fiData[j] > value) {
+                fiData[j + 1] = fiData[j];
+                j--;
+            }
+            fiData[j + 1] = value;
+        }
+    }
+
+    template <typename T>
+    T medianOfThree(T fiA, T fiB, T fiC)
+    {
+        if (fiA < fiB) {
+            if (fiB < fiC) {return fiB;}
+            return fiA < fiC ? fiC : fiA;
+        }
+        if (fiA < fiC) {return fiA;}
+        return fiB < fiC ? fiC : fiB;
+    }
+
+    template <typename T>
+    T selectKth(T* fiData, int fiCount, int fiK);
+
+    /**
+     * @brief Returns the median of the medians of groups of five in [fiLeft, fiRight]; reorders the range.
+     */
+    template <typename T>
+    T medianOfMedians(T* fiData, int fiLeft, int fiRight)
+    {
+        int groups = 0;
+        for (int start = fiLeft; start <= fiRight; start += 5) {
+            int end = start + 4 < fiRight ? start + 4 : fiRight;
+            insertionSort(fiData, start, end);
+            T median = fiData[start + (end - start) / 2];
+            fiData[start + (end - start) / 2] = fiData[fiLeft + groups];
+            fiData[fiLeft + groups] = median;
+            groups++;
+        }
+        return selectKth(fiData + fiLeft, groups, groups / 2);
+    }
+
+    /**
+     * @brief Reorders fiData so that fiData[fiK] is the value it would have after sorting, and returns it.
+     *
+     * Elements before fiK end up not greater and elements after it not smaller than fiData[fiK].
+     */
+    template <typename T>
+    T selectKth(T* fiData, int fiCount, int fiK)
+    {
+        int left = 0;
+        int right = fiCount - 1;
+        int depthLimit = 0;
+        for (int n = fiCount; n > 1; n >>= 1) {depthLimit += 2;}
+
+        while (right - left >= SelectInsertionThreshold) {
+            T pivot = depthLimit-- > 0 ? medianOfThree(fiData[left], fiData[left + (right - left) / 2], fiData[right])
+                                       : medianOfMedians(fiData, left, right);
+
+            // Three-way partition: [left, less) < pivot, [less, i) == pivot, (greater, right] > pivot
+            int less = left;
+            int i = left;
+            int greater = right;
+            while (i <= greater) {
+                if (fiData[i] < pivot) {
+                    T swap = fiData[i];
+                    fiData[i++] = fiData[less];
+                    fiData[less++] = swap;
+                }
+                else if (pivot < fiData[i]) {
+                    T swap = fiData[i];
+                    fiData[i] = fiData[greater];
+                    fiData[greater--] = swap;
+                }
+                else {
+                    i++;
+                }
+            }
+
+            if (fiK < less) {right = less - 1;}
+            else if (fiK > greater) {left = greater + 1;}
+            else {return pivot;}
+        }
+
+        insertionSort(fiData, left, right);
+        return fiData[fiK];
+    }
+
+    template <typename T>
+    double median(const T fiArray[], int fiArrayLen)
+    {
+        if (fiArrayLen <= 0) {return 0.0;}
+        std::vector<T> data(fiArray, fiArray + fiArrayLen);
+        int upper = fiArrayLen / 2;
+        T upperValue = selectKth(data.data(), fiArrayLen, upper);
+        if (fiArrayLen % 2 == 1) {return upperValue;}
+
+        // Everything before the upper middle is not greater than it, so the lower middle is their maximum
+        T lowerValue = data[0];
+        for (int i = 1; i < upper; i++) {
+            if (data[i] > lowerValue) {lowerValue = data[i];}
+        }
+        return ((double)lowerValue + (double)upperValue) / 2.0;
+    }
+}
+
+double MathUtility::calculateMean(const double fiArray[], int fiArrayLen) {
+    if (fiArrayLen <= 0) {return 0.0;}
+    return doubleSumFunction()(fiArray, fiArrayLen) / fiArrayLen;
+}
+
+double MathUtility::calculateMean(const float fiArray[], int fiArrayLen) {
+    if (fiArrayLen <= 0) {return 0.0;}
+    return floatSumFunction()(fiArray, fiArrayLen) / fiArrayLen;
+}
+
+double MathUtility::calculateMedian(const double fiArray[], int fiArrayLen) {
+    return median(fiArray, fiArrayLen);
+}
+
+double MathUtility::calculateMedian(const float fiArray[], int fiArrayLen) {
+    return median(fiArray, fiArrayLen);
+}
+
+int MathUtility::compareDouble(const void *fiPtrLhs, const void *fiPtrRhs) {
+    double lhs = *(const double*)fiPtrLhs;
+    double rhs = *(const double*)fiPtrRhs;
+    if (lhs < rhs) {return -1;}
+    if (lhs > rhs) {return 1;}
+    return 0;
+}
+
+void MathUtility::calculateMinMax(const double fiArray[], int fiArrayLen, double *foMin, double *foMax) {
+    if (fiArrayLen <= 0) {
+        *foMin = 0.0;
+        *foMax = 0.0;
+        return;
+    }
+    doubleMinMaxFunction()(fiArray, fiArrayLen, foMin, foMax);
+}
+
+void MathUtility::calculateMinMax(const float fiArray[], int fiArrayLen, float *foMin, float *foMax) {
+    if (fiArrayLen <= 0) {
+        *foMin = 0.0f;
+        *foMax = 0.0f;
+        return;
+    }
+    floatMinMaxFunction()(fiArray, fiArrayLen, foMin, foMax);
+}
+
+const char* MathUtility::reductionImplementationName() {
+#ifdef CORUH_X86
+    if (CpuFeatures::hasAvx2()) {return "avx2";}
+    if (CpuFeatures::hasSse2()) {return "sse2";}
+#endif
+    return "scalar";
+}
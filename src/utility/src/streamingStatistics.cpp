@@ -0,0 +1,299 @@
+/**
+ * @file streamingStatistics.cpp
+ * @brief Streaming accumulators for count, mean, variance, extremes and quantiles.
+ *
+ * RunningStatistics keeps Welford's running mean and sum of squared deviations; two accumulators are combined
+ * with Chan's pairwise formula, which gives the same result as feeding all values into one. QuantileDigest is a
+ * merging t-digest: added values go to a buffer of 5 * compression entries, and a full buffer is sorted
+ * together with the existing centroids and merged in one pass. Neighbouring clusters are combined while the
+ * result spans at most one unit of the scale function k(q) = compression / (2 pi) * asin(2q - 1), which is steep
+ * near q = 0 and q = 1 and keeps the tail clusters small.
+ */
+
+#include "../header/streamingStatistics.h"
+#include <algorithm>
+#include <math.h>
+
+using namespace Coruh::Utility;
+
+namespace
+{
+    /** @brief Buffer capacity as a multiple of the compression. */
+    const double DigestBufferFactor = 5.0;
+
+    const double Pi = 3.14159265358979323846;
+
+    /**
+     * @brief Scale function of the digest: maps a quantile to its position on a scale where every
+     *        centroid may span at most one unit.
+     */
+    double digestScale(double fiCompression, double fiQuantile)
+    {
+        double x = 2.0 * fiQuantile - 1.0;
+        if (x < -1.0) {x = -1.0;}
+        if (x > 1.0) {x = 1.0;}
+        return fiCompression / (2.0 * Pi) * asin(x);
+    }
+}
+
+/**
+ * @brief Creates an empty accumulator.
+ */
+RunningStatistics::RunningStatistics()
+{
+    reset();
+}
+
+/**
+ * @brief Removes all values.
+ */
+void RunningStatistics::reset()
+{
+    valueCount = 0;
+    runningMean = 0.0;
+    squaredDeviations = 0.0;
+    smallest = 0.0;
+    largest = 0.0;
+}
+
+/**
+ * @brief Adds a value.
+ *
+ * @param fiValue The value.
+ */
+void RunningStatistics::add(double fiValue)
+{
+    if (valueCount == 0) {
+        smallest = fiValue;
+        largest = fiValue;
+    }
+    else {
+        if (fiValue < smallest) {smallest = fiValue;}
+        if (fiValue > largest) {largest = fiValue;}
+    }
+    valueCount++;
+    double delta = fiValue - runningMean;
+    runningMean += delta / (double)valueCount;
+    squaredDeviations += delta * (fiValue - runningMean);
+}
+
+/**
+ * @brief Adds all values summarised by another accumulator.
+ *
+ * @param fiOther The accumulator to absorb.
+ */
+void RunningStatistics::merge(const RunningStatistics& fiOther)
+{
+    if (fiOther.valueCount == 0) {return;}
+    if (valueCount == 0) {
+        *this = fiOther;
+        return;
+    }
+
+    double countA = (double)valueCount;
+    double countB = (double)fiOther.valueCount;
+    double total = countA + countB;
+    double delta = fiOther.runningMean - runningMean;
+    runningMean += delta * countB / total;
+    squaredDeviations += fiOther.squaredDeviations + delta * delta * countA * countB / total;
+    valueCount += fiOther.valueCount;
+    smallest = std::min(smallest, fiOther.smallest);
+    largest = std::max(largest, fiOther.largest);
+}
+
+/**
+ * @brief Returns the population variance.
+ *
+ * @return The variance, 0 for fewer than two values.
+ */
+double RunningStatistics::variance() const
+{
+    return valueCount < 2 ? 0.0 : squaredDeviations / (double)valueCount;
+}
+
+/**
+ * @brief Returns the sample variance.
+ *
+ * @return The variance divided by n - 1, 0 for fewer than two values.
+ */
+double RunningStatistics::sampleVariance() const
+{
+    return valueCount < 2 ? 0.0 : squaredDeviations / (double)(valueCount - 1);
+}
+
+/**
+ * @brief Returns the population standard deviation.
+ *
+ * @return The square root of variance().
+ */
+double RunningStatistics::standardDeviation() const
+{
+    return sqrt(variance());
+}
+
+/**
+ * @brief Creates an empty digest.
+ *
+ * @param fiCompression Accuracy parameter, at least 10.
+ */
+QuantileDigest::QuantileDigest(double fiCompression) : compression(fiCompression < 10.0 ? 10.0 : fiCompression)
+{
+    reset();
+}
+
+/**
+ * @brief Removes all values.
+ */
+void QuantileDigest::reset()
+{
+    centroids.clear();
+    buffer.clear();
+    buffer.reserve((size_t)(DigestBufferFactor * compression));
+    mergedWeight = 0.0;
+    bufferedWeight = 0.0;
+    smallest = 0.0;
+    largest = 0.0;
+}
+
+/**
+ * @brief Adds a value with a weight.
+ *
+ * @param fiValue The value.
+ * @param fiWeight Its weight; values with a weight that is not positive are ignored.
+ */
+void QuantileDigest::add(double fiValue, double fiWeight)
+{
+    if (!(fiWeight > 0.0) || fiValue != fiValue) {return;}
+    if (totalWeight() == 0.0) {
+        smallest = fiValue;
+        largest = fiValue;
+    }
+    else {
+        if (fiValue < smallest) {smallest = fiValue;}
+        if (fiValue > largest) {largest = fiValue;}
+    }
+
+    Centroid centroid;
+    centroid.mean = fiValue;
+    centroid.weight = fiWeight;
+    buffer.push_back(centroid);
+    bufferedWeight += fiWeight;
+    if ((double)buffer.size() >= DigestBufferFactor * compression) {compress();}
+}
+
+/**
+ * @brief Adds all values summarised by another digest.
+ *
+ * The centroids of the other digest are added like weighted values, so the result is as accurate as a digest
+ * fed with both streams.
+ *
+ * @param fiOther The digest to absorb.
+ */
+void QuantileDigest::merge(const QuantileDigest& fiOther)
+{
+    if (&fiOther == this) {
+        QuantileDigest copy(*this);
+        merge(copy);
+        return;
+    }
+    for (size_t i = 0; i < fiOther.centroids.size(); i++) {
+        add(fiOther.centroids[i].mean, fiOther.centroids[i].weight);
+    }
+    for (size_t i = 0; i < fiOther.buffer.size(); i++) {
+        add(fiOther.buffer[i].mean, fiOther.buffer[i].weight);
+    }
+    if (fiOther.totalWeight() > 0.0) {
+        // Centroid means lie inside the range; the exact extremes come from the other digest
+        smallest = std::min(smallest, fiOther.smallest);
+        largest = std::max(largest, fiOther.largest);
+    }
+}
+
+/**
+ * @brief Merges the buffer into the centroids.
+ */
+void QuantileDigest::compress()
+{
+    if (buffer.empty()) {return;}
+
+    std::vector<Centroid> all;
+    all.reserve(centroids.size() + buffer.size());
+    all.insert(all.end(), centroids.begin(), centroids.end());
+    all.insert(all.end(), buffer.begin(), buffer.end());
+    std::sort(all.begin(), all.end(), [](const Centroid& fiLeft, const Centroid& fiRight) {return fiLeft.mean < fiRight.mean;});
+
+    double total = mergedWeight + bufferedWeight;
+    centroids.clear();
+    Centroid current = all[0];
+    double weightBefore = 0.0;
+    double scaleBefore = digestScale(compression, 0.0);
+    for (size_t i = 1; i < all.size(); i++) {
+        double combined = current.weight + all[i].weight;
+        if (digestScale(compression, (weightBefore + combined) / total) - scaleBefore <= 1.0) {
+            current.mean += (all[i].mean - current.mean) * all[i].weight / combined;
+            current.weight = combined;
+        }
+        else {
+            centroids.push_back(current);
+            weightBefore += current.weight;
+            scaleBefore = digestScale(compression, weightBefore / total);
+            current = all[i];
+        }
+    }
+    centroids.push_back(current);
+
+    buffer.clear();
+    mergedWeight = total;
+    bufferedWeight = 0.0;
+}
+
+/**
+ * @brief Returns the approximate quantile.
+ *
+ * Every centroid is taken to sit at the middle of its weight; the estimate interpolates linearly between the
+ * neighbouring centroid means, and between the extremes and the outermost centroids.
+ *
+ * @param fiQuantile Fraction in [0, 1].
+ * @return The estimate, 0 for an empty digest.
+ */
+double QuantileDigest::quantile(double fiQuantile)
+{
+    compress();
+    if (centroids.empty()) {return 0.0;}
+    if (fiQuantile <= 0.0) {return smallest;}
+    if (fiQuantile >= 1.0) {return largest;}
+
+    double target = fiQuantile * mergedWeight;
+    const Centroid& first = centroids.front();
+    if (target < first.weight / 2.0) {
+        return smallest + (first.mean - smallest) * target / (first.weight / 2.0);
+    }
+    const Centroid& last = centroids.back();
+    if (target > mergedWeight - last.weight / 2.0) {
+        double fromEnd = mergedWeight - target;
+        return largest - (largest - last.mean) * fromEnd / (last.weight / 2.0);
+    }
+
+    double weightBefore = 0.0;
+    for (size_t i = 0; i + 1 < centroids.size(); i++) {
+        double center = weightBefore + centroids[i].weight / 2.0;
+        double nextCenter = weightBefore + centroids[i].weight + centroids[i + 1].weight / 2.0;
+        if (target <= nextCenter) {
+            double fraction = (target - center) / (nextCenter - center);
+            return centroids[i].mean + (centroids[i + 1].mean - centroids[i].mean) * fraction;
+        }
+        weightBefore += centroids[i].weight;
+    }
+    return last.mean;
+}
+
+/**
+ * @brief Returns the number of centroids after merging the buffer.
+ *
+ * @return The centroid count.
+ */
+size_t QuantileDigest::centroidCount()
+{
+    compress();
+    return centroids.size();
+}